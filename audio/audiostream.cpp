@@ -20,6 +20,7 @@
  *
  */
 
+#include "common/atomic.h"
 #include "common/debug.h"
 #include "common/file.h"
 #include "common/mutex.h"
@@ -279,6 +280,21 @@ void QueuingAudioStream::queueBuffer(byte *data, uint32 size, DisposeAfterUse::F
 	queueAudioStream(stream, DisposeAfterUse::YES);
 }
 
+namespace {
+
+/**
+ * Return the number of samples in the stream, counting each channel
+ * separately, or -1 if the length of the stream is unknown.
+ */
+int32 getQueuedStreamLength(AudioStream *stream) {
+	SeekableAudioStream *seekable = dynamic_cast<SeekableAudioStream *>(stream);
+	if (!seekable)
+		return -1;
+
+	return convertTimeToStreamPos(seekable->getLength(), seekable->getRate(), seekable->isStereo()).totalNumberOfFrames();
+}
+
+} // End of anonymous namespace
 
 class QueuingAudioStreamImpl : public QueuingAudioStream {
 private:
@@ -292,9 +308,11 @@ private:
 	struct StreamHolder {
 		AudioStream *_stream;
 		DisposeAfterUse::Flag _disposeAfterUse;
-		StreamHolder(AudioStream *stream, DisposeAfterUse::Flag disposeAfterUse)
+		int32 _samplesLeft;
+		StreamHolder(AudioStream *stream, DisposeAfterUse::Flag disposeAfterUse, int32 samplesLeft)
 		    : _stream(stream),
-		      _disposeAfterUse(disposeAfterUse) {}
+		      _disposeAfterUse(disposeAfterUse),
+		      _samplesLeft(samplesLeft) {}
 	};
 
 	/**
@@ -312,6 +330,16 @@ private:
 	 */
 	bool _finished;
 
+	/**
+	 * Number of samples of known length still queued.
+	 */
+	uint32 _queuedSamples;
+
+	/**
+	 * Number of times readBuffer() ran dry before finish() was called.
+	 */
+	uint32 _underruns;
+
 	/**
 	 * A mutex to avoid access problems (causing e.g. corruption of
 	 * the linked list) in thread aware environments.
@@ -325,7 +353,7 @@ private:
 
 public:
 	QueuingAudioStreamImpl(int rate, bool stereo)
-	    : _rate(rate), _stereo(stereo), _finished(false) {}
+	    : _rate(rate), _stereo(stereo), _finished(false), _queuedSamples(0), _underruns(0) {}
 	~QueuingAudioStreamImpl();
 
 	// Implement the AudioStream API
@@ -355,6 +383,16 @@ public:
 		Common::StackLock lock(_mutex);
 		return _queue.size();
 	}
+
+	Timestamp getQueuedDuration() const {
+		Common::StackLock lock(_mutex);
+		return Timestamp(0, _queuedSamples / (_stereo ? 2 : 1), _rate);
+	}
+
+	uint32 getUnderrunCount() const {
+		Common::StackLock lock(_mutex);
+		return _underruns;
+	}
 };
 
 QueuingAudioStreamImpl::~QueuingAudioStreamImpl() {
@@ -370,8 +408,12 @@ void QueuingAudioStreamImpl::queueAudioStream(AudioStream *stream, DisposeAfterU
 	if ((stream->getRate() != getRate()) || (stream->isStereo() != isStereo()))
 		error("QueuingAudioStreamImpl::queueAudioStream: stream has mismatched parameters");
 
+	const int32 length = getQueuedStreamLength(stream);
+
 	Common::StackLock lock(_mutex);
-	_queue.push(StreamHolder(stream, disposeAfterUse));
+	_queue.push(StreamHolder(stream, disposeAfterUse, length));
+	if (length > 0)
+		_queuedSamples += length;
 }
 
 int QueuingAudioStreamImpl::readBuffer(int16 *buffer, const int numSamples) {
@@ -379,12 +421,22 @@ int QueuingAudioStreamImpl::readBuffer(int16 *buffer, const int numSamples) {
 	int samplesDecoded = 0;
 
 	while (samplesDecoded < numSamples && !_queue.empty()) {
-		AudioStream *stream = _queue.front()._stream;
-		samplesDecoded += stream->readBuffer(buffer + samplesDecoded, numSamples - samplesDecoded);
+		StreamHolder &holder = _queue.front();
+		AudioStream *stream = holder._stream;
+		const int samplesRead = stream->readBuffer(buffer + samplesDecoded, numSamples - samplesDecoded);
+		samplesDecoded += samplesRead;
+
+		if (holder._samplesLeft > 0) {
+			const int32 consumed = MIN<int32>(holder._samplesLeft, samplesRead);
+			holder._samplesLeft -= consumed;
+			_queuedSamples -= consumed;
+		}
 
 		// Done with the stream completely
 		if (stream->endOfStream()) {
 			StreamHolder tmp = _queue.pop();
+			if (tmp._samplesLeft > 0)
+				_queuedSamples -= tmp._samplesLeft;
 			if (tmp._disposeAfterUse == DisposeAfterUse::YES)
 				delete stream;
 			continue;
@@ -395,6 +447,9 @@ int QueuingAudioStreamImpl::readBuffer(int16 *buffer, const int numSamples) {
 			break;
 	}
 
+	if (samplesDecoded < numSamples && !_finished)
+		_underruns++;
+
 	return samplesDecoded;
 }
 
@@ -402,6 +457,216 @@ QueuingAudioStream *makeQueuingAudioStream(int rate, bool stereo) {
 	return new QueuingAudioStreamImpl(rate, stereo);
 }
 
+class LockFreeQueuingAudioStream : public QueuingAudioStream {
+private:
+	struct StreamHolder {
+		AudioStream *_stream;
+		DisposeAfterUse::Flag _disposeAfterUse;
+		int32 _samplesLeft;
+	};
+
+	/**
+	 * A single-producer/single-consumer ring of stream descriptors.
+	 *
+	 * _head is only written by the consumer and _tail only by the
+	 * producer. Both are free running; the slot is taken modulo the
+	 * capacity, which is a power of two. Once full, the producer links
+	 * a larger segment through _next and never touches this one again,
+	 * leaving the consumer to free it after draining it.
+	 */
+	struct Segment {
+		Segment(uint32 capacity) : _mask(capacity - 1), _holders(new StreamHolder[capacity]), _next(nullptr), _head(0), _tail(0) {}
+		~Segment() { delete[] _holders; }
+
+		uint32 capacity() const { return _mask + 1; }
+
+		const uint32 _mask;
+		StreamHolder *_holders;
+		Common::Atomic<Segment *> _next;
+		Common::Atomic<uint32> _head;
+		Common::Atomic<uint32> _tail;
+	};
+
+	const int _rate;
+	const bool _stereo;
+
+	/** Segment the producer queues into. Only touched by the producer. */
+	Segment *_producerSegment;
+
+	/** Segment the consumer reads from. Only touched by the consumer. */
+	Segment *_consumerSegment;
+
+	Common::Atomic<uint32> _finished;
+	Common::Atomic<uint32> _queuedStreams;
+	Common::Atomic<uint32> _queuedSamples;
+	Common::Atomic<uint32> _underruns;
+
+	/** Total number of streams ever queued; used to detect a starved consumer. */
+	Common::Atomic<uint32> _pushCount;
+
+	/** The value of _pushCount when the consumer last ran out of data. */
+	Common::Atomic<uint32> _starvedAtPushCount;
+
+	/** Return the descriptor at the head of the queue, or nullptr. Consumer only. */
+	StreamHolder *front();
+
+	/** Remove the descriptor at the head of the queue. Consumer only. */
+	void pop();
+
+public:
+	LockFreeQueuingAudioStream(int rate, bool stereo, uint32 initialCapacity);
+	~LockFreeQueuingAudioStream();
+
+	// Implement the AudioStream API
+	virtual int readBuffer(int16 *buffer, const int numSamples);
+	virtual bool isStereo() const { return _stereo; }
+	virtual int getRate() const { return _rate; }
+
+	virtual bool endOfData() const {
+		// The front stream may be in use by the consumer, so rely on the
+		// state it published at the end of its last readBuffer() call.
+		return _queuedStreams.load() == 0 || _starvedAtPushCount.load() == _pushCount.load();
+	}
+
+	virtual bool endOfStream() const {
+		return _finished.load() && _queuedStreams.load() == 0;
+	}
+
+	// Implement the QueuingAudioStream API
+	virtual void queueAudioStream(AudioStream *stream, DisposeAfterUse::Flag disposeAfterUse);
+	virtual void finish() { _finished.store(1); }
+	uint32 numQueuedStreams() const { return _queuedStreams.load(); }
+
+	Timestamp getQueuedDuration() const {
+		return Timestamp(0, _queuedSamples.load() / (_stereo ? 2 : 1), _rate);
+	}
+
+	uint32 getUnderrunCount() const { return _underruns.load(); }
+};
+
+LockFreeQueuingAudioStream::LockFreeQueuingAudioStream(int rate, bool stereo, uint32 initialCapacity)
+    : _rate(rate), _stereo(stereo), _finished(0), _queuedStreams(0), _queuedSamples(0),
+      _underruns(0), _pushCount(0), _starvedAtPushCount(~0U) {
+	uint32 capacity = 1;
+	while (capacity < initialCapacity)
+		capacity <<= 1;
+
+	_producerSegment = _consumerSegment = new Segment(capacity);
+}
+
+LockFreeQueuingAudioStream::~LockFreeQueuingAudioStream() {
+	while (StreamHolder *holder = front()) {
+		if (holder->_disposeAfterUse == DisposeAfterUse::YES)
+			delete holder->_stream;
+		pop();
+	}
+
+	delete _consumerSegment;
+}
+
+LockFreeQueuingAudioStream::StreamHolder *LockFreeQueuingAudioStream::front() {
+	for (;;) {
+		Segment *segment = _consumerSegment;
+		const uint32 head = segment->_head.loadRelaxed();
+		if (head != segment->_tail.load())
+			return &segment->_holders[head & segment->_mask];
+
+		Segment *next = segment->_next.load();
+		if (!next)
+			return nullptr;
+
+		// The producer finished writing to this segment before linking
+		// the next one, so the acquire above made its last item visible.
+		if (head != segment->_tail.load())
+			continue;
+
+		_consumerSegment = next;
+		delete segment;
+	}
+}
+
+void LockFreeQueuingAudioStream::pop() {
+	Segment *segment = _consumerSegment;
+	segment->_head.store(segment->_head.loadRelaxed() + 1);
+	_queuedStreams.fetchSub(1);
+}
+
+void LockFreeQueuingAudioStream::queueAudioStream(AudioStream *stream, DisposeAfterUse::Flag disposeAfterUse) {
+	assert(!_finished.load());
+	if ((stream->getRate() != getRate()) || (stream->isStereo() != isStereo()))
+		error("LockFreeQueuingAudioStream::queueAudioStream: stream has mismatched parameters");
+
+	Segment *segment = _producerSegment;
+	uint32 tail = segment->_tail.loadRelaxed();
+	if (tail - segment->_head.load() == segment->capacity()) {
+		Segment *grown = new Segment(segment->capacity() * 2);
+		segment->_next.store(grown);
+		_producerSegment = segment = grown;
+		tail = 0;
+	}
+
+	StreamHolder &holder = segment->_holders[tail & segment->_mask];
+	holder._stream = stream;
+	holder._disposeAfterUse = disposeAfterUse;
+	holder._samplesLeft = getQueuedStreamLength(stream);
+
+	if (holder._samplesLeft > 0)
+		_queuedSamples.fetchAdd(holder._samplesLeft);
+	_queuedStreams.fetchAdd(1);
+	segment->_tail.store(tail + 1);
+	_pushCount.fetchAdd(1);
+}
+
+int LockFreeQueuingAudioStream::readBuffer(int16 *buffer, const int numSamples) {
+	const uint32 pushCount = _pushCount.load();
+	int samplesDecoded = 0;
+
+	while (samplesDecoded < numSamples) {
+		StreamHolder *holder = front();
+		if (!holder)
+			break;
+
+		AudioStream *stream = holder->_stream;
+		const int samplesRead = stream->readBuffer(buffer + samplesDecoded, numSamples - samplesDecoded);
+		samplesDecoded += samplesRead;
+
+		if (holder->_samplesLeft > 0) {
+			const int32 consumed = MIN<int32>(holder->_samplesLeft, samplesRead);
+			holder->_samplesLeft -= consumed;
+			_queuedSamples.fetchSub(consumed);
+		}
+
+		// Done with the stream completely
+		if (stream->endOfStream()) {
+			if (holder->_samplesLeft > 0)
+				_queuedSamples.fetchSub(holder->_samplesLeft);
+			if (holder->_disposeAfterUse == DisposeAfterUse::YES)
+				delete stream;
+			pop();
+			continue;
+		}
+
+		// Done with data but not the stream, bail out
+		if (stream->endOfData())
+			break;
+	}
+
+	if (samplesDecoded < numSamples && !_finished.load())
+		_underruns.fetchAdd(1);
+
+	// Publish whether we ran dry, for endOfData() callers on other threads.
+	// Anything queued after pushCount was sampled clears the condition.
+	StreamHolder *holder = front();
+	if (!holder || holder->_stream->endOfData())
+		_starvedAtPushCount.store(pushCount);
+
+	return samplesDecoded;
+}
+
+QueuingAudioStream *makeLockFreeQueuingAudioStream(int rate, bool stereo, uint32 initialCapacity) {
+	return new LockFreeQueuingAudioStream(rate, stereo, initialCapacity);
+}
+
 Timestamp convertTimeToStreamPos(const Timestamp &where, int rate, bool isStereo) {
 	Timestamp result(where.convertToFramerate(rate * (isStereo ? 2 : 1)));
 
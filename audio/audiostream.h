@@ -377,6 +377,20 @@ public:
 	 * the currently playing stream).
 	 */
 	virtual uint32 numQueuedStreams() const = 0;
+
+	/**
+	 * Return the amount of audio still queued for playback.
+	 *
+	 * Only streams of known length (raw buffers and seekable streams)
+	 * are accounted for.
+	 */
+	virtual Timestamp getQueuedDuration() const = 0;
+
+	/**
+	 * Return how often readBuffer() ran out of queued data before
+	 * finish() was called.
+	 */
+	virtual uint32 getUnderrunCount() const = 0;
 };
 
 /**
@@ -384,6 +398,25 @@ public:
  */
 QueuingAudioStream *makeQueuingAudioStream(int rate, bool stereo);
 
+/**
+ * Factory function for a lock-free QueuingAudioStream.
+ *
+ * The returned stream never takes a mutex. In exchange, all streams must
+ * be queued from a single producer thread, while readBuffer() is only
+ * called by a single consumer (normally the mixer). endOfData(),
+ * endOfStream(), numQueuedStreams(), getQueuedDuration() and
+ * getUnderrunCount() may be called from any thread.
+ *
+ * Queued stream descriptors are kept in preallocated ring buffers. When
+ * a ring fills up, a larger one is chained behind it, so queuing never
+ * blocks.
+ *
+ * @param rate             Sample rate of the stream.
+ * @param stereo           Whether the stream is stereo.
+ * @param initialCapacity  Number of descriptors preallocated; rounded up to a power of two.
+ */
+QueuingAudioStream *makeLockFreeQueuingAudioStream(int rate, bool stereo, uint32 initialCapacity = 16);
+
 /**
  * Convert a point in time to a precise sample offset
  * with the given parameters.
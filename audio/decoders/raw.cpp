@@ -21,6 +21,7 @@
  */
 
 #include "common/endian.h"
+#include "common/memorypool.h"
 #include "common/memstream.h"
 #include "common/textconsole.h"
 #include "common/util.h"
@@ -34,6 +35,17 @@ namespace Audio {
 #pragma mark --- RawStream ---
 #pragma mark -
 
+/**
+ * Pool for the sample buffers of RawStreams, which are often queued on one
+ * thread and played and deleted on the mixer thread.
+ */
+template<size_t bufferSize>
+static Common::ThreadSafeMemoryPool &getSampleBufferPool() {
+	// Never deleted, since streams may be deleted during static destruction
+	static Common::ThreadSafeMemoryPool *pool = new Common::ThreadSafeMemoryPool(bufferSize);
+	return *pool;
+}
+
 /**
  * This is a stream, which allows for playing raw PCM data from a stream.
  */
@@ -43,7 +55,7 @@ public:
 	RawStream(int rate, bool stereo, DisposeAfterUse::Flag disposeStream, Common::SeekableReadStream *stream)
 		: _rate(rate), _isStereo(stereo), _playtime(0, rate), _stream(stream, disposeStream), _endOfData(false), _buffer(0) {
 		// Setup our buffer for readBuffer
-		_buffer = new byte[kSampleBufferLength * bytesPerSample];
+		_buffer = (byte *)getSampleBufferPool<kSampleBufferLength * bytesPerSample>().allocChunk();
 		assert(_buffer);
 
 		// Calculate the total playtime of the stream
@@ -51,7 +63,7 @@ public:
 	}
 
 	~RawStream() {
-		delete[] _buffer;
+		getSampleBufferPool<kSampleBufferLength * bytesPerSample>().freeChunk(_buffer);
 	}
 
 	int readBuffer(int16 *buffer, const int numSamples);
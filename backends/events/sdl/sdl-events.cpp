@@ -564,6 +564,17 @@ bool SdlEventSource::dispatchSDLEvent(SDL_Event &ev, Common::Event &event) {
 	case SDL_CLIPBOARDUPDATE:
 		event.type = Common::EVENT_CLIPBOARD_UPDATE;
 		return true;
+
+#if SDL_VERSION_ATLEAST(2, 0, 4)
+	// The textures may have lost their contents, and the surface graphics
+	// manager only uploads the parts of the screen which changed
+	case SDL_RENDER_TARGETS_RESET:
+	case SDL_RENDER_DEVICE_RESET:
+		if (_graphicsManager) {
+			_graphicsManager->notifyVideoExpose();
+		}
+		return false;
+#endif
 #else
 	case SDL_VIDEOEXPOSE:
 		if (_graphicsManager) {
@@ -63,6 +63,15 @@ protected:
 	 */
 	virtual AbstractFSNode *getChild(const Common::String &name) const = 0;
 
+	/**
+	 * Returns the child node with the given name, when it is already known to
+	 * exist and whether it is a directory, e.g. from an earlier listing.
+	 * Implementations can create such nodes without querying the file system.
+	 *
+	 * @note By default, this method returns the value of getChild().
+	 */
+	virtual AbstractFSNode *getChildWithKnownType(const Common::String &name, bool isDirectory) const { return getChild(name); }
+
 	/**
 	 * The parent node of this directory.
 	 * The parent of the root is the root itself.
@@ -173,6 +182,19 @@ public:
 	 */
 	virtual bool isWritable() const = 0;
 
+	/**
+	 * Returns the time the object referred by this path was last modified, in
+	 * seconds. For directories, this changes when entries are added, removed
+	 * or renamed.
+	 *
+	 * As the time only changes once per second, or less often on some file
+	 * systems, implementations must not return the time of objects modified
+	 * so recently that they could be modified again without it changing.
+	 *
+	 * @return The time, or -1 if it is unknown.
+	 */
+	virtual int64 getModificationTime() const { return -1; }
+
 
 	/**
 	 * Creates a SeekableReadStream instance corresponding to the file
@@ -183,6 +205,14 @@ public:
 	 */
 	virtual Common::SeekableReadStream *createReadStream() = 0;
 
+	/**
+	 * Creates a SeekableReadStream instance for game data, which is not
+	 * written to while it is read. Backends may map such files into memory.
+	 *
+	 * @return pointer to the stream object, 0 in case of a failure
+	 */
+	virtual Common::SeekableReadStream *createGameDataReadStream() { return createReadStream(); }
+
 	/**
 	 * Creates a WriteStream instance corresponding to the file
 	 * referred by this node. This assumes that the node actually refers
@@ -34,6 +34,7 @@
 
 #include "backends/fs/posix/posix-fs.h"
 #include "backends/fs/posix/posix-iostream.h"
+#include "backends/fs/posix/posix-mappedstream.h"
 #include "common/algorithm.h"
 
 #include <sys/param.h>
@@ -48,6 +49,7 @@
 #include <stdio.h>
 #include <errno.h>
 #include <fcntl.h>
+#include <time.h>
 #include <unistd.h>
 
 #ifdef __OS2__
@@ -71,6 +73,18 @@ bool POSIXFilesystemNode::isWritable() const {
 	return access(_path.c_str(), W_OK) == 0;
 }
 
+int64 POSIXFilesystemNode::getModificationTime() const {
+	struct stat st;
+	if (stat(_path.c_str(), &st) != 0)
+		return -1;
+
+	// Another change within the same second would not be noticed
+	if (st.st_mtime >= time(nullptr) - 1)
+		return -1;
+
+	return st.st_mtime;
+}
+
 void POSIXFilesystemNode::setFlags() {
 	struct stat st;
 
@@ -141,6 +155,21 @@ AbstractFSNode *POSIXFilesystemNode::getChild(const Common::String &n) const {
 	return makeNode(newPath);
 }
 
+AbstractFSNode *POSIXFilesystemNode::getChildWithKnownType(const Common::String &n, bool isDirectory) const {
+	assert(_isDirectory);
+	assert(!n.contains('/'));
+
+	// Like getChildren() does, without stat()
+	POSIXFilesystemNode *entry = new POSIXFilesystemNode(*this);
+	entry->_displayName = n;
+	if (_path.lastChar() != '/')
+		entry->_path += '/';
+	entry->_path += n;
+	entry->_isDirectory = isDirectory;
+	entry->_isValid = true;
+	return entry;
+}
+
 bool POSIXFilesystemNode::getChildren(AbstractFSList &myList, ListMode mode, bool hidden) const {
 	assert(_isDirectory);
 
@@ -290,6 +319,14 @@ Common::SeekableReadStream *POSIXFilesystemNode::createReadStream() {
 	return PosixIoStream::makeFromPath(getPath(), false);
 }
 
+Common::SeekableReadStream *POSIXFilesystemNode::createGameDataReadStream() {
+	Common::SeekableReadStream *stream = PosixMappedStream::makeFromPath(getPath());
+	if (stream)
+		return stream;
+
+	return createReadStream();
+}
+
 Common::WriteStream *POSIXFilesystemNode::createWriteStream() {
 	return PosixIoStream::makeFromPath(getPath(), true);
 }
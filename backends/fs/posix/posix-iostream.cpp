@@ -24,11 +24,12 @@
 
 #include "backends/fs/posix/posix-iostream.h"
 
+#include <errno.h>
 #include <sys/stat.h>
+#include <unistd.h>
 
 #if defined(ANDROID_PLAIN_PORT)
 #include "backends/platform/android/jni-android.h"
-#include <unistd.h>
 #endif
 
 
@@ -121,3 +122,44 @@ int64 PosixIoStream::size() const {
 
 	return st.st_size;
 }
+
+Common::AsyncReadRequest *PosixIoStream::readAsync(int64 offset, uint32 size) {
+	int fd = fileno((FILE *)_handle);
+	if (fd == -1)
+		return StdioStream::readAsync(offset, size);
+
+	return PosixReadRequest::create(fd, offset, size);
+}
+
+Common::AsyncReadRequest *PosixReadRequest::create(int fd, int64 offset, uint32 size) {
+	PosixReadRequest *request = new PosixReadRequest(dup(fd), offset, size);
+	request->start(request->_fd != -1);
+	return request;
+}
+
+PosixReadRequest::PosixReadRequest(int fd, int64 offset, uint32 size) :
+		Common::AsyncReadRequest(size), _fd(fd), _offset(offset) {
+}
+
+PosixReadRequest::~PosixReadRequest() {
+	cancel();
+	if (_fd != -1)
+		close(_fd);
+}
+
+uint32 PosixReadRequest::readData(byte *buffer, uint32 size) {
+	if (_fd == -1 || _offset < 0)
+		return 0;
+
+	// pread() does not move the file position shared with the stream
+	uint32 dataSize = 0;
+	while (dataSize < size) {
+		ssize_t count = pread(_fd, buffer + dataSize, size - dataSize, _offset + dataSize);
+		if (count < 0 && errno == EINTR)
+			continue;
+		if (count <= 0)
+			break;
+		dataSize += count;
+	}
+	return dataSize;
+}
@@ -24,6 +24,7 @@
 #define BACKENDS_FS_POSIX_POSIXIOSTREAM_H
 
 #include "backends/fs/stdiostream.h"
+#include "common/asyncio.h"
 
 /**
  * A file input / output stream using POSIX interfaces
@@ -43,6 +44,32 @@ public:
 #endif
 
 	int64 size() const override;
+	Common::AsyncReadRequest *readAsync(int64 offset, uint32 size) override;
+};
+
+/**
+ * Reads a range of a file on an I/O thread. The request keeps its own
+ * duplicate of the file descriptor, so that the stream can be closed
+ * meanwhile.
+ */
+class PosixReadRequest : public Common::AsyncReadRequest {
+public:
+	/**
+	 * Start reading a range of the file open as @p fd, or fail right
+	 * away if the descriptor cannot be duplicated.
+	 */
+	static Common::AsyncReadRequest *create(int fd, int64 offset, uint32 size);
+
+	~PosixReadRequest();
+
+protected:
+	uint32 readData(byte *buffer, uint32 size) override;
+
+private:
+	PosixReadRequest(int fd, int64 offset, uint32 size);
+
+	int _fd;
+	int64 _offset;
 };
 
 #endif
@@ -0,0 +1,112 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#define FORBIDDEN_SYMBOL_ALLOW_ALL
+
+#include "backends/fs/posix/posix-mappedstream.h"
+#include "backends/fs/posix/posix-iostream.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#if defined(_POSIX_MAPPED_FILES) && _POSIX_MAPPED_FILES > 0 && defined(__linux__)
+#include <sys/mman.h>
+#include <sys/vfs.h>
+#define USE_POSIX_MMAP
+#endif
+
+enum {
+	// Smaller files are read in a single buffered read anyway
+	kMinMappedSize = 64 * 1024
+};
+
+#ifdef USE_POSIX_MMAP
+/**
+ * Whether the file is on a file system which is unlikely to go away or be
+ * changed by someone else while it is mapped. Reading a mapped file which
+ * became shorter, or whose medium was removed, raises SIGBUS instead of
+ * failing like read() does.
+ */
+static bool isOnFixedStorage(int fd) {
+	struct statfs fs;
+	if (fstatfs(fd, &fs) == -1)
+		return false;
+
+	switch ((uint32)fs.f_type) {
+	case 0x9660:     // ISO 9660, CDs
+	case 0x15013346: // UDF, DVDs
+	case 0x4D44:     // FAT, memory cards and USB sticks
+	case 0x2011BAB0: // exFAT
+	case 0x65735546: // FUSE, e.g. NTFS or remote file systems
+	case 0x6969:     // NFS
+	case 0x517B:     // SMB
+	case 0xFE534D42: // SMB2
+	case 0xFF534D42: // CIFS
+	case 0x01021997: // 9P
+		return false;
+	default:
+		return true;
+	}
+}
+#endif
+
+PosixMappedStream *PosixMappedStream::makeFromPath(const Common::String &path) {
+#ifdef USE_POSIX_MMAP
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd == -1)
+		return nullptr;
+
+	struct stat st;
+	if (fstat(fd, &st) == -1 || !S_ISREG(st.st_mode) ||
+	    st.st_size < kMinMappedSize || (uint64)st.st_size > 0xFFFFFFFF ||
+	    !isOnFixedStorage(fd)) {
+		close(fd);
+		return nullptr;
+	}
+
+	void *data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (data == MAP_FAILED) {
+		close(fd);
+		return nullptr;
+	}
+
+	return new PosixMappedStream(fd, (const byte *)data, st.st_size);
+#else
+	return nullptr;
+#endif
+}
+
+PosixMappedStream::PosixMappedStream(int fd, const byte *data, uint32 size) :
+		MemoryReadStream(data, size), _fd(fd), _mapping(data) {
+}
+
+PosixMappedStream::~PosixMappedStream() {
+#ifdef USE_POSIX_MMAP
+	munmap(const_cast<byte *>(_mapping), size());
+#endif
+	close(_fd);
+}
+
+Common::AsyncReadRequest *PosixMappedStream::readAsync(int64 offset, uint32 size) {
+	return PosixReadRequest::create(_fd, offset, size);
+}
@@ -0,0 +1,61 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef BACKENDS_FS_POSIX_POSIXMAPPEDSTREAM_H
+#define BACKENDS_FS_POSIX_POSIXMAPPEDSTREAM_H
+
+#include "common/memstream.h"
+#include "common/str.h"
+
+/**
+ * A file input stream mapping the whole file into memory.
+ *
+ * Reading is a plain memory copy, and mapRange() gives direct access to the
+ * file contents. The file must not be truncated while it is mapped, so this
+ * is only used for game data, and only for files on local fixed storage.
+ * readAsync() reads the file with pread() on an I/O thread, so that the
+ * calling thread does not wait for the pages to be loaded.
+ */
+class PosixMappedStream : public Common::MemoryReadStream {
+public:
+	/**
+	 * Map the file at the given path and wrap it in a PosixMappedStream.
+	 *
+	 * @return the stream, or nullptr if the file could not be mapped, for
+	 *         example because it is too small or too large to be worth it,
+	 *         or is on removable media or a network share, in which case
+	 *         it should be read through a PosixIoStream
+	 */
+	static PosixMappedStream *makeFromPath(const Common::String &path);
+
+	~PosixMappedStream();
+
+	Common::AsyncReadRequest *readAsync(int64 offset, uint32 size);
+
+private:
+	PosixMappedStream(int fd, const byte *data, uint32 size);
+
+	int _fd;
+	const byte *_mapping;
+};
+
+#endif
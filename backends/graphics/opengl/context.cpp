@@ -43,6 +43,8 @@ void Context::reset() {
 	framebufferObjectSupported = false;
 	packedPixelsSupported = false;
 	textureEdgeClampSupported = false;
+	unpackSubimageSupported = false;
+	pixelBufferObjectSupported = false;
 
 #define GL_FUNC_DEF(ret, name, param) name = nullptr;
 #include "backends/graphics/opengl/opengl-func.h"
@@ -162,6 +164,10 @@ void OpenGLGraphicsManager::initializeGLContext() {
 			g_context.packedPixelsSupported = true;
 		} else if (token == "GL_SGIS_texture_edge_clamp") {
 			g_context.textureEdgeClampSupported = true;
+		} else if (token == "GL_EXT_unpack_subimage") {
+			g_context.unpackSubimageSupported = true;
+		} else if (token == "GL_ARB_pixel_buffer_object") {
+			g_context.pixelBufferObjectSupported = true;
 		}
 	}
 
@@ -187,6 +193,29 @@ void OpenGLGraphicsManager::initializeGLContext() {
 		g_context.textureEdgeClampSupported = true;
 	}
 
+	// OpenGL always has GL_UNPACK_ROW_LENGTH, OpenGL ES only from 3.0 on.
+	if (g_context.type == kContextGL || g_context.isGLVersionOrHigher(3, 0)) {
+		g_context.unpackSubimageSupported = true;
+	}
+
+	// PBOs are core in OpenGL 2.1. We do not use them with OpenGL ES, which
+	// lacks glMapBuffer before 3.0.
+#if !USE_FORCED_GLES
+	if (g_context.type == kContextGL) {
+		if (g_context.isGLVersionOrHigher(2, 1)) {
+			g_context.pixelBufferObjectSupported = true;
+		}
+
+		g_context.pixelBufferObjectSupported &= g_context.glGenBuffers && g_context.glDeleteBuffers
+		                                     && g_context.glBindBuffer && g_context.glBufferData
+		                                     && g_context.glMapBuffer && g_context.glUnmapBuffer;
+	} else {
+		g_context.pixelBufferObjectSupported = false;
+	}
+#else
+	g_context.pixelBufferObjectSupported = false;
+#endif
+
 	// Log context type.
 	switch (g_context.type) {
 	case kContextGL:
@@ -213,6 +242,8 @@ void OpenGLGraphicsManager::initializeGLContext() {
 	debug(5, "OpenGL: FBO support: %d", g_context.framebufferObjectSupported);
 	debug(5, "OpenGL: Packed pixels support: %d", g_context.packedPixelsSupported);
 	debug(5, "OpenGL: Texture edge clamping support: %d", g_context.textureEdgeClampSupported);
+	debug(5, "OpenGL: Unpack subimage support: %d", g_context.unpackSubimageSupported);
+	debug(5, "OpenGL: PBO support: %d", g_context.pixelBufferObjectSupported);
 }
 
 } // End of namespace OpenGL
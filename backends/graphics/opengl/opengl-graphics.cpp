@@ -29,6 +29,7 @@
 #include "backends/graphics/opengl/shader.h"
 
 #include "common/array.h"
+#include "common/debug.h"
 #include "common/textconsole.h"
 #include "common/translation.h"
 #include "common/algorithm.h"
@@ -58,7 +59,7 @@ namespace OpenGL {
 
 OpenGLGraphicsManager::OpenGLGraphicsManager()
 	: _currentState(), _oldState(), _transactionMode(kTransactionNone), _screenChangeID(1 << (sizeof(int) * 8 - 2)),
-	  _pipeline(nullptr), _stretchMode(STRETCH_FIT),
+	  _pipeline(nullptr), _uploadedBytes(0), _stretchMode(STRETCH_FIT),
 	  _defaultFormat(), _defaultFormatAlpha(),
 	  _gameScreen(nullptr), _overlay(nullptr),
 	  _cursor(nullptr),
@@ -465,18 +466,27 @@ void OpenGLGraphicsManager::fillScreen(uint32 col) {
 	_gameScreen->fill(col);
 }
 
+void OpenGLGraphicsManager::updateSurfaceTexture(Surface *surface) {
+	surface->resetUploadedBytes();
+	surface->updateGLTexture();
+	_uploadedBytes += surface->getUploadedBytes();
+}
+
 void OpenGLGraphicsManager::updateScreen() {
 	if (!_gameScreen) {
 		return;
 	}
 
+	// Count the texture data uploaded for this frame only.
+	_uploadedBytes = 0;
+
 #ifdef USE_OSD
 	if (_osdMessageChangeRequest) {
 		osdMessageUpdateSurface();
 	}
 
 	if (_osdIconSurface) {
-		_osdIconSurface->updateGLTexture();
+		updateSurfaceTexture(_osdIconSurface);
 	}
 #endif
 
@@ -499,11 +509,13 @@ void OpenGLGraphicsManager::updateScreen() {
 	}
 
 	// Update changes to textures.
-	_gameScreen->updateGLTexture();
+	updateSurfaceTexture(_gameScreen);
 	if (_cursorVisible && _cursor) {
-		_cursor->updateGLTexture();
+		updateSurfaceTexture(_cursor);
 	}
-	_overlay->updateGLTexture();
+	updateSurfaceTexture(_overlay);
+
+	debug(9, "OpenGL: Uploaded %u bytes of texture data", _uploadedBytes);
 
 	// Clear the screen buffer.
 	GL_CALL(glClear(GL_COLOR_BUFFER_BIT));
@@ -288,6 +288,17 @@ private:
 	 */
 	Pipeline *_pipeline;
 
+	/**
+	 * Update the texture of a surface, and count the bytes it uploaded.
+	 */
+	void updateSurfaceTexture(Surface *surface);
+
+	/**
+	 * The number of bytes of texture data uploaded for the frame being
+	 * drawn by updateScreen.
+	 */
+	uint32 _uploadedBytes;
+
 protected:
 	/**
 	 * Query the address of an OpenGL function by name.
@@ -39,12 +39,17 @@ GLTexture::GLTexture(GLenum glIntFormat, GLenum glFormat, GLenum glType)
 	: _glIntFormat(glIntFormat), _glFormat(glFormat), _glType(glType),
 	  _width(0), _height(0), _logicalWidth(0), _logicalHeight(0),
 	  _texCoords(), _glFilter(GL_NEAREST),
-	  _glTexture(0) {
+	  _glTexture(0), _pixelBuffers(), _pixelBuffer(0), _uploadedBytes(0) {
 	create();
 }
 
 GLTexture::~GLTexture() {
 	GL_CALL_SAFE(glDeleteTextures, (1, &_glTexture));
+#if !USE_FORCED_GLES
+	if (_pixelBuffers[0]) {
+		GL_CALL_SAFE(glDeleteBuffers, (2, _pixelBuffers));
+	}
+#endif
 }
 
 void GLTexture::enableLinearFiltering(bool enable) {
@@ -63,6 +68,13 @@ void GLTexture::enableLinearFiltering(bool enable) {
 void GLTexture::destroy() {
 	GL_CALL(glDeleteTextures(1, &_glTexture));
 	_glTexture = 0;
+
+#if !USE_FORCED_GLES
+	if (_pixelBuffers[0]) {
+		GL_CALL(glDeleteBuffers(2, _pixelBuffers));
+		_pixelBuffers[0] = _pixelBuffers[1] = 0;
+	}
+#endif
 }
 
 void GLTexture::create() {
@@ -93,6 +105,13 @@ void GLTexture::create() {
 		GL_CALL(glTexImage2D(GL_TEXTURE_2D, 0, _glIntFormat, _width, _height,
 		                     0, _glFormat, _glType, NULL));
 	}
+
+#if !USE_FORCED_GLES
+	// Get the buffers to stream texture data through.
+	if (g_context.pixelBufferObjectSupported) {
+		GL_CALL(glGenBuffers(2, _pixelBuffers));
+	}
+#endif
 }
 
 void GLTexture::bind() const {
@@ -141,15 +160,52 @@ void GLTexture::setSize(uint width, uint height) {
 }
 
 void GLTexture::updateArea(const Common::Rect &area, const Graphics::Surface &src) {
+	Common::Array<Common::Rect> areas;
+	areas.push_back(area);
+	updateAreas(areas, src);
+}
+
+void GLTexture::updateAreas(const Common::Array<Common::Rect> &areas, const Graphics::Surface &src) {
 	// Set the texture on the active texture unit.
 	bind();
 
-	// Update the actual texture.
-	// Although we have the area of the texture buffer we want to update we
-	// cannot take advantage of the left/right boundries here because it is
-	// not possible to specify a pitch to glTexSubImage2D. To be precise, with
-	// plain OpenGL we could set GL_UNPACK_ROW_LENGTH to achieve this. However,
-	// OpenGL ES 1.0 does not support GL_UNPACK_ROW_LENGTH. Thus, we are left
+#if !USE_FORCED_GLES
+	// Packing all areas into a PBO takes one copy, after which the driver
+	// can upload them without blocking us.
+	if (_pixelBuffers[0] && uploadThroughPixelBuffer(areas, src)) {
+		return;
+	}
+#endif
+
+	if (!g_context.unpackSubimageSupported) {
+		uploadRows(areas, src);
+		return;
+	}
+
+	// GL_UNPACK_ROW_LENGTH lets glTexSubImage2D skip the pixels between the
+	// rows of an area, thus we only upload the areas themselves.
+	const uint bytesPerPixel = src.format.bytesPerPixel;
+	GL_CALL(glPixelStorei(GL_UNPACK_ROW_LENGTH, src.pitch / bytesPerPixel));
+
+	for (uint i = 0; i < areas.size(); ++i) {
+		const Common::Rect &area = areas[i];
+		GL_CALL(glTexSubImage2D(GL_TEXTURE_2D, 0, area.left, area.top, area.width(), area.height(),
+		                        _glFormat, _glType, src.getBasePtr(area.left, area.top)));
+		_uploadedBytes += area.width() * area.height() * bytesPerPixel;
+	}
+
+	GL_CALL(glPixelStorei(GL_UNPACK_ROW_LENGTH, 0));
+}
+
+namespace {
+bool compareAreaTops(const Common::Rect &a, const Common::Rect &b) {
+	return a.top < b.top;
+}
+} // End of anonymous namespace
+
+void GLTexture::uploadRows(const Common::Array<Common::Rect> &areas, const Graphics::Surface &src) {
+	// Without GL_UNPACK_ROW_LENGTH (OpenGL ES 1.0 and 2.0) it is not
+	// possible to specify a pitch to glTexSubImage2D. Thus, we are left
 	// with the following options:
 	//
 	// 1) (As we do right now) Simply always update the whole texture lines of
@@ -162,16 +218,91 @@ void GLTexture::updateArea(const Common::Rect &area, const Graphics::Surface &sr
 	//
 	// 3) Use glTexSubImage2D per line changed. This is what the old OpenGL
 	//    graphics manager did but it is much slower! Thus, we do not use it.
-	GL_CALL(glTexSubImage2D(GL_TEXTURE_2D, 0, 0, area.top, src.w, area.height(),
-	                       _glFormat, _glType, src.getBasePtr(0, area.top)));
+	//
+	// The areas are merged by lines first so that no line is uploaded twice.
+	Common::Array<Common::Rect> sorted(areas);
+	Common::sort(sorted.begin(), sorted.end(), compareAreaTops);
+
+	uint i = 0;
+	while (i < sorted.size()) {
+		const int16 top = sorted[i].top;
+		int16 bottom = sorted[i].bottom;
+		for (++i; i < sorted.size() && sorted[i].top <= bottom; ++i) {
+			bottom = MAX(bottom, sorted[i].bottom);
+		}
+
+		GL_CALL(glTexSubImage2D(GL_TEXTURE_2D, 0, 0, top, src.w, bottom - top,
+		                        _glFormat, _glType, src.getBasePtr(0, top)));
+		_uploadedBytes += (bottom - top) * src.w * src.format.bytesPerPixel;
+	}
+}
+
+#if !USE_FORCED_GLES
+bool GLTexture::uploadThroughPixelBuffer(const Common::Array<Common::Rect> &areas, const Graphics::Surface &src) {
+	const uint bytesPerPixel = src.format.bytesPerPixel;
+
+	uint size = 0;
+	for (uint i = 0; i < areas.size(); ++i) {
+		size += areas[i].width() * areas[i].height() * bytesPerPixel;
+	}
+
+	// We alternate between two buffers, so that we never fill the buffer
+	// the previous upload might still be reading from. Respecifying the
+	// data store additionally lets the driver hand out fresh memory.
+	_pixelBuffer ^= 1;
+	GL_CALL(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, _pixelBuffers[_pixelBuffer]));
+	GL_CALL(glBufferData(GL_PIXEL_UNPACK_BUFFER, size, nullptr, GL_STREAM_DRAW));
+
+	GLvoid *buffer = nullptr;
+	GL_ASSIGN(buffer, glMapBuffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY));
+	if (!buffer) {
+		GL_CALL(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0));
+		return false;
+	}
+
+	// Pack the areas one after another.
+	byte *dst = (byte *)buffer;
+	for (uint i = 0; i < areas.size(); ++i) {
+		const Common::Rect &area = areas[i];
+		const uint rowSize = area.width() * bytesPerPixel;
+		const byte *srcRow = (const byte *)src.getBasePtr(area.left, area.top);
+
+		for (int y = area.height(); y > 0; --y) {
+			memcpy(dst, srcRow, rowSize);
+			dst += rowSize;
+			srcRow += src.pitch;
+		}
+	}
+
+	GLboolean unmapped = GL_FALSE;
+	GL_ASSIGN(unmapped, glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER));
+	if (!unmapped) {
+		// The buffer contents got lost, e.g. due to a mode switch.
+		GL_CALL(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0));
+		return false;
+	}
+
+	// While a PBO is bound, the pixel pointers are offsets into it.
+	uintptr offset = 0;
+	for (uint i = 0; i < areas.size(); ++i) {
+		const Common::Rect &area = areas[i];
+		GL_CALL(glTexSubImage2D(GL_TEXTURE_2D, 0, area.left, area.top, area.width(), area.height(),
+		                        _glFormat, _glType, (const GLvoid *)offset));
+		offset += area.width() * area.height() * bytesPerPixel;
+	}
+
+	GL_CALL(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0));
+	_uploadedBytes += size;
+	return true;
 }
+#endif
 
 //
 // Surface
 //
 
 Surface::Surface()
-	: _allDirty(false), _dirtyArea() {
+	: _allDirty(false), _dirtyAreas() {
 }
 
 void Surface::copyRectToTexture(uint x, uint y, uint w, uint h, const void *srcPtr, uint srcPitch) {
@@ -179,15 +310,7 @@ void Surface::copyRectToTexture(uint x, uint y, uint w, uint h, const void *srcP
 	assert(x + w <= (uint)dstSurf->w);
 	assert(y + h <= (uint)dstSurf->h);
 
-	// *sigh* Common::Rect::extend behaves unexpected whenever one of the two
-	// parameters is an empty rect. Thus, we check whether the current dirty
-	// area is valid. In case it is not we simply use the parameters as new
-	// dirty area. Otherwise, we simply call extend.
-	if (_dirtyArea.isEmpty()) {
-		_dirtyArea = Common::Rect(x, y, x + w, y + h);
-	} else {
-		_dirtyArea.extend(Common::Rect(x, y, x + w, y + h));
-	}
+	addDirtyArea(Common::Rect(x, y, x + w, y + h));
 
 	const byte *src = (const byte *)srcPtr;
 	byte *dst = (byte *)dstSurf->getBasePtr(x, y);
@@ -212,12 +335,76 @@ void Surface::fill(uint32 color) {
 	flagDirty();
 }
 
-Common::Rect Surface::getDirtyArea() const {
+namespace {
+// Every upload has a cost of its own, so areas are merged when this wastes
+// fewer pixels than that.
+const int kDirtyAreaMergeSlack = 32 * 32;
+// Past this many areas, new ones are merged into the closest one.
+const uint kMaxDirtyAreas = 16;
+
+inline int getArea(const Common::Rect &r) {
+	return r.width() * r.height();
+}
+} // End of anonymous namespace
+
+void Surface::addDirtyArea(const Common::Rect &area) {
+	// *sigh* Common::Rect::extend behaves unexpected whenever one of the two
+	// parameters is an empty rect. Thus, we skip empty areas, which
+	// do not need an upload anyway.
+	if (_allDirty || area.isEmpty()) {
+		return;
+	}
+
+	// Merge with all areas which intersect, so that the areas stay
+	// disjoint, or are cheaper to upload together.
+	Common::Rect merged = area;
+	uint i = 0;
+	while (i < _dirtyAreas.size()) {
+		Common::Rect bounds = merged;
+		bounds.extend(_dirtyAreas[i]);
+
+		if (merged.intersects(_dirtyAreas[i])
+		    || getArea(bounds) <= getArea(merged) + getArea(_dirtyAreas[i]) + kDirtyAreaMergeSlack) {
+			merged = bounds;
+			_dirtyAreas.remove_at(i);
+			// The grown area might now reach areas we already checked.
+			i = 0;
+		} else {
+			++i;
+		}
+	}
+
+	if (_dirtyAreas.size() < kMaxDirtyAreas) {
+		_dirtyAreas.push_back(merged);
+		return;
+	}
+
+	// Merge with the area that grows the least.
+	uint closest = 0;
+	int closestGrowth = 0;
+	for (i = 0; i < _dirtyAreas.size(); ++i) {
+		Common::Rect bounds = merged;
+		bounds.extend(_dirtyAreas[i]);
+
+		const int growth = getArea(bounds) - getArea(_dirtyAreas[i]);
+		if (i == 0 || growth < closestGrowth) {
+			closest = i;
+			closestGrowth = growth;
+		}
+	}
+
+	merged.extend(_dirtyAreas[closest]);
+	_dirtyAreas.remove_at(closest);
+	addDirtyArea(merged);
+}
+
+Common::Array<Common::Rect> &Surface::getDirtyAreas() {
 	if (_allDirty) {
-		return Common::Rect(getWidth(), getHeight());
-	} else {
-		return _dirtyArea;
+		_dirtyAreas.resize(1);
+		_dirtyAreas[0] = Common::Rect(getWidth(), getHeight());
 	}
+
+	return _dirtyAreas;
 }
 
 //
@@ -277,38 +464,42 @@ void Texture::updateGLTexture() {
 		return;
 	}
 
-	Common::Rect dirtyArea = getDirtyArea();
+	Common::Array<Common::Rect> &dirtyAreas = getDirtyAreas();
 
 	// In case we use linear filtering we might need to duplicate the last
 	// pixel row/column to avoid glitches with filtering.
 	if (_glTexture.isLinearFilteringEnabled()) {
-		if (dirtyArea.right == _userPixelData.w && _userPixelData.w != _textureData.w) {
-			uint height = dirtyArea.height();
+		for (uint i = 0; i < dirtyAreas.size(); ++i) {
+			Common::Rect &dirtyArea = dirtyAreas[i];
 
-			const byte *src = (const byte *)_textureData.getBasePtr(_userPixelData.w - 1, dirtyArea.top);
-			byte *dst = (byte *)_textureData.getBasePtr(_userPixelData.w, dirtyArea.top);
+			if (dirtyArea.right == _userPixelData.w && _userPixelData.w != _textureData.w) {
+				uint height = dirtyArea.height();
 
-			while (height-- > 0) {
-				memcpy(dst, src, _textureData.format.bytesPerPixel);
-				dst += _textureData.pitch;
-				src += _textureData.pitch;
-			}
+				const byte *src = (const byte *)_textureData.getBasePtr(_userPixelData.w - 1, dirtyArea.top);
+				byte *dst = (byte *)_textureData.getBasePtr(_userPixelData.w, dirtyArea.top);
 
-			// Extend the dirty area.
-			++dirtyArea.right;
-		}
+				while (height-- > 0) {
+					memcpy(dst, src, _textureData.format.bytesPerPixel);
+					dst += _textureData.pitch;
+					src += _textureData.pitch;
+				}
+
+				// Extend the dirty area.
+				++dirtyArea.right;
+			}
 
-		if (dirtyArea.bottom == _userPixelData.h && _userPixelData.h != _textureData.h) {
-			const byte *src = (const byte *)_textureData.getBasePtr(dirtyArea.left, _userPixelData.h - 1);
-			byte *dst = (byte *)_textureData.getBasePtr(dirtyArea.left, _userPixelData.h);
-			memcpy(dst, src, dirtyArea.width() * _textureData.format.bytesPerPixel);
+			if (dirtyArea.bottom == _userPixelData.h && _userPixelData.h != _textureData.h) {
+				const byte *src = (const byte *)_textureData.getBasePtr(dirtyArea.left, _userPixelData.h - 1);
+				byte *dst = (byte *)_textureData.getBasePtr(dirtyArea.left, _userPixelData.h);
+				memcpy(dst, src, dirtyArea.width() * _textureData.format.bytesPerPixel);
 
-			// Extend the dirty area.
-			++dirtyArea.bottom;
+				// Extend the dirty area.
+				++dirtyArea.bottom;
+			}
 		}
 	}
 
-	_glTexture.updateArea(dirtyArea, _textureData);
+	_glTexture.updateAreas(dirtyAreas, _textureData);
 
 	// We should have handled everything, thus not dirty anymore.
 	clearDirty();
@@ -408,20 +599,25 @@ void TextureCLUT8::updateGLTexture() {
 	// Do the palette look up
 	Graphics::Surface *outSurf = Texture::getSurface();
 
-	Common::Rect dirtyArea = getDirtyArea();
-
-	if (outSurf->format.bytesPerPixel == 2) {
-		doPaletteLookUp<uint16>((uint16 *)outSurf->getBasePtr(dirtyArea.left, dirtyArea.top),
-		                        (const byte *)_clut8Data.getBasePtr(dirtyArea.left, dirtyArea.top),
-		                        dirtyArea.width(), dirtyArea.height(),
-		                        outSurf->pitch, _clut8Data.pitch, (const uint16 *)_palette);
-	} else if (outSurf->format.bytesPerPixel == 4) {
-		doPaletteLookUp<uint32>((uint32 *)outSurf->getBasePtr(dirtyArea.left, dirtyArea.top),
-		                        (const byte *)_clut8Data.getBasePtr(dirtyArea.left, dirtyArea.top),
-		                        dirtyArea.width(), dirtyArea.height(),
-		                        outSurf->pitch, _clut8Data.pitch, (const uint32 *)_palette);
-	} else {
-		warning("TextureCLUT8::updateGLTexture: Unsupported pixel depth: %d", outSurf->format.bytesPerPixel);
+	const Common::Array<Common::Rect> &dirtyAreas = getDirtyAreas();
+
+	for (uint i = 0; i < dirtyAreas.size(); ++i) {
+		const Common::Rect &dirtyArea = dirtyAreas[i];
+
+		if (outSurf->format.bytesPerPixel == 2) {
+			doPaletteLookUp<uint16>((uint16 *)outSurf->getBasePtr(dirtyArea.left, dirtyArea.top),
+			                        (const byte *)_clut8Data.getBasePtr(dirtyArea.left, dirtyArea.top),
+			                        dirtyArea.width(), dirtyArea.height(),
+			                        outSurf->pitch, _clut8Data.pitch, (const uint16 *)_palette);
+		} else if (outSurf->format.bytesPerPixel == 4) {
+			doPaletteLookUp<uint32>((uint32 *)outSurf->getBasePtr(dirtyArea.left, dirtyArea.top),
+			                        (const byte *)_clut8Data.getBasePtr(dirtyArea.left, dirtyArea.top),
+			                        dirtyArea.width(), dirtyArea.height(),
+			                        outSurf->pitch, _clut8Data.pitch, (const uint32 *)_palette);
+		} else {
+			warning("TextureCLUT8::updateGLTexture: Unsupported pixel depth: %d", outSurf->format.bytesPerPixel);
+			break;
+		}
 	}
 
 	// Do generic handling of updating the texture.
@@ -459,11 +655,15 @@ void FakeTexture::updateGLTexture() {
 	// Convert color space.
 	Graphics::Surface *outSurf = Texture::getSurface();
 
-	const Common::Rect dirtyArea = getDirtyArea();
+	const Common::Array<Common::Rect> &dirtyAreas = getDirtyAreas();
+
+	for (uint i = 0; i < dirtyAreas.size(); ++i) {
+		const Common::Rect &dirtyArea = dirtyAreas[i];
 
-	byte *dst = (byte *)outSurf->getBasePtr(dirtyArea.left, dirtyArea.top);
-	const byte *src = (const byte *)_rgbData.getBasePtr(dirtyArea.left, dirtyArea.top);
-	Graphics::crossBlit(dst, src, outSurf->pitch, _rgbData.pitch, dirtyArea.width(), dirtyArea.height(), outSurf->format, _rgbData.format);
+		byte *dst = (byte *)outSurf->getBasePtr(dirtyArea.left, dirtyArea.top);
+		const byte *src = (const byte *)_rgbData.getBasePtr(dirtyArea.left, dirtyArea.top);
+		Graphics::crossBlit(dst, src, outSurf->pitch, _rgbData.pitch, dirtyArea.width(), dirtyArea.height(), outSurf->format, _rgbData.format);
+	}
 
 	// Do generic handling of updating the texture.
 	Texture::updateGLTexture();
@@ -481,25 +681,29 @@ void TextureRGB555::updateGLTexture() {
 	// Convert color space.
 	Graphics::Surface *outSurf = Texture::getSurface();
 
-	const Common::Rect dirtyArea = getDirtyArea();
+	const Common::Array<Common::Rect> &dirtyAreas = getDirtyAreas();
 
-	uint16 *dst = (uint16 *)outSurf->getBasePtr(dirtyArea.left, dirtyArea.top);
-	const uint dstAdd = outSurf->pitch - 2 * dirtyArea.width();
+	for (uint i = 0; i < dirtyAreas.size(); ++i) {
+		const Common::Rect &dirtyArea = dirtyAreas[i];
 
-	const uint16 *src = (const uint16 *)_rgbData.getBasePtr(dirtyArea.left, dirtyArea.top);
-	const uint srcAdd = _rgbData.pitch - 2 * dirtyArea.width();
+		uint16 *dst = (uint16 *)outSurf->getBasePtr(dirtyArea.left, dirtyArea.top);
+		const uint dstAdd = outSurf->pitch - 2 * dirtyArea.width();
 
-	for (int height = dirtyArea.height(); height > 0; --height) {
-		for (int width = dirtyArea.width(); width > 0; --width) {
-			const uint16 color = *src++;
+		const uint16 *src = (const uint16 *)_rgbData.getBasePtr(dirtyArea.left, dirtyArea.top);
+		const uint srcAdd = _rgbData.pitch - 2 * dirtyArea.width();
 
-			*dst++ =   ((color & 0x7C00) << 1)                             // R
-			         | (((color & 0x03E0) << 1) | ((color & 0x0200) >> 4)) // G
-			         | (color & 0x001F);                                   // B
-		}
+		for (int height = dirtyArea.height(); height > 0; --height) {
+			for (int width = dirtyArea.width(); width > 0; --width) {
+				const uint16 color = *src++;
+
+				*dst++ =   ((color & 0x7C00) << 1)                             // R
+				         | (((color & 0x03E0) << 1) | ((color & 0x0200) >> 4)) // G
+				         | (color & 0x001F);                                   // B
+			}
 
-		src = (const uint16 *)((const byte *)src + srcAdd);
-		dst = (uint16 *)((byte *)dst + dstAdd);
+			src = (const uint16 *)((const byte *)src + srcAdd);
+			dst = (uint16 *)((byte *)dst + dstAdd);
+		}
 	}
 
 	// Do generic handling of updating the texture.
@@ -523,23 +727,27 @@ void TextureRGBA8888Swap::updateGLTexture() {
 	// Convert color space.
 	Graphics::Surface *outSurf = Texture::getSurface();
 
-	const Common::Rect dirtyArea = getDirtyArea();
+	const Common::Array<Common::Rect> &dirtyAreas = getDirtyAreas();
 
-	uint32 *dst = (uint32 *)outSurf->getBasePtr(dirtyArea.left, dirtyArea.top);
-	const uint dstAdd = outSurf->pitch - 4 * dirtyArea.width();
+	for (uint i = 0; i < dirtyAreas.size(); ++i) {
+		const Common::Rect &dirtyArea = dirtyAreas[i];
 
-	const uint32 *src = (const uint32 *)_rgbData.getBasePtr(dirtyArea.left, dirtyArea.top);
-	const uint srcAdd = _rgbData.pitch - 4 * dirtyArea.width();
+		uint32 *dst = (uint32 *)outSurf->getBasePtr(dirtyArea.left, dirtyArea.top);
+		const uint dstAdd = outSurf->pitch - 4 * dirtyArea.width();
 
-	for (int height = dirtyArea.height(); height > 0; --height) {
-		for (int width = dirtyArea.width(); width > 0; --width) {
-			const uint32 color = *src++;
+		const uint32 *src = (const uint32 *)_rgbData.getBasePtr(dirtyArea.left, dirtyArea.top);
+		const uint srcAdd = _rgbData.pitch - 4 * dirtyArea.width();
 
-			*dst++ = SWAP_BYTES_32(color);
-		}
+		for (int height = dirtyArea.height(); height > 0; --height) {
+			for (int width = dirtyArea.width(); width > 0; --width) {
+				const uint32 color = *src++;
 
-		src = (const uint32 *)((const byte *)src + srcAdd);
-		dst = (uint32 *)((byte *)dst + dstAdd);
+				*dst++ = SWAP_BYTES_32(color);
+			}
+
+			src = (const uint32 *)((const byte *)src + srcAdd);
+			dst = (uint32 *)((byte *)dst + dstAdd);
+		}
 	}
 
 	// Do generic handling of updating the texture.
@@ -672,7 +880,7 @@ void TextureCLUT8GPU::updateGLTexture() {
 
 	// Update CLUT8 texture if necessary.
 	if (Surface::isDirty()) {
-		_clut8Texture.updateArea(getDirtyArea(), _clut8Data);
+		_clut8Texture.updateAreas(getDirtyAreas(), _clut8Data);
 		clearDirty();
 	}
 
@@ -28,6 +28,7 @@
 #include "graphics/pixelformat.h"
 #include "graphics/surface.h"
 
+#include "common/array.h"
 #include "common/rect.h"
 
 namespace OpenGL {
@@ -99,6 +100,29 @@ public:
 	 */
 	void updateArea(const Common::Rect &area, const Graphics::Surface &src);
 
+	/**
+	 * Copy several areas of image data to the texture.
+	 *
+	 * When PBOs are supported, the areas are packed into one buffer and
+	 * streamed from there.
+	 *
+	 * @param areas    The areas to update.
+	 * @param src      Surface for the whole texture containing the pixel data
+	 *                 to upload. Only the areas will be uploaded.
+	 */
+	void updateAreas(const Common::Array<Common::Rect> &areas, const Graphics::Surface &src);
+
+	/**
+	 * Query the number of bytes uploaded to this texture since the last
+	 * call to resetUploadedBytes.
+	 */
+	uint32 getUploadedBytes() const { return _uploadedBytes; }
+
+	/**
+	 * Reset the counter of uploaded bytes.
+	 */
+	void resetUploadedBytes() { _uploadedBytes = 0; }
+
 	/**
 	 * Query the GL texture's width.
 	 */
@@ -132,6 +156,11 @@ public:
 	 */
 	GLuint getGLTexture() const { return _glTexture; }
 private:
+	void uploadRows(const Common::Array<Common::Rect> &areas, const Graphics::Surface &src);
+#if !USE_FORCED_GLES
+	bool uploadThroughPixelBuffer(const Common::Array<Common::Rect> &areas, const Graphics::Surface &src);
+#endif
+
 	const GLenum _glIntFormat;
 	const GLenum _glFormat;
 	const GLenum _glType;
@@ -143,6 +172,11 @@ private:
 	GLint _glFilter;
 
 	GLuint _glTexture;
+
+	GLuint _pixelBuffers[2];
+	uint _pixelBuffer;
+
+	uint32 _uploadedBytes;
 };
 
 /**
@@ -201,7 +235,7 @@ public:
 	void fill(uint32 color);
 
 	void flagDirty() { _allDirty = true; }
-	virtual bool isDirty() const { return _allDirty || !_dirtyArea.isEmpty(); }
+	virtual bool isDirty() const { return _allDirty || !_dirtyAreas.empty(); }
 
 	virtual uint getWidth() const = 0;
 	virtual uint getHeight() const = 0;
@@ -238,13 +272,30 @@ public:
 	 * Obtain underlying OpenGL texture.
 	 */
 	virtual const GLTexture &getGLTexture() const = 0;
+
+	/**
+	 * Query the number of bytes uploaded by updateGLTexture since the last
+	 * call to resetUploadedBytes.
+	 */
+	virtual uint32 getUploadedBytes() const = 0;
+
+	/**
+	 * Reset the counter of uploaded bytes.
+	 */
+	virtual void resetUploadedBytes() = 0;
 protected:
-	void clearDirty() { _allDirty = false; _dirtyArea = Common::Rect(); }
+	void clearDirty() { _allDirty = false; _dirtyAreas.resize(0); }
 
-	Common::Rect getDirtyArea() const;
+	/**
+	 * Obtain the dirty areas, which do not overlap. The areas may be
+	 * modified until clearDirty is called.
+	 */
+	Common::Array<Common::Rect> &getDirtyAreas();
 private:
+	void addDirtyArea(const Common::Rect &area);
+
 	bool _allDirty;
-	Common::Rect _dirtyArea;
+	Common::Array<Common::Rect> _dirtyAreas;
 };
 
 /**
@@ -285,6 +336,9 @@ public:
 
 	virtual void updateGLTexture();
 	virtual const GLTexture &getGLTexture() const { return _glTexture; }
+
+	virtual uint32 getUploadedBytes() const { return _glTexture.getUploadedBytes(); }
+	virtual void resetUploadedBytes() { _glTexture.resetUploadedBytes(); }
 protected:
 	const Graphics::PixelFormat _format;
 
@@ -387,6 +441,9 @@ public:
 	virtual void updateGLTexture();
 	virtual const GLTexture &getGLTexture() const;
 
+	virtual uint32 getUploadedBytes() const { return _clut8Texture.getUploadedBytes() + _paletteTexture.getUploadedBytes(); }
+	virtual void resetUploadedBytes() { _clut8Texture.resetUploadedBytes(); _paletteTexture.resetUploadedBytes(); }
+
 	static bool isSupportedByContext() {
 		return g_context.shadersSupported
 		    && g_context.multitextureSupported
@@ -120,6 +120,7 @@ SurfaceSdlGraphicsManager::SurfaceSdlGraphicsManager(SdlEventSource *sdlEventSou
 	_useOldSrc(false),
 	_overlayscreen(0), _tmpscreen2(0),
 	_screenChangeCount(0),
+	_dirtyTiles(0, 0, DIRTY_TILE_SIZE),
 	_mouseData(nullptr), _mouseSurface(nullptr),
 	_mouseOrigSurface(nullptr), _cursorDontScale(false), _cursorPaletteDisabled(true),
 	_currentShakeXOffset(0), _currentShakeYOffset(0),
@@ -1144,22 +1145,50 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 
 	// Force a full redraw if requested.
 	// If _useOldSrc, the scaler will do its own partial updates.
+	// Otherwise add the dirty regions after any rects which are already
+	// in screen coordinates.
+	uint firstRect = _dirtyRectList.size();
 	if (_forceRedraw) {
-		_numDirtyRects = 1;
+		firstRect = 0;
+		_dirtyRectList.resize(1);
 		_dirtyRectList[0].x = 0;
 		_dirtyRectList[0].y = 0;
 		_dirtyRectList[0].w = width;
 		_dirtyRectList[0].h = height;
+	} else if (!_dirtyTiles.isClean()) {
+		_dirtyTileRects.resize(0);
+		_dirtyTiles.extractRectangles(Common::Rect(width, height), _dirtyTileRects);
+
+		for (uint i = 0; i < _dirtyTileRects.size(); i++) {
+			int x = _dirtyTileRects[i].left;
+			int y = _dirtyTileRects[i].top;
+			int w = _dirtyTileRects[i].width();
+			int h = _dirtyTileRects[i].height();
+
+#ifdef USE_ASPECT
+			// The tiles do not follow the lines of the stretching
+			if (_videoMode.aspectRatioCorrection && !_overlayVisible)
+				makeRectStretchable(x, y, w, h, _videoMode.filtering);
+#endif
+
+			SDL_Rect r;
+			r.x = x;
+			r.y = y;
+			r.w = w;
+			r.h = h;
+			_dirtyRectList.push_back(r);
+		}
 	}
 
 	// Only draw anything if necessary
-	if (_numDirtyRects > 0 || _cursorNeedsRedraw) {
+	if (!_dirtyRectList.empty() || _cursorNeedsRedraw) {
 		SDL_Rect *r;
 		SDL_Rect dst;
 		uint32 srcPitch, dstPitch;
-		SDL_Rect *lastRect = _dirtyRectList + _numDirtyRects;
+		SDL_Rect *firstDirtyRect = _dirtyRectList.begin() + firstRect;
+		SDL_Rect *lastRect = _dirtyRectList.end();
 
-		for (r = _dirtyRectList; r != lastRect; ++r) {
+		for (r = firstDirtyRect; r != lastRect; ++r) {
 			dst = *r;
 			dst.x += _maxExtraPixels;	// Shift rect since some scalers need to access the data around
 			dst.y += _maxExtraPixels;	// any pixel to scale it, and we want to avoid mem access crashes.
@@ -1174,7 +1203,7 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 		srcPitch = srcSurf->pitch;
 		dstPitch = _hwScreen->pitch;
 
-		for (r = _dirtyRectList; r != lastRect; ++r) {
+		for (r = firstDirtyRect; r != lastRect; ++r) {
 			int dst_x = r->x + _currentShakeXOffset;
 			int dst_y = r->y + _currentShakeYOffset;
 			int dst_w = 0;
@@ -1312,14 +1341,15 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 
 		// Finally, blit all our changes to the screen
 		if (!_displayDisabled) {
-			SDL_UpdateRects(_hwScreen, _numDirtyRects, _dirtyRectList);
+			SDL_UpdateRects(_hwScreen, _dirtyRectList.size(), _dirtyRectList.begin());
 		}
 	}
 
 	// Set up the old scale factor
 	_scalerPlugin->setFactor(oldScaleFactor);
 
-	_numDirtyRects = 0;
+	_dirtyRectList.resize(0);
+	_dirtyTiles.clear();
 	_forceRedraw = false;
 	_cursorNeedsRedraw = false;
 }
@@ -1480,11 +1510,6 @@ void SurfaceSdlGraphicsManager::addDirtyRect(int x, int y, int w, int h, bool re
 	if (_forceRedraw)
 		return;
 
-	if (_numDirtyRects == NUM_DIRTY_RECT) {
-		_forceRedraw = true;
-		return;
-	}
-
 	int height, width;
 
 	if (!_overlayVisible && !realCoordinates) {
@@ -1535,13 +1560,27 @@ void SurfaceSdlGraphicsManager::addDirtyRect(int x, int y, int w, int h, bool re
 		return;
 	}
 
-	if (w > 0 && h > 0) {
-		SDL_Rect *r = &_dirtyRectList[_numDirtyRects++];
+	if (w <= 0 || h <= 0)
+		return;
 
-		r->x = x;
-		r->y = y;
-		r->w = w;
-		r->h = h;
+	if (realCoordinates) {
+		SDL_Rect r;
+		r.x = x;
+		r.y = y;
+		r.w = w;
+		r.h = h;
+		_dirtyRectList.push_back(r);
+	} else {
+		// Regions marked while the grid was set up for the game screen
+		// are lost when the overlay is shown, and the other way round
+		if (_dirtyTiles.getWidth() != width || _dirtyTiles.getHeight() != height) {
+			if (!_dirtyTiles.isClean()) {
+				_forceRedraw = true;
+				return;
+			}
+			_dirtyTiles.resize(width, height);
+		}
+		_dirtyTiles.markRegion(Common::Rect(x, y, x + w, y + h));
 	}
 }
 
@@ -2584,7 +2623,25 @@ SDL_Surface *SurfaceSdlGraphicsManager::SDL_SetVideoMode(int width, int height,
 }
 
 void SurfaceSdlGraphicsManager::SDL_UpdateRects(SDL_Surface *screen, int numrects, SDL_Rect *rects) {
-	SDL_UpdateTexture(_screenTexture, nullptr, screen->pixels, screen->pitch);
+	// Only upload the changed parts of the screen, unless they cover most
+	// of it anyway
+	const SDL_Rect screenRect = { 0, 0, screen->w, screen->h };
+	int dirtyArea = 0;
+	for (int i = 0; i < numrects; i++)
+		dirtyArea += rects[i].w * rects[i].h;
+
+	if (dirtyArea >= screen->w * screen->h / 2) {
+		SDL_UpdateTexture(_screenTexture, nullptr, screen->pixels, screen->pitch);
+	} else {
+		for (int i = 0; i < numrects; i++) {
+			SDL_Rect rect;
+			if (!SDL_IntersectRect(&rects[i], &screenRect, &rect))
+				continue;
+
+			const byte *pixels = (const byte *)screen->pixels + rect.y * screen->pitch + rect.x * screen->format->BytesPerPixel;
+			SDL_UpdateTexture(_screenTexture, &rect, pixels, screen->pitch);
+		}
+	}
 
 	SDL_Rect viewport;
 	viewport.x = _activeArea.drawRect.left;
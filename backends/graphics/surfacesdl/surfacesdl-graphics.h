@@ -25,6 +25,7 @@
 
 #include "backends/graphics/graphics.h"
 #include "backends/graphics/sdl/sdl-graphics.h"
+#include "graphics/dirtytilegrid.h"
 #include "graphics/pixelformat.h"
 #include "graphics/scaler.h"
 #include "graphics/scalerplugin.h"
@@ -334,13 +335,16 @@ protected:
 	int _screenChangeCount;
 
 	enum {
-		NUM_DIRTY_RECT = 100,
+		DIRTY_TILE_SIZE = 8,
 		MAX_SCALING = 3
 	};
 
-	// Dirty rect management
-	SDL_Rect _dirtyRectList[NUM_DIRTY_RECT];
-	int _numDirtyRects;
+	// Dirty rect management. The regions in game or overlay coordinates
+	// are marked in the tile grid, which merges them, and are added to
+	// the list of rects in screen coordinates when the screen is updated.
+	Graphics::DirtyTileGrid _dirtyTiles;
+	Common::Array<Common::Rect> _dirtyTileRects;
+	Common::Array<SDL_Rect> _dirtyRectList;
 
 	struct MousePos {
 		// The size and hotspot of the original cursor image.
@@ -335,3 +335,43 @@ void ModularMutexBackend::deleteMutex(MutexRef mutex) {
 	assert(_mutexManager);
 	_mutexManager->deleteMutex(mutex);
 }
+
+OSystem::ThreadRef ModularMutexBackend::createThread(ThreadProc proc, void *param) {
+	// Threads are optional, so callers cope without them until the
+	// mutex manager is set up
+	if (!_mutexManager)
+		return nullptr;
+	return _mutexManager->createThread(proc, param);
+}
+
+void ModularMutexBackend::joinThread(ThreadRef thread) {
+	assert(_mutexManager);
+	_mutexManager->joinThread(thread);
+}
+
+uint ModularMutexBackend::getCpuCount() {
+	if (!_mutexManager)
+		return 1;
+	return _mutexManager->getCpuCount();
+}
+
+OSystem::SemaphoreRef ModularMutexBackend::createSemaphore() {
+	if (!_mutexManager)
+		return nullptr;
+	return _mutexManager->createSemaphore();
+}
+
+void ModularMutexBackend::postSemaphore(SemaphoreRef semaphore) {
+	assert(_mutexManager);
+	_mutexManager->postSemaphore(semaphore);
+}
+
+void ModularMutexBackend::waitSemaphore(SemaphoreRef semaphore) {
+	assert(_mutexManager);
+	_mutexManager->waitSemaphore(semaphore);
+}
+
+void ModularMutexBackend::deleteSemaphore(SemaphoreRef semaphore) {
+	assert(_mutexManager);
+	_mutexManager->deleteSemaphore(semaphore);
+}
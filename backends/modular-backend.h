@@ -178,6 +178,19 @@ public:
 
 	//@}
 
+	/** @name Worker threads */
+	//@{
+
+	virtual ThreadRef createThread(ThreadProc proc, void *param) override final;
+	virtual void joinThread(ThreadRef thread) override final;
+	virtual uint getCpuCount() override final;
+	virtual SemaphoreRef createSemaphore() override final;
+	virtual void postSemaphore(SemaphoreRef semaphore) override final;
+	virtual void waitSemaphore(SemaphoreRef semaphore) override final;
+	virtual void deleteSemaphore(SemaphoreRef semaphore) override final;
+
+	//@}
+
 protected:
 	/** @name Managers variables */
 	//@{
@@ -38,6 +38,20 @@ public:
 	virtual void lockMutex(OSystem::MutexRef mutex) = 0;
 	virtual void unlockMutex(OSystem::MutexRef mutex) = 0;
 	virtual void deleteMutex(OSystem::MutexRef mutex) = 0;
+
+	/**
+	 * Start a worker thread. Managers for platforms without
+	 * threads keep this default, which makes callers do the
+	 * work themselves.
+	 */
+	virtual OSystem::ThreadRef createThread(OSystem::ThreadProc proc, void *param) { return nullptr; }
+	virtual void joinThread(OSystem::ThreadRef thread) {}
+	virtual uint getCpuCount() { return 1; }
+
+	virtual OSystem::SemaphoreRef createSemaphore() { return nullptr; }
+	virtual void postSemaphore(OSystem::SemaphoreRef semaphore) {}
+	virtual void waitSemaphore(OSystem::SemaphoreRef semaphore) {}
+	virtual void deleteSemaphore(OSystem::SemaphoreRef semaphore) {}
 };
 
 #endif
@@ -21,14 +21,16 @@
  */
 
 #define FORBIDDEN_SYMBOL_EXCEPTION_time_h
+#define FORBIDDEN_SYMBOL_EXCEPTION_unistd_h
 
 #include "common/scummsys.h"
 
-#if defined(__ANDROID__) || defined(IPHONE)
+#if defined(__ANDROID__) || defined(IPHONE) || defined(POSIX)
 
 #include "backends/mutex/pthread/pthread-mutex.h"
 
 #include <pthread.h>
+#include <unistd.h>
 
 
 OSystem::MutexRef PthreadMutexManager::createMutex() {
@@ -67,4 +69,111 @@ void PthreadMutexManager::deleteMutex(OSystem::MutexRef mutex) {
 		delete m;
 }
 
+namespace {
+
+struct PthreadStart {
+	OSystem::ThreadProc proc;
+	void *param;
+};
+
+void *pthreadEntry(void *data) {
+	PthreadStart start = *(PthreadStart *)data;
+	delete (PthreadStart *)data;
+
+	start.proc(start.param);
+	return nullptr;
+}
+
+} // End of anonymous namespace
+
+OSystem::ThreadRef PthreadMutexManager::createThread(OSystem::ThreadProc proc, void *param) {
+	PthreadStart *start = new PthreadStart;
+	start->proc = proc;
+	start->param = param;
+
+	pthread_t *thread = new pthread_t;
+	if (pthread_create(thread, nullptr, pthreadEntry, start) != 0) {
+		warning("pthread_create() failed");
+		delete start;
+		delete thread;
+		return nullptr;
+	}
+
+	return (OSystem::ThreadRef)thread;
+}
+
+void PthreadMutexManager::joinThread(OSystem::ThreadRef thread) {
+	pthread_t *t = (pthread_t *)thread;
+
+	if (pthread_join(*t, nullptr) != 0)
+		warning("pthread_join() failed");
+	delete t;
+}
+
+uint PthreadMutexManager::getCpuCount() {
+#ifdef _SC_NPROCESSORS_ONLN
+	long count = sysconf(_SC_NPROCESSORS_ONLN);
+	if (count > 0)
+		return count;
+#endif
+	return 1;
+}
+
+namespace {
+
+// Unnamed POSIX semaphores are not available everywhere, e.g. on macOS
+struct PthreadSemaphore {
+	pthread_mutex_t mutex;
+	pthread_cond_t cond;
+	uint count;
+};
+
+} // End of anonymous namespace
+
+OSystem::SemaphoreRef PthreadMutexManager::createSemaphore() {
+	PthreadSemaphore *semaphore = new PthreadSemaphore;
+	semaphore->count = 0;
+
+	if (pthread_mutex_init(&semaphore->mutex, nullptr) != 0) {
+		warning("pthread_mutex_init() failed");
+		delete semaphore;
+		return nullptr;
+	}
+	if (pthread_cond_init(&semaphore->cond, nullptr) != 0) {
+		warning("pthread_cond_init() failed");
+		pthread_mutex_destroy(&semaphore->mutex);
+		delete semaphore;
+		return nullptr;
+	}
+
+	return (OSystem::SemaphoreRef)semaphore;
+}
+
+void PthreadMutexManager::postSemaphore(OSystem::SemaphoreRef semaphore) {
+	PthreadSemaphore *s = (PthreadSemaphore *)semaphore;
+
+	pthread_mutex_lock(&s->mutex);
+	s->count++;
+	pthread_cond_signal(&s->cond);
+	pthread_mutex_unlock(&s->mutex);
+}
+
+void PthreadMutexManager::waitSemaphore(OSystem::SemaphoreRef semaphore) {
+	PthreadSemaphore *s = (PthreadSemaphore *)semaphore;
+
+	pthread_mutex_lock(&s->mutex);
+	while (!s->count)
+		pthread_cond_wait(&s->cond, &s->mutex);
+	s->count--;
+	pthread_mutex_unlock(&s->mutex);
+}
+
+void PthreadMutexManager::deleteSemaphore(OSystem::SemaphoreRef semaphore) {
+	PthreadSemaphore *s = (PthreadSemaphore *)semaphore;
+
+	pthread_cond_destroy(&s->cond);
+	pthread_mutex_destroy(&s->mutex);
+	delete s;
+}
+
 #endif
@@ -34,6 +34,15 @@ public:
 	virtual void lockMutex(OSystem::MutexRef mutex);
 	virtual void unlockMutex(OSystem::MutexRef mutex);
 	virtual void deleteMutex(OSystem::MutexRef mutex);
+
+	virtual OSystem::ThreadRef createThread(OSystem::ThreadProc proc, void *param);
+	virtual void joinThread(OSystem::ThreadRef thread);
+	virtual uint getCpuCount();
+
+	virtual OSystem::SemaphoreRef createSemaphore();
+	virtual void postSemaphore(OSystem::SemaphoreRef semaphore);
+	virtual void waitSemaphore(OSystem::SemaphoreRef semaphore);
+	virtual void deleteSemaphore(OSystem::SemaphoreRef semaphore);
 };
 
 
@@ -49,14 +49,21 @@ typedef void (*sighandler_t)(int);
 
 #if defined(USE_NULL_DRIVER)
 #include "backends/modular-backend.h"
+#include "backends/mutex/null/null-mutex.h"
 #include "base/main.h"
 
+#if defined(NULL_DRIVER_USE_FOR_TEST)
+#include "backends/graphics/null/null-graphics.h"
+#if defined(POSIX)
+#include "backends/mutex/pthread/pthread-mutex.h"
+#endif
+#endif
+
 #ifndef NULL_DRIVER_USE_FOR_TEST
 #include "backends/saves/default/default-saves.h"
 #include "backends/timer/default/default-timer.h"
 #include "backends/events/default/default-events.h"
 #include "backends/mixer/null/null-mixer.h"
-#include "backends/mutex/null/null-mutex.h"
 #include "backends/graphics/null/null-graphics.h"
 #include "gui/debugger.h"
 #endif
@@ -83,6 +90,8 @@ public:
 
 	virtual void initBackend();
 
+	virtual bool hasFeature(Feature f);
+
 	virtual bool pollEvent(Common::Event &event);
 
 	virtual uint32 getMillis(bool skipRecord = false);
@@ -117,6 +126,17 @@ OSystem_NULL::OSystem_NULL() {
 	#else
 		#error Unknown and unsupported FS backend
 	#endif
+
+#ifdef NULL_DRIVER_USE_FOR_TEST
+	// Tests do not call initBackend(), but code under test may use mutexes,
+	// worker threads where the host has them, and query the screen format
+#ifdef POSIX
+	_mutexManager = new PthreadMutexManager();
+#else
+	_mutexManager = new NullMutexManager();
+#endif
+	_graphicsManager = new NullGraphicsManager();
+#endif
 }
 
 OSystem_NULL::~OSystem_NULL() {
@@ -158,6 +178,25 @@ void OSystem_NULL::initBackend() {
 	BaseBackend::initBackend();
 }
 
+bool OSystem_NULL::hasFeature(Feature f) {
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+	if (f == kFeatureCpuSSE2)
+		return __builtin_cpu_supports("sse2");
+	if (f == kFeatureCpuAVX2)
+		return __builtin_cpu_supports("avx2");
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+	if (f == kFeatureCpuNEON)
+		return true;
+#endif
+#ifdef NULL_DRIVER_USE_FOR_TEST
+	// There is no graphics manager to ask
+	return false;
+#else
+	return ModularGraphicsBackend::hasFeature(f);
+#endif
+}
+
 bool OSystem_NULL::pollEvent(Common::Event &event) {
 #ifndef NULL_DRIVER_USE_FOR_TEST
 	((DefaultTimerManager *)getTimerManager())->checkTimers();
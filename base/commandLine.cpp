@@ -326,6 +326,8 @@ void registerDefaults() {
 
 	ConfMan.registerDefault("gui_browser_show_hidden", false);
 	ConfMan.registerDefault("gui_browser_native", true);
+	ConfMan.registerDefault("directory_cache", false);
+	ConfMan.registerDefault("gui_theme_cache", false);
 	ConfMan.registerDefault("gui_return_to_launcher_at_exit", false);
 	// Specify threshold for scanning directories in the launcher
 	// If number of game entries in scummvm.ini exceeds the specified
@@ -49,6 +49,7 @@
 #endif
 #include "common/system.h"
 #include "common/textconsole.h"
+#include "common/threadpool.h"
 #include "common/tokenizer.h"
 #include "common/translation.h"
 #include "common/text-to-speech.h"
@@ -716,6 +717,7 @@ extern "C" int scummvm_main(int argc, const char * const argv[]) {
 #endif
 	EngineManager::destroy();
 	Graphics::YUVToRGBManager::destroy();
+	Common::ThreadPool::destroy();
 
 	return 0;
 }
@@ -21,7 +21,9 @@
  */
 
 #include "common/archive.h"
+#include "common/asyncio.h"
 #include "common/fs.h"
+#include "common/stream.h"
 #include "common/system.h"
 #include "common/textconsole.h"
 
@@ -60,6 +62,17 @@ int Archive::listMatchingMembers(ArchiveMemberList &list, const String &pattern)
 	return matches;
 }
 
+AsyncReadRequest *Archive::readMemberAsync(const String &name) const {
+	SeekableReadStream *stream = createReadStreamForMember(name);
+	if (!stream)
+		return nullptr;
+
+	// The request does not need the stream to stay around
+	AsyncReadRequest *request = stream->readAsync(0, stream->size());
+	delete stream;
+	return request;
+}
+
 
 
 SearchSet::ArchiveNodeList::iterator SearchSet::find(const String &name) {
@@ -265,6 +278,20 @@ SeekableReadStream *SearchSet::createReadStreamForMember(const String &name) con
 	return nullptr;
 }
 
+AsyncReadRequest *SearchSet::readMemberAsync(const String &name) const {
+	if (name.empty())
+		return nullptr;
+
+	ArchiveNodeList::const_iterator it = _list.begin();
+	for (; it != _list.end(); ++it) {
+		AsyncReadRequest *request = it->_arc->readMemberAsync(name);
+		if (request)
+			return request;
+	}
+
+	return nullptr;
+}
+
 
 SearchManager::SearchManager() {
 	clear(); // Force a reset
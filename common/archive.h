@@ -40,6 +40,7 @@ namespace Common {
  * @{
  */
 
+class AsyncReadRequest;
 class FSNode;
 class SeekableReadStream;
 
@@ -137,6 +138,18 @@ public:
 	 * @return The newly created input stream.
 	 */
 	virtual SeekableReadStream *createReadStreamForMember(const String &name) const = 0;
+
+	/**
+	 * Start reading the whole contents of a member with the specified name
+	 * in the background. If no member with this name exists, 0 is returned.
+	 *
+	 * The default implementation opens the member and uses
+	 * SeekableReadStream::readAsync, so it only reads in the background for
+	 * members which are stored as they are.
+	 *
+	 * @return The newly created read request.
+	 */
+	virtual AsyncReadRequest *readMemberAsync(const String &name) const;
 };
 
 
@@ -263,6 +276,8 @@ public:
 	 */
 	virtual SeekableReadStream *createReadStreamForMember(const String &name) const;
 
+	virtual AsyncReadRequest *readMemberAsync(const String &name) const;
+
 	/**
 	 * Ignore clashes when adding directories. For more details, see the corresponding parameter
 	 * in @ref FSDirectory documentation.
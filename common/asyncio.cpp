@@ -0,0 +1,235 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "common/asyncio.h"
+#include "common/list.h"
+#include "common/memstream.h"
+#include "common/singleton.h"
+#include "common/system.h"
+
+namespace Common {
+
+/**
+ * The I/O threads reading AsyncReadRequests. Threads are started when
+ * requests are queued, up to kMaxWorkers, and return once the queue is empty.
+ */
+class AsyncIOPool : public Singleton<AsyncIOPool> {
+public:
+	/** Queue a request, or run it right away if no thread can read it */
+	void queue(AsyncReadRequest *request);
+
+	/** Remove a request from the queue, if no thread picked it yet */
+	bool dequeue(AsyncReadRequest *request);
+
+private:
+	friend class Singleton<SingletonBaseType>;
+
+	enum {
+		// Reads mostly wait for the disk, more threads would not help it
+		kMaxWorkers = 4
+	};
+
+	struct Worker {
+		OSystem::ThreadRef thread;
+		bool finished;
+	};
+
+	AsyncIOPool();
+	~AsyncIOPool();
+
+	static void workerProc(void *param);
+	void work(Worker *worker);
+
+	Mutex _mutex;
+	List<AsyncReadRequest *> _queue;
+	Worker _workers[kMaxWorkers];
+	uint _activeWorkers;
+};
+
+AsyncIOPool::AsyncIOPool() : _activeWorkers(0) {
+	for (uint i = 0; i < kMaxWorkers; i++) {
+		_workers[i].thread = nullptr;
+		_workers[i].finished = false;
+	}
+}
+
+AsyncIOPool::~AsyncIOPool() {
+	// Requests wait for or cancel themselves, so only finished workers remain
+	for (uint i = 0; i < kMaxWorkers; i++) {
+		if (_workers[i].thread)
+			g_system->joinThread(_workers[i].thread);
+	}
+}
+
+void AsyncIOPool::queue(AsyncReadRequest *request) {
+	_mutex.lock();
+
+	// Release the workers which ran out of requests
+	Worker *freeWorker = nullptr;
+	for (uint i = 0; i < kMaxWorkers; i++) {
+		if (_workers[i].thread && _workers[i].finished) {
+			g_system->joinThread(_workers[i].thread);
+			_workers[i].thread = nullptr;
+		}
+		if (!_workers[i].thread)
+			freeWorker = &_workers[i];
+	}
+
+	request->_state.store(AsyncReadRequest::kStateQueued);
+	_queue.push_back(request);
+
+	if (freeWorker) {
+		freeWorker->finished = false;
+		freeWorker->thread = g_system->createThread(workerProc, freeWorker);
+		if (freeWorker->thread)
+			_activeWorkers++;
+	}
+
+	if (_activeWorkers) {
+		_mutex.unlock();
+		return;
+	}
+
+	// No threads
+	_queue.pop_back();
+	request->_state.store(AsyncReadRequest::kStateRunning);
+	_mutex.unlock();
+	request->run();
+}
+
+bool AsyncIOPool::dequeue(AsyncReadRequest *request) {
+	StackLock lock(_mutex);
+
+	if (request->_state.load() != AsyncReadRequest::kStateQueued)
+		return false;
+
+	for (List<AsyncReadRequest *>::iterator i = _queue.begin(); i != _queue.end(); ++i) {
+		if (*i == request) {
+			_queue.erase(i);
+			break;
+		}
+	}
+	request->_state.store(AsyncReadRequest::kStateCreated);
+	return true;
+}
+
+void AsyncIOPool::workerProc(void *param) {
+	instance().work((Worker *)param);
+}
+
+void AsyncIOPool::work(Worker *worker) {
+	for (;;) {
+		_mutex.lock();
+		if (_queue.empty()) {
+			worker->finished = true;
+			_activeWorkers--;
+			_mutex.unlock();
+			return;
+		}
+
+		// Lock the request before it leaves the queue, so that waiting for
+		// a request which is not queued any more blocks until it is read
+		AsyncReadRequest *request = _queue.front();
+		_queue.pop_front();
+		request->_mutex.lock();
+		request->_state.store(AsyncReadRequest::kStateRunning);
+		_mutex.unlock();
+
+		request->run();
+		request->_mutex.unlock();
+	}
+}
+
+DECLARE_SINGLETON(AsyncIOPool);
+
+AsyncReadRequest::AsyncReadRequest(uint32 size) : _state(kStateCreated), _size(size), _dataSize(0) {
+	_buffer = (byte *)malloc(MAX<uint32>(size, 1));
+}
+
+AsyncReadRequest::~AsyncReadRequest() {
+	cancel();
+	free(_buffer);
+}
+
+void AsyncReadRequest::start(bool background) {
+	assert(_state.load() == kStateCreated);
+
+	if (background) {
+		AsyncIOPool::instance().queue(this);
+	} else {
+		_state.store(kStateRunning);
+		run();
+	}
+}
+
+void AsyncReadRequest::run() {
+	_dataSize = _buffer ? readData(_buffer, _size) : 0;
+	_state.store(kStateDone);
+}
+
+void AsyncReadRequest::wait() {
+	if (isDone())
+		return;
+
+	if (AsyncIOPool::instance().dequeue(this)) {
+		_state.store(kStateRunning);
+		run();
+		return;
+	}
+
+	// An I/O thread holds the mutex until the data is read
+	StackLock lock(_mutex);
+}
+
+void AsyncReadRequest::cancel() {
+	if (_state.load() == kStateCreated || !AsyncIOPool::hasInstance())
+		return;
+
+	// Even once the request is done, an I/O thread may still hold the mutex
+	if (!AsyncIOPool::instance().dequeue(this))
+		StackLock lock(_mutex);
+}
+
+const byte *AsyncReadRequest::getData() {
+	wait();
+	return _buffer;
+}
+
+uint32 AsyncReadRequest::getDataSize() {
+	wait();
+	return _dataSize;
+}
+
+bool AsyncReadRequest::err() {
+	wait();
+	return _dataSize < _size;
+}
+
+SeekableReadStream *AsyncReadRequest::createReadStream() {
+	wait();
+
+	byte *data = _buffer;
+	_buffer = nullptr;
+	return new MemoryReadStream(data, data ? _dataSize : 0, DisposeAfterUse::YES);
+}
+
+} // End of namespace Common
@@ -0,0 +1,151 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef COMMON_ASYNCIO_H
+#define COMMON_ASYNCIO_H
+
+#include "common/scummsys.h"
+#include "common/atomic.h"
+#include "common/mutex.h"
+#include "common/noncopyable.h"
+
+namespace Common {
+
+/**
+ * @defgroup common_asyncio Asynchronous reads
+ * @ingroup common
+ *
+ * @brief Reading data in the background, while the engine goes on.
+ * @{
+ */
+
+class SeekableReadStream;
+
+/**
+ * A range of data being read in the background.
+ *
+ * Requests are returned by SeekableReadStream::readAsync() and
+ * Archive::readMemberAsync(). Streams which support it read on a small pool
+ * of I/O threads. Others, and all streams on backends without worker
+ * threads, read the data right away, so the request is complete as soon as
+ * it is returned.
+ *
+ * A request does not depend on the stream or archive it was made from,
+ * which may be deleted before the request completes. Deleting a request
+ * which has not started yet cancels it, deleting a request which is being
+ * read waits for it.
+ */
+class AsyncReadRequest : NonCopyable {
+public:
+	virtual ~AsyncReadRequest();
+
+	/**
+	 * Check whether the data has been read, without waiting.
+	 */
+	bool isDone() const { return _state.load() == kStateDone; }
+
+	/**
+	 * Wait for the data to be read. A request which has not been picked
+	 * by an I/O thread yet is read on the calling thread.
+	 */
+	void wait();
+
+	/**
+	 * Wait for the data to be read, and return it.
+	 *
+	 * @return The data, or nullptr if it has been handed to createReadStream().
+	 */
+	const byte *getData();
+
+	/**
+	 * Wait for the data to be read, and return how many bytes were read.
+	 */
+	uint32 getDataSize();
+
+	/**
+	 * Wait for the data to be read, and check whether less than the
+	 * requested size could be read.
+	 */
+	bool err();
+
+	/**
+	 * Wait for the data to be read, and hand it over to a memory stream.
+	 *
+	 * @return The stream, which the caller must delete.
+	 */
+	SeekableReadStream *createReadStream();
+
+	/**
+	 * Start reading. Implementations of readAsync() call this once the
+	 * request is set up.
+	 *
+	 * @param background  Whether to read on an I/O thread if possible, or
+	 *                    right away on the calling thread.
+	 */
+	void start(bool background = true);
+
+protected:
+	/**
+	 * Create a request for @p size bytes. The buffer is allocated here,
+	 * the data is read by readData() once start() is called.
+	 */
+	AsyncReadRequest(uint32 size);
+
+	/**
+	 * Read the data. Called on an I/O thread, unless the request was
+	 * started on the calling thread.
+	 *
+	 * @return The number of bytes read.
+	 */
+	virtual uint32 readData(byte *buffer, uint32 size) = 0;
+
+	/**
+	 * Cancel the request if it has not started yet, or wait for it to
+	 * complete. Subclasses whose readData() uses their own members must
+	 * call this first in their destructor.
+	 */
+	void cancel();
+
+private:
+	friend class AsyncIOPool;
+
+	enum State {
+		kStateCreated,
+		kStateQueued,
+		kStateRunning,
+		kStateDone
+	};
+
+	void run();
+
+	Atomic<int32> _state;
+	Mutex _mutex;   ///< Held while the request is read on an I/O thread
+	byte *_buffer;
+	uint32 _size;
+	uint32 _dataSize;
+};
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
@@ -0,0 +1,185 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef COMMON_ATOMIC_H
+#define COMMON_ATOMIC_H
+
+#include "common/scummsys.h"
+#include "common/noncopyable.h"
+
+#if defined(__clang__) || (defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 7)))
+#define SCUMMVM_HAS_ATOMICS
+#define SCUMMVM_ATOMICS_GCC
+#elif defined(_MSC_VER)
+#define SCUMMVM_HAS_ATOMICS
+#define SCUMMVM_ATOMICS_MSVC
+#include <intrin.h>
+#endif
+
+namespace Common {
+
+#if defined(SCUMMVM_ATOMICS_MSVC)
+namespace AtomicMSVC {
+
+/**
+ * Orders the accesses before and after it. x86 and x64 CPUs do not move
+ * loads after later accesses or stores before earlier ones, so only the
+ * compiler has to be kept from doing so. ARM CPUs need a real barrier.
+ */
+inline void fence() {
+#if defined(_M_ARM64)
+	__dmb(_ARM64_BARRIER_ISH);
+#elif defined(_M_ARM)
+	__dmb(_ARM_BARRIER_ISH);
+#else
+	_ReadWriteBarrier();
+#endif
+}
+
+template<typename T, size_t Size>
+struct IntegerCompareExchange;
+
+template<typename T>
+struct IntegerCompareExchange<T, 4> {
+	static T apply(volatile T *value, T expected, T desired) {
+		return (T)_InterlockedCompareExchange((volatile long *)value, (long)desired, (long)expected);
+	}
+};
+
+template<typename T>
+struct IntegerCompareExchange<T, 8> {
+	static T apply(volatile T *value, T expected, T desired) {
+		return (T)_InterlockedCompareExchange64((volatile __int64 *)value, (__int64)desired, (__int64)expected);
+	}
+};
+
+/** The interlocked functions are full barriers, on ARM too */
+template<typename T>
+struct CompareExchange : IntegerCompareExchange<T, sizeof(T)> {};
+
+template<typename T>
+struct CompareExchange<T *> {
+	static T *apply(T *volatile *value, T *expected, T *desired) {
+		return (T *)_InterlockedCompareExchangePointer((void *volatile *)value, (void *)desired, (void *)expected);
+	}
+};
+
+} // End of namespace AtomicMSVC
+#endif
+
+/**
+ * @defgroup common_atomic Atomic operations
+ * @ingroup common
+ *
+ * @brief Minimal wrapper around the compiler's atomic primitives.
+ * @{
+ */
+
+/**
+ * A value of integral or pointer type that can be shared between threads
+ * without taking a mutex.
+ *
+ * load() has acquire semantics, store() has release semantics and all
+ * read-modify-write operations are sequentially consistent. Only types
+ * of 4 or 8 bytes are supported. The constructors are constexpr, so that
+ * a static Atomic is set up before any code runs.
+ *
+ * On compilers without atomic builtins (SCUMMVM_HAS_ATOMICS undefined)
+ * this falls back to plain volatile accesses, which is only adequate for
+ * the single-core targets using such compilers.
+ */
+template<typename T>
+class Atomic : NonCopyable {
+public:
+	constexpr Atomic() : _value(T()) {}
+	explicit constexpr Atomic(T value) : _value(value) {}
+
+#if defined(SCUMMVM_ATOMICS_GCC)
+	T load() const { return __atomic_load_n(&_value, __ATOMIC_ACQUIRE); }
+	T loadRelaxed() const { return __atomic_load_n(&_value, __ATOMIC_RELAXED); }
+	void store(T value) { __atomic_store_n(&_value, value, __ATOMIC_RELEASE); }
+	void storeRelaxed(T value) { __atomic_store_n(&_value, value, __ATOMIC_RELAXED); }
+	T exchange(T value) { return __atomic_exchange_n(&_value, value, __ATOMIC_SEQ_CST); }
+	T fetchAdd(T delta) { return __atomic_fetch_add(&_value, delta, __ATOMIC_SEQ_CST); }
+	T fetchSub(T delta) { return __atomic_fetch_sub(&_value, delta, __ATOMIC_SEQ_CST); }
+
+	/**
+	 * Replace the value with @p desired if it equals @p expected.
+	 * On failure @p expected is updated with the current value.
+	 */
+	bool compareExchange(T &expected, T desired) {
+		return __atomic_compare_exchange_n(&_value, &expected, desired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+	}
+#elif defined(SCUMMVM_ATOMICS_MSVC)
+	T load() const { T value = _value; AtomicMSVC::fence(); return value; }
+	T loadRelaxed() const { return _value; }
+	void store(T value) { AtomicMSVC::fence(); _value = value; }
+	void storeRelaxed(T value) { _value = value; }
+	T exchange(T value) {
+		T expected = _value;
+		while (!compareExchange(expected, value)) {}
+		return expected;
+	}
+	T fetchAdd(T delta) {
+		T expected = _value;
+		while (!compareExchange(expected, (T)(expected + delta))) {}
+		return expected;
+	}
+	T fetchSub(T delta) {
+		T expected = _value;
+		while (!compareExchange(expected, (T)(expected - delta))) {}
+		return expected;
+	}
+	bool compareExchange(T &expected, T desired) {
+		const T previous = AtomicMSVC::CompareExchange<T>::apply(&_value, expected, desired);
+		if (previous == expected)
+			return true;
+		expected = previous;
+		return false;
+	}
+#else
+	T load() const { return _value; }
+	T loadRelaxed() const { return _value; }
+	void store(T value) { _value = value; }
+	void storeRelaxed(T value) { _value = value; }
+	T exchange(T value) { T old = _value; _value = value; return old; }
+	T fetchAdd(T delta) { T old = _value; _value = old + delta; return old; }
+	T fetchSub(T delta) { T old = _value; _value = old - delta; return old; }
+	bool compareExchange(T &expected, T desired) {
+		if (_value != expected) {
+			expected = _value;
+			return false;
+		}
+		_value = desired;
+		return true;
+	}
+#endif
+
+private:
+	volatile T _value;
+};
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
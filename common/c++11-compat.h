@@ -48,4 +48,13 @@
 #define final
 #endif
 
+//
+// Replacement for the constexpr keyword. Objects with a constexpr constructor
+// are then no longer guaranteed to be initialized before any code runs.
+//
+// MSVC 2015 and newer support constexpr.
+#if !defined(_MSC_VER) || _MSC_VER < 1900
+#define constexpr
+#endif
+
 #endif
@@ -143,6 +143,16 @@ uint32 File::read(void *ptr, uint32 len) {
 	return _handle->read(ptr, len);
 }
 
+const byte *File::mapRange(int64 offset, uint32 size) {
+	assert(_handle);
+	return _handle->mapRange(offset, size);
+}
+
+AsyncReadRequest *File::readAsync(int64 offset, uint32 size) {
+	assert(_handle);
+	return _handle->readAsync(offset, size);
+}
+
 
 DumpFile::DumpFile() : _handle(nullptr) {
 }
@@ -134,6 +134,8 @@ public:
 	int64 size() const override; /*!< Implement abstract SeekableReadStream method. */
 	bool seek(int64 offs, int whence = SEEK_SET) override;	/*!< Implement abstract SeekableReadStream method. */
 	uint32 read(void *dataPtr, uint32 dataSize) override;	/*!< Implement abstract SeekableReadStream method. */
+	const byte *mapRange(int64 offset, uint32 size) override;	/*!< Implement SeekableReadStream method. */
+	AsyncReadRequest *readAsync(int64 offset, uint32 size) override;	/*!< Implement SeekableReadStream method. */
 };
 
 
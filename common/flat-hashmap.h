@@ -0,0 +1,644 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+// The hash map implementation in this file follows the design of the
+// SwissTable maps of Abseil, using plain integer operations instead of
+// SIMD instructions to look at a group of control bytes at once.
+
+#ifndef COMMON_FLAT_HASHMAP_H
+#define COMMON_FLAT_HASHMAP_H
+
+#include "common/endian.h"
+#include "common/hashmap.h"
+
+namespace Common {
+
+/**
+ * @defgroup common_flat_hashmap Flat hash table (FlatHashMap)
+ * @ingroup common
+ *
+ * @brief API for operations on a hash table storing its entries inline.
+ *
+ * @{
+ */
+
+/**
+ * FlatHashMap<Key,Val> maps objects of type Key to objects of type Val, with
+ * the same interface as HashMap.
+ *
+ * Where HashMap stores pointers to separately allocated nodes, FlatHashMap
+ * stores the nodes themselves in one array, along with one control byte per
+ * node holding 7 bits of its hash. Lookups compare 8 control bytes at a time
+ * and only look at the nodes whose hash bits match, so they usually touch a
+ * single node. This makes lookups faster, in particular for small keys and
+ * values.
+ *
+ * Unlike with HashMap, nodes move when the map grows, so pointers and
+ * references to values are only valid until the next key is added.
+ * Iterators stay valid when other entries are erased, as with HashMap.
+ */
+template<class Key, class Val, class HashFunc = Hash<Key>, class EqualFunc = EqualTo<Key> >
+class FlatHashMap {
+public:
+	typedef uint size_type;
+
+private:
+
+	typedef FlatHashMap<Key, Val, HashFunc, EqualFunc> HM_t;
+
+	struct Node {
+		Val _value;
+		const Key _key;
+		explicit Node(const Key &key) : _value(), _key(key) {}
+		Node(const Node &node) : _value(node._value), _key(node._key) {}
+	};
+
+	enum {
+		FLATHASHMAP_GROUP_SIZE = 8,
+		FLATHASHMAP_MIN_CAPACITY = 16,
+
+		// The quotient of the next two constants controls how much the
+		// internal storage of the hashmap may fill up, including erased
+		// entries, before being increased automatically.
+		FLATHASHMAP_LOADFACTOR_NUMERATOR = 7,
+		FLATHASHMAP_LOADFACTOR_DENOMINATOR = 8
+	};
+
+	/**
+	 * Control bytes. Used nodes have the top 7 bits of the hash, with the
+	 * high bit clear.
+	 */
+	enum {
+		kCtrlEmpty = 0x80,
+		kCtrlDeleted = 0xFE
+	};
+
+	/** Default value, returned by the const getVal. */
+	Val _defaultVal;
+
+	Node *_storage;     ///< Nodes, followed by the control bytes; nullptr until a key is added.
+	byte *_ctrl;        ///< Control bytes, one per node.
+	size_type _mask;    ///< Capacity of the FlatHashMap minus one; must be a power of two minus one
+	size_type _size;
+	size_type _deleted; ///< Number of erased nodes, which are still probed past
+
+	HashFunc _hash;
+	EqualFunc _equal;
+
+	static uint32 mixHash(uint32 hash) {
+		// Every bit of the hash affects both the group, taken from the low
+		// bits, and the control byte, taken from the high ones. A mere
+		// multiplication would leave the low bits of hashes which only
+		// differ in their high bits, like those of shifted integers, equal.
+		// This is the finalizer of MurmurHash3.
+		hash ^= hash >> 16;
+		hash *= 0x85EBCA6B;
+		hash ^= hash >> 13;
+		hash *= 0xC2B2AE35;
+		hash ^= hash >> 16;
+		return hash;
+	}
+
+	static uint64 groupBytes(byte b) {
+		return 0x0101010101010101ULL * b;
+	}
+
+	/** The high bits of the group bytes for which @p ctrl matches the hash bits @p h2. */
+	static uint64 matchHash(uint64 ctrl, byte h2) {
+		// May also match bytes following a match, which are checked anyway
+		const uint64 x = ctrl ^ groupBytes(h2);
+		return (x - groupBytes(0x01)) & ~x & groupBytes(0x80);
+	}
+
+	static uint64 matchEmpty(uint64 ctrl) {
+		return ctrl & ~(ctrl << 6) & groupBytes(0x80);
+	}
+
+	static uint64 matchEmptyOrDeleted(uint64 ctrl) {
+		return ctrl & groupBytes(0x80);
+	}
+
+	/** The index of the group byte with the lowest match in @p match. */
+	static uint lowestMatch(uint64 match) {
+#if defined(__GNUC__)
+		return __builtin_ctzll(match) >> 3;
+#else
+		uint index = 0;
+		while (!(match & 0x80)) {
+			match >>= 8;
+			index++;
+		}
+		return index;
+#endif
+	}
+
+	uint64 loadGroup(size_type group) const {
+		return READ_LE_UINT64(_ctrl + group * FLATHASHMAP_GROUP_SIZE);
+	}
+
+	void assign(const HM_t &map);
+	void allocStorage(size_type capacity);
+	void freeStorage();
+	size_type lookup(const Key &key, uint32 hash) const;
+	size_type lookup(const Key &key) const;
+	size_type findFreeNode(uint32 hash) const;
+	size_type lookupAndCreateIfMissing(const Key &key);
+	void expandStorage(size_type newCapacity);
+	void eraseNode(size_type ctr);
+
+	template<class T> friend class IteratorImpl;
+
+	/**
+	 * Simple FlatHashMap iterator implementation.
+	 */
+	template<class NodeType>
+	class IteratorImpl {
+		friend class FlatHashMap;
+		template<class T> friend class IteratorImpl;
+	protected:
+		typedef const FlatHashMap hashmap_t;
+
+		size_type _idx;
+		hashmap_t *_hashmap;
+
+	protected:
+		IteratorImpl(size_type idx, hashmap_t *hashmap) : _idx(idx), _hashmap(hashmap) {}
+
+		NodeType *deref() const {
+			assert(_hashmap != nullptr);
+			assert(_idx <= _hashmap->_mask);
+			assert(!(_hashmap->_ctrl[_idx] & 0x80));
+			return &_hashmap->_storage[_idx];
+		}
+
+	public:
+		IteratorImpl() : _idx(0), _hashmap(nullptr) {}
+		template<class T>
+		IteratorImpl(const IteratorImpl<T> &c) : _idx(c._idx), _hashmap(c._hashmap) {}
+
+		NodeType &operator*() const { return *deref(); }
+		NodeType *operator->() const { return deref(); }
+
+		bool operator==(const IteratorImpl &iter) const { return _idx == iter._idx && _hashmap == iter._hashmap; }
+		bool operator!=(const IteratorImpl &iter) const { return !(*this == iter); }
+
+		IteratorImpl &operator++() {
+			assert(_hashmap);
+			_idx = _hashmap->nextUsed(_idx + 1);
+			return *this;
+		}
+
+		IteratorImpl operator++(int) {
+			IteratorImpl old = *this;
+			operator ++();
+			return old;
+		}
+	};
+
+	/** Find the first used node from @p ctr on, or return -1 if there is none. */
+	size_type nextUsed(size_type ctr) const {
+		if (_storage) {
+			for (; ctr <= _mask; ++ctr) {
+				if (!(_ctrl[ctr] & 0x80))
+					return ctr;
+			}
+		}
+		return (size_type)-1;
+	}
+
+public:
+	typedef IteratorImpl<Node> iterator;
+	typedef IteratorImpl<const Node> const_iterator;
+
+	FlatHashMap();
+	FlatHashMap(const HM_t &map);
+	~FlatHashMap();
+
+	HM_t &operator=(const HM_t &map) {
+		if (this == &map)
+			return *this;
+
+		// Remove the previous content and ...
+		clear();
+		freeStorage();
+		// ... copy the new stuff.
+		assign(map);
+		return *this;
+	}
+
+	bool contains(const Key &key) const;
+
+	Val &operator[](const Key &key);
+	const Val &operator[](const Key &key) const;
+
+	Val &getOrCreateVal(const Key &key);
+	Val &getVal(const Key &key);
+	const Val &getVal(const Key &key) const;
+	const Val &getValOrDefault(const Key &key) const;
+	const Val &getValOrDefault(const Key &key, const Val &defaultVal) const;
+	bool tryGetVal(const Key &key, Val &out) const;
+	void setVal(const Key &key, const Val &val);
+
+	void clear(bool shrinkArray = 0);
+
+	void erase(iterator entry);
+	void erase(const Key &key);
+
+	size_type size() const { return _size; }
+
+	iterator	begin() {
+		return iterator(nextUsed(0), this);
+	}
+	iterator	end() {
+		return iterator((size_type)-1, this);
+	}
+
+	const_iterator	begin() const {
+		return const_iterator(nextUsed(0), this);
+	}
+	const_iterator	end() const {
+		return const_iterator((size_type)-1, this);
+	}
+
+	iterator	find(const Key &key) {
+		return iterator(lookup(key), this);
+	}
+
+	const_iterator	find(const Key &key) const {
+		return const_iterator(lookup(key), this);
+	}
+
+	/** Return true if hashmap is empty. */
+	bool empty() const {
+		return (_size == 0);
+	}
+};
+
+//-------------------------------------------------------
+// FlatHashMap functions
+
+/**
+ * Base constructor, creates an empty hashmap. No memory is allocated
+ * until a key is added.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+FlatHashMap<Key, Val, HashFunc, EqualFunc>::FlatHashMap() : _defaultVal(), _storage(nullptr), _ctrl(nullptr),
+	_mask(FLATHASHMAP_MIN_CAPACITY - 1), _size(0), _deleted(0) {
+}
+
+/**
+ * Copy constructor, creates a full copy of the given hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+FlatHashMap<Key, Val, HashFunc, EqualFunc>::FlatHashMap(const HM_t &map) :
+	_defaultVal(), _storage(nullptr), _ctrl(nullptr) {
+	assign(map);
+}
+
+/**
+ * Destructor, frees all used memory.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+FlatHashMap<Key, Val, HashFunc, EqualFunc>::~FlatHashMap() {
+	clear();
+	freeStorage();
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::allocStorage(size_type capacity) {
+	// One allocation for both, the control bytes only need byte alignment
+	_mask = capacity - 1;
+	_storage = (Node *)malloc(capacity * (sizeof(Node) + 1));
+	assert(_storage != nullptr);
+	_ctrl = (byte *)(_storage + capacity);
+	memset(_ctrl, kCtrlEmpty, capacity);
+}
+
+/**
+ * Internal method for freeing the storage of the hashmap.
+ *
+ * @note The nodes are *not* destroyed here -- the caller is responsible for
+ *       doing that!
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::freeStorage() {
+	free(_storage);
+	_storage = nullptr;
+	_ctrl = nullptr;
+	_mask = FLATHASHMAP_MIN_CAPACITY - 1;
+}
+
+/**
+ * Internal method for assigning the content of another FlatHashMap
+ * to this one.
+ *
+ * @note The previous storage here is *not* deallocated here -- the caller is
+ *       responsible for doing that!
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::assign(const HM_t &map) {
+	_mask = map._mask;
+	_size = map._size;
+	_deleted = map._deleted;
+	if (!map._storage)
+		return;
+
+	// Simply clone the map given to us, keeping the nodes in place
+	allocStorage(_mask + 1);
+	memcpy(_ctrl, map._ctrl, _mask + 1);
+	for (size_type ctr = 0; ctr <= _mask; ++ctr) {
+		if (!(_ctrl[ctr] & 0x80))
+			new ((void *)&_storage[ctr]) Node(map._storage[ctr]);
+	}
+}
+
+/**
+ * Clear all values in the hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::clear(bool shrinkArray) {
+	if (!_storage)
+		return;
+
+	for (size_type ctr = 0; ctr <= _mask; ++ctr) {
+		if (!(_ctrl[ctr] & 0x80))
+			_storage[ctr].~Node();
+	}
+
+	if (shrinkArray)
+		freeStorage();
+	else
+		memset(_ctrl, kCtrlEmpty, _mask + 1);
+
+	_size = 0;
+	_deleted = 0;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::expandStorage(size_type newCapacity) {
+	const size_type old_mask = _mask;
+	Node *old_storage = _storage;
+	byte *old_ctrl = _ctrl;
+
+	allocStorage(newCapacity);
+	_deleted = 0;
+
+	if (!old_storage)
+		return;
+
+	// Move all the old nodes. Since we know that no key exists twice in the
+	// old table, we only need to look for a free node for each of them.
+	for (size_type ctr = 0; ctr <= old_mask; ++ctr) {
+		if (old_ctrl[ctr] & 0x80)
+			continue;
+
+		const uint32 hash = mixHash(_hash(old_storage[ctr]._key));
+		const size_type idx = findFreeNode(hash);
+		_ctrl[idx] = hash >> 25;
+		new ((void *)&_storage[idx]) Node(old_storage[ctr]);
+		old_storage[ctr].~Node();
+	}
+
+	free(old_storage);
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+typename FlatHashMap<Key, Val, HashFunc, EqualFunc>::size_type FlatHashMap<Key, Val, HashFunc, EqualFunc>::lookup(const Key &key, uint32 hash) const {
+	if (!_storage)
+		return (size_type)-1;
+
+	// Probe the groups in triangular steps, which visits each of them once
+	// since there is a power of two of them
+	const size_type groupMask = _mask / FLATHASHMAP_GROUP_SIZE;
+	const byte h2 = hash >> 25;
+	size_type group = hash & groupMask;
+	for (size_type step = 1; ; step++) {
+		const uint64 ctrl = loadGroup(group);
+		for (uint64 match = matchHash(ctrl, h2); match; match &= match - 1) {
+			const size_type ctr = group * FLATHASHMAP_GROUP_SIZE + lowestMatch(match);
+			if (_equal(_storage[ctr]._key, key))
+				return ctr;
+		}
+
+		// A key is never stored past a group which had an empty node
+		if (matchEmpty(ctrl))
+			return (size_type)-1;
+
+		group = (group + step) & groupMask;
+	}
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+typename FlatHashMap<Key, Val, HashFunc, EqualFunc>::size_type FlatHashMap<Key, Val, HashFunc, EqualFunc>::lookup(const Key &key) const {
+	return lookup(key, mixHash(_hash(key)));
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+typename FlatHashMap<Key, Val, HashFunc, EqualFunc>::size_type FlatHashMap<Key, Val, HashFunc, EqualFunc>::findFreeNode(uint32 hash) const {
+	const size_type groupMask = _mask / FLATHASHMAP_GROUP_SIZE;
+	size_type group = hash & groupMask;
+	for (size_type step = 1; ; step++) {
+		const uint64 match = matchEmptyOrDeleted(loadGroup(group));
+		if (match)
+			return group * FLATHASHMAP_GROUP_SIZE + lowestMatch(match);
+
+		group = (group + step) & groupMask;
+	}
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+typename FlatHashMap<Key, Val, HashFunc, EqualFunc>::size_type FlatHashMap<Key, Val, HashFunc, EqualFunc>::lookupAndCreateIfMissing(const Key &key) {
+	const uint32 hash = mixHash(_hash(key));
+	size_type ctr = lookup(key, hash);
+	if (ctr != (size_type)-1)
+		return ctr;
+
+	// Keep the load factor below a certain threshold.
+	// Erased nodes are also counted
+	size_type capacity = _mask + 1;
+	if (!_storage) {
+		expandStorage(capacity);
+	} else if ((_size + _deleted + 1) * FLATHASHMAP_LOADFACTOR_DENOMINATOR >
+	           capacity * FLATHASHMAP_LOADFACTOR_NUMERATOR) {
+		// Only get rid of the erased nodes if there are many of them
+		if (_size * 2 * FLATHASHMAP_LOADFACTOR_DENOMINATOR >= capacity * FLATHASHMAP_LOADFACTOR_NUMERATOR)
+			capacity *= 2;
+		expandStorage(capacity);
+	}
+
+	ctr = findFreeNode(hash);
+	if (_ctrl[ctr] == kCtrlDeleted)
+		_deleted--;
+	_ctrl[ctr] = hash >> 25;
+	new ((void *)&_storage[ctr]) Node(key);
+	_size++;
+
+	return ctr;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::eraseNode(size_type ctr) {
+	_storage[ctr].~Node();
+	_size--;
+
+	// Lookups stop at a group with an empty node, so if there is one, no
+	// key can be stored past this group and the node can become empty too
+	const size_type group = ctr / FLATHASHMAP_GROUP_SIZE;
+	if (matchEmpty(loadGroup(group))) {
+		_ctrl[ctr] = kCtrlEmpty;
+	} else {
+		_ctrl[ctr] = kCtrlDeleted;
+		_deleted++;
+	}
+}
+
+/**
+ * Check whether the hashmap contains the given key.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+bool FlatHashMap<Key, Val, HashFunc, EqualFunc>::contains(const Key &key) const {
+	return lookup(key) != (size_type)-1;
+}
+
+/**
+ * Get a value from the hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::operator[](const Key &key) {
+	return getOrCreateVal(key);
+}
+
+/**
+ * @overload
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::operator[](const Key &key) const {
+	return getVal(key);
+}
+
+/**
+ * Get a value from the hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getOrCreateVal(const Key &key) {
+	// Adding the key may move the storage
+	size_type ctr = lookupAndCreateIfMissing(key);
+	return _storage[ctr]._value;
+}
+
+/**
+ * @overload
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getVal(const Key &key) {
+	size_type ctr = lookup(key);
+	if (ctr != (size_type)-1)
+		return _storage[ctr]._value;
+	else
+		// See comment in HashMap::getVal().
+#ifdef RELEASE_BUILD
+		return _defaultVal;
+#else
+		unknownKeyError(key);
+#endif
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getVal(const Key &key) const {
+	size_type ctr = lookup(key);
+	if (ctr != (size_type)-1)
+		return _storage[ctr]._value;
+	else
+		// See comment in HashMap::getVal().
+#ifdef RELEASE_BUILD
+		return _defaultVal;
+#else
+		unknownKeyError(key);
+#endif
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getValOrDefault(const Key &key) const {
+	return getValOrDefault(key, _defaultVal);
+}
+
+/**
+ * Get a value from the hashmap. If the key is not present, then return @p defaultVal.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getValOrDefault(const Key &key, const Val &defaultVal) const {
+	size_type ctr = lookup(key);
+	if (ctr != (size_type)-1)
+		return _storage[ctr]._value;
+	else
+		return defaultVal;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+bool FlatHashMap<Key, Val, HashFunc, EqualFunc>::tryGetVal(const Key &key, Val &out) const {
+	size_type ctr = lookup(key);
+	if (ctr != (size_type)-1) {
+		out = _storage[ctr]._value;
+		return true;
+	} else {
+		return false;
+	}
+}
+
+/**
+ * Assign an element specified by @p key to a value @p val.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::setVal(const Key &key, const Val &val) {
+	size_type ctr = lookupAndCreateIfMissing(key);
+	_storage[ctr]._value = val;
+}
+
+/**
+ * Erase an element referred to by an iterator.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::erase(iterator entry) {
+	// Check whether we have a valid iterator
+	assert(entry._hashmap == this);
+	const size_type ctr = entry._idx;
+	assert(ctr <= _mask);
+	assert(!(_ctrl[ctr] & 0x80));
+
+	eraseNode(ctr);
+}
+
+/**
+ * Erase an element specified by a key.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::erase(const Key &key) {
+	size_type ctr = lookup(key);
+	if (ctr != (size_type)-1)
+		eraseNode(ctr);
+}
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
@@ -20,6 +20,7 @@
  *
  */
 
+#include "common/stream.h"
 #include "common/system.h"
 #include "common/textconsole.h"
 #include "backends/fs/abstract-fs.h"
@@ -69,6 +70,13 @@ FSNode FSNode::getChild(const String &n) const {
 	return FSNode(node);
 }
 
+FSNode FSNode::getChildWithKnownType(const String &n, bool isDirectory) const {
+	if (_realNode == nullptr || !_realNode->isDirectory())
+		return FSNode();
+
+	return FSNode(_realNode->getChildWithKnownType(n, isDirectory));
+}
+
 bool FSNode::getChildren(FSList &fslist, ListMode mode, bool hidden) const {
 	if (!_realNode || !_realNode->isDirectory())
 		return false;
@@ -125,6 +133,10 @@ bool FSNode::isWritable() const {
 	return _realNode && _realNode->isWritable();
 }
 
+int64 FSNode::getModificationTime() const {
+	return _realNode ? _realNode->getModificationTime() : -1;
+}
+
 SeekableReadStream *FSNode::createReadStream() const {
 	if (_realNode == nullptr)
 		return nullptr;
@@ -140,6 +152,21 @@ SeekableReadStream *FSNode::createReadStream() const {
 	return _realNode->createReadStream();
 }
 
+SeekableReadStream *FSNode::createGameDataReadStream() const {
+	if (_realNode == nullptr)
+		return nullptr;
+
+	if (!_realNode->exists()) {
+		warning("FSNode::createGameDataReadStream: '%s' does not exist", getName().c_str());
+		return nullptr;
+	} else if (_realNode->isDirectory()) {
+		warning("FSNode::createGameDataReadStream: '%s' is a directory", getName().c_str());
+		return nullptr;
+	}
+
+	return _realNode->createGameDataReadStream();
+}
+
 WriteStream *FSNode::createWriteStream() const {
 	if (_realNode == nullptr)
 		return nullptr;
@@ -169,26 +196,26 @@ bool FSNode::createDirectory() const {
 }
 
 FSDirectory::FSDirectory(const FSNode &node, int depth, bool flat, bool ignoreClashes, bool includeDirectories)
-  : _node(node), _cached(false), _depth(depth), _flat(flat), _ignoreClashes(ignoreClashes),
+  : _node(node), _cached(false), _keepListings(false), _listingsChanged(false), _depth(depth), _flat(flat), _ignoreClashes(ignoreClashes),
 	_includeDirectories(includeDirectories) {
 }
 
 FSDirectory::FSDirectory(const String &prefix, const FSNode &node, int depth, bool flat,
 						 bool ignoreClashes, bool includeDirectories)
-  : _node(node), _cached(false), _depth(depth), _flat(flat), _ignoreClashes(ignoreClashes),
+  : _node(node), _cached(false), _keepListings(false), _listingsChanged(false), _depth(depth), _flat(flat), _ignoreClashes(ignoreClashes),
 	_includeDirectories(includeDirectories) {
 
 	setPrefix(prefix);
 }
 
 FSDirectory::FSDirectory(const String &name, int depth, bool flat, bool ignoreClashes, bool includeDirectories)
-  : _node(name), _cached(false), _depth(depth), _flat(flat), _ignoreClashes(ignoreClashes),
+  : _node(name), _cached(false), _keepListings(false), _listingsChanged(false), _depth(depth), _flat(flat), _ignoreClashes(ignoreClashes),
 	_includeDirectories(includeDirectories) {
 }
 
 FSDirectory::FSDirectory(const String &prefix, const String &name, int depth, bool flat,
 						 bool ignoreClashes, bool includeDirectories)
-  : _node(name), _cached(false), _depth(depth), _flat(flat), _ignoreClashes(ignoreClashes),
+  : _node(name), _cached(false), _keepListings(false), _listingsChanged(false), _depth(depth), _flat(flat), _ignoreClashes(ignoreClashes),
 	_includeDirectories(includeDirectories) {
 
 	setPrefix(prefix);
@@ -208,18 +235,61 @@ FSNode FSDirectory::getFSNode() const {
 	return _node;
 }
 
+FSNode *FSDirectory::NodeCache::find(const String &name) {
+	// A name which was never interned is only in the other names
+	InternedString key;
+	if (InternedString::findIgnoreCase(name, key)) {
+		HashMap<InternedString, FSNode>::iterator it = interned.find(key);
+		if (it != interned.end())
+			return &it->_value;
+	}
+
+	if (!others.empty()) {
+		HashMap<String, FSNode, IgnoreCase_Hash, IgnoreCase_EqualTo>::iterator it = others.find(name);
+		if (it != others.end())
+			return &it->_value;
+	}
+
+	return nullptr;
+}
+
+void FSDirectory::NodeCache::setVal(const String &lowercaseName, const FSNode &node) {
+	// Replacing a name keeps it where it is
+	InternedString key;
+	if (!others.contains(lowercaseName) && InternedString::intern(lowercaseName, key))
+		interned.setVal(key, node);
+	else
+		others.setVal(lowercaseName, node);
+}
+
 FSNode *FSDirectory::lookupCache(NodeCache &cache, const String &name) const {
 	// make caching as lazy as possible
 	if (!name.empty()) {
 		ensureCached();
-
-		if (cache.contains(name))
-			return &cache[name];
+		return cache.find(name);
 	}
 
 	return nullptr;
 }
 
+int FSDirectory::listCache(const NodeCache &cache, ArchiveMemberList &list, const String *lowercasePattern) const {
+	int matches = 0;
+	for (HashMap<InternedString, FSNode>::const_iterator it = cache.interned.begin(); it != cache.interned.end(); ++it) {
+		if (!lowercasePattern || matchString(it->_key.c_str(), lowercasePattern->c_str(), false, true)) {
+			list.push_back(ArchiveMemberPtr(new FSNode(it->_value)));
+			matches++;
+		}
+	}
+	for (HashMap<String, FSNode, IgnoreCase_Hash, IgnoreCase_EqualTo>::const_iterator it = cache.others.begin(); it != cache.others.end(); ++it) {
+		if (!lowercasePattern || it->_key.matchString(*lowercasePattern, false, true)) {
+			list.push_back(ArchiveMemberPtr(new FSNode(it->_value)));
+			matches++;
+		}
+	}
+
+	return matches;
+}
+
 bool FSDirectory::hasFile(const String &name) const {
 	if (name.empty() || !_node.isDirectory())
 		return false;
@@ -252,7 +322,8 @@ SeekableReadStream *FSDirectory::createReadStreamForMember(const String &name) c
 	FSNode *node = lookupCache(_fileCache, name);
 	if (!node)
 		return nullptr;
-	SeekableReadStream *stream = node->createReadStream();
+	// Game directories are not written to while they are used
+	SeekableReadStream *stream = node->createGameDataReadStream();
 	if (!stream)
 		warning("FSDirectory::createReadStreamForMember: Can't create stream for file '%s'", name.c_str());
 
@@ -280,7 +351,7 @@ void FSDirectory::cacheDirectoryRecursive(FSNode node, int depth, const String&
 		return;
 
 	FSList list;
-	node.getChildren(list, FSNode::kListAll);
+	listDirectory(node, list);
 
 	FSList::iterator it = list.begin();
 	for ( ; it != list.end(); ++it) {
@@ -292,40 +363,148 @@ void FSDirectory::cacheDirectoryRecursive(FSNode node, int depth, const String&
 
 		// since the hashmap is case insensitive, we need to check for clashes when caching
 		if (it->isDirectory()) {
-			if (!_flat && _subDirCache.contains(lowercaseName)) {
+			if (!_flat && _subDirCache.find(lowercaseName)) {
 				// Always warn in this case as it's when there are 2 directories at the same place with different case
 				// That means a problem in user installation as lookups are always done case insensitive
 				warning("FSDirectory::cacheDirectory: name clash when building cache, ignoring sub-directory '%s'",
 				        name.c_str());
 			} else {
-				if (_subDirCache.contains(lowercaseName)) {
+				if (_subDirCache.find(lowercaseName)) {
 					if (!_ignoreClashes) {
 						warning("FSDirectory::cacheDirectory: name clash when building subDirCache with subdirectory '%s'",
 						        name.c_str());
 					}
 				}
 				cacheDirectoryRecursive(*it, depth - 1, _flat ? prefix : lowercaseName + "/");
-				_subDirCache[lowercaseName] = *it;
+				_subDirCache.setVal(lowercaseName, *it);
 			}
 		} else {
-			if (_fileCache.contains(lowercaseName)) {
+			if (_fileCache.find(lowercaseName)) {
 				if (!_ignoreClashes) {
 					warning("FSDirectory::cacheDirectory: name clash when building cache, ignoring file '%s'",
 					        name.c_str());
 				}
 			} else {
-				_fileCache[lowercaseName] = *it;
+				_fileCache.setVal(lowercaseName, *it);
 			}
 		}
 	}
 
 }
 
+void FSDirectory::listDirectory(const FSNode &node, FSList &list) const {
+	if (!_keepListings) {
+		node.getChildren(list, FSNode::kListAll);
+		return;
+	}
+
+	// Reuse the saved listing if the directory did not change since then
+	const String path = node.getPath();
+	const int64 modificationTime = node.getModificationTime();
+	ListingCache::const_iterator saved = _savedListings.find(path);
+	if (modificationTime != -1 && saved != _savedListings.end() && saved->_value.modificationTime == modificationTime) {
+		const Array<ListingEntry> &entries = saved->_value.entries;
+		for (uint i = 0; i < entries.size(); i++)
+			list.push_back(node.getChildWithKnownType(entries[i].name, entries[i].isDirectory));
+
+		_listings[path] = saved->_value;
+		return;
+	}
+
+	node.getChildren(list, FSNode::kListAll);
+	_listingsChanged = true;
+
+	Listing &listing = _listings[path];
+	listing.modificationTime = modificationTime;
+	listing.entries.clear();
+	for (FSList::const_iterator it = list.begin(); it != list.end(); ++it) {
+		ListingEntry entry;
+		entry.name = it->getName();
+		entry.isDirectory = it->isDirectory();
+		listing.entries.push_back(entry);
+	}
+}
+
 void FSDirectory::ensureCached() const  {
 	if (_cached)
 		return;
 	cacheDirectoryRecursive(_node, _depth, _prefix);
 	_cached = true;
+
+	if (_keepListings) {
+		// Directories may also have been removed
+		if (_listings.size() != _savedListings.size())
+			_listingsChanged = true;
+		_savedListings.clear();
+	}
+}
+
+bool FSDirectory::loadListingCache(SeekableReadStream *stream) {
+	_keepListings = true;
+	_savedListings.clear();
+
+	if (!stream)
+		return false;
+
+	if (stream->readUint32BE() != MKTAG('F', 'S', 'D', 'C') || stream->readUint32LE() != kListingCacheVersion)
+		return false;
+	if (stream->readString() != _node.getPath() || stream->readSint32LE() != _depth)
+		return false;
+
+	uint32 directories = stream->readUint32LE();
+	while (directories-- && !stream->eos()) {
+		const String path = stream->readString();
+		Listing &listing = _savedListings[path];
+		listing.modificationTime = stream->readSint64LE();
+
+		uint32 entries = stream->readUint32LE();
+		while (entries-- && !stream->eos()) {
+			ListingEntry entry;
+			entry.isDirectory = stream->readByte() != 0;
+			entry.name = stream->readString();
+			listing.entries.push_back(entry);
+		}
+	}
+
+	if (stream->eos() || stream->err()) {
+		_savedListings.clear();
+		return false;
+	}
+
+	return true;
+}
+
+bool FSDirectory::listingCacheChanged() const {
+	ensureCached();
+	return _listingsChanged;
+}
+
+bool FSDirectory::saveListingCache(WriteStream *stream) const {
+	assert(_keepListings);
+	ensureCached();
+
+	stream->writeUint32BE(MKTAG('F', 'S', 'D', 'C'));
+	stream->writeUint32LE(kListingCacheVersion);
+	stream->writeString(_node.getPath());
+	stream->writeByte(0);
+	stream->writeSint32LE(_depth);
+
+	stream->writeUint32LE(_listings.size());
+	for (ListingCache::const_iterator it = _listings.begin(); it != _listings.end(); ++it) {
+		stream->writeString(it->_key);
+		stream->writeByte(0);
+		stream->writeSint64LE(it->_value.modificationTime);
+
+		const Array<ListingEntry> &entries = it->_value.entries;
+		stream->writeUint32LE(entries.size());
+		for (uint i = 0; i < entries.size(); i++) {
+			stream->writeByte(entries[i].isDirectory);
+			stream->writeString(entries[i].name);
+			stream->writeByte(0);
+		}
+	}
+
+	return stream->flush() && !stream->err();
 }
 
 int FSDirectory::listMatchingMembers(ArchiveMemberList &list, const String &pattern) const {
@@ -340,21 +519,9 @@ int FSDirectory::listMatchingMembers(ArchiveMemberList &list, const String &patt
 	String lowercasePattern(pattern);
 	lowercasePattern.toLowercase();
 
-	int matches = 0;
-	for (NodeCache::const_iterator it = _fileCache.begin(); it != _fileCache.end(); ++it) {
-		if (it->_key.matchString(lowercasePattern, false, true)) {
-			list.push_back(ArchiveMemberPtr(new FSNode(it->_value)));
-			matches++;
-		}
-	}
-	if (_includeDirectories) {
-		for (NodeCache::const_iterator it = _subDirCache.begin(); it != _subDirCache.end(); ++it) {
-			if (it->_key.matchString(lowercasePattern, false, true)) {
-				list.push_back(ArchiveMemberPtr(new FSNode(it->_value)));
-				matches++;
-			}
-		}
-	}
+	int matches = listCache(_fileCache, list, &lowercasePattern);
+	if (_includeDirectories)
+		matches += listCache(_subDirCache, list, &lowercasePattern);
 
 	return matches;
 }
@@ -366,18 +533,9 @@ int FSDirectory::listMembers(ArchiveMemberList &list) const {
 	// Cache dir data
 	ensureCached();
 
-	int files = 0;
-	for (NodeCache::const_iterator it = _fileCache.begin(); it != _fileCache.end(); ++it) {
-		list.push_back(ArchiveMemberPtr(new FSNode(it->_value)));
-		++files;
-	}
-
-	if (_includeDirectories) {
-		for (NodeCache::const_iterator it = _subDirCache.begin(); it != _subDirCache.end(); ++it) {
-			list.push_back(ArchiveMemberPtr(new FSNode(it->_value)));
-			++files;
-		}
-	}
+	int files = listCache(_fileCache, list, nullptr);
+	if (_includeDirectories)
+		files += listCache(_subDirCache, list, nullptr);
 
 	return files;
 }
@@ -27,6 +27,7 @@
 #include "common/archive.h"
 #include "common/hash-str.h"
 #include "common/hashmap.h"
+#include "common/intern-str.h"
 #include "common/ptr.h"
 #include "common/str.h"
 
@@ -67,6 +68,7 @@ class FSList : public Array<FSNode> {};
 class FSNode : public ArchiveMember {
 private:
 	friend class ::AbstractFSNode;
+	friend class FSDirectory;
 	SharedPtr<AbstractFSNode>	_realNode;
 	/**
 	 * Construct an FSNode from a backend's AbstractFSNode implementation.
@@ -76,6 +78,13 @@ private:
 	 */
 	FSNode(AbstractFSNode *realNode);
 
+	/**
+	 * Get the child node of a directory, which is known to exist, and whether
+	 * it is a directory. Used by FSDirectory to rebuild its cache from listings
+	 * saved earlier without querying the file system.
+	 */
+	FSNode getChildWithKnownType(const String &name, bool isDirectory) const;
+
 public:
 	/**
 	 * Flag to tell listDir() which kind of files to list.
@@ -222,6 +231,15 @@ public:
 	 */
 	bool isWritable() const;
 
+	/**
+	 * Get the time the node was last modified, in seconds. For directories,
+	 * this changes when entries are added, removed or renamed.
+	 *
+	 * @return The time, or -1 if it is unknown or was too recent to be
+	 *         relied on.
+	 */
+	int64 getModificationTime() const;
+
 	/**
 	 * Create a SeekableReadStream instance corresponding to the file
 	 * referred by this node. This assumes that the node actually refers
@@ -231,6 +249,17 @@ public:
 	 */
 	virtual SeekableReadStream *createReadStream() const;
 
+	/**
+	 * Create a SeekableReadStream instance for a file of game data, which
+	 * is neither written to nor truncated while the stream exists. The
+	 * backend may then map the file into memory instead of reading it.
+	 * Savegames and other files which may change are to be opened with
+	 * createReadStream() instead.
+	 *
+	 * @return Pointer to the stream object, 0 in case of a failure.
+	 */
+	SeekableReadStream *createGameDataReadStream() const;
+
 	/**
 	 * Create a WriteStream instance corresponding to the file
 	 * referred by this node. This assumes that the node actually refers
@@ -304,16 +333,47 @@ class FSDirectory : public Archive {
 	void setPrefix(const String &prefix);
 
 	// Caches are case insensitive, clashes are dealt with when creating
-	// Key is stored in lowercase.
-	typedef HashMap<String, FSNode, IgnoreCase_Hash, IgnoreCase_EqualTo> NodeCache;
+	// Key is stored in lowercase, and interned so that lookups only hash
+	// and compare it once. Names which could not be interned, because the
+	// table of interned strings is full, are kept as strings.
+	struct NodeCache {
+		HashMap<InternedString, FSNode> interned;
+		HashMap<String, FSNode, IgnoreCase_Hash, IgnoreCase_EqualTo> others;
+
+		FSNode *find(const String &name);
+		void setVal(const String &lowercaseName, const FSNode &node);
+	};
 	mutable NodeCache	_fileCache, _subDirCache;
 	mutable bool _cached;
 
+	// Directory listings, to rebuild the caches in later runs
+	enum {
+		kListingCacheVersion = 1
+	};
+
+	struct ListingEntry {
+		String name;
+		bool isDirectory;
+	};
+
+	struct Listing {
+		int64 modificationTime;
+		Array<ListingEntry> entries;
+	};
+
+	// Key is the path of the directory
+	typedef HashMap<String, Listing> ListingCache;
+	mutable ListingCache _listings, _savedListings;
+	bool _keepListings;
+	mutable bool _listingsChanged;
+
 	// look for a match
 	FSNode *lookupCache(NodeCache &cache, const String &name) const;
+	int listCache(const NodeCache &cache, ArchiveMemberList &list, const String *lowercasePattern) const;
 
 	// cache management
 	void cacheDirectoryRecursive(FSNode node, int depth, const String& prefix) const;
+	void listDirectory(const FSNode &node, FSList &list) const;
 
 	// fill cache if not already cached
 	void ensureCached() const;
@@ -392,6 +452,32 @@ public:
 	 * for success.
 	 */
 	virtual SeekableReadStream *createReadStreamForMember(const String &name) const;
+
+	/**
+	 * Keep the directory listings the cache is built from, so that they can be
+	 * saved with saveListingCache(), and load those saved in an earlier run.
+	 * Directories which were not modified since then are not listed again.
+	 * Must be called before the FSDirectory is first used.
+	 *
+	 * @param stream  Saved listings, or nullptr if there are none yet.
+	 * @return True if listings were loaded, false if there were none or they
+	 *         were saved for another directory.
+	 */
+	bool loadListingCache(SeekableReadStream *stream);
+
+	/**
+	 * Check whether any directory had to be listed again, or was removed,
+	 * since the listings were loaded. If not, there is no need to save them.
+	 */
+	bool listingCacheChanged() const;
+
+	/**
+	 * Save the directory listings, to be loaded with loadListingCache() in
+	 * a later run.
+	 *
+	 * @return True if the listings were written successfully.
+	 */
+	bool saveListingCache(WriteStream *stream) const;
 };
 
 /** @} */
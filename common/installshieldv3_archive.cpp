@@ -22,11 +22,41 @@
 
 #include "common/installshieldv3_archive.h"
 
+#include "common/asyncio.h"
 #include "common/dcl.h"
 #include "common/debug.h"
+#include "common/memstream.h"
+#include "common/ptr.h"
 
 namespace Common {
 
+/**
+ * Reads the packed data of a member in the background, and unpacks it on
+ * the I/O thread as well.
+ */
+class DCLReadRequest : public AsyncReadRequest {
+public:
+	DCLReadRequest(AsyncReadRequest *packed, uint32 unpackedSize) : AsyncReadRequest(unpackedSize), _packed(packed) {
+		start();
+	}
+
+	~DCLReadRequest() override {
+		cancel();
+	}
+
+protected:
+	uint32 readData(byte *buffer, uint32 size) override {
+		if (_packed->err())
+			return 0;
+
+		MemoryReadStream packedStream(_packed->getData(), _packed->getDataSize());
+		return decompressDCL(&packedStream, buffer, packedStream.size(), size) ? size : 0;
+	}
+
+private:
+	ScopedPtr<AsyncReadRequest> _packed;
+};
+
 InstallShieldV3::InstallShieldV3() : Common::Archive() {
 	_stream = nullptr;
 }
@@ -133,4 +163,12 @@ Common::SeekableReadStream *InstallShieldV3::createReadStreamForMember(const Com
 	return Common::decompressDCL(_stream, entry.compressedSize, entry.uncompressedSize);
 }
 
+Common::AsyncReadRequest *InstallShieldV3::readMemberAsync(const Common::String &name) const {
+	if (!_stream || !_map.contains(name))
+		return nullptr;
+
+	const FileEntry &entry = _map[name];
+	return new DCLReadRequest(_stream->readAsync(entry.offset, entry.compressedSize), entry.uncompressedSize);
+}
+
 } // End of namespace Common
@@ -47,6 +47,7 @@ public:
 	int listMembers(Common::ArchiveMemberList &list) const override;
 	const Common::ArchiveMemberPtr getMember(const Common::String &name) const override;
 	Common::SeekableReadStream *createReadStreamForMember(const Common::String &name) const override;
+	Common::AsyncReadRequest *readMemberAsync(const Common::String &name) const override;
 
 private:
 	struct FileEntry {
@@ -0,0 +1,143 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "common/intern-str.h"
+#include "common/hash-str.h"
+
+namespace Common {
+
+Atomic<const InternedString::Entry *> InternedString::_buckets[1 << kBucketBits];
+Atomic<uint32> InternedString::_size(0);
+Atomic<uint32> InternedString::_maxSize(kDefaultMaxSize);
+
+InternedString::InternedString(const char *str) {
+	intern(str, false, _entry);
+}
+
+InternedString::InternedString(const String &str) {
+	intern(str.c_str(), false, _entry);
+}
+
+bool InternedString::intern(const char *str, InternedString &result) {
+	const Entry *entry;
+	if (!intern(str, true, entry))
+		return false;
+
+	result = InternedString(entry);
+	return true;
+}
+
+bool InternedString::find(const char *str, InternedString &result) {
+	if (!*str) {
+		result = InternedString();
+		return true;
+	}
+
+	const uint hash = hashit(str);
+	const Entry *entry = findInBucket(bucket(hash).load(), nullptr, str, hash);
+	if (!entry)
+		return false;
+
+	result = InternedString(entry);
+	return true;
+}
+
+bool InternedString::findIgnoreCase(const char *str, InternedString &result) {
+	if (!*str) {
+		result = InternedString();
+		return true;
+	}
+
+	// The lowercase string hashes like hashit_lower() hashes this one. Only
+	// lowercase entries are compared, so a case insensitive comparison
+	// finds the one which is equal to the lowercase string.
+	const uint hash = hashit_lower(str);
+	for (const Entry *entry = bucket(hash).load(); entry; entry = entry->_next) {
+		if (entry->_hash == hash && entry->_lowercase == entry && !scumm_stricmp(entry->_str, str)) {
+			result = InternedString(entry);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+const InternedString::Entry *InternedString::findInBucket(const Entry *first, const Entry *last, const char *str, uint hash) {
+	for (const Entry *entry = first; entry != last; entry = entry->_next) {
+		if (entry->_hash == hash && !strcmp(entry->_str, str))
+			return entry;
+	}
+
+	return nullptr;
+}
+
+bool InternedString::intern(const char *str, bool bounded, const Entry *&result) {
+	result = nullptr;
+	if (!*str)
+		return true;
+
+	const uint hash = hashit(str);
+	Atomic<const Entry *> &head = bucket(hash);
+	const Entry *first = head.load();
+	result = findInBucket(first, nullptr, str, hash);
+	if (result)
+		return true;
+
+	const uint size = strlen(str);
+	const uint32 entrySize = sizeof(Entry) + size;
+	if (bounded && _size.load() + entrySize > _maxSize.load())
+		return false;
+
+	// The lowercase version is interned first, and may be this string
+	String lowercase(str, size);
+	lowercase.toLowercase();
+	const Entry *lowercaseEntry = nullptr;
+	if (!lowercase.equals(str) && !intern(lowercase.c_str(), bounded, lowercaseEntry))
+		return false;
+
+	Entry *created = (Entry *)malloc(entrySize);
+	created->_hash = hash;
+	created->_size = size;
+	created->_lowercase = lowercaseEntry ? lowercaseEntry : created;
+	memcpy(created->_str, str, size + 1);
+
+	// Another thread may add to the bucket, maybe the same string, until
+	// the new entry makes it to the front of the bucket
+	while (true) {
+		created->_next = first;
+		const Entry *expected = first;
+		if (head.compareExchange(expected, created)) {
+			_size.fetchAdd(entrySize);
+			result = created;
+			return true;
+		}
+
+		result = findInBucket(expected, first, str, hash);
+		if (result) {
+			free(created);
+			return true;
+		}
+		first = expected;
+	}
+}
+
+} // End of namespace Common
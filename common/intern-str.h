@@ -0,0 +1,199 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef COMMON_INTERN_STR_H
+#define COMMON_INTERN_STR_H
+
+#include "common/scummsys.h"
+#include "common/atomic.h"
+#include "common/func.h"
+#include "common/str.h"
+
+namespace Common {
+
+/**
+ * @defgroup common_intern_str Interned strings
+ * @ingroup common
+ *
+ * @brief Strings stored once, for use as hash map keys.
+ * @{
+ */
+
+/**
+ * An immutable string which is stored only once for the whole program.
+ *
+ * Two InternedStrings are equal if and only if they point to the same
+ * characters, so comparing them is a pointer comparison. Their hashes are
+ * computed once, when the string is first interned, and are the same as
+ * those of String, so an InternedString hashes like its String would in
+ * both a case sensitive and a case insensitive map. Each InternedString
+ * also knows its lowercase version, which makes case insensitive
+ * comparisons pointer comparisons as well.
+ *
+ * This makes them cheap keys for maps which are looked up by the same
+ * names over and over. A name which is not known yet can be looked for
+ * with find(), which does not add it, so maps keyed by InternedStrings
+ * do not keep every name they were asked about.
+ *
+ * Interned strings are never freed, and the memory they use is only
+ * given back when the program exits. So the constructors are meant for a
+ * fixed set of names, such as literals. Names read from game data or from
+ * the file system are to be interned with intern(), which gives up once the
+ * table holds getMaxSize() bytes; its callers have to be able to do
+ * without an InternedString.
+ *
+ * The table the strings are stored in does not take any lock, so strings
+ * can be interned and looked for from any thread, even before g_system is
+ * set up or during static initialization.
+ */
+class InternedString {
+private:
+	enum {
+		kBucketBits = 12,
+		kDefaultMaxSize = 4 * 1024 * 1024
+	};
+
+	struct Entry {
+		const Entry *_next;       ///< Next entry in the same bucket
+		const Entry *_lowercase;  ///< Lowercase version of this entry; itself if it is lowercase already
+		uint _hash;
+		uint _size;
+		char _str[1];             ///< The characters, allocated along with the entry
+	};
+
+public:
+	/** The empty string. */
+	InternedString() : _entry(nullptr) {}
+
+	/**
+	 * Intern a copy of @p str, or find the one which was interned already.
+	 *
+	 * This ignores the limit on the size of the table, and the string is
+	 * never freed.
+	 */
+	explicit InternedString(const char *str);
+	explicit InternedString(const String &str);
+
+	/**
+	 * Intern a copy of @p str, or find the one which was interned already,
+	 * unless the table is full.
+	 *
+	 * The string is never freed.
+	 *
+	 * @param str    The string to intern.
+	 * @param result Set to the interned string on success.
+	 * @return False if @p str was not interned yet and adding it would
+	 *         make the table larger than getMaxSize().
+	 */
+	static bool intern(const char *str, InternedString &result);
+	static bool intern(const String &str, InternedString &result) { return intern(str.c_str(), result); }
+
+	/**
+	 * Look for @p str without adding it if it is not there.
+	 *
+	 * @param str    The string to look for.
+	 * @param result Set to the interned string if it was found.
+	 * @return Whether @p str was interned already.
+	 */
+	static bool find(const char *str, InternedString &result);
+	static bool find(const String &str, InternedString &result) { return find(str.c_str(), result); }
+
+	/**
+	 * Look for the lowercase version of @p str without adding it if it is
+	 * not there, and without converting @p str.
+	 *
+	 * @param str    The string to look for.
+	 * @param result Set to the interned lowercase string if it was found.
+	 * @return Whether the lowercase version of @p str was interned already.
+	 */
+	static bool findIgnoreCase(const char *str, InternedString &result);
+	static bool findIgnoreCase(const String &str, InternedString &result) { return findIgnoreCase(str.c_str(), result); }
+
+	/** The number of bytes allocated for all the strings interned so far. */
+	static uint32 getSize() { return _size.load(); }
+
+	/**
+	 * The number of bytes beyond which intern() does not add strings. Calls
+	 * on other threads may go past it by a few strings.
+	 */
+	static uint32 getMaxSize() { return _maxSize.load(); }
+	static void setMaxSize(uint32 maxSize) { _maxSize.store(maxSize); }
+
+	const char *c_str() const { return _entry ? _entry->_str : ""; }
+	uint size() const { return _entry ? _entry->_size : 0; }
+	bool empty() const { return _entry == nullptr; }
+
+	/** A new String, which may be used on another thread than this one. */
+	String toString() const { return String(c_str(), size()); }
+
+	/** The hash of the string, as computed by String::hash(). */
+	uint hash() const { return _entry ? _entry->_hash : 0; }
+
+	/** The hash of the lowercase string, as computed by hashit_lower(). */
+	uint hashIgnoreCase() const { return _entry ? _entry->_lowercase->_hash : 0; }
+
+	/** The lowercase version of this string, which is interned along with it. */
+	InternedString toLowercase() const { return InternedString(_entry ? _entry->_lowercase : nullptr); }
+
+	bool operator==(const InternedString &x) const { return _entry == x._entry; }
+	bool operator!=(const InternedString &x) const { return _entry != x._entry; }
+
+	bool equalsIgnoreCase(const InternedString &x) const { return toLowercase() == x.toLowercase(); }
+
+private:
+	explicit InternedString(const Entry *entry) : _entry(entry) {}
+
+	static bool intern(const char *str, bool bounded, const Entry *&result);
+	static const Entry *findInBucket(const Entry *first, const Entry *last, const char *str, uint hash);
+	static Atomic<const Entry *> &bucket(uint hash) { return _buckets[(hash * 0x9E3779B1) >> (32 - kBucketBits)]; }
+
+	/** Lists of entries, newest first, which are only ever prepended to. */
+	static Atomic<const Entry *> _buckets[1 << kBucketBits];
+
+	static Atomic<uint32> _size;
+	static Atomic<uint32> _maxSize;
+
+	const Entry *_entry;
+};
+
+struct InternedString_IgnoreCase_EqualTo {
+	bool operator()(const InternedString &x, const InternedString &y) const { return x.equalsIgnoreCase(y); }
+};
+
+struct InternedString_IgnoreCase_Hash {
+	uint operator()(const InternedString &x) const { return x.hashIgnoreCase(); }
+};
+
+// Specialization of the Hash functor for InternedString objects, which is
+// case sensitive like the default EqualTo.
+template<>
+struct Hash<InternedString> {
+	uint operator()(const InternedString &s) const {
+		return s.hash();
+	}
+};
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
@@ -23,6 +23,7 @@
 #include "common/scummsys.h"
 #include "common/debug.h"
 #include "common/util.h"
+#include "common/asyncio.h"
 #include "common/file.h"
 #include "common/fs.h"
 #include "common/macresman.h"
@@ -512,6 +513,40 @@ SeekableReadStream *MacResManager::getResource(uint32 typeID, uint16 resID) {
 	return _stream->readStream(len);
 }
 
+AsyncReadRequest *MacResManager::getResourceAsync(uint32 typeID, uint16 resID) {
+	int typeNum = -1;
+	int resNum = -1;
+
+	for (int i = 0; i < _resMap.numTypes; i++)
+		if (_resTypes[i].id == typeID) {
+			typeNum = i;
+			break;
+		}
+
+	if (typeNum == -1)
+		return nullptr;
+
+	for (int i = 0; i < _resTypes[typeNum].items; i++)
+		if (_resLists[typeNum][i].id == resID) {
+			resNum = i;
+			break;
+		}
+
+	if (resNum == -1)
+		return nullptr;
+
+	// Only the length is read right away
+	const uint32 dataOffset = _dataOffset + _resLists[typeNum][resNum].dataOffset;
+	_stream->seek(dataOffset);
+	uint32 len = _stream->readUint32BE();
+
+	// Ignore resources with 0 length
+	if (!len)
+		return nullptr;
+
+	return _stream->readAsync(dataOffset + 4, len);
+}
+
 SeekableReadStream *MacResManager::getResource(const String &fileName) {
 	for (uint32 i = 0; i < _resMap.numTypes; i++) {
 		for (uint32 j = 0; j < _resTypes[i].items; j++) {
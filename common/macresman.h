@@ -129,6 +129,14 @@ public:
 	 */
 	SeekableReadStream *getResource(uint32 typeID, uint16 resID);
 
+	/**
+	 * Start reading a resource from the MacBinary file in the background
+	 * @param typeID FourCC of the type
+	 * @param resID Resource ID to fetch
+	 * @return Pointer to an AsyncReadRequest for the resource data
+	 */
+	AsyncReadRequest *getResourceAsync(uint32 typeID, uint16 resID);
+
 	/**
 	 * Read resource from the MacBinary file
 	 * @note This will take the first resource that matches this name, regardless of type
@@ -179,4 +179,121 @@ void MemoryPool::freeUnusedPages() {
 	}
 }
 
+
+#pragma mark -
+
+
+ThreadSafeMemoryPool::ThreadSafeMemoryPool(size_t chunkSize)
+	: _pool(chunkSize), _lock(0), _freed(nullptr) {
+}
+
+void ThreadSafeMemoryPool::lock() {
+	// Only held to take a chunk or a batch of them, so spinning is cheaper
+	// than sleeping
+	int expected = 0;
+	while (_lock.loadRelaxed() || !_lock.compareExchange(expected, 1))
+		expected = 0;
+}
+
+void *ThreadSafeMemoryPool::allocChunkLocked() {
+	if (!_freed.loadRelaxed())
+		return _pool.allocChunk();
+
+	// Taking all the freed chunks at once is safe from other threads
+	// freeing and taking them in the meantime, unlike taking only the
+	// first one. The most recently freed one is used first.
+	void *chunk = _freed.exchange(nullptr);
+	void *next = *(void **)chunk;
+	while (next) {
+		void *following = *(void **)next;
+		_pool.freeChunk(next);
+		next = following;
+	}
+
+	return chunk;
+}
+
+void *ThreadSafeMemoryPool::allocChunk() {
+	lock();
+	void *chunk = allocChunkLocked();
+	unlock();
+
+	return chunk;
+}
+
+void ThreadSafeMemoryPool::freeChunk(void *ptr) {
+	freeChunks(ptr, ptr);
+}
+
+void ThreadSafeMemoryPool::freeChunks(void *first, void *last) {
+	void *next = _freed.loadRelaxed();
+	do {
+		*(void **)last = next;
+	} while (!_freed.compareExchange(next, first));
+}
+
+void ThreadSafeMemoryPool::freeUnusedPages() {
+	lock();
+	void *chunk = _freed.exchange(nullptr);
+	while (chunk) {
+		void *next = *(void **)chunk;
+		_pool.freeChunk(chunk);
+		chunk = next;
+	}
+	_pool.freeUnusedPages();
+	unlock();
+}
+
+ThreadSafeMemoryPool::Cache::Cache(ThreadSafeMemoryPool &pool)
+	: _pool(pool), _next(nullptr), _count(0) {
+}
+
+ThreadSafeMemoryPool::Cache::~Cache() {
+	if (!_next)
+		return;
+
+	void *last = _next;
+	while (*(void **)last)
+		last = *(void **)last;
+	_pool.freeChunks(_next, last);
+}
+
+void *ThreadSafeMemoryPool::Cache::allocChunk() {
+	if (!_next) {
+		_pool.lock();
+		for (int i = 0; i < kCacheBatchSize; i++) {
+			void *chunk = _pool.allocChunkLocked();
+			*(void **)chunk = _next;
+			_next = chunk;
+		}
+		_pool.unlock();
+		_count = kCacheBatchSize;
+	}
+
+	void *result = _next;
+	_next = *(void **)result;
+	_count--;
+	return result;
+}
+
+void ThreadSafeMemoryPool::Cache::freeChunk(void *ptr) {
+	*(void **)ptr = _next;
+	_next = ptr;
+	_count++;
+
+	// Give a batch back when there are two, so that a thread which only
+	// frees does not keep them all, and one which allocates and frees in
+	// turns does not give them back every time
+	if (_count == 2 * kCacheBatchSize) {
+		void *last = _next;
+		for (int i = 1; i < kCacheBatchSize; i++)
+			last = *(void **)last;
+
+		void *first = _next;
+		_next = *(void **)last;
+		_count -= kCacheBatchSize;
+		_pool.freeChunks(first, last);
+	}
+}
+
 } // End of namespace Common
@@ -25,6 +25,8 @@
 
 #include "common/scummsys.h"
 #include "common/array.h"
+#include "common/atomic.h"
+#include "common/noncopyable.h"
 
 
 namespace Common {
@@ -149,6 +151,103 @@ public:
 	}
 };
 
+/**
+ * A memory pool which may be used from several threads at once, e.g. for
+ * objects made on a worker thread and deleted on the main thread.
+ *
+ * Freeing a chunk does not take any lock. Allocating one takes a short
+ * spin lock, so threads which allocate a lot should do it through a Cache
+ * of their own, which takes chunks from the pool in batches. Since the
+ * lock is not a Mutex, the pool does not need g_system, and may be a
+ * global.
+ *
+ * Chunks are interchangeable: a chunk may be freed to the pool, or to any
+ * Cache of the pool, on any thread.
+ */
+class ThreadSafeMemoryPool : NonCopyable {
+public:
+	/**
+	 * Chunks of a ThreadSafeMemoryPool kept for one thread, which only
+	 * takes the lock of the pool once for each batch of chunks.
+	 *
+	 * A cache must only be used by one thread at a time. Chunks it holds
+	 * are returned to the pool when it is deleted.
+	 */
+	class Cache : NonCopyable {
+	public:
+		explicit Cache(ThreadSafeMemoryPool &pool);
+		~Cache();
+
+		void	*allocChunk();
+		void	freeChunk(void *ptr);
+
+	private:
+		ThreadSafeMemoryPool	&_pool;
+		void			*_next;
+		size_t			_count;
+	};
+
+	/**
+	 * Constructor for a thread-safe memory pool with the given chunk size.
+	 * @param chunkSize		the chunk size of this memory pool
+	 */
+	explicit ThreadSafeMemoryPool(size_t chunkSize);
+
+	/**
+	 * Allocate a new chunk from the memory pool.
+	 */
+	void	*allocChunk();
+	/**
+	 * Return a chunk to the memory pool, from any thread. The given
+	 * pointer must have been obtained from this pool or one of its caches.
+	 */
+	void	freeChunk(void *ptr);
+
+	/**
+	 * Perform garbage collection, see MemoryPool::freeUnusedPages().
+	 * Chunks held by caches count as used.
+	 */
+	void	freeUnusedPages();
+
+	/**
+	 * Return the chunk size used by this memory pool.
+	 */
+	size_t	getChunkSize() const { return _pool.getChunkSize(); }
+
+private:
+	enum {
+		kCacheBatchSize = 32
+	};
+
+	MemoryPool		_pool;   ///< Only used with _lock held
+	Atomic<int>		_lock;
+	Atomic<void *>	_freed;  ///< Chunks freed since the last allocation which had the lock
+
+	void	lock();
+	void	unlock() { _lock.store(0); }
+
+	void	*allocChunkLocked();
+	void	freeChunks(void *first, void *last);
+};
+
+/**
+ * A thread-safe memory pool for C++ objects.
+ */
+template<class T>
+class ThreadSafeObjectPool : public ThreadSafeMemoryPool {
+public:
+	ThreadSafeObjectPool() : ThreadSafeMemoryPool(sizeof(T)) {}
+
+	/**
+	 * Return the memory chunk used as storage for the given object back
+	 * to the pool, after calling its destructor.
+	 */
+	void deleteChunk(T *ptr) {
+		ptr->~T();
+		this->freeChunk(ptr);
+	}
+};
+
 /** @} */
 
 } // End of namespace Common
@@ -170,4 +269,13 @@ inline void operator delete(void *p, Common::MemoryPool &pool) {
 	pool.freeChunk(p);
 }
 
+inline void *operator new(size_t nbytes, Common::ThreadSafeMemoryPool &pool) {
+	assert(nbytes <= pool.getChunkSize());
+	return pool.allocChunk();
+}
+
+inline void operator delete(void *p, Common::ThreadSafeMemoryPool &pool) {
+	pool.freeChunk(p);
+}
+
 #endif
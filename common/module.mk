@@ -3,6 +3,7 @@ MODULE := common
 MODULE_OBJS := \
 	achievements.o \
 	archive.o \
+	asyncio.o \
 	base-str.o \
 	config-manager.o \
 	coroutines.o \
@@ -18,6 +19,7 @@ MODULE_OBJS := \
 	ini-file.o \
 	installshield_cab.o \
 	installshieldv3_archive.o \
+	intern-str.o \
 	json.o \
 	language.o \
 	localization.o \
@@ -41,6 +43,7 @@ MODULE_OBJS := \
 	stuffit.o \
 	system.o \
 	textconsole.o \
+	threadpool.o \
 	tokenizer.o \
 	translation.o \
 	unarj.o \
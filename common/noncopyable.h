@@ -39,7 +39,7 @@ namespace Common {
  */
 class NonCopyable {
 public:
-	NonCopyable() {}
+	constexpr NonCopyable() {}
 private:
 	// Prevent copying instances by accident
 	NonCopyable(const NonCopyable&);
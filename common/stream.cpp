@@ -20,6 +20,7 @@
  *
  */
 
+#include "common/asyncio.h"
 #include "common/ptr.h"
 #include "common/stream.h"
 #include "common/memstream.h"
@@ -223,6 +224,36 @@ String SeekableReadStream::readLine(bool handleCR) {
 	return line;
 }
 
+/**
+ * Reads a range of a stream through the stream itself, so it cannot be done
+ * in the background.
+ */
+class StreamReadRequest : public AsyncReadRequest {
+public:
+	StreamReadRequest(SeekableReadStream *stream, int64 offset, uint32 size) :
+		AsyncReadRequest(size), _stream(stream), _offset(offset) {}
+
+protected:
+	uint32 readData(byte *buffer, uint32 size) override {
+		const int64 pos = _stream->pos();
+		uint32 dataSize = 0;
+		if (_stream->seek(_offset))
+			dataSize = _stream->read(buffer, size);
+		_stream->seek(pos);
+		return dataSize;
+	}
+
+private:
+	SeekableReadStream *_stream;
+	int64 _offset;
+};
+
+AsyncReadRequest *SeekableReadStream::readAsync(int64 offset, uint32 size) {
+	AsyncReadRequest *request = new StreamReadRequest(this, offset, size);
+	request->start(false);
+	return request;
+}
+
 uint32 SubReadStream::read(void *dataPtr, uint32 dataSize) {
 	if (dataSize > _end - _pos) {
 		dataSize = _end - _pos;
@@ -271,6 +302,23 @@ bool SeekableSubReadStream::seek(int64 offset, int whence) {
 	return ret;
 }
 
+const byte *SeekableSubReadStream::mapRange(int64 offset, uint32 size) {
+	if (offset < 0 || offset > _end - _begin || size > _end - _begin - offset)
+		return nullptr;
+	return _parentStream->mapRange(_begin + offset, size);
+}
+
+AsyncReadRequest *SeekableSubReadStream::readAsync(int64 offset, uint32 size) {
+	// Stay inside the substream
+	if (offset < 0 || offset > _end - _begin) {
+		offset = _end - _begin;
+		size = 0;
+	}
+	size = MIN<int64>(size, _end - _begin - offset);
+
+	return _parentStream->readAsync(_begin + offset, size);
+}
+
 uint32 SafeSeekableSubReadStream::read(void *dataPtr, uint32 dataSize) {
 	// Make sure the parent stream is at the right position
 	seek(0, SEEK_CUR);
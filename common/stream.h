@@ -38,6 +38,7 @@ namespace Common {
  * @{
  */
 
+class AsyncReadRequest;
 class ReadStream;
 class SeekableReadStream;
 
@@ -712,6 +713,38 @@ public:
 	 */
 	virtual bool skip(uint32 offset) { return seek(offset, SEEK_CUR); }
 
+	/**
+	 * Obtain a pointer to a range of the stream data, without copying it.
+	 *
+	 * This is only possible for streams whose data is already in memory,
+	 * or can be mapped there, such as memory streams and memory-mapped
+	 * files. The stream position indicator is not changed. The returned
+	 * data must not be modified, and stays valid as long as the stream
+	 * exists.
+	 *
+	 * @param offset	Offset of the range from the start of the stream.
+	 * @param size		Size of the range in bytes.
+	 *
+	 * @return A pointer to the data, or nullptr if the stream cannot provide
+	 *         it or the range is not inside the stream.
+	 */
+	virtual const byte *mapRange(int64 offset, uint32 size) { return nullptr; }
+
+	/**
+	 * Start reading a range of the stream in the background.
+	 *
+	 * Streams backed by files read on I/O threads where the backend
+	 * supports it. The default implementation reads the range right away.
+	 * The stream position indicator is not changed, and the stream may
+	 * be deleted before the request completes.
+	 *
+	 * @param offset	Offset of the range from the start of the stream.
+	 * @param size		Size of the range in bytes.
+	 *
+	 * @return The request, which the caller must delete. See AsyncReadRequest.
+	 */
+	virtual AsyncReadRequest *readAsync(int64 offset, uint32 size);
+
 	/**
 	 * Read at most one less than the number of characters specified
 	 * by @p bufSize from the stream and store them in the string buffer.
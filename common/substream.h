@@ -86,6 +86,8 @@ public:
 	virtual int64 size() const { return _end - _begin; }
 
 	virtual bool seek(int64 offset, int whence = SEEK_SET);
+	virtual const byte *mapRange(int64 offset, uint32 size);
+	virtual AsyncReadRequest *readAsync(int64 offset, uint32 size);
 };
 
 /**
@@ -503,7 +503,22 @@ public:
 		/**
 		* For platforms that should not have a Quit button.
 		*/
-		kFeatureNoQuit
+		kFeatureNoQuit,
+
+		/**
+		* The CPU supports the x86 SSE2 instruction set.
+		*/
+		kFeatureCpuSSE2,
+
+		/**
+		* The CPU supports the x86 AVX2 instruction set.
+		*/
+		kFeatureCpuAVX2,
+
+		/**
+		* The CPU supports the ARM NEON instruction set.
+		*/
+		kFeatureCpuNEON
 	};
 
 	/**
@@ -1423,8 +1438,9 @@ public:
 	 *
 	 * Historically, the OSystem API used to have a method that allowed
 	 * creating threads. Hence, mutex support was needed for thread syncing.
-	 * To ease portability, we decided to remove the threading API.
-	 * Instead, we now use timers (see setTimerCallback() and Common::Timer).
+	 * To ease portability, we decided to remove the general threading API.
+	 * Instead, we now use timers (see setTimerCallback() and Common::Timer),
+	 * plus optional worker threads for CPU bound tasks (see createThread()).
 	 * But since those can be implemented using threads (and in fact, that is
 	 * how our primary backend, the SDL one, does it on many systems), we
 	 * still must do mutex syncing in our timer callbacks.
@@ -1476,6 +1492,90 @@ public:
 
 	/** @} */
 
+	/**
+	 * @defgroup common_system_thread Worker threads
+	 * @ingroup common_system
+	 * @{
+	 *
+	 * Backends may optionally provide plain worker threads, which CPU bound
+	 * code (such as video decoders) can use to spread work over several cores.
+	 *
+	 * Worker threads are strictly an optimization: createThread() returns
+	 * nullptr on backends without thread support, and callers must then do
+	 * the work themselves. Code running on a worker thread must not call any
+	 * other OSystem method than the mutex and thread handling ones.
+	 */
+
+	typedef struct OpaqueThread *ThreadRef;
+
+	/** Entry point of a worker thread. */
+	typedef void (*ThreadProc)(void *param);
+
+	/**
+	 * Start a new worker thread.
+	 *
+	 * @param proc   Function to run on the new thread.
+	 * @param param  Parameter passed to @p proc.
+	 *
+	 * @return The new thread, or nullptr if threads are not supported
+	 *         or the thread could not be created.
+	 */
+	virtual ThreadRef createThread(ThreadProc proc, void *param) { return nullptr; }
+
+	/**
+	 * Wait for a worker thread to return from its entry point and release it.
+	 *
+	 * Every thread returned by createThread() must be joined exactly once.
+	 *
+	 * @param thread  The thread to join.
+	 */
+	virtual void joinThread(ThreadRef thread) {}
+
+	/**
+	 * Return the number of logical CPUs available to ScummVM.
+	 *
+	 * This is a hint for sizing pools of worker threads; backends which
+	 * cannot create threads keep the default of 1.
+	 */
+	virtual uint getCpuCount() { return 1; }
+
+	typedef struct OpaqueSemaphore *SemaphoreRef;
+
+	/**
+	 * Create a new semaphore, which worker threads can sleep on until
+	 * there is work for them.
+	 *
+	 * Backends which provide worker threads must provide semaphores too.
+	 *
+	 * @return The new semaphore, with a count of zero, or nullptr if
+	 *         threads are not supported.
+	 */
+	virtual SemaphoreRef createSemaphore() { return nullptr; }
+
+	/**
+	 * Increment the count of a semaphore, which wakes up one of the
+	 * threads waiting on it, if any.
+	 *
+	 * @param semaphore  The semaphore to post.
+	 */
+	virtual void postSemaphore(SemaphoreRef semaphore) {}
+
+	/**
+	 * Wait until the count of a semaphore is above zero, and decrement it.
+	 *
+	 * @param semaphore  The semaphore to wait on.
+	 */
+	virtual void waitSemaphore(SemaphoreRef semaphore) {}
+
+	/**
+	 * Delete a semaphore, which no thread may be waiting on.
+	 *
+	 * @param semaphore  The semaphore to delete.
+	 */
+	virtual void deleteSemaphore(SemaphoreRef semaphore) {}
+
+	/** @} */
+
 
 
 	/** @defgroup common_system_sound Sound
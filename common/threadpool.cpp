@@ -0,0 +1,252 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "common/threadpool.h"
+
+namespace Common {
+
+DECLARE_SINGLETON(ThreadPool);
+
+Task::Task() : _state(kStateCreated), _pool(nullptr), _queue(0), _prev(nullptr), _next(nullptr) {
+}
+
+Task::~Task() {
+	if (_state.load() == kStateCreated)
+		return;
+
+	// A task which is still queued is cancelled. Even once the task is
+	// done, the thread which ran it may still hold the mutex.
+	if (_pool && _pool->dequeue(this))
+		_mutex.unlock();
+	else
+		StackLock lock(_mutex);
+}
+
+void Task::wait() {
+	if (isDone())
+		return;
+
+	if (_pool && _pool->dequeue(this)) {
+		run();
+		_state.store(kStateDone);
+		_mutex.unlock();
+		return;
+	}
+
+	// The thread running the task holds the mutex until it is done
+	StackLock lock(_mutex);
+}
+
+void Task::runHere() {
+	_state.store(kStateRunning);
+	run();
+	_state.store(kStateDone);
+}
+
+ThreadPool::ThreadPool() : _workers(nullptr), _workerCount(0), _threadCount(0), _nextQueue(0), _idle(0), _stop(0), _wakeup(nullptr) {
+	startThreads(g_system->getCpuCount() - 1);
+}
+
+ThreadPool::ThreadPool(uint threadCount) : _workers(nullptr), _workerCount(0), _threadCount(0), _nextQueue(0), _idle(0), _stop(0), _wakeup(nullptr) {
+	startThreads(threadCount);
+}
+
+ThreadPool::~ThreadPool() {
+	if (!_threadCount)
+		return;
+
+	// Every worker thread either sees the flag before it sleeps, or is
+	// woken up by one of the posts
+	_stop.store(1);
+	for (uint i = 0; i < _threadCount; i++)
+		g_system->postSemaphore(_wakeup);
+	for (uint i = 0; i < _threadCount; i++)
+		g_system->joinThread(_workers[i]._thread);
+
+	g_system->deleteSemaphore(_wakeup);
+	delete[] _workers;
+}
+
+void ThreadPool::startThreads(uint threadCount) {
+	if (!threadCount)
+		return;
+
+	_wakeup = g_system->createSemaphore();
+	if (!_wakeup)
+		return;
+
+	// Worker threads look at all the queues, but tasks only go to those
+	// whose thread could be started. Those are counted separately, as the
+	// threads which started already look at the queues.
+	_workers = new Worker[threadCount];
+	for (uint i = 0; i < threadCount; i++) {
+		_workers[i]._pool = this;
+		_workers[i]._index = i;
+		_workers[i]._thread = nullptr;
+		_workers[i]._first = nullptr;
+		_workers[i]._last = nullptr;
+	}
+	_workerCount = threadCount;
+
+	for (uint i = 0; i < threadCount; i++) {
+		_workers[i]._thread = g_system->createThread(workerProc, &_workers[i]);
+		if (!_workers[i]._thread)
+			break;
+		_threadCount++;
+	}
+
+	if (!_threadCount) {
+		g_system->deleteSemaphore(_wakeup);
+		_wakeup = nullptr;
+		delete[] _workers;
+		_workers = nullptr;
+	}
+}
+
+void ThreadPool::start(Task *task) {
+	assert(task->_state.load() == Task::kStateCreated || task->_state.load() == Task::kStateDone);
+
+	task->_pool = this;
+	if (!_threadCount) {
+		task->runHere();
+		return;
+	}
+
+	Worker *worker = &_workers[_nextQueue.fetchAdd(1) % _threadCount];
+	worker->_mutex.lock();
+	task->_queue = worker->_index;
+	task->_prev = worker->_last;
+	task->_next = nullptr;
+	if (worker->_last)
+		worker->_last->_next = task;
+	else
+		worker->_first = task;
+	worker->_last = task;
+	task->_state.store(Task::kStateQueued);
+	worker->_mutex.unlock();
+
+	// Only wake up as many threads as there are tasks. A thread which is
+	// about to sleep checks the queues once it is counted as idle.
+	uint idle = _idle.load();
+	while (idle) {
+		if (_idle.compareExchange(idle, idle - 1)) {
+			g_system->postSemaphore(_wakeup);
+			break;
+		}
+	}
+}
+
+bool ThreadPool::dequeue(Task *task) {
+	if (task->_state.load() != Task::kStateQueued)
+		return false;
+
+	Worker *worker = &_workers[task->_queue];
+	StackLock lock(worker->_mutex);
+
+	if (task->_state.load() != Task::kStateQueued)
+		return false;
+
+	if (task->_prev)
+		task->_prev->_next = task->_next;
+	else
+		worker->_first = task->_next;
+	if (task->_next)
+		task->_next->_prev = task->_prev;
+	else
+		worker->_last = task->_prev;
+	task->_mutex.lock();
+	task->_state.store(Task::kStateRunning);
+	return true;
+}
+
+Task *ThreadPool::take(Worker *worker) {
+	for (uint i = 0; i < _workerCount; i++) {
+		Worker *victim = &_workers[(worker->_index + i) % _workerCount];
+		StackLock lock(victim->_mutex);
+
+		// The newest task of its own queue is the most likely to still be
+		// in the cache, the oldest tasks of the others the least likely to
+		// be waited for soon
+		Task *task = (victim == worker) ? victim->_last : victim->_first;
+		if (!task)
+			continue;
+
+		if (task->_prev)
+			task->_prev->_next = task->_next;
+		else
+			victim->_first = task->_next;
+		if (task->_next)
+			task->_next->_prev = task->_prev;
+		else
+			victim->_last = task->_prev;
+
+		// Lock the task before it leaves the queue, so that waiting for a
+		// task which is not queued any more blocks until it has run
+		task->_mutex.lock();
+		task->_state.store(Task::kStateRunning);
+		return task;
+	}
+
+	return nullptr;
+}
+
+void ThreadPool::workerProc(void *param) {
+	Worker *worker = (Worker *)param;
+	worker->_pool->work(worker);
+}
+
+void ThreadPool::work(Worker *worker) {
+	for (;;) {
+		Task *task = take(worker);
+		if (!task) {
+			if (_stop.load())
+				return;
+
+			// Tasks started from now on wake this thread up, so look at
+			// the queues once more before sleeping
+			_idle.fetchAdd(1);
+			task = take(worker);
+			if (!task && !_stop.load()) {
+				g_system->waitSemaphore(_wakeup);
+				continue;
+			}
+
+			// Take back the idle count, unless a task was started meanwhile
+			// and posted for it already
+			uint idle = _idle.load();
+			bool counted = false;
+			while (idle && !counted)
+				counted = _idle.compareExchange(idle, idle - 1);
+			if (!counted)
+				g_system->waitSemaphore(_wakeup);
+
+			if (!task)
+				return;
+		}
+
+		task->run();
+		task->_state.store(Task::kStateDone);
+		task->_mutex.unlock();
+	}
+}
+
+} // End of namespace Common
@@ -0,0 +1,338 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef COMMON_THREADPOOL_H
+#define COMMON_THREADPOOL_H
+
+#include "common/scummsys.h"
+#include "common/atomic.h"
+#include "common/mutex.h"
+#include "common/noncopyable.h"
+#include "common/singleton.h"
+#include "common/system.h"
+#include "common/util.h"
+
+namespace Common {
+
+/**
+ * @defgroup common_threadpool Thread pool
+ * @ingroup common
+ *
+ * @brief Running CPU bound work on a pool of worker threads.
+ * @{
+ */
+
+class ThreadPool;
+
+/**
+ * A piece of work which is run by a ThreadPool.
+ *
+ * Tasks are started with ThreadPool::start(), and may be started again
+ * once they are done. Waiting for a task which no worker thread has picked
+ * yet runs it on the calling thread, so tasks may start and wait for other
+ * tasks, including from within a task, without tying up the pool.
+ *
+ * Deleting a task which has not been picked yet cancels it, deleting a
+ * task which is running waits for it. Subclasses whose run() uses their
+ * own members must call wait() first in their destructor.
+ */
+class Task : NonCopyable {
+public:
+	Task();
+	virtual ~Task();
+
+	/**
+	 * Check whether the task has run, without waiting.
+	 */
+	bool isDone() const { return _state.load() == kStateDone; }
+
+	/**
+	 * Wait for the task to run. A task which has not been picked by a
+	 * worker thread yet is run on the calling thread.
+	 */
+	void wait();
+
+protected:
+	/**
+	 * Do the work. Called on a worker thread, or on the thread which
+	 * started or waits for the task.
+	 */
+	virtual void run() = 0;
+
+private:
+	friend class ThreadPool;
+
+	enum State {
+		kStateCreated,
+		kStateQueued,
+		kStateRunning,
+		kStateDone
+	};
+
+	void runHere();
+
+	Atomic<int32> _state;
+	Mutex _mutex;        ///< Held while the task runs, once it was queued
+	ThreadPool *_pool;   ///< The pool the task was last started on
+	uint _queue;         ///< The worker queue the task is in, while it is queued
+	Task *_prev;
+	Task *_next;
+};
+
+/**
+ * A task which runs a function, such as a lambda, and keeps its result.
+ *
+ * The result type must be default constructible and assignable.
+ */
+template<class T>
+class Future : public Task {
+public:
+	template<class Func>
+	explicit Future(const Func &func) : _function(new Function<Func>(func)), _result() {}
+
+	~Future() {
+		wait();
+		delete _function;
+	}
+
+	/**
+	 * Wait for the function to run, and return its result.
+	 */
+	T &get() {
+		wait();
+		return _result;
+	}
+
+protected:
+	virtual void run() override { _result = _function->call(); }
+
+private:
+	struct FunctionBase {
+		virtual ~FunctionBase() {}
+		virtual T call() = 0;
+	};
+
+	template<class Func>
+	struct Function : public FunctionBase {
+		Function(const Func &func) : _func(func) {}
+		virtual T call() override { return _func(); }
+		Func _func;
+	};
+
+	FunctionBase *_function;
+	T _result;
+};
+
+/**
+ * A task which runs a function without result.
+ */
+template<>
+class Future<void> : public Task {
+public:
+	template<class Func>
+	explicit Future(const Func &func) : _function(new Function<Func>(func)) {}
+
+	~Future() {
+		wait();
+		delete _function;
+	}
+
+	/**
+	 * Wait for the function to run.
+	 */
+	void get() { wait(); }
+
+protected:
+	virtual void run() override { _function->call(); }
+
+private:
+	struct FunctionBase {
+		virtual ~FunctionBase() {}
+		virtual void call() = 0;
+	};
+
+	template<class Func>
+	struct Function : public FunctionBase {
+		Function(const Func &func) : _func(func) {}
+		virtual void call() override { _func(); }
+		Func _func;
+	};
+
+	FunctionBase *_function;
+};
+
+/**
+ * A pool of worker threads running Tasks.
+ *
+ * Each worker thread has its own queue of tasks. Tasks are spread over
+ * the queues as they are started, and a worker thread which runs out of
+ * tasks takes the oldest ones from the queues of the others, so threads
+ * do not wait on each other as long as there is work left. Idle worker
+ * threads sleep on a semaphore until tasks are started.
+ *
+ * The default pool, returned by instance(), has one worker thread less than
+ * there are CPUs, since the thread starting tasks usually waits for them
+ * and runs the tasks which are still queued meanwhile. On backends without
+ * worker threads and on single CPU systems, it has no worker threads, and
+ * tasks run right away on the thread which starts them.
+ *
+ * instance() must be called first from the main thread. Tasks may then be
+ * started from any thread, including from within other tasks, but like
+ * any code running on a worker thread, they must not call other OSystem
+ * methods than the mutex and thread handling ones.
+ */
+class ThreadPool : public Singleton<ThreadPool> {
+public:
+	/**
+	 * Create a pool of @p threadCount worker threads, or fewer if the
+	 * backend cannot create that many.
+	 */
+	explicit ThreadPool(uint threadCount);
+
+	/**
+	 * Stop the worker threads, once they have run the tasks which are
+	 * still queued.
+	 */
+	~ThreadPool();
+
+	/**
+	 * Return the number of worker threads, which may be zero.
+	 */
+	uint getThreadCount() const { return _threadCount; }
+
+	/**
+	 * Queue a task for a worker thread, or run it right away if the pool
+	 * has no worker threads. The task must not be queued or running.
+	 */
+	void start(Task *task);
+
+	/**
+	 * Call @p func for each index from @p begin to @p end, excluding
+	 * @p end, spreading the calls over the worker threads and the calling
+	 * thread. Indices are handed out in small chunks, in no particular
+	 * order, and each one exactly once. Returns once all calls returned.
+	 */
+	template<class Func>
+	void parallelFor(int begin, int end, const Func &func);
+
+private:
+	friend class Singleton<SingletonBaseType>;
+	friend class Task;
+
+	struct Worker {
+		ThreadPool *_pool;
+		uint _index;
+		OSystem::ThreadRef _thread;
+		Mutex _mutex;   ///< Guards the queue
+		Task *_first;   ///< Oldest task, which other threads take first
+		Task *_last;    ///< Newest task, which this thread takes first
+	};
+
+	template<class Func>
+	class ParallelForTask : public Task {
+	public:
+		ParallelForTask() : _next(nullptr), _end(0), _chunk(0), _func(nullptr) {}
+		~ParallelForTask() { wait(); }
+
+		Atomic<int> *_next;
+		int _end;
+		int _chunk;
+		const Func *_func;
+
+	protected:
+		virtual void run() override {
+			for (;;) {
+				const int begin = _next->fetchAdd(_chunk);
+				if (begin >= _end)
+					return;
+				const int end = MIN(begin + _chunk, _end);
+				for (int i = begin; i < end; i++)
+					(*_func)(i);
+			}
+		}
+	};
+
+	/** The default pool, with one worker thread less than there are CPUs */
+	ThreadPool();
+
+	void startThreads(uint threadCount);
+
+	static void workerProc(void *param);
+	void work(Worker *worker);
+
+	/** Take a task from @p worker's queue, or from the other ones */
+	Task *take(Worker *worker);
+
+	/** Remove a task from its queue and lock it, if no thread picked it yet */
+	bool dequeue(Task *task);
+
+	Worker *_workers;
+	uint _workerCount;         ///< Queues, including those whose thread could not be started
+	uint _threadCount;
+	Atomic<uint> _nextQueue;
+	Atomic<uint> _idle;        ///< Worker threads which sleep, or are about to
+	Atomic<int32> _stop;
+	OSystem::SemaphoreRef _wakeup;
+};
+
+template<class Func>
+void ThreadPool::parallelFor(int begin, int end, const Func &func) {
+	if (begin >= end)
+		return;
+
+	// Chunks of several indices make for fewer atomic operations, while
+	// still leaving enough of them to even out the threads
+	const int count = end - begin;
+	const int chunk = MAX(1, count / (int)((_threadCount + 1) * 8));
+	const uint helperCount = MIN<uint>(_threadCount, (count - 1) / chunk);
+
+	if (!helperCount) {
+		for (int i = begin; i < end; i++)
+			func(i);
+		return;
+	}
+
+	Atomic<int> next(begin);
+	ParallelForTask<Func> *helpers = new ParallelForTask<Func>[helperCount + 1];
+	for (uint i = 0; i <= helperCount; i++) {
+		helpers[i]._next = &next;
+		helpers[i]._end = end;
+		helpers[i]._chunk = chunk;
+		helpers[i]._func = &func;
+		if (i < helperCount)
+			start(&helpers[i]);
+	}
+
+	// The calling thread takes chunks too, then takes back the helpers
+	// which are still queued
+	helpers[helperCount].runHere();
+	for (uint i = 0; i < helperCount; i++)
+		helpers[i].wait();
+
+	delete[] helpers;
+}
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
@@ -106,6 +106,10 @@ typedef struct {
 #include "common/fs.h"
 #include "common/unzip.h"
 #include "common/memstream.h"
+#include "common/mutex.h"
+#include "common/ptr.h"
+#include "common/substream.h"
+#include "common/zlib.h"
 
 #include "common/hashmap.h"
 #include "common/hash-str.h"
@@ -273,6 +277,13 @@ int unzOpenCurrentFile(unzFile file);
   If there is no error, the return value is UNZ_OK.
 */
 
+int unzGetCurrentFileDataOffset(unzFile file, uLong *poffset);
+/*
+  Get the position of the data of the current file in the stream of the
+  zipfile, after checking its local header like unzOpenCurrentFile does.
+  If there is no error, the return value is UNZ_OK.
+*/
+
 int unzCloseCurrentFile(unzFile file);
 /*
   Close the file in zip opened with unzOpenCurrentFile
@@ -378,10 +389,21 @@ typedef struct {
 typedef Common::HashMap<Common::String, cached_file_in_zip, Common::IgnoreCase_Hash,
 	Common::IgnoreCase_EqualTo> ZipHash;
 
+/* zip_stream_s contain the stream of the zipfile, which the streams of its
+   members share so that they can outlive it, and the mutex which serializes
+   the use of the stream */
+typedef struct zip_stream_s {
+	Common::ScopedPtr<Common::SeekableReadStream> _stream;
+	Common::Mutex _mutex;
+
+	zip_stream_s(Common::SeekableReadStream *stream) : _stream(stream) {}
+} zip_stream_s;
+
 /* unz_s contain internal information about the zipfile
 */
 typedef struct {
 	Common::SeekableReadStream *_stream;				/* io structore of the zipfile */
+	Common::SharedPtr<zip_stream_s> _sharedStream;	/* owner of _stream */
 	unz_global_info gi;				/* public global information */
 	uLong byte_before_the_zipfile;	/* byte before the zipfile, (>0 for sfx)*/
 	uLong num_file;					/* number of the current file in the zipfile*/
@@ -543,6 +565,7 @@ unzFile unzOpen(Common::SeekableReadStream *stream) {
 
 	int err=UNZ_OK;
 
+	us->_sharedStream = Common::SharedPtr<zip_stream_s>(new zip_stream_s(stream));
 	us->_stream = stream;
 
 	central_pos = unzlocal_SearchCentralDir(*us->_stream);
@@ -595,7 +618,6 @@ unzFile unzOpen(Common::SeekableReadStream *stream) {
 		err=UNZ_BADZIPFILE;
 
 	if (err != UNZ_OK) {
-		delete us->_stream;
 		delete us;
 		return nullptr;
 	}
@@ -644,7 +666,6 @@ int unzClose(unzFile file) {
 	if (s->pfile_in_zip_read != nullptr)
 		unzCloseCurrentFile(file);
 
-	delete s->_stream;
 	delete s;
 	return UNZ_OK;
 }
@@ -1125,6 +1146,32 @@ int unzOpenCurrentFile (unzFile file) {
 }
 
 
+/*
+  Get the position of the data of the current file in the stream of the
+  zipfile, after checking its local header like unzOpenCurrentFile does.
+  If there is no error, the return value is UNZ_OK.
+*/
+int unzGetCurrentFileDataOffset(unzFile file, uLong *poffset) {
+	uInt iSizeVar;
+	unz_s* s;
+	uLong offset_local_extrafield;  /* offset of the local extra field */
+	uInt  size_local_extrafield;    /* size of the local extra field */
+
+	if (file==nullptr)
+		return UNZ_PARAMERROR;
+	s=(unz_s*)file;
+	if (!s->current_file_ok)
+		return UNZ_PARAMERROR;
+
+	if (unzlocal_CheckCurrentFileCoherencyHeader(s,&iSizeVar,
+				&offset_local_extrafield,&size_local_extrafield)!=UNZ_OK)
+		return UNZ_BADZIPFILE;
+
+	*poffset = s->cur_file_info_internal.offset_curfile + SIZEZIPLOCALHEADER + iSizeVar +
+		s->byte_before_the_zipfile;
+	return UNZ_OK;
+}
+
 /*
   Read bytes from the current file.
   buf contain buffer where data must be copied
@@ -1453,6 +1500,91 @@ public:
 };
 */
 
+/**
+ * A substream of the stream of a ZIP archive. It can be used alongside the
+ * other streams of the archive, from any thread, and keeps the archive stream
+ * alive after the archive is deleted.
+ */
+class ZipMemberReadStream : public SeekableSubReadStream {
+	SharedPtr<zip_stream_s> _zipStream;
+
+public:
+	// The caller must hold the lock of the archive stream
+	ZipMemberReadStream(const SharedPtr<zip_stream_s> &zipStream, uint32 begin, uint32 end)
+		: SeekableSubReadStream(zipStream->_stream.get(), begin, end), _zipStream(zipStream) {
+	}
+
+	virtual uint32 read(void *dataPtr, uint32 dataSize) {
+		StackLock lock(_zipStream->_mutex);
+
+		// Make sure the archive stream is at the right position
+		SeekableSubReadStream::seek(0, SEEK_CUR);
+		return SeekableSubReadStream::read(dataPtr, dataSize);
+	}
+
+	virtual bool seek(int64 offset, int whence = SEEK_SET) {
+		StackLock lock(_zipStream->_mutex);
+		return SeekableSubReadStream::seek(offset, whence);
+	}
+
+	virtual AsyncReadRequest *readAsync(int64 offset, uint32 size) {
+		// The request may read synchronously through the archive stream
+		StackLock lock(_zipStream->_mutex);
+		return SeekableSubReadStream::readAsync(offset, size);
+	}
+};
+
+#ifdef USE_ZLIB
+/**
+ * Checks the CRC of a member once all of it has been read in order.
+ *
+ * Only the data read through read() from the start of the member is checked:
+ * the CRC can not be checked if a part of the member is skipped, or only read
+ * through mapRange() or readAsync().
+ */
+class ZipMemberCheckReadStream : public SeekableReadStream {
+	ScopedPtr<SeekableReadStream> _member;
+	String _name;
+	uint32 _expectedCrc;
+	uLong _crc;
+	int64 _crcPos;
+	bool _crcErr;
+
+public:
+	ZipMemberCheckReadStream(SeekableReadStream *member, const String &name, uint32 expectedCrc)
+		: _member(member), _name(name), _expectedCrc(expectedCrc), _crc(crc32(0L, Z_NULL, 0)), _crcPos(0), _crcErr(false) {
+	}
+
+	virtual uint32 read(void *dataPtr, uint32 dataSize) {
+		const int64 start = _member->pos();
+		const uint32 actual = _member->read(dataPtr, dataSize);
+
+		// Only extend the CRC with data following what was checked so far
+		if (start <= _crcPos && start + actual > _crcPos) {
+			const uint32 skip = (uint32)(_crcPos - start);
+			_crc = crc32(_crc, (const Bytef *)dataPtr + skip, actual - skip);
+			_crcPos = start + actual;
+
+			if (_crcPos == _member->size() && _crc != _expectedCrc) {
+				warning("ZipArchive: CRC mismatch in '%s'", _name.c_str());
+				_crcErr = true;
+			}
+		}
+
+		return actual;
+	}
+
+	virtual bool err() const { return _crcErr || _member->err(); }
+	virtual void clearErr() { _crcErr = false; _member->clearErr(); }
+	virtual bool eos() const { return _member->eos(); }
+	virtual int64 pos() const { return _member->pos(); }
+	virtual int64 size() const { return _member->size(); }
+	virtual bool seek(int64 offset, int whence = SEEK_SET) { return _member->seek(offset, whence); }
+	virtual const byte *mapRange(int64 offset, uint32 size) { return _member->mapRange(offset, size); }
+	virtual AsyncReadRequest *readAsync(int64 offset, uint32 size) { return _member->readAsync(offset, size); }
+};
+#endif
+
 ZipArchive::ZipArchive(unzFile zipFile) : _zipFile(zipFile) {
 	assert(_zipFile);
 }
@@ -1462,6 +1594,9 @@ ZipArchive::~ZipArchive() {
 }
 
 bool ZipArchive::hasFile(const String &name) const {
+	const unz_s *const archive = (const unz_s *)_zipFile;
+	StackLock lock(archive->_sharedStream->_mutex);
+
 	return (unzLocateFile(_zipFile, name.c_str(), 2) == UNZ_OK);
 }
 
@@ -1486,35 +1621,35 @@ const ArchiveMemberPtr ZipArchive::getMember(const String &name) const {
 }
 
 SeekableReadStream *ZipArchive::createReadStreamForMember(const String &name) const {
+	const unz_s *const archive = (const unz_s *)_zipFile;
+	StackLock lock(archive->_sharedStream->_mutex);
+
 	if (unzLocateFile(_zipFile, name.c_str(), 2) != UNZ_OK)
 		return nullptr;
 
 	unz_file_info fileInfo;
-	if (unzOpenCurrentFile(_zipFile) != UNZ_OK)
-		return nullptr;
-
 	if (unzGetCurrentFileInfo(_zipFile, &fileInfo, nullptr, 0, nullptr, 0, nullptr, 0) != UNZ_OK)
 		return nullptr;
 
-	byte *buffer = (byte *)malloc(fileInfo.uncompressed_size);
-	assert(buffer);
-
-	if (unzReadCurrentFile(_zipFile, buffer, fileInfo.uncompressed_size) != (int)fileInfo.uncompressed_size) {
-		free(buffer);
+	uLong offset;
+	if (unzGetCurrentFileDataOffset(_zipFile, &offset) != UNZ_OK)
 		return nullptr;
-	}
 
-	if (unzCloseCurrentFile(_zipFile) != UNZ_OK) {
-		free(buffer);
+	if (offset + fileInfo.compressed_size > (uLong)archive->_stream->size())
 		return nullptr;
-	}
 
-	return new MemoryReadStream(buffer, fileInfo.uncompressed_size, DisposeAfterUse::YES);
+	// Members are read straight from the archive, deflated ones are
+	// inflated as they are read
+	SeekableReadStream *stream = new ZipMemberReadStream(archive->_sharedStream, offset, offset + fileInfo.compressed_size);
+	if (fileInfo.compression_method == Z_DEFLATED)
+		stream = wrapDeflateReadStream(stream, fileInfo.uncompressed_size);
+
+#ifdef USE_ZLIB
+	if (stream)
+		stream = new ZipMemberCheckReadStream(stream, name, fileInfo.crc);
+#endif
 
-	// FIXME: instead of reading all into a memory stream, we could
-	// instead create a new ZipStream class. But then we have to be
-	// careful to handle the case where the client code opens multiple
-	// files in the archive and tries to use them independently.
+	return stream;
 }
 
 Archive *makeZipArchive(const String &name) {
@@ -24,6 +24,7 @@
 #define FORBIDDEN_SYMBOL_ALLOW_ALL
 
 #include "common/zlib.h"
+#include "common/array.h"
 #include "common/ptr.h"
 #include "common/util.h"
 #include "common/stream.h"
@@ -222,15 +223,36 @@ bool inflateZlibHeaderless(Common::WriteStream *dst, Common::SeekableReadStream
 static bool _shownBackwardSeekingWarning = false;
 #endif
 
+// inflateGetDictionary() and inflatePrime() are needed to resume inflating
+// from the middle of the data
+#if ZLIB_VERNUM >= 0x1271
+#define GZIP_CHECKPOINTS
+#endif
+
 /**
  * A simple wrapper class which can be used to wrap around an arbitrary
  * other SeekableReadStream and will then provide on-the-fly decompression support.
- * Assumes the compressed data to be in gzip format.
+ * Assumes the compressed data to be in gzip format, or to be raw deflate data.
+ *
+ * The state of the decompression is saved at the first block boundary after
+ * every CHECKPOINT_SPAN bytes of output while reading. Seeks then resume from
+ * the nearest checkpoint instead of decompressing everything from the start.
  */
 class GZipReadStream : public SeekableReadStream {
 protected:
 	enum {
-		BUFSIZE = 16384		// 1 << MAX_WBITS
+		BUFSIZE = 16384,		// 1 << MAX_WBITS
+		WINDOWSIZE = 32768,		// 1 << MAX_WBITS, the longest back reference
+		CHECKPOINT_SPAN = 1 << 20
+	};
+
+	/** Everything needed to resume decompressing at a deflate block boundary */
+	struct Checkpoint {
+		uint32 inPos;		///< Position of the first whole byte of the block in the wrapped stream
+		uint32 outPos;		///< Position of the block in the decompressed data
+		uint bits;			///< Bits of the block in the byte before inPos
+		uint windowSize;
+		byte *window;		///< The last decompressed bytes before outPos
 	};
 
 	byte	_buf[BUFSIZE];
@@ -241,37 +263,106 @@ protected:
 	uint32 _pos;
 	uint32 _origSize;
 	bool _eos;
+	bool _raw;
+	Array<Checkpoint> _checkpoints;
+
+#ifdef GZIP_CHECKPOINTS
+	void addCheckpoint(uint32 outPos) {
+		const uint bits = _stream.data_type & 7;
+		// The partial byte must still be in the buffer
+		if (bits && _stream.next_in == _buf)
+			return;
+
+		Checkpoint checkpoint;
+		checkpoint.inPos = _wrapped->pos() - _stream.avail_in;
+		checkpoint.outPos = outPos;
+		checkpoint.bits = bits;
+		checkpoint.window = new byte[WINDOWSIZE];
+		uInt windowSize = WINDOWSIZE;
+		inflateGetDictionary(&_stream, checkpoint.window, &windowSize);
+		checkpoint.windowSize = windowSize;
+		_checkpoints.push_back(checkpoint);
+	}
+
+	bool restoreCheckpoint(const Checkpoint &checkpoint) {
+		_wrapped->seek(checkpoint.inPos - (checkpoint.bits ? 1 : 0), SEEK_SET);
+		// Checkpoints are past any header, so resume without one. The
+		// trailer of gzip and zlib data is then not checked any more.
+		_zlibErr = inflateReset2(&_stream, -MAX_WBITS);
+		if (_zlibErr != Z_OK)
+			return false;
+
+		if (checkpoint.bits) {
+			const byte partial = _wrapped->readByte();
+			_zlibErr = inflatePrime(&_stream, checkpoint.bits, partial >> (8 - checkpoint.bits));
+			if (_zlibErr != Z_OK)
+				return false;
+		}
+
+		_zlibErr = inflateSetDictionary(&_stream, checkpoint.window, checkpoint.windowSize);
+		if (_zlibErr != Z_OK)
+			return false;
+
+		_stream.next_in = _buf;
+		_stream.avail_in = 0;
+		_pos = checkpoint.outPos;
+		return true;
+	}
+
+	/** Returns the last checkpoint at or before pos, or nullptr if there is none */
+	const Checkpoint *findCheckpoint(uint32 pos) const {
+		uint first = 0, last = _checkpoints.size();
+		while (first < last) {
+			const uint middle = (first + last) / 2;
+			if (_checkpoints[middle].outPos <= pos)
+				first = middle + 1;
+			else
+				last = middle;
+		}
+		return first ? &_checkpoints[first - 1] : nullptr;
+	}
+#endif
 
 public:
 
-	GZipReadStream(SeekableReadStream *w, uint32 knownSize = 0) : _wrapped(w), _stream() {
+	GZipReadStream(SeekableReadStream *w, uint32 knownSize = 0, bool raw = false) : _wrapped(w), _stream(), _raw(raw) {
 		assert(w != nullptr);
 
-		// Verify file header is correct
-		w->seek(0, SEEK_SET);
-		uint16 header = w->readUint16BE();
-		assert(header == 0x1F8B ||
-		       ((header & 0x0F00) == 0x0800 && header % 31 == 0));
-
-		if (header == 0x1F8B) {
-			// Retrieve the original file size
-			w->seek(-4, SEEK_END);
-			_origSize = w->readUint32LE();
-		} else {
-			// Original size not available in zlib format
-			// use an otherwise known size if supplied.
+		if (raw) {
+			// Raw deflate data has neither header nor size
 			_origSize = knownSize;
+		} else {
+			// Verify file header is correct
+			w->seek(0, SEEK_SET);
+			uint16 header = w->readUint16BE();
+			assert(header == 0x1F8B ||
+			       ((header & 0x0F00) == 0x0800 && header % 31 == 0));
+
+			if (header == 0x1F8B) {
+				// Retrieve the original file size
+				w->seek(-4, SEEK_END);
+				_origSize = w->readUint32LE();
+			} else {
+				// Original size not available in zlib format
+				// use an otherwise known size if supplied.
+				_origSize = knownSize;
+			}
 		}
 		_pos = 0;
 		w->seek(0, SEEK_SET);
 		_eos = false;
 
-		// Adding 32 to windowBits indicates to zlib that it is supposed to
-		// automatically detect whether gzip or zlib headers are used for
-		// the compressed file. This feature was added in zlib 1.2.0.4,
-		// released 10 August 2003.
-		// Note: This is *crucial* for savegame compatibility, do *not* remove!
-		_zlibErr = inflateInit2(&_stream, MAX_WBITS + 32);
+		if (raw) {
+			// Negative MAX_WBITS tells zlib there's no header
+			_zlibErr = inflateInit2(&_stream, -MAX_WBITS);
+		} else {
+			// Adding 32 to windowBits indicates to zlib that it is supposed to
+			// automatically detect whether gzip or zlib headers are used for
+			// the compressed file. This feature was added in zlib 1.2.0.4,
+			// released 10 August 2003.
+			// Note: This is *crucial* for savegame compatibility, do *not* remove!
+			_zlibErr = inflateInit2(&_stream, MAX_WBITS + 32);
+		}
 		if (_zlibErr != Z_OK)
 			return;
 
@@ -282,6 +373,9 @@ public:
 
 	~GZipReadStream() {
 		inflateEnd(&_stream);
+
+		for (uint i = 0; i < _checkpoints.size(); i++)
+			delete[] _checkpoints[i].window;
 	}
 
 	bool err() const { return (_zlibErr != Z_OK) && (_zlibErr != Z_STREAM_END); }
@@ -294,6 +388,13 @@ public:
 		_stream.next_out = (byte *)dataPtr;
 		_stream.avail_out = dataSize;
 
+#ifdef GZIP_CHECKPOINTS
+		// Stop at the end of each block, to see where checkpoints can be made
+		const int flush = Z_BLOCK;
+#else
+		const int flush = Z_NO_FLUSH;
+#endif
+
 		// Keep going while we get no error
 		while (_zlibErr == Z_OK && _stream.avail_out) {
 			if (_stream.avail_in == 0 && !_wrapped->eos()) {
@@ -301,7 +402,17 @@ public:
 				_stream.next_in = _buf;
 				_stream.avail_in = _wrapped->read(_buf, BUFSIZE);
 			}
-			_zlibErr = inflate(&_stream, Z_NO_FLUSH);
+			_zlibErr = inflate(&_stream, flush);
+
+#ifdef GZIP_CHECKPOINTS
+			// At the end of a block, unless it is the last one
+			if (_zlibErr == Z_OK && (_stream.data_type & 128) && !(_stream.data_type & 64)) {
+				const uint32 outPos = _pos + dataSize - _stream.avail_out;
+				const uint32 lastPos = _checkpoints.empty() ? 0 : _checkpoints.back().outPos;
+				if (outPos >= lastPos + CHECKPOINT_SPAN)
+					addCheckpoint(outPos);
+			}
+#endif
 		}
 
 		// Update the position counter
@@ -341,6 +452,16 @@ public:
 
 		assert(newPos >= 0);
 
+#ifdef GZIP_CHECKPOINTS
+		// Resume from the nearest checkpoint, unless the current position
+		// is nearer
+		const Checkpoint *checkpoint = findCheckpoint(newPos);
+		if (checkpoint && (checkpoint->outPos > _pos || (uint32)newPos < _pos)) {
+			if (!restoreCheckpoint(*checkpoint))
+				return false; // FIXME: STREAM REWRITE
+		}
+#endif
+
 		if ((uint32)newPos < _pos) {
 			// To search backward, we have to restart the whole decompression
 			// from the start of the file. A rather wasteful operation, best
@@ -358,7 +479,12 @@ public:
 
 			_pos = 0;
 			_wrapped->seek(0, SEEK_SET);
+#ifdef GZIP_CHECKPOINTS
+			// A checkpoint may have switched to raw deflate data
+			_zlibErr = inflateReset2(&_stream, _raw ? -MAX_WBITS : MAX_WBITS + 32);
+#else
 			_zlibErr = inflateReset(&_stream);
+#endif
 			if (_zlibErr != Z_OK)
 				return false; // FIXME: STREAM REWRITE
 			_stream.next_in = _buf;
@@ -515,6 +641,22 @@ SeekableReadStream *wrapCompressedReadStream(SeekableReadStream *toBeWrapped, ui
 	return toBeWrapped;
 }
 
+SeekableReadStream *wrapDeflateReadStream(SeekableReadStream *toBeWrapped, uint32 knownSize) {
+	if (toBeWrapped) {
+		if (toBeWrapped->err()) {
+			delete toBeWrapped;
+			return nullptr;
+		}
+#if defined(USE_ZLIB)
+		return new GZipReadStream(toBeWrapped, knownSize, true);
+#else
+		delete toBeWrapped;
+		return nullptr;
+#endif
+	}
+	return nullptr;
+}
+
 WriteStream *wrapCompressedWriteStream(WriteStream *toBeWrapped) {
 #if defined(USE_ZLIB)
 	if (toBeWrapped)
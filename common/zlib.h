@@ -134,6 +134,10 @@ bool inflateZlibHeaderless(Common::WriteStream *dst, Common::SeekableReadStream
  * here. knownSize will be ignored if the GZip-stream DOES include a length.
  * The created stream also becomes responsible for freeing the passed stream.
  *
+ * Seeking backwards, or far ahead into data which was already decompressed
+ * once, does not start over from the beginning: about every megabyte, the
+ * stream remembers the state needed to resume decompression there.
+ *
  * It is safe to call this with a NULL parameter (in this case, NULL is
  * returned).
  *
@@ -142,6 +146,25 @@ bool inflateZlibHeaderless(Common::WriteStream *dst, Common::SeekableReadStream
  */
 SeekableReadStream *wrapCompressedReadStream(SeekableReadStream *toBeWrapped, uint32 knownSize = 0);
 
+/**
+ * Take an arbitrary SeekableReadStream of raw deflate data, without zlib or
+ * gzip header, and wrap it in a custom stream which provides transparent
+ * on-the-fly decompression. Like ZIP archives, raw deflate data does not
+ * carry its decompressed length, so it has to be supplied as knownSize.
+ * The created stream also becomes responsible for freeing the passed stream.
+ *
+ * Seeking in the created stream resumes decompression from checkpoints saved
+ * while reading, rather than from the start of the data.
+ *
+ * It is safe to call this with a NULL parameter (in this case, NULL is
+ * returned). Without ZLIB support, NULL is returned and the stream is
+ * destroyed.
+ *
+ * @param toBeWrapped	the stream of raw deflate data to be wrapped
+ * @param knownSize		the length of the decompressed data
+ */
+SeekableReadStream *wrapDeflateReadStream(SeekableReadStream *toBeWrapped, uint32 knownSize);
+
 /**
  * Take an arbitrary WriteStream and wrap it in a custom stream which provides
  * transparent on-the-fly compression. The compressed data is written in the
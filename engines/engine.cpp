@@ -34,12 +34,14 @@
 #include "common/config-manager.h"
 #include "common/events.h"
 #include "common/file.h"
+#include "common/fs.h"
 #include "common/system.h"
 #include "common/str.h"
 #include "common/ustr.h"
 #include "common/error.h"
 #include "common/list.h"
 #include "common/memstream.h"
+#include "common/ptr.h"
 #include "common/savefile.h"
 #include "common/scummsys.h"
 #include "common/taskbar.h"
@@ -191,7 +193,28 @@ Engine::~Engine() {
 }
 
 void Engine::initializePath(const Common::FSNode &gamePath) {
-	SearchMan.addDirectory(gamePath.getPath(), gamePath, 0, 4);
+	if (!ConfMan.getBool("directory_cache")) {
+		SearchMan.addDirectory(gamePath.getPath(), gamePath, 0, 4);
+		return;
+	}
+
+	if (!gamePath.exists() || !gamePath.isDirectory())
+		return;
+
+	// Reuse the listings of the game directories from the last run, and only
+	// write them back if some directory changed since then
+	Common::FSDirectory *dir = new Common::FSDirectory(gamePath, 4);
+	const Common::String cacheName = "dircache-" + ConfMan.getActiveDomainName();
+
+	Common::ScopedPtr<Common::InSaveFile> cacheIn(_saveFileMan->openForLoading(cacheName));
+	dir->loadListingCache(cacheIn.get());
+	if (dir->listingCacheChanged()) {
+		Common::ScopedPtr<Common::OutSaveFile> cacheOut(_saveFileMan->openForSaving(cacheName, false));
+		if (cacheOut && dir->saveListingCache(cacheOut.get()))
+			cacheOut->finalize();
+	}
+
+	SearchMan.add(gamePath.getPath(), dir);
 }
 
 void initCommonGFX() {
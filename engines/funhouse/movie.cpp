@@ -179,7 +179,7 @@ void Movie::playMode() {
 
 void Movie::loadAudio() {
 	if (!_audioStream) {
-		_audioStream = Audio::makeQueuingAudioStream(22050, false);
+		_audioStream = Audio::makeLockFreeQueuingAudioStream(22050, false);
 		fillAudioQueue();
 	}
 }
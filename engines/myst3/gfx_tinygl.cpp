@@ -65,6 +65,7 @@ void TinyGLRenderer::init() {
 	_fb = new TinyGL::FrameBuffer(kOriginalWidth, kOriginalHeight, g_system->getScreenFormat());
 	TinyGL::glInit(_fb, 512);
 	tglEnableDirtyRects(ConfMan.getBool("dirtyrects"));
+	tglSetRenderThreadCount(g_system->getCpuCount());
 
 	tglMatrixMode(TGL_PROJECTION);
 	tglLoadIdentity();
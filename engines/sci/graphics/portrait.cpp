@@ -93,19 +93,28 @@ void Portrait::init() {
 		if (!file)
 			error("portrait %s.bin not found", _resourceName.c_str());
 	}
-	_fileData->allocateFromStream(*file, Common::kSpanMaxSize, fileName);
-	delete file;
 
-	if (strncmp((const char *)_fileData->getUnsafeDataAt(0, 3), "WIN", 3)) {
+	// Parse the file in place if it can be mapped, keeping it open
+	const byte *mappedData = file->mapRange(0, file->size());
+	if (mappedData) {
+		_file.reset(file);
+		_fileData = SciSpan<const byte>(mappedData, file->size(), fileName);
+	} else {
+		_fileBuffer->allocateFromStream(*file, Common::kSpanMaxSize, fileName);
+		_fileData = *_fileBuffer;
+		delete file;
+	}
+
+	if (strncmp((const char *)_fileData.getUnsafeDataAt(0, 3), "WIN", 3)) {
 		error("portrait %s doesn't have valid header", _resourceName.c_str());
 	}
-	_width = _fileData->getUint16LEAt(3);
-	_height = _fileData->getUint16LEAt(5);
-	_bitmaps.resize(_fileData->getUint16LEAt(7));
-	_lipSyncIDCount = _fileData->getUint16LEAt(11);
+	_width = _fileData.getUint16LEAt(3);
+	_height = _fileData.getUint16LEAt(5);
+	_bitmaps.resize(_fileData.getUint16LEAt(7));
+	_lipSyncIDCount = _fileData.getUint16LEAt(11);
 
-	uint16 portraitPaletteSize = _fileData->getUint16LEAt(13);
-	SciSpan<const byte> data = _fileData->subspan(17);
+	uint16 portraitPaletteSize = _fileData.getUint16LEAt(13);
+	SciSpan<const byte> data = _fileData.subspan(17);
 	// Read palette
 	memset(&_portraitPalette, 0, sizeof(Palette));
 	uint16 palSize = 0, palNr = 0;
@@ -23,6 +23,9 @@
 #ifndef SCI_GRAPHICS_PORTRAITS_H
 #define SCI_GRAPHICS_PORTRAITS_H
 
+#include "common/ptr.h"
+#include "common/stream.h"
+
 #include "sci/util.h"
 
 namespace Sci {
@@ -71,7 +74,9 @@ private:
 
 	Common::String _resourceName;
 
-	Common::SpanOwner<SciSpan<const byte> > _fileData;
+	Common::ScopedPtr<Common::SeekableReadStream> _file;
+	Common::SpanOwner<SciSpan<const byte> > _fileBuffer;
+	SciSpan<const byte> _fileData;
 
 	uint32 _lipSyncIDCount;
 	SciSpan<const byte> _lipSyncIDTable;
@@ -43,6 +43,8 @@ FMVScreen::FMVScreen(Gfx::Driver *gfx, Cursor *cursor) :
 	_decoder = new Video::BinkDecoder();
 	_decoder->setDefaultHighColorFormat(Gfx::Driver::getRGBAPixelFormat());
 	_decoder->setSoundType(Audio::Mixer::kSFXSoundType);
+	// Decode a few frames in advance, so the costly ones do not stall playback
+	_decoder->setDecodeAhead(4);
 
 	_texture = _gfx->createTexture();
 	_texture->setSamplingFilter(StarkSettings->getImageSamplingFilter());
@@ -27,12 +27,14 @@
 #include "engines/engine.h"
 
 #include "testbed/graphics.h"
+#include "testbed/testbed.h"
 #include "testbed/testsuite.h"
 
 #include "graphics/cursorman.h"
 #include "graphics/fontman.h"
 #include "graphics/palette.h"
 #include "graphics/surface.h"
+#include "graphics/transparent_surface.h"
 #include "graphics/VectorRendererSpec.h"
 
 namespace Testbed {
@@ -1518,4 +1520,62 @@ void GFXtests::showPixelFormat(const Graphics::PixelFormat &pf, uint aLoss) {
 	g_system->updateScreen();
 }
 
+void TestbedEngine::blitBenchmark() {
+	static const char *const levelNames[] = { "plain", "SSE2", "AVX2", "NEON" };
+	static const char *const modeNames[] = { "alpha", "additive", "subtractive", "multiply" };
+	static const Graphics::TSpriteBlendMode modes[] = {
+		Graphics::BLEND_NORMAL, Graphics::BLEND_ADDITIVE, Graphics::BLEND_SUBTRACTIVE, Graphics::BLEND_MULTIPLY
+	};
+	// Cursor, character and full screen overlay sized sprites
+	static const int sizes[] = { 32, 128, 640 };
+	const int pixelsPerSize = 640 * 480 * 100;
+
+	const Graphics::PixelFormat format = Graphics::TransparentSurface::getSupportedPixelFormat();
+	Graphics::Surface target;
+	target.create(640, 480, format);
+	target.fillRect(Common::Rect(640, 480), format.ARGBToColor(255, 40, 80, 120));
+
+	Graphics::TransparentSurface::SIMDLevel defaultLevel = Graphics::TransparentSurface::getSIMDLevel();
+
+	for (uint s = 0; s < ARRAYSIZE(sizes); s++) {
+		const int size = sizes[s];
+		const int blits = pixelsPerSize / (size * size);
+
+		// Anti-aliased disc on a transparent background, like most sprites
+		Graphics::TransparentSurface sprite;
+		sprite.create(size, MIN(size, 480), format);
+		for (int y = 0; y < sprite.h; y++) {
+			for (int x = 0; x < sprite.w; x++) {
+				const int dx = 2 * x - size, dy = 2 * y - sprite.h;
+				const int alpha = CLIP(size * size / 2 - (dx * dx + dy * dy) / 2, 0, 255);
+				*(uint32 *)sprite.getBasePtr(x, y) = format.ARGBToColor(alpha, x * 255 / size, y * 255 / sprite.h, 128);
+			}
+		}
+
+		for (uint m = 0; m < ARRAYSIZE(modes); m++) {
+			for (int colorMod = 0; colorMod < 2; colorMod++) {
+				const uint color = colorMod ? TS_ARGB(192, 255, 128, 64) : TS_ARGB(255, 255, 255, 255);
+
+				for (int level = Graphics::TransparentSurface::kSIMDNone; level <= Graphics::TransparentSurface::kSIMDNEON; level++) {
+					if (!Graphics::TransparentSurface::setSIMDLevel((Graphics::TransparentSurface::SIMDLevel)level))
+						continue;
+
+					uint32 start = g_system->getMillis();
+					for (int i = 0; i < blits; i++)
+						sprite.blit(target, (i * 37) % (640 - sprite.w + 1), (i * 23) % (480 - sprite.h + 1), Graphics::FLIP_NONE, nullptr, color, -1, -1, modes[m]);
+					uint32 time = MAX<uint32>(g_system->getMillis() - start, 1);
+
+					Testsuite::logPrintf("%dx%d sprites, %s%s with %s: %.2f Mpixels/s\n", sprite.w, sprite.h, modeNames[m],
+						colorMod ? " and color modulation" : "", levelNames[level], (double)blits * sprite.w * sprite.h / time / 1000);
+				}
+			}
+		}
+
+		sprite.free();
+	}
+
+	Graphics::TransparentSurface::setSIMDLevel(defaultLevel);
+	target.free();
+}
+
 } // End of namespace Testbed
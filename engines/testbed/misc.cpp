@@ -21,6 +21,10 @@
  */
 
 #include "testbed/misc.h"
+#include "testbed/testbed.h"
+#include "common/flat-hashmap.h"
+#include "common/hash-str.h"
+#include "common/threadpool.h"
 #include "common/timer.h"
 
 namespace Testbed {
@@ -190,4 +194,136 @@ MiscTestSuite::MiscTestSuite() {
 	addTest("openUrl", &MiscTests::testOpenUrl, true);
 }
 
+template<class Map, class Key>
+static void benchmarkMap(const char *name, const Common::Array<Key> &keys, const Common::Array<Key> &missing) {
+	const int rounds = 20;
+	uint32 start = g_system->getMillis();
+	Map *maps[rounds];
+	for (int r = 0; r < rounds; r++) {
+		maps[r] = new Map();
+		for (uint i = 0; i < keys.size(); i++)
+			(*maps[r])[keys[i]] = i;
+	}
+	const uint32 insertTime = g_system->getMillis() - start;
+
+	start = g_system->getMillis();
+	uint found = 0;
+	for (int r = 0; r < rounds; r++) {
+		for (uint i = 0; i < keys.size(); i++)
+			found += maps[r]->contains(keys[i]);
+		for (uint i = 0; i < missing.size(); i++)
+			found += maps[r]->contains(missing[i]);
+	}
+	const uint32 lookupTime = g_system->getMillis() - start;
+
+	start = g_system->getMillis();
+	for (int r = 0; r < rounds; r++) {
+		for (uint i = 0; i < keys.size(); i += 2)
+			maps[r]->erase(keys[i]);
+		delete maps[r];
+	}
+	const uint32 eraseTime = g_system->getMillis() - start;
+
+	Testsuite::logPrintf("%s: %d keys %d times, insert %d ms, lookup %d ms (%d found), erase %d ms\n", name, keys.size(), rounds,
+		insertTime, lookupTime, found, eraseTime);
+}
+
+void TestbedEngine::hashMapBenchmark() {
+	const uint count = 200000;
+
+	// Sequential integers like script and resource numbers, random ones
+	// like offsets, integers which only differ in their high bits like
+	// aligned addresses, and strings like file names
+	Common::Array<uint32> sequential, sequentialMissing, random, randomMissing, strided, stridedMissing;
+	Common::Array<Common::String> strings, stringsMissing;
+	uint32 seed = 1;
+	for (uint i = 0; i < count; i++) {
+		sequential.push_back(i);
+		sequentialMissing.push_back(count + i);
+		seed = seed * 1103515245 + 12345;
+		random.push_back(seed);
+		randomMissing.push_back(seed ^ 0x5A5A5A5A);
+		strided.push_back(i << 12);
+		stridedMissing.push_back((i << 12) | 0x800);
+		strings.push_back(Common::String::format("resource.%03d/%u", i % 1000, seed));
+		stringsMissing.push_back(Common::String::format("missing.%03d/%u", i % 1000, seed));
+	}
+
+	benchmarkMap<Common::HashMap<uint32, uint32> >("HashMap, sequential", sequential, sequentialMissing);
+	benchmarkMap<Common::FlatHashMap<uint32, uint32> >("FlatHashMap, sequential", sequential, sequentialMissing);
+	benchmarkMap<Common::HashMap<uint32, uint32> >("HashMap, random", random, randomMissing);
+	benchmarkMap<Common::FlatHashMap<uint32, uint32> >("FlatHashMap, random", random, randomMissing);
+	benchmarkMap<Common::HashMap<uint32, uint32> >("HashMap, strided", strided, stridedMissing);
+	benchmarkMap<Common::FlatHashMap<uint32, uint32> >("FlatHashMap, strided", strided, stridedMissing);
+	benchmarkMap<Common::HashMap<Common::String, uint32, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> >("HashMap, strings", strings, stringsMissing);
+	benchmarkMap<Common::FlatHashMap<Common::String, uint32, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> >("FlatHashMap, strings", strings, stringsMissing);
+}
+
+static void benchmarkThreadProc(void *param) {
+	((Common::Atomic<uint32> *)param)->fetchAdd(1);
+}
+
+void TestbedEngine::threadPoolBenchmark() {
+	Common::ThreadPool &pool = Common::ThreadPool::instance();
+	Testsuite::logPrintf("ThreadPool: %d worker threads, %d CPUs\n", pool.getThreadCount(), g_system->getCpuCount());
+
+	// Tiny jobs, so that only the cost of handing them over is measured
+	const uint jobCount = 2000;
+	Common::Atomic<uint32> counter(0);
+
+	uint32 start = g_system->getMillis();
+	for (uint i = 0; i < jobCount; i++) {
+		OSystem::ThreadRef thread = g_system->createThread(benchmarkThreadProc, &counter);
+		if (thread)
+			g_system->joinThread(thread);
+		else
+			benchmarkThreadProc(&counter);
+	}
+	Testsuite::logPrintf("createThread: %d jobs one after another in %d ms\n", jobCount, g_system->getMillis() - start);
+
+	Common::Future<void> job([&counter]() { counter.fetchAdd(1); });
+	start = g_system->getMillis();
+	for (uint i = 0; i < jobCount; i++) {
+		pool.start(&job);
+		job.wait();
+	}
+	Testsuite::logPrintf("ThreadPool: %d jobs one after another in %d ms\n", jobCount, g_system->getMillis() - start);
+
+	// Waiting right away mostly runs the job on this thread, batches let
+	// the workers take them
+	const uint batchSize = 64;
+	Common::Array<Common::Future<void> *> batch;
+	for (uint i = 0; i < batchSize; i++)
+		batch.push_back(new Common::Future<void>([&counter]() { counter.fetchAdd(1); }));
+	start = g_system->getMillis();
+	for (uint i = 0; i < jobCount / batchSize; i++) {
+		for (uint j = 0; j < batchSize; j++)
+			pool.start(batch[j]);
+		for (uint j = 0; j < batchSize; j++)
+			batch[j]->wait();
+	}
+	Testsuite::logPrintf("ThreadPool: %d jobs in batches of %d in %d ms\n", jobCount / batchSize * batchSize, batchSize, g_system->getMillis() - start);
+	for (uint i = 0; i < batchSize; i++)
+		delete batch[i];
+
+	// Loops whose iterations are short, where the overhead of parallelFor
+	// may outweigh the gain
+	const int loopCount = 1000;
+	const int loopSize = 4096;
+	Common::Array<uint32> values(loopSize, 1);
+	start = g_system->getMillis();
+	for (int i = 0; i < loopCount; i++) {
+		for (int j = 0; j < loopSize; j++)
+			values[j] = values[j] * 1103515245 + 12345;
+	}
+	Testsuite::logPrintf("Serial loop: %d loops of %d iterations in %d ms\n", loopCount, loopSize, g_system->getMillis() - start);
+
+	start = g_system->getMillis();
+	for (int i = 0; i < loopCount; i++)
+		pool.parallelFor(0, loopSize, [&values](int j) { values[j] = values[j] * 1103515245 + 12345; });
+	Testsuite::logPrintf("parallelFor: %d loops of %d iterations in %d ms\n", loopCount, loopSize, g_system->getMillis() - start);
+
+	Testsuite::logPrintf("%d jobs run, checksum %u\n", counter.load(), values[0]);
+}
+
 } // End of namespace Testbed
@@ -33,6 +33,11 @@ MODULE_OBJS += \
 	speech.o
 endif
 
+ifdef USE_TINYGL
+MODULE_OBJS += \
+	tinygl.o
+endif
+
 MODULE_DIRS += \
 	engines/testbed
 
@@ -20,9 +20,12 @@
  *
  */
 
+#include "common/memstream.h"
 #include "common/savefile.h"
+#include "common/zlib.h"
 
 #include "testbed/savegame.h"
+#include "testbed/testbed.h"
 
 namespace Testbed {
 
@@ -192,4 +195,57 @@ SaveGameTestSuite::SaveGameTestSuite() {
 	addTest("VerifyErrorMessages", &SaveGametests::testErrorMessages, false);
 }
 
+void TestbedEngine::gzipBenchmark() {
+	const uint32 size = 64 * 1024 * 1024;
+	const int seeks = 200;
+
+	// Random bytes and copies of recent ones, so that it compresses somewhat
+	byte *data = new byte[size];
+	uint32 seed = 1;
+	for (uint32 i = 0; i < size; i++) {
+		seed = seed * 1103515245 + 12345;
+		data[i] = (seed >> 16) & 15 ? data[MAX<int>(i - 1 - ((seed >> 20) & 63), 0)] : (byte)(seed >> 24);
+	}
+
+	Common::MemoryWriteStreamDynamic *compressed = new Common::MemoryWriteStreamDynamic(DisposeAfterUse::NO);
+	Common::WriteStream *gzip = Common::wrapCompressedWriteStream(compressed);
+	gzip->write(data, size);
+	gzip->finalize();
+	byte *compressedData = compressed->getData();
+	const uint32 compressedSize = compressed->size();
+	delete gzip;
+	delete[] data;
+
+	byte buffer[4096];
+	for (int pass = 0; pass < 2; pass++) {
+		Common::SeekableReadStream *stream = Common::wrapCompressedReadStream(new Common::MemoryReadStream(compressedData, compressedSize));
+		if (!stream) {
+			warning("gzip data could not be decompressed");
+			break;
+		}
+
+		// The second pass seeks in a stream which was never read through
+		uint32 start = g_system->getMillis();
+		if (pass == 0) {
+			while (!stream->eos() && !stream->err())
+				stream->read(buffer, sizeof(buffer));
+			Testsuite::logPrintf("%d MB from %d MB of gzip data: read in %d ms\n", size >> 20, compressedSize >> 20, g_system->getMillis() - start);
+			start = g_system->getMillis();
+		}
+
+		seed = 2;
+		for (int i = 0; i < seeks; i++) {
+			seed = seed * 1103515245 + 12345;
+			stream->seek((seed >> 4) % (size - sizeof(buffer)));
+			stream->read(buffer, sizeof(buffer));
+		}
+		Testsuite::logPrintf("%d random seeks and reads %s: %.2f ms each\n", seeks, pass == 0 ? "after reading it" : "in new stream",
+			(double)(g_system->getMillis() - start) / seeks);
+
+		delete stream;
+	}
+
+	free(compressedData);
+}
+
 } // End of namespace Testbed
@@ -217,6 +217,53 @@ Common::Error TestbedEngine::run() {
 		return Common::kNoError;
 	}
 
+	// The benchmarks are meant for developers. They are enabled by setting
+	// one of the following keys in the testbed section of the configuration
+	// file, and they report their results to the testbed log:
+	//   benchmark_movie=FILE  decode a movie as fast as possible
+	//   benchmark_yuv=true    YUV to RGB conversion with each instruction set
+	//   benchmark_blit=true   TransparentSurface blending with each instruction set
+	//   benchmark_gzip=true   seeking in gzip compressed data
+	//   benchmark_hashmap=true  HashMap against FlatHashMap
+	//   benchmark_threadpool=true  ThreadPool tasks against starting threads
+	//   benchmark_tinygl=true  TinyGL frame time with a growing number of threads
+	if (ConfMan.hasKey("benchmark_movie")) {
+		videoBenchmark();
+		return Common::kNoError;
+	}
+
+	if (ConfMan.hasKey("benchmark_yuv") && ConfMan.getBool("benchmark_yuv")) {
+		yuvBenchmark();
+		return Common::kNoError;
+	}
+
+	if (ConfMan.hasKey("benchmark_blit") && ConfMan.getBool("benchmark_blit")) {
+		blitBenchmark();
+		return Common::kNoError;
+	}
+
+	if (ConfMan.hasKey("benchmark_gzip") && ConfMan.getBool("benchmark_gzip")) {
+		gzipBenchmark();
+		return Common::kNoError;
+	}
+
+	if (ConfMan.hasKey("benchmark_hashmap") && ConfMan.getBool("benchmark_hashmap")) {
+		hashMapBenchmark();
+		return Common::kNoError;
+	}
+
+	if (ConfMan.hasKey("benchmark_threadpool") && ConfMan.getBool("benchmark_threadpool")) {
+		threadPoolBenchmark();
+		return Common::kNoError;
+	}
+
+#ifdef USE_TINYGL
+	if (ConfMan.hasKey("benchmark_tinygl") && ConfMan.getBool("benchmark_tinygl")) {
+		tinyglBenchmark();
+		return Common::kNoError;
+	}
+#endif
+
 	// Initialize graphics using following:
 	initGraphics(320, 200);
 
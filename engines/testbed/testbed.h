@@ -62,6 +62,15 @@ public:
 private:
 	void checkForAllAchievements();
 	void videoTest();
+	void videoBenchmark();
+	void yuvBenchmark();
+	void blitBenchmark();
+	void gzipBenchmark();
+	void hashMapBenchmark();
+	void threadPoolBenchmark();
+#ifdef USE_TINYGL
+	void tinyglBenchmark();
+#endif
 
 	Common::Array<Testsuite *> _testsuiteList;
 };
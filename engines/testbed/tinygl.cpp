@@ -0,0 +1,164 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+
+#include "common/system.h"
+#include "graphics/surface.h"
+#include "graphics/tinygl/zblit.h"
+#include "graphics/tinygl/zgl.h"
+
+#include "testbed/testbed.h"
+
+namespace Testbed {
+
+static void tinyglRecordScene(unsigned int list, int width, int height, unsigned int texture) {
+	tglNewList(list, TGL_COMPILE);
+
+	tglClearColor(0.1f, 0.2f, 0.3f, 1.0f);
+	tglClear(TGL_COLOR_BUFFER_BIT | TGL_DEPTH_BUFFER_BIT);
+
+	// Textured background
+	tglDisable(TGL_DEPTH_TEST);
+	tglEnable(TGL_TEXTURE_2D);
+	tglBindTexture(TGL_TEXTURE_2D, texture);
+	tglColor4f(1.0f, 1.0f, 1.0f, 1.0f);
+	tglBegin(TGL_QUADS);
+	tglTexCoord2f(0.0f, 0.0f); tglVertex3f(0.0f, 0.0f, 0.0f);
+	tglTexCoord2f(4.0f, 0.0f); tglVertex3f(width, 0.0f, 0.0f);
+	tglTexCoord2f(4.0f, 3.0f); tglVertex3f(width, height, 0.0f);
+	tglTexCoord2f(0.0f, 3.0f); tglVertex3f(0.0f, height, 0.0f);
+	tglEnd();
+	tglDisable(TGL_TEXTURE_2D);
+
+	// Overlapping depth tested meshes
+	tglEnable(TGL_DEPTH_TEST);
+	tglShadeModel(TGL_SMOOTH);
+	uint32 seed = 1;
+	for (int mesh = 0; mesh < 40; mesh++) {
+		seed = seed * 1103515245 + 12345;
+		float x = (seed >> 8) % width, y = (seed >> 4) % height;
+		tglBegin(TGL_TRIANGLES);
+		for (int i = 0; i < 50; i++) {
+			seed = seed * 1103515245 + 12345;
+			float dx = (int)((seed >> 8) % 121) - 60, dy = (int)((seed >> 16) % 121) - 60;
+			float z = ((seed >> 4) % 200) / 100.0f - 1.0f;
+			tglColor3f(1.0f, 0.0f, 0.0f); tglVertex3f(x + dx, y + dy, z);
+			tglColor3f(0.0f, 1.0f, 0.0f); tglVertex3f(x + dx + 40.0f, y + dy, -z);
+			tglColor3f(0.0f, 0.0f, 1.0f); tglVertex3f(x + dx, y + dy + 40.0f, z / 2.0f);
+		}
+		tglEnd();
+	}
+	tglDisable(TGL_DEPTH_TEST);
+
+	tglEndList();
+}
+
+static void tinyglRecordOverlay(unsigned int list, int width, int height) {
+	tglNewList(list, TGL_COMPILE);
+
+	tglEnable(TGL_BLEND);
+	tglBlendFunc(TGL_SRC_ALPHA, TGL_ONE_MINUS_SRC_ALPHA);
+	tglBegin(TGL_QUADS);
+	for (int i = 0; i < 8; i++) {
+		float top = i * height / 8.0f;
+		tglColor4f(i / 8.0f, 0.5f, 1.0f - i / 8.0f, 0.5f);
+		tglVertex3f(i * 10.0f, top, 0.0f);
+		tglVertex3f(width - i * 10.0f, top, 0.0f);
+		tglVertex3f(width - i * 10.0f, top + height / 16.0f, 0.0f);
+		tglVertex3f(i * 10.0f, top + height / 16.0f, 0.0f);
+	}
+	tglEnd();
+	tglDisable(TGL_BLEND);
+
+	tglEndList();
+}
+
+void TestbedEngine::tinyglBenchmark() {
+	const int width = 1280, height = 720, frames = 50;
+	const Graphics::PixelFormat format(4, 8, 8, 8, 8, 24, 16, 8, 0);
+
+	TinyGL::FrameBuffer *fb = new TinyGL::FrameBuffer(width, height, format);
+	TinyGL::glInit(fb, 256);
+	tglEnableDirtyRects(false);
+
+	tglViewport(0, 0, width, height);
+	tglMatrixMode(TGL_PROJECTION);
+	tglLoadIdentity();
+	tglOrtho(0, width, height, 0, -1, 1);
+	tglMatrixMode(TGL_MODELVIEW);
+	tglLoadIdentity();
+
+	Graphics::Surface image;
+	image.create(256, 256, format);
+	for (int y = 0; y < image.h; y++) {
+		for (int x = 0; x < image.w; x++)
+			image.setPixel(x, y, format.ARGBToColor(255, x, y, (x ^ y) & 0xff));
+	}
+
+	unsigned int texture;
+	tglGenTextures(1, &texture);
+	tglBindTexture(TGL_TEXTURE_2D, texture);
+	tglTexImage2D(TGL_TEXTURE_2D, 0, 3, image.w, image.h, 0, TGL_RGBA, TGL_UNSIGNED_BYTE, image.getPixels());
+	Graphics::BlitImage *blitImage = Graphics::tglGenBlitImage();
+	Graphics::tglUploadBlitImage(blitImage, image, 0, false);
+
+	// The frame is recorded once, then replayed through the draw call
+	// queue for each measured frame. The blit in the middle splits it in
+	// two segments for the threaded renderer.
+	unsigned int lists = tglGenLists(2);
+	tinyglRecordScene(lists, width, height, texture);
+	tinyglRecordOverlay(lists + 1, width, height);
+
+	uint32 *reference = new uint32[width * height];
+	const uint maxThreads = MAX<uint>(g_system->getCpuCount(), 4);
+
+	for (uint threads = 1; threads <= maxThreads; threads *= 2) {
+		tglSetRenderThreadCount(threads);
+
+		uint32 start = g_system->getMillis();
+		for (int i = 0; i < frames; i++) {
+			tglCallList(lists);
+			Graphics::tglBlit(blitImage, width / 2 - 128, height / 2 - 128);
+			tglCallList(lists + 1);
+			TinyGL::tglPresentBuffer();
+		}
+		uint32 time = MAX<uint32>(g_system->getMillis() - start, 1);
+
+		bool identical = true;
+		if (threads == 1)
+			memcpy(reference, fb->getPixelBuffer(), width * height * sizeof(uint32));
+		else
+			identical = memcmp(reference, fb->getPixelBuffer(), width * height * sizeof(uint32)) == 0;
+
+		Testsuite::logPrintf("TinyGL %dx%d with %d thread(s): %.2f ms/frame%s\n", width, height, threads,
+			(double)time / frames, identical ? "" : ", output differs from a single thread");
+	}
+
+	delete[] reference;
+	Graphics::tglDeleteBlitImage(blitImage);
+	tglDeleteTextures(1, &texture);
+	image.free();
+	TinyGL::glClose();
+	delete fb;
+}
+
+} // End of namespace Testbed
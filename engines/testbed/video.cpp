@@ -22,7 +22,11 @@
 
 #include "common/events.h"
 #include "engines/util.h"
+#include "graphics/yuv_to_rgb.h"
+#include "video/avi_decoder.h"
+#include "video/bink_decoder.h"
 #include "video/qt_decoder.h"
+#include "video/smk_decoder.h"
 
 #include "testbed/testbed.h"
 
@@ -49,21 +53,21 @@ void TestbedEngine::videoTest() {
 			uint32 pos = video->getTime();
 			warning("video time: %d", pos);
 
-			const Graphics::Surface *frame = video->decodeNextFrame();
-			if (frame) {
-				Graphics::Surface *conv = frame->convertTo(pixelformat);
+			// Decode straight into the screen, converting only if needed
+			Graphics::Surface *screen = g_system->lockScreen();
 
-				int x = 0, y = 0;
+			int x = 0, y = 0;
 
-				if (conv->w < g_system->getWidth() && conv->h < g_system->getHeight()) {
-					x = (g_system->getWidth() - conv->w) >> 1;
-					y = (g_system->getHeight() - conv->h) >> 1;
-				}
-				g_system->copyRectToScreen(conv->getPixels(), conv->pitch, x, y, MIN<uint16>(conv->w, 640), MIN<uint16>(conv->h, 480));
-
-				delete conv;
+			if (video->getWidth() < screen->w && video->getHeight() < screen->h) {
+				x = (screen->w - video->getWidth()) >> 1;
+				y = (screen->h - video->getHeight()) >> 1;
 			}
 
+			Graphics::Surface area = screen->getSubArea(Common::Rect(x, y, screen->w, screen->h));
+			video->decodeNextFrameInto(area);
+
+			g_system->unlockScreen();
+
 			Common::Event event;
 
 			while (g_system->getEventManager()->pollEvent(event)) {
@@ -81,4 +85,90 @@ void TestbedEngine::videoTest() {
 	delete video;
 }
 
+void TestbedEngine::videoBenchmark() {
+	Common::String path = ConfMan.get("benchmark_movie");
+
+	Video::VideoDecoder *video;
+	if (path.hasSuffixIgnoreCase(".smk"))
+		video = new Video::SmackerDecoder();
+	else if (path.hasSuffixIgnoreCase(".avi"))
+		video = new Video::AVIDecoder();
+#ifdef USE_BINK
+	else if (path.hasSuffixIgnoreCase(".bik"))
+		video = new Video::BinkDecoder();
+#endif
+	else
+		video = new Video::QuickTimeDecoder();
+
+	if (!video->loadFile(path)) {
+		warning("Cannot open video %s", path.c_str());
+		delete video;
+		return;
+	}
+
+	// Decode only: no playback, no conversion and no blitting
+	uint32 frames = 0;
+	uint32 start = g_system->getMillis();
+
+	while (!video->endOfVideo() && !Engine::shouldQuit()) {
+		if (!video->decodeNextFrame())
+			break;
+		frames++;
+	}
+
+	uint32 elapsed = MAX<uint32>(g_system->getMillis() - start, 1);
+	Testsuite::logPrintf("Decoded %d frames of %s in %d ms: %.2f fps\n", frames, path.c_str(), elapsed, frames * 1000.0 / elapsed);
+
+	delete video;
+}
+
+void TestbedEngine::yuvBenchmark() {
+	static const char *const levelNames[] = { "lookup", "SSE2", "AVX2", "NEON" };
+	const int width = 1280, height = 720, iterations = 100;
+
+	// Any content will do, the conversion cost does not depend on it
+	byte *yPlane = new byte[width * height];
+	byte *uPlane = new byte[width * height];
+	byte *vPlane = new byte[width * height];
+
+	for (int i = 0; i < width * height; i++) {
+		yPlane[i] = i * 7;
+		uPlane[i] = i * 3;
+		vPlane[i] = i * 5;
+	}
+
+	Graphics::YUVToRGBManager::SIMDLevel defaultLevel = YUVToRGBMan.getSIMDLevel();
+
+	for (int bpp = 2; bpp <= 4; bpp += 2) {
+		Graphics::Surface surface;
+		surface.create(width, height, bpp == 2 ? Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0) : Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0));
+
+		for (int level = Graphics::YUVToRGBManager::kSIMDNone; level <= Graphics::YUVToRGBManager::kSIMDNEON; level++) {
+			if (!YUVToRGBMan.setSIMDLevel((Graphics::YUVToRGBManager::SIMDLevel)level))
+				continue;
+
+			uint32 start = g_system->getMillis();
+			for (int i = 0; i < iterations; i++)
+				YUVToRGBMan.convert420(&surface, Graphics::YUVToRGBManager::kScaleITU, yPlane, uPlane, vPlane, width, height, width, width / 2);
+			uint32 time420 = MAX<uint32>(g_system->getMillis() - start, 1);
+
+			start = g_system->getMillis();
+			for (int i = 0; i < iterations; i++)
+				YUVToRGBMan.convert444(&surface, Graphics::YUVToRGBManager::kScaleITU, yPlane, uPlane, vPlane, width, height, width, width);
+			uint32 time444 = MAX<uint32>(g_system->getMillis() - start, 1);
+
+			Testsuite::logPrintf("%dx%d to %dbpp with %s: 420 %.2f ms/frame, 444 %.2f ms/frame\n", width, height, bpp * 8, levelNames[level],
+				(double)time420 / iterations, (double)time444 / iterations);
+		}
+
+		surface.free();
+	}
+
+	YUVToRGBMan.setSIMDLevel(defaultLevel);
+
+	delete[] yPlane;
+	delete[] uPlane;
+	delete[] vPlane;
+}
+
 }
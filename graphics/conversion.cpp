@@ -355,6 +355,29 @@ Size scaleBlitBilinearInterpolate(Size c01, Size c00, Size c11, Size c10, int ex
 	return fmt.ARGBToColorT<ColorMask>(dp_a, dp_r, dp_g, dp_b);
 }
 
+/**
+ * Stands in for the color masks of 32bpp formats with four 8 bit channels.
+ * Their channels can be interpolated byte by byte, whatever their order.
+ */
+struct ByteChannelMasks {};
+
+template<>
+uint32 scaleBlitBilinearInterpolate<ByteChannelMasks, uint32>(uint32 c01, uint32 c00, uint32 c11, uint32 c10, int ex, int ey,
+															 const Graphics::PixelFormat &fmt) {
+	uint32 dp = 0;
+	for (int shift = 0; shift < 32; shift += 8) {
+		dp |= (uint32)scaleBlitBilinearInterpolate((byte)(c01 >> shift), (byte)(c00 >> shift),
+		                                           (byte)(c11 >> shift), (byte)(c10 >> shift), ex, ey) << shift;
+	}
+	return dp;
+}
+
+inline bool hasByteChannels(const Graphics::PixelFormat &fmt) {
+	return fmt.bytesPerPixel == 4 &&
+	       fmt.aLoss == 0 && fmt.rLoss == 0 && fmt.gLoss == 0 && fmt.bLoss == 0 &&
+	       fmt.aShift % 8 == 0 && fmt.rShift % 8 == 0 && fmt.gShift % 8 == 0 && fmt.bShift % 8 == 0;
+}
+
 template <typename ColorMask, typename Size, bool flipx, bool flipy> // TODO: See mirroring comment in RenderTicket ctor
 void scaleBlitBilinearLogic(byte *dst, const byte *src,
 							const uint dstPitch, const uint srcPitch,
@@ -445,6 +468,9 @@ void scaleBlitBilinearLogic(byte *dst, const byte *src,
 	}
 }
 
+/** Width and height of the destination tiles of rotoscaleBlitLogic() */
+const uint kRotoscaleTileSize = 32;
+
 template<typename ColorMask, typename Size, bool filtering, bool flipx, bool flipy> // TODO: See mirroring comment in RenderTicket ctor
 void rotoscaleBlitLogic(byte *dst, const byte *src,
 						const uint dstPitch, const uint srcPitch,
@@ -480,57 +506,65 @@ void rotoscaleBlitLogic(byte *dst, const byte *src,
 	int sw = srcW - 1;
 	int sh = srcH - 1;
 
-	Size *pc = (Size *)dst;
-
-	for (uint y = 0; y < dstH; y++) {
-		int t = cy - y;
-		int sdx = ax + (isinx * t) + xd;
-		int sdy = ay - (icosy * t) + yd;
-		for (uint x = 0; x < dstW; x++) {
-			int dx = (sdx >> 16);
-			int dy = (sdy >> 16);
-			if (flipx) {
-				dx = sw - dx;
-			}
-			if (flipy) {
-				dy = sh - dy;
-			}
-
-			if (filtering) {
-				if ((dx > -1) && (dy > -1) && (dx < sw) && (dy < sh)) {
-					const byte *sp = src + dy * srcPitch + dx * sizeof(Size);
-					Size c00, c01, c10, c11;
-					c00 = *(const Size *)sp;
-					sp += sizeof(Size);
-					c01 = *(const Size *)sp;
-					sp += srcPitch;
-					c11 = *(const Size *)sp;
-					sp -= sizeof(Size);
-					c10 = *(const Size *)sp;
+	// Walk the destination in square tiles rather than in whole rows. The
+	// source pixels of a rotated row are spread over many source rows, and
+	// the next rows of a tile read from the same ones while they are cached.
+	for (uint tileY = 0; tileY < dstH; tileY += kRotoscaleTileSize) {
+		const uint tileBottom = MIN<uint>(tileY + kRotoscaleTileSize, dstH);
+		for (uint tileX = 0; tileX < dstW; tileX += kRotoscaleTileSize) {
+			const uint tileRight = MIN<uint>(tileX + kRotoscaleTileSize, dstW);
+			for (uint y = tileY; y < tileBottom; y++) {
+				int t = cy - y;
+				int sdx = ax + (isinx * t) + xd + icosx * (int)tileX;
+				int sdy = ay - (icosy * t) + yd + isiny * (int)tileX;
+				Size *pc = (Size *)(dst + y * dstPitch) + tileX;
+				for (uint x = tileX; x < tileRight; x++) {
+					int dx = (sdx >> 16);
+					int dy = (sdy >> 16);
 					if (flipx) {
-						SWAP(c00, c01);
-						SWAP(c10, c11);
+						dx = sw - dx;
 					}
 					if (flipy) {
-						SWAP(c00, c10);
-						SWAP(c01, c11);
+						dy = sh - dy;
 					}
-					/*
-					* Interpolate colors
-					*/
-					int ex = (sdx & 0xffff);
-					int ey = (sdy & 0xffff);
-					*pc = scaleBlitBilinearInterpolate<ColorMask, Size>(c01, c00, c11, c10, ex, ey, fmt);
-				}
-			} else {
-				if ((dx >= 0) && (dy >= 0) && (dx < (int)srcW) && (dy < (int)srcH)) {
-					const byte *sp = src + dy * srcPitch + dx * sizeof(Size);
-					*pc = *(const Size *)sp;
+
+					if (filtering) {
+						if ((dx > -1) && (dy > -1) && (dx < sw) && (dy < sh)) {
+							const byte *sp = src + dy * srcPitch + dx * sizeof(Size);
+							Size c00, c01, c10, c11;
+							c00 = *(const Size *)sp;
+							sp += sizeof(Size);
+							c01 = *(const Size *)sp;
+							sp += srcPitch;
+							c11 = *(const Size *)sp;
+							sp -= sizeof(Size);
+							c10 = *(const Size *)sp;
+							if (flipx) {
+								SWAP(c00, c01);
+								SWAP(c10, c11);
+							}
+							if (flipy) {
+								SWAP(c00, c10);
+								SWAP(c01, c11);
+							}
+							/*
+							* Interpolate colors
+							*/
+							int ex = (sdx & 0xffff);
+							int ey = (sdy & 0xffff);
+							*pc = scaleBlitBilinearInterpolate<ColorMask, Size>(c01, c00, c11, c10, ex, ey, fmt);
+						}
+					} else {
+						if ((dx >= 0) && (dy >= 0) && (dx < (int)srcW) && (dy < (int)srcH)) {
+							const byte *sp = src + dy * srcPitch + dx * sizeof(Size);
+							*pc = *(const Size *)sp;
+						}
+					}
+					sdx += icosx;
+					sdy += isiny;
+					pc++;
 				}
 			}
-			sdx += icosx;
-			sdy += isiny;
-			pc++;
 		}
 	}
 }
@@ -597,6 +631,8 @@ bool scaleBlitBilinear(byte *dst, const byte *src,
 		scaleBlitBilinearLogic<ColorMasks<565>,  uint16, false, false>(dst, src, dstPitch, srcPitch, dstW, dstH, srcW, srcH, fmt, sax, say);
 	} else if (fmt == createPixelFormat<555>()) {
 		scaleBlitBilinearLogic<ColorMasks<555>,  uint16, false, false>(dst, src, dstPitch, srcPitch, dstW, dstH, srcW, srcH, fmt, sax, say);
+	} else if (hasByteChannels(fmt)) {
+		scaleBlitBilinearLogic<ByteChannelMasks, uint32, false, false>(dst, src, dstPitch, srcPitch, dstW, dstH, srcW, srcH, fmt, sax, say);
 
 	} else if (fmt.bytesPerPixel == 4) {
 		scaleBlitBilinearLogic<ColorMasks<0>,    uint32, false, false>(dst, src, dstPitch, srcPitch, dstW, dstH, srcW, srcH, fmt, sax, say);
@@ -650,6 +686,8 @@ bool rotoscaleBlitBilinear(byte *dst, const byte *src,
 		rotoscaleBlitLogic<ColorMasks<565>,  uint16, true, false, false>(dst, src, dstPitch, srcPitch, dstW, dstH, srcW, srcH, fmt, transform, newHotspot);
 	} else if (fmt == createPixelFormat<555>()) {
 		rotoscaleBlitLogic<ColorMasks<555>,  uint16, true, false, false>(dst, src, dstPitch, srcPitch, dstW, dstH, srcW, srcH, fmt, transform, newHotspot);
+	} else if (hasByteChannels(fmt)) {
+		rotoscaleBlitLogic<ByteChannelMasks, uint32, true, false, false>(dst, src, dstPitch, srcPitch, dstW, dstH, srcW, srcH, fmt, transform, newHotspot);
 
 	} else if (fmt.bytesPerPixel == 4) {
 		rotoscaleBlitLogic<ColorMasks<0>,    uint32, true, false, false>(dst, src, dstPitch, srcPitch, dstW, dstH, srcW, srcH, fmt, transform, newHotspot);
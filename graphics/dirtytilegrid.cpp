@@ -0,0 +1,165 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "common/util.h"
+#include "graphics/dirtytilegrid.h"
+
+namespace Graphics {
+
+DirtyTileGrid::DirtyTileGrid(int width, int height, int tileSize) :
+	_tileSize(tileSize), _pixelWidth(-1), _pixelHeight(-1), _width(0), _height(0),
+	_dirty(false), _visit(0), _firstRectangle(0) {
+	assert(tileSize > 0);
+	resize(width, height);
+}
+
+void DirtyTileGrid::resize(int width, int height) {
+	if (width != _pixelWidth || height != _pixelHeight) {
+		_pixelWidth = width;
+		_pixelHeight = height;
+		_width = (width + _tileSize - 1) / _tileSize;
+		_height = (height + _tileSize - 1) / _tileSize;
+		_tiles.resize(_width * _height);
+		_tileRectangles.clear();
+		_lastVisit.clear();
+	}
+	clear();
+}
+
+void DirtyTileGrid::clear() {
+	if (!_tiles.empty())
+		memset(_tiles.begin(), 0, _tiles.size());
+	_dirty = false;
+}
+
+void DirtyTileGrid::markRegion(const Common::Rect &region) {
+	int left, top, right, bottom;
+	if (!getTileRange(region, left, top, right, bottom))
+		return;
+	for (int y = top; y <= bottom; y++)
+		memset(&_tiles[y * _width + left], 1, right - left + 1);
+	_dirty = true;
+}
+
+void DirtyTileGrid::extractRectangles(const Common::Rect &clipRect, Common::Array<Common::Rect> &rectangles) {
+	Common::Array<Common::Rect> tileRects;
+	// Rectangles still open at the previous and at the current row.
+	Common::Array<uint> openLists[2];
+
+	if (_dirty) {
+		for (int y = 0; y < _height; y++) {
+			const byte *row = &_tiles[y * _width];
+			const Common::Array<uint> &open = openLists[y & 1];
+			Common::Array<uint> &nextOpen = openLists[(y + 1) & 1];
+			uint openIndex = 0;
+			nextOpen.resize(0);
+			for (int x = 0; x < _width; ) {
+				if (!row[x]) {
+					x++;
+					continue;
+				}
+				int runStart = x;
+				while (x < _width && row[x])
+					x++;
+
+				while (openIndex < open.size() && tileRects[open[openIndex]].left < runStart)
+					openIndex++;
+				if (openIndex < open.size() && tileRects[open[openIndex]].left == runStart && tileRects[open[openIndex]].right == x) {
+					tileRects[open[openIndex]].bottom = y + 1;
+					nextOpen.push_back(open[openIndex]);
+				} else {
+					nextOpen.push_back(tileRects.size());
+					tileRects.push_back(Common::Rect(runStart, y, x, y + 1));
+				}
+			}
+		}
+	}
+
+	// Remember which rectangle covers each tile, for findRectangles().
+	_tileRectangles.resize(_width * _height);
+	for (uint i = 0; i < _tileRectangles.size(); i++)
+		_tileRectangles[i] = -1;
+
+	_firstRectangle = rectangles.size();
+	for (uint i = 0; i < tileRects.size(); i++) {
+		const Common::Rect &tileRect = tileRects[i];
+		Common::Rect rect(tileRect.left * _tileSize, tileRect.top * _tileSize,
+		                  tileRect.right * _tileSize, tileRect.bottom * _tileSize);
+		rect.clip(clipRect);
+		if (rect.isEmpty())
+			continue;
+
+		for (int y = tileRect.top; y < tileRect.bottom; y++) {
+			for (int x = tileRect.left; x < tileRect.right; x++)
+				_tileRectangles[y * _width + x] = rectangles.size();
+		}
+		rectangles.push_back(rect);
+	}
+	_lastVisit.resize(rectangles.size());
+	for (uint i = 0; i < _lastVisit.size(); i++)
+		_lastVisit[i] = 0;
+	_visit = 0;
+}
+
+void DirtyTileGrid::findRectangles(const Common::Rect &region, const Common::Array<Common::Rect> &rectangles, Common::Array<uint> &indices) {
+	indices.resize(0);
+	int left, top, right, bottom;
+	if (!getTileRange(region, left, top, right, bottom))
+		return;
+
+	// Testing the rectangles directly is cheaper when there are fewer
+	// of them than tiles in the region.
+	if (rectangles.size() - _firstRectangle <= (uint)((right - left + 1) * (bottom - top + 1))) {
+		for (uint i = _firstRectangle; i < rectangles.size(); i++) {
+			if (rectangles[i].intersects(region))
+				indices.push_back(i);
+		}
+		return;
+	}
+	_visit++;
+	for (int y = top; y <= bottom; y++) {
+		const int *row = &_tileRectangles[y * _width];
+		for (int x = left; x <= right; x++) {
+			if (row[x] >= 0 && _lastVisit[row[x]] != _visit) {
+				_lastVisit[row[x]] = _visit;
+				indices.push_back(row[x]);
+			}
+		}
+	}
+}
+
+bool DirtyTileGrid::getTileRange(const Common::Rect &region, int &left, int &top, int &right, int &bottom) const {
+	// Regions partly outside the grid only cover the tiles they overlap,
+	// and the coordinates are not negative anymore once clipped.
+	if (region.isEmpty() || !_width || !_height)
+		return false;
+	const Common::Rect clipped = region.findIntersectingRect(Common::Rect(_pixelWidth, _pixelHeight));
+	if (clipped.isEmpty())
+		return false;
+	left = clipped.left / _tileSize;
+	top = clipped.top / _tileSize;
+	right = (clipped.right - 1) / _tileSize;
+	bottom = (clipped.bottom - 1) / _tileSize;
+	return true;
+}
+
+} // End of namespace Graphics
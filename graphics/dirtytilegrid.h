@@ -0,0 +1,95 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef GRAPHICS_DIRTYTILEGRID_H
+#define GRAPHICS_DIRTYTILEGRID_H
+
+#include "common/array.h"
+#include "common/rect.h"
+
+namespace Graphics {
+
+/**
+ * Tracks the dirty regions of a screen with a grid of square tiles.
+ *
+ * Marking a region is linear in the number of tiles it covers, whatever
+ * the number of regions already marked, and there is no limit on that
+ * number. The dirty tiles are then covered by a list of disjoint
+ * rectangles, which are aligned on the tiles.
+ */
+class DirtyTileGrid {
+public:
+	DirtyTileGrid(int width = 0, int height = 0, int tileSize = 16);
+
+	/**
+	 * Change the size of the tracked area and mark every tile as clean.
+	 * Does nothing besides clearing when the size is unchanged.
+	 */
+	void resize(int width, int height);
+
+	/** Mark every tile as clean. */
+	void clear();
+
+	/** Mark the tiles covered by region as dirty. */
+	void markRegion(const Common::Rect &region);
+
+	/** Return whether no tile is dirty. */
+	bool isClean() const { return !_dirty; }
+
+	int getWidth() const { return _pixelWidth; }
+	int getHeight() const { return _pixelHeight; }
+
+	/**
+	 * Cover the dirty tiles with disjoint rectangles, clipped to clipRect,
+	 * and append them to rectangles.
+	 *
+	 * Runs of dirty tiles are found row by row, and a run spanning the
+	 * same columns as one in the previous row extends its rectangle.
+	 * The rectangles stay valid for findRectangles() until the grid
+	 * changes again.
+	 */
+	void extractRectangles(const Common::Rect &clipRect, Common::Array<Common::Rect> &rectangles);
+
+	/**
+	 * List the indices of the rectangles found by the last call to
+	 * extractRectangles() which cover a tile of region, each one once.
+	 * An empty list means nothing dirty lies under region.
+	 */
+	void findRectangles(const Common::Rect &region, const Common::Array<Common::Rect> &rectangles, Common::Array<uint> &indices);
+
+private:
+	bool getTileRange(const Common::Rect &region, int &left, int &top, int &right, int &bottom) const;
+
+	int _tileSize;
+	int _pixelWidth, _pixelHeight;
+	int _width, _height;
+	bool _dirty;
+	Common::Array<byte> _tiles;
+	Common::Array<int> _tileRectangles;
+	Common::Array<uint> _lastVisit;
+	uint _visit;
+	uint _firstRectangle;
+};
+
+} // End of namespace Graphics
+
+#endif
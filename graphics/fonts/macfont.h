@@ -24,7 +24,7 @@
 #define GRAPHICS_FONTS_MACFONT_H
 
 #include "common/array.h"
-#include "common/hashmap.h"
+#include "common/flat-hashmap.h"
 #include "common/stream.h"
 #include "graphics/font.h"
 
@@ -91,7 +91,7 @@ private:
 		uint16 _entryLength;
 		Common::Array<KernPair> _kernPairs;
 
-		Common::HashMap<uint16, int16> _kernTable;
+		Common::FlatHashMap<uint16, int16> _kernTable;
 	};
 
 	uint16 _ffNumKerns;
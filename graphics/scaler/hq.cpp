@@ -23,6 +23,23 @@
 #include "graphics/scaler.h"
 #include "graphics/scaler/intern.h"
 
+// SSE2 is part of the x86-64 baseline. The NEON pattern matching has not
+// been built on ARM yet, so it also needs USE_ARM_NEON_KERNELS to be defined.
+#if defined(__GNUC__) && (defined(__x86_64__) || (defined(__i386__) && defined(__SSE2__)))
+#include <emmintrin.h>
+#define HQ_SIMD_SSE2
+#elif defined(_MSC_VER) && (defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#include <emmintrin.h>
+#define HQ_SIMD_SSE2
+#elif defined(USE_ARM_NEON_KERNELS) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+#include <arm_neon.h>
+#define HQ_SIMD_NEON
+#endif
+
+#if defined(HQ_SIMD_SSE2) || defined(HQ_SIMD_NEON)
+#define HQ_SIMD
+#endif
+
 // RGB-to-YUV lookup table
 extern "C" {
 
@@ -214,12 +231,225 @@ static inline uint32 ConvertYUV(uint32 x) {
 	return RGBtoYUV[r | g | b];
 }
 
+#ifdef HQ_SIMD
+
+enum {
+	kPatternChunk = 64 // Pixels whose patterns computePatterns32() finds at once
+};
+
+#ifdef HQ_SIMD_SSE2
+
+/**
+ * SSE2 version of ConvertYUV(), computing the table entries instead of
+ * looking them up, 4 pixels at a time.
+ *
+ * @return the number of pixels converted
+ */
+template<typename ColorMask>
+static int convertYUVRowSSE2(const uint32 *src, int count, uint32 *dst) {
+	const __m128i mask5 = _mm_set1_epi32(0xF8);
+	const __m128i mask6 = _mm_set1_epi32(0xFC);
+	const __m128i offset = _mm_set1_epi32(128);
+
+	int i = 0;
+	for (; i + 4 <= count; i += 4) {
+		const __m128i x = _mm_loadu_si128((const __m128i *)(src + i));
+
+		// Keep the bits of the 16 bit table index and expand them the
+		// same way PixelFormat::colorToRGB() does
+		__m128i r = _mm_and_si128(_mm_srli_epi32(x, ColorMask::kRedShift + ColorMask::kRedBits - 8), mask5);
+		__m128i g = _mm_and_si128(_mm_srli_epi32(x, ColorMask::kGreenShift + ColorMask::kGreenBits - 8), mask6);
+		__m128i b = _mm_and_si128(_mm_srli_epi32(x, ColorMask::kBlueShift + ColorMask::kBlueBits - 8), mask5);
+		r = _mm_or_si128(r, _mm_srli_epi32(r, 5));
+		g = _mm_or_si128(g, _mm_srli_epi32(g, 6));
+		b = _mm_or_si128(b, _mm_srli_epi32(b, 5));
+
+		const __m128i y = _mm_srli_epi32(_mm_add_epi32(_mm_add_epi32(r, g), b), 2);
+		const __m128i u = _mm_add_epi32(_mm_srai_epi32(_mm_sub_epi32(r, b), 2), offset);
+		const __m128i v = _mm_add_epi32(_mm_srai_epi32(_mm_sub_epi32(_mm_sub_epi32(_mm_add_epi32(g, g), r), b), 3), offset);
+
+		const __m128i yuv = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(y, 16), _mm_slli_epi32(u, 8)), v);
+		_mm_storeu_si128((__m128i *)(dst + i), yuv);
+	}
+	return i;
+}
+
+/**
+ * Set the pattern bit of the 4 pixels in w5 which differ from their
+ * neighbours in w, the same way diffYUV() does.
+ */
+static inline __m128i matchNeighbourSSE2(__m128i pattern, __m128i w5, __m128i yuv5, const uint32 *w, const uint32 *yuv, int bit) {
+	// Each byte of the thresholds is the largest difference in that
+	// channel which still counts as equal
+	const __m128i thresholds = _mm_set1_epi32(0x00300706);
+
+	const __m128i wN = _mm_loadu_si128((const __m128i *)w);
+	const __m128i yuvN = _mm_loadu_si128((const __m128i *)yuv);
+
+	const __m128i absDiff = _mm_or_si128(_mm_subs_epu8(yuv5, yuvN), _mm_subs_epu8(yuvN, yuv5));
+	const __m128i excess = _mm_subs_epu8(absDiff, thresholds);
+	const __m128i same = _mm_or_si128(_mm_cmpeq_epi32(w5, wN), _mm_cmpeq_epi32(excess, _mm_setzero_si128()));
+	return _mm_or_si128(pattern, _mm_andnot_si128(same, _mm_set1_epi32(bit)));
+}
+
+/**
+ * SSE2 version of the pattern computation of HQ2x_implementation(), 4
+ * pixels at a time.
+ *
+ * @return the number of patterns computed
+ */
+static int matchPatternsSSE2(const uint32 *p, uint32 nextlineSrc, const uint32 yuv[3][kPatternChunk + 2], int count, uint32 *patterns) {
+	int i = 0;
+	for (; i + 4 <= count; i += 4) {
+		const uint32 *w = p + i;
+		const __m128i w5 = _mm_loadu_si128((const __m128i *)w);
+		const __m128i yuv5 = _mm_loadu_si128((const __m128i *)&yuv[1][i + 1]);
+
+		__m128i pattern = _mm_setzero_si128();
+		pattern = matchNeighbourSSE2(pattern, w5, yuv5, w - 1 - nextlineSrc, &yuv[0][i + 0], 0x0001);
+		pattern = matchNeighbourSSE2(pattern, w5, yuv5, w - nextlineSrc, &yuv[0][i + 1], 0x0002);
+		pattern = matchNeighbourSSE2(pattern, w5, yuv5, w + 1 - nextlineSrc, &yuv[0][i + 2], 0x0004);
+		pattern = matchNeighbourSSE2(pattern, w5, yuv5, w - 1, &yuv[1][i + 0], 0x0008);
+		pattern = matchNeighbourSSE2(pattern, w5, yuv5, w + 1, &yuv[1][i + 2], 0x0010);
+		pattern = matchNeighbourSSE2(pattern, w5, yuv5, w - 1 + nextlineSrc, &yuv[2][i + 0], 0x0020);
+		pattern = matchNeighbourSSE2(pattern, w5, yuv5, w + nextlineSrc, &yuv[2][i + 1], 0x0040);
+		pattern = matchNeighbourSSE2(pattern, w5, yuv5, w + 1 + nextlineSrc, &yuv[2][i + 2], 0x0080);
+		_mm_storeu_si128((__m128i *)(patterns + i), pattern);
+	}
+	return i;
+}
+
+#endif
+
+#ifdef HQ_SIMD_NEON
+
+/**
+ * NEON version of convertYUVRowSSE2().
+ */
+template<typename ColorMask>
+static int convertYUVRowNEON(const uint32 *src, int count, uint32 *dst) {
+	const uint32x4_t mask5 = vdupq_n_u32(0xF8);
+	const uint32x4_t mask6 = vdupq_n_u32(0xFC);
+	const int32x4_t offset = vdupq_n_s32(128);
+	const int32x4_t redShift = vdupq_n_s32(8 - ColorMask::kRedShift - ColorMask::kRedBits);
+	const int32x4_t greenShift = vdupq_n_s32(8 - ColorMask::kGreenShift - ColorMask::kGreenBits);
+	const int32x4_t blueShift = vdupq_n_s32(8 - ColorMask::kBlueShift - ColorMask::kBlueBits);
+
+	int i = 0;
+	for (; i + 4 <= count; i += 4) {
+		const uint32x4_t x = vld1q_u32(src + i);
+
+		uint32x4_t r = vandq_u32(vshlq_u32(x, redShift), mask5);
+		uint32x4_t g = vandq_u32(vshlq_u32(x, greenShift), mask6);
+		uint32x4_t b = vandq_u32(vshlq_u32(x, blueShift), mask5);
+		r = vorrq_u32(r, vshrq_n_u32(r, 5));
+		g = vorrq_u32(g, vshrq_n_u32(g, 6));
+		b = vorrq_u32(b, vshrq_n_u32(b, 5));
+
+		const int32x4_t rs = vreinterpretq_s32_u32(r);
+		const int32x4_t gs = vreinterpretq_s32_u32(g);
+		const int32x4_t bs = vreinterpretq_s32_u32(b);
+		const uint32x4_t y = vshrq_n_u32(vaddq_u32(vaddq_u32(r, g), b), 2);
+		const int32x4_t u = vaddq_s32(vshrq_n_s32(vsubq_s32(rs, bs), 2), offset);
+		const int32x4_t v = vaddq_s32(vshrq_n_s32(vsubq_s32(vsubq_s32(vaddq_s32(gs, gs), rs), bs), 3), offset);
+
+		const uint32x4_t yuv = vorrq_u32(vorrq_u32(vshlq_n_u32(y, 16), vshlq_n_u32(vreinterpretq_u32_s32(u), 8)), vreinterpretq_u32_s32(v));
+		vst1q_u32(dst + i, yuv);
+	}
+	return i;
+}
+
+/**
+ * NEON version of matchNeighbourSSE2().
+ */
+static inline uint32x4_t matchNeighbourNEON(uint32x4_t pattern, uint32x4_t w5, uint32x4_t yuv5, const uint32 *w, const uint32 *yuv, int bit) {
+	const uint8x16_t thresholds = vreinterpretq_u8_u32(vdupq_n_u32(0x00300706));
+
+	const uint32x4_t wN = vld1q_u32(w);
+	const uint32x4_t yuvN = vld1q_u32(yuv);
+
+	const uint8x16_t excess = vqsubq_u8(vabdq_u8(vreinterpretq_u8_u32(yuv5), vreinterpretq_u8_u32(yuvN)), thresholds);
+	const uint32x4_t same = vorrq_u32(vceqq_u32(w5, wN), vceqq_u32(vreinterpretq_u32_u8(excess), vdupq_n_u32(0)));
+	return vorrq_u32(pattern, vbicq_u32(vdupq_n_u32(bit), same));
+}
+
+/**
+ * NEON version of matchPatternsSSE2().
+ */
+static int matchPatternsNEON(const uint32 *p, uint32 nextlineSrc, const uint32 yuv[3][kPatternChunk + 2], int count, uint32 *patterns) {
+	int i = 0;
+	for (; i + 4 <= count; i += 4) {
+		const uint32 *w = p + i;
+		const uint32x4_t w5 = vld1q_u32(w);
+		const uint32x4_t yuv5 = vld1q_u32(&yuv[1][i + 1]);
+
+		uint32x4_t pattern = vdupq_n_u32(0);
+		pattern = matchNeighbourNEON(pattern, w5, yuv5, w - 1 - nextlineSrc, &yuv[0][i + 0], 0x0001);
+		pattern = matchNeighbourNEON(pattern, w5, yuv5, w - nextlineSrc, &yuv[0][i + 1], 0x0002);
+		pattern = matchNeighbourNEON(pattern, w5, yuv5, w + 1 - nextlineSrc, &yuv[0][i + 2], 0x0004);
+		pattern = matchNeighbourNEON(pattern, w5, yuv5, w - 1, &yuv[1][i + 0], 0x0008);
+		pattern = matchNeighbourNEON(pattern, w5, yuv5, w + 1, &yuv[1][i + 2], 0x0010);
+		pattern = matchNeighbourNEON(pattern, w5, yuv5, w - 1 + nextlineSrc, &yuv[2][i + 0], 0x0020);
+		pattern = matchNeighbourNEON(pattern, w5, yuv5, w + nextlineSrc, &yuv[2][i + 1], 0x0040);
+		pattern = matchNeighbourNEON(pattern, w5, yuv5, w + 1 + nextlineSrc, &yuv[2][i + 2], 0x0080);
+		vst1q_u32(patterns + i, pattern);
+	}
+	return i;
+}
+
+#endif
+
+/**
+ * Compute the patterns of up to kPatternChunk 32 bit pixels starting at p,
+ * which HQ2x_implementation() and HQ3x_implementation() otherwise compute
+ * one pixel at a time.
+ */
+template<typename ColorMask>
+static void computePatterns32(const uint32 *p, uint32 nextlineSrc, int count, uint32 *patterns) {
+	// The YUV values of the rows above, at and below the pixels, starting
+	// one pixel to the left
+	uint32 yuv[3][kPatternChunk + 2];
+
+	for (int row = 0; row < 3; row++) {
+		const uint32 *src = p - 1 + (row - 1) * (int)nextlineSrc;
+#ifdef HQ_SIMD_SSE2
+		int i = convertYUVRowSSE2<ColorMask>(src, count + 2, yuv[row]);
+#else
+		int i = convertYUVRowNEON<ColorMask>(src, count + 2, yuv[row]);
+#endif
+		for (; i < count + 2; i++)
+			yuv[row][i] = ConvertYUV<ColorMask>(src[i]);
+	}
+
+#ifdef HQ_SIMD_SSE2
+	int i = matchPatternsSSE2(p, nextlineSrc, yuv, count, patterns);
+#else
+	int i = matchPatternsNEON(p, nextlineSrc, yuv, count, patterns);
+#endif
+	for (; i < count; i++) {
+		const uint32 *w = p + i;
+		const uint32 yuv5 = yuv[1][i + 1];
+		uint32 pattern = 0;
+		if (w[0] != w[-1 - (int)nextlineSrc] && diffYUV(yuv5, yuv[0][i + 0])) pattern |= 0x0001;
+		if (w[0] != w[-(int)nextlineSrc] && diffYUV(yuv5, yuv[0][i + 1])) pattern |= 0x0002;
+		if (w[0] != w[1 - (int)nextlineSrc] && diffYUV(yuv5, yuv[0][i + 2])) pattern |= 0x0004;
+		if (w[0] != w[-1] && diffYUV(yuv5, yuv[1][i + 0])) pattern |= 0x0008;
+		if (w[0] != w[1] && diffYUV(yuv5, yuv[1][i + 2])) pattern |= 0x0010;
+		if (w[0] != w[-1 + nextlineSrc] && diffYUV(yuv5, yuv[2][i + 0])) pattern |= 0x0020;
+		if (w[0] != w[nextlineSrc] && diffYUV(yuv5, yuv[2][i + 1])) pattern |= 0x0040;
+		if (w[0] != w[1 + nextlineSrc] && diffYUV(yuv5, yuv[2][i + 2])) pattern |= 0x0080;
+		patterns[i] = pattern;
+	}
+}
+
+#endif
+
 /*
  * The HQ2x high quality 2x graphics filter.
  * Original author Maxim Stepin (see http://www.hiend3d.com/hq2x.html).
  * Adapted for ScummVM to 16 bit output and optimized by Max Horn.
  */
-template<typename ColorMask>
+template<typename ColorMask, bool simd>
 static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height) {
 	typedef typename ColorMask::PixelType Pixel;
 
@@ -231,6 +461,10 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 	const uint32 nextlineDst = dstPitch / sizeof(Pixel);
 	Pixel *q = (Pixel *)dstPtr;
 
+#ifdef HQ_SIMD
+	uint32 patterns[kPatternChunk];
+#endif
+
 	//	 +----+----+----+
 	//	 |    |    |    |
 	//	 | w1 | w2 | w3 |
@@ -253,6 +487,12 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 
 		int tmpWidth = width;
 		while (tmpWidth--) {
+#ifdef HQ_SIMD
+			const int chunkPos = (width - tmpWidth - 1) % kPatternChunk;
+			if (simd && chunkPos == 0)
+				computePatterns32<ColorMask>((const uint32 *)p, nextlineSrc, MIN<int>(tmpWidth + 1, kPatternChunk), patterns);
+#endif
+
 			p++;
 
 			w3 = *(p - nextlineSrc);
@@ -260,15 +500,22 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			w9 = *(p + nextlineSrc);
 
 			int pattern = 0;
-			const int yuv5 = YUV(5);
-			if (w5 != w1 && diffYUV(yuv5, YUV(1))) pattern |= 0x0001;
-			if (w5 != w2 && diffYUV(yuv5, YUV(2))) pattern |= 0x0002;
-			if (w5 != w3 && diffYUV(yuv5, YUV(3))) pattern |= 0x0004;
-			if (w5 != w4 && diffYUV(yuv5, YUV(4))) pattern |= 0x0008;
-			if (w5 != w6 && diffYUV(yuv5, YUV(6))) pattern |= 0x0010;
-			if (w5 != w7 && diffYUV(yuv5, YUV(7))) pattern |= 0x0020;
-			if (w5 != w8 && diffYUV(yuv5, YUV(8))) pattern |= 0x0040;
-			if (w5 != w9 && diffYUV(yuv5, YUV(9))) pattern |= 0x0080;
+#ifdef HQ_SIMD
+			if (simd) {
+				pattern = patterns[chunkPos];
+			} else
+#endif
+			{
+				const int yuv5 = YUV(5);
+				if (w5 != w1 && diffYUV(yuv5, YUV(1))) pattern |= 0x0001;
+				if (w5 != w2 && diffYUV(yuv5, YUV(2))) pattern |= 0x0002;
+				if (w5 != w3 && diffYUV(yuv5, YUV(3))) pattern |= 0x0004;
+				if (w5 != w4 && diffYUV(yuv5, YUV(4))) pattern |= 0x0008;
+				if (w5 != w6 && diffYUV(yuv5, YUV(6))) pattern |= 0x0010;
+				if (w5 != w7 && diffYUV(yuv5, YUV(7))) pattern |= 0x0020;
+				if (w5 != w8 && diffYUV(yuv5, YUV(8))) pattern |= 0x0040;
+				if (w5 != w9 && diffYUV(yuv5, YUV(9))) pattern |= 0x0080;
+			}
 
 			switch (pattern) {
 			case 0:
@@ -2156,7 +2403,7 @@ void HQ3x(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch,
  * Original author Maxim Stepin (see http://www.hiend3d.com/hq3x.html).
  * Adapted for ScummVM to 16 bit output and optimized by Max Horn.
  */
-template<typename ColorMask>
+template<typename ColorMask, bool simd>
 static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height) {
 	typedef typename ColorMask::PixelType Pixel;
 
@@ -2169,6 +2416,10 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 	const uint32 nextlineDst2 = 2 * nextlineDst;
 	Pixel *q = (Pixel *)dstPtr;
 
+#ifdef HQ_SIMD
+	uint32 patterns[kPatternChunk];
+#endif
+
 	//	 +----+----+----+
 	//	 |    |    |    |
 	//	 | w1 | w2 | w3 |
@@ -2191,6 +2442,12 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 
 		int tmpWidth = width;
 		while (tmpWidth--) {
+#ifdef HQ_SIMD
+			const int chunkPos = (width - tmpWidth - 1) % kPatternChunk;
+			if (simd && chunkPos == 0)
+				computePatterns32<ColorMask>((const uint32 *)p, nextlineSrc, MIN<int>(tmpWidth + 1, kPatternChunk), patterns);
+#endif
+
 			p++;
 
 			w3 = *(p - nextlineSrc);
@@ -2198,15 +2455,22 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			w9 = *(p + nextlineSrc);
 
 			int pattern = 0;
-			const int yuv5 = YUV(5);
-			if (w5 != w1 && diffYUV(yuv5, YUV(1))) pattern |= 0x0001;
-			if (w5 != w2 && diffYUV(yuv5, YUV(2))) pattern |= 0x0002;
-			if (w5 != w3 && diffYUV(yuv5, YUV(3))) pattern |= 0x0004;
-			if (w5 != w4 && diffYUV(yuv5, YUV(4))) pattern |= 0x0008;
-			if (w5 != w6 && diffYUV(yuv5, YUV(6))) pattern |= 0x0010;
-			if (w5 != w7 && diffYUV(yuv5, YUV(7))) pattern |= 0x0020;
-			if (w5 != w8 && diffYUV(yuv5, YUV(8))) pattern |= 0x0040;
-			if (w5 != w9 && diffYUV(yuv5, YUV(9))) pattern |= 0x0080;
+#ifdef HQ_SIMD
+			if (simd) {
+				pattern = patterns[chunkPos];
+			} else
+#endif
+			{
+				const int yuv5 = YUV(5);
+				if (w5 != w1 && diffYUV(yuv5, YUV(1))) pattern |= 0x0001;
+				if (w5 != w2 && diffYUV(yuv5, YUV(2))) pattern |= 0x0002;
+				if (w5 != w3 && diffYUV(yuv5, YUV(3))) pattern |= 0x0004;
+				if (w5 != w4 && diffYUV(yuv5, YUV(4))) pattern |= 0x0008;
+				if (w5 != w6 && diffYUV(yuv5, YUV(6))) pattern |= 0x0010;
+				if (w5 != w7 && diffYUV(yuv5, YUV(7))) pattern |= 0x0020;
+				if (w5 != w8 && diffYUV(yuv5, YUV(8))) pattern |= 0x0040;
+				if (w5 != w9 && diffYUV(yuv5, YUV(9))) pattern |= 0x0080;
+			}
 
 			switch (pattern) {
 			case 0:
@@ -4988,7 +5252,27 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 	}
 }
 
+template<typename ColorMask>
+static void scale32(uint factor, bool simd, const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height) {
+#ifdef HQ_SIMD
+	if (simd) {
+		if (factor == 2)
+			HQ2x_implementation<ColorMask, true>(srcPtr, srcPitch, dstPtr, dstPitch, width, height);
+		else
+			HQ3x_implementation<ColorMask, true>(srcPtr, srcPitch, dstPtr, dstPitch, width, height);
+		return;
+	}
+#endif
+
+	if (factor == 2)
+		HQ2x_implementation<ColorMask, false>(srcPtr, srcPitch, dstPtr, dstPitch, width, height);
+	else
+		HQ3x_implementation<ColorMask, false>(srcPtr, srcPitch, dstPtr, dstPitch, width, height);
+}
+
 HQPlugin::HQPlugin() {
+	_simd = false;
+	enableSIMD(true);
 	_factor = 2;
 	_factors.push_back(2);
 	_factors.push_back(3);
@@ -5027,44 +5311,39 @@ void HQPlugin::scaleIntern(const uint8 *srcPtr, uint32 srcPitch,
 #else
 		case 2:
 			if (_format.gLoss == 2)
-				HQ2x_implementation<Graphics::ColorMasks<565> >(srcPtr, srcPitch, dstPtr,
+				HQ2x_implementation<Graphics::ColorMasks<565>, false>(srcPtr, srcPitch, dstPtr,
 						dstPitch, width, height);
 			else
-				HQ2x_implementation<Graphics::ColorMasks<555> >(srcPtr, srcPitch, dstPtr,
+				HQ2x_implementation<Graphics::ColorMasks<555>, false>(srcPtr, srcPitch, dstPtr,
 						dstPitch, width, height);
 			break;
 		case 3:
 			if (_format.gLoss == 2)
-				HQ3x_implementation<Graphics::ColorMasks<565> >(srcPtr, srcPitch, dstPtr,
+				HQ3x_implementation<Graphics::ColorMasks<565>, false>(srcPtr, srcPitch, dstPtr,
 						dstPitch, width, height);
 			else
-				HQ3x_implementation<Graphics::ColorMasks<555> >(srcPtr, srcPitch, dstPtr,
+				HQ3x_implementation<Graphics::ColorMasks<555>, false>(srcPtr, srcPitch, dstPtr,
 						dstPitch, width, height);
 			break;
 #endif
 		}
 	} else {
-		switch (_factor) {
-		case 2:
-			if (_format.aLoss == 0)
-				HQ2x_implementation<Graphics::ColorMasks<8888> >(srcPtr, srcPitch, dstPtr,
-						dstPitch, width, height);
-			else
-				HQ2x_implementation<Graphics::ColorMasks<888> >(srcPtr, srcPitch, dstPtr,
-						dstPitch, width, height);
-			break;
-		case 3:
-			if (_format.aLoss == 0)
-				HQ3x_implementation<Graphics::ColorMasks<8888> >(srcPtr, srcPitch, dstPtr,
-						dstPitch, width, height);
-			else
-				HQ3x_implementation<Graphics::ColorMasks<888> >(srcPtr, srcPitch, dstPtr,
-						dstPitch, width, height);
-			break;
-		}
+		if (_format.aLoss == 0)
+			scale32<Graphics::ColorMasks<8888> >(_factor, _simd, srcPtr, srcPitch, dstPtr, dstPitch, width, height);
+		else
+			scale32<Graphics::ColorMasks<888> >(_factor, _simd, srcPtr, srcPitch, dstPtr, dstPitch, width, height);
 	}
 }
 
+bool HQPlugin::enableSIMD(bool enable) {
+#ifdef HQ_SIMD
+	_simd = enable;
+#else
+	_simd = false;
+#endif
+	return _simd;
+}
+
 uint HQPlugin::increaseFactor() {
 	if (_factor < 3)
 		setFactor(_factor + 1);
@@ -35,9 +35,21 @@ public:
 	virtual uint extraPixels() const override { return 1; }
 	virtual const char *getName() const override;
 	virtual const char *getPrettyName() const override;
+
+	/**
+	 * Enable or disable the vectorized edge detection of the 32 bit
+	 * scalers. It is enabled by default whenever the build supports it,
+	 * and produces the same pixels as the scalar code.
+	 *
+	 * @return whether the vectorized code is now in use.
+	 */
+	bool enableSIMD(bool enable);
 protected:
 	virtual void scaleIntern(const uint8 *srcPtr, uint32 srcPitch,
 							uint8 *dstPtr, uint32 dstPitch, int width, int height, int x, int y) override;
+
+private:
+	bool _simd;
 };
 
 
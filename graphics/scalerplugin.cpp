@@ -21,11 +21,20 @@
 
 #include "graphics/scalerplugin.h"
 
+#include "common/system.h"
+#include "common/threadpool.h"
+
 void ScalerPluginObject::initialize(const Graphics::PixelFormat &format) {
 	_format = format;
 }
 
 namespace {
+
+enum {
+	kMinBandHeight = 16,
+	kMinBandedPixels = 128 * 128
+};
+
 /**
  * Trivial 'scaler' - in fact it doesn't do any scaling but just copies the
  * source to the destination.
@@ -55,9 +64,31 @@ void ScalerPluginObject::scale(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstP
 		} else {
 			Normal1x<uint32>(srcPtr, srcPitch, dstPtr, dstPitch, width, height);
 		}
-	} else {
+		return;
+	}
+
+	// Bands read extraPixels() rows beyond their edges, keep them tall
+	// enough for that overlap to stay small. Small rects are not worth
+	// handing to other threads.
+	const uint threadCount = _threadCount ? _threadCount : g_system->getCpuCount();
+	const int minBandHeight = MAX<int>(kMinBandHeight, extraPixels() * 8);
+	const int bandCount = MIN<int>(height / minBandHeight, threadCount * 4);
+	if (threadCount < 2 || bandCount < 2 || width * height < kMinBandedPixels || !canScaleInBands()) {
 		scaleIntern(srcPtr, srcPitch, dstPtr, dstPitch, width, height, x, y);
+		return;
 	}
+
+	// The calling thread scales bands too, and all of them if the pool has
+	// no worker threads
+	const int bandHeight = (height + bandCount - 1) / bandCount;
+	Common::ThreadPool::instance().parallelFor(0, bandCount, [=](int band) {
+		const int top = band * bandHeight;
+		const int bandRows = MIN(bandHeight, height - top);
+		if (bandRows > 0) {
+			scaleIntern(srcPtr + top * srcPitch, srcPitch, dstPtr + top * _factor * dstPitch, dstPitch,
+			            width, bandRows, x, y + top);
+		}
+	});
 }
 
 SourceScaler::SourceScaler() : _width(0), _height(0), _oldSrc(NULL), _enable(false) {
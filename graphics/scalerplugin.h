@@ -29,6 +29,7 @@
 class ScalerPluginObject : public PluginObject {
 public:
 
+	ScalerPluginObject() : _threadCount(0) {}
 	virtual ~ScalerPluginObject() {}
 
 	/**
@@ -47,6 +48,10 @@ public:
 	/**
 	 * Scale a rect.
 	 *
+	 * Large rects are split into horizontal bands which are scaled on
+	 * the worker threads of the default Common::ThreadPool, see
+	 * setThreadCount().
+	 *
 	 * @param srcPtr   Pointer to the source buffer.
 	 * @param srcPitch The number of bytes in a scanline of the source.
 	 * @param dstPtr   Pointer to the destination buffer.
@@ -59,6 +64,13 @@ public:
 	void scale(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr,
 	           uint32 dstPitch, int width, int height, int x, int y);
 
+	/**
+	 * Set the number of threads scale() splits rects for, including the
+	 * calling one. The default of 0 uses one thread per CPU. A count of 1
+	 * scales on the calling thread only.
+	 */
+	void setThreadCount(uint count) { _threadCount = count; }
+
 	/**
 	 * Increase the factor of scaling.
 	 * @return The new factor
@@ -155,9 +167,19 @@ protected:
 	virtual void scaleIntern(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr,
 	                         uint32 dstPitch, int width, int height, int x, int y) = 0;
 
+	/**
+	 * Whether scaleIntern() may be called concurrently on bands of the same
+	 * rect. The bands read the rows around them from the shared source, so
+	 * this holds for any scaler without per-call state in its members.
+	 */
+	virtual bool canScaleInBands() const { return true; }
+
 	uint _factor;
 	Common::Array<uint> _factors;
 	Graphics::PixelFormat _format;
+
+private:
+	uint _threadCount;
 };
 
 /**
@@ -184,6 +206,12 @@ protected:
 	virtual void scaleIntern(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr,
 	                         uint32 dstPitch, int width, int height, int x, int y) final;
 
+	/**
+	 * The old source is updated as each rect is scaled, so concurrent bands
+	 * would see the new pixels of their neighbours as unchanged.
+	 */
+	virtual bool canScaleInBands() const override { return false; }
+
 	/**
 	 * Scalers must implement this function. It will be called by oldSrcScale.
 	 * If by comparing the src and oldsrc images it is discovered that no change
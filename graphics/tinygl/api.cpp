@@ -690,3 +690,8 @@ void tglEnableDirtyRects(bool enable) {
 	TinyGL::GLContext *c = TinyGL::gl_get_context();
 	c->_enableDirtyRectangles = enable;
 }
+
+void tglSetRenderThreadCount(int count) {
+	TinyGL::GLContext *c = TinyGL::gl_get_context();
+	c->_renderThreadCount = MAX(count, 1);
+}
@@ -850,6 +850,8 @@ void tglTexCoordPointer(TGLint size, TGLenum type, TGLsizei stride, const TGLvoi
 void tglPolygonOffset(TGLfloat factor, TGLfloat units);
 
 void tglEnableDirtyRects(bool enable);
+// Rasterize the frame in horizontal bands on up to count threads when presenting.
+void tglSetRenderThreadCount(int count);
 
 void tglDebug(int mode);
 
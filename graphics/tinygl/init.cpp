@@ -234,6 +234,8 @@ void glInit(void *zbuffer1, int textureSize) {
 	c->_drawCallAllocator[0].initialize(kDrawCallMemory);
 	c->_drawCallAllocator[1].initialize(kDrawCallMemory);
 	c->_enableDirtyRectangles = true;
+	c->_renderThreadCount = 1;
+	c->_renderThreads = nullptr;
 
 	Graphics::Internal::tglBlitResetScissorRect();
 }
@@ -243,6 +245,7 @@ void glClose() {
 
 	tglDisposeDrawCallLists(c);
 	tglDisposeResources(c);
+	tglDisposeRenderThreads(c);
 
 	specbuf_cleanup(c);
 	for (int i = 0; i < 3; i++)
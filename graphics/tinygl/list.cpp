@@ -270,3 +270,19 @@ unsigned int glGenLists(int range) {
 }
 
 } // end of namespace TinyGL
+
+void tglNewList(unsigned int list, int mode) {
+	TinyGL::glNewList(list, mode);
+}
+
+void tglEndList() {
+	TinyGL::glEndList();
+}
+
+int tglIsList(unsigned int list) {
+	return TinyGL::glIsList(list);
+}
+
+unsigned int tglGenLists(int range) {
+	return TinyGL::glGenLists(range);
+}
@@ -30,7 +30,7 @@ namespace Graphics {
 #define ZB_POINT_ST_UNIT (1 << ZB_POINT_ST_FRAC_BITS)
 #define ZB_POINT_ST_FRAC_MASK (ZB_POINT_ST_UNIT - 1)
 
-TexelBuffer::TexelBuffer(unsigned int width, unsigned int height, unsigned int textureSize) {
+TexelBuffer::TexelBuffer(unsigned int width, unsigned int height, unsigned int textureSize, MipmapMode mipmapMode) {
 	assert(width);
 	assert(height);
 	assert(textureSize);
@@ -41,6 +41,56 @@ TexelBuffer::TexelBuffer(unsigned int width, unsigned int height, unsigned int t
 	_fracTextureMask = _fracTextureUnit - 1;
 	_widthRatio = (float) width / textureSize;
 	_heightRatio = (float) height / textureSize;
+	_mipmapMode = mipmapMode;
+
+	// Each level halves the previous one, down to a single pixel
+	_levelCount = 0;
+	_pixelCount = 0;
+	do {
+		Level &level = _levels[_levelCount++];
+		level.width = width;
+		level.height = height;
+		level.offset = _pixelCount;
+		level.widthRatio = (float) width / textureSize;
+		level.heightRatio = (float) height / textureSize;
+		_pixelCount += width * height;
+		width = MAX(width / 2, 1U);
+		height = MAX(height / 2, 1U);
+	} while (mipmapMode != kMipmapNone && _levelCount < kMaxLevels && (_levels[_levelCount - 1].width > 1 || _levels[_levelCount - 1].height > 1));
+}
+
+PixelBuffer TexelBuffer::createLevels(const PixelBuffer &buf) const {
+	if (_levelCount == 1)
+		return buf;
+
+	// Filter in ARGB, so that the texel buffers can convert it like any
+	// other source format.
+	const PixelFormat argb(4, 8, 8, 8, 8, 16, 8, 0, 24);
+	PixelBuffer levels(argb, _pixelCount, DisposeAfterUse::NO);
+	levels.copyBuffer(0, _width * _height, buf);
+
+	uint32 *pixels = (uint32 *)levels.getRawBuffer();
+	for (unsigned int l = 1; l < _levelCount; l++) {
+		const Level &src = _levels[l - 1];
+		const Level &dst = _levels[l];
+		for (unsigned int y = 0; y < dst.height; y++) {
+			const uint32 *row0 = pixels + src.offset + MIN(y * 2, src.height - 1) * src.width;
+			const uint32 *row1 = pixels + src.offset + MIN(y * 2 + 1, src.height - 1) * src.width;
+			uint32 *out = pixels + dst.offset + y * dst.width;
+			for (unsigned int x = 0; x < dst.width; x++) {
+				unsigned int x0 = MIN(x * 2, src.width - 1);
+				unsigned int x1 = MIN(x * 2 + 1, src.width - 1);
+				uint32 color = 0;
+				for (int shift = 0; shift < 32; shift += 8) {
+					unsigned int sum = ((row0[x0] >> shift) & 0xFF) + ((row0[x1] >> shift) & 0xFF) +
+					                   ((row1[x0] >> shift) & 0xFF) + ((row1[x1] >> shift) & 0xFF);
+					color |= ((sum + 2) >> 2) << shift;
+				}
+				out[x] = color;
+			}
+		}
+	}
+	return levels;
 }
 
 static inline unsigned int wrap(unsigned int wrap_mode, int coord, unsigned int _fracTextureUnit, unsigned int _fracTextureMask) {
@@ -62,26 +112,90 @@ static inline unsigned int wrap(unsigned int wrap_mode, int coord, unsigned int
 	}
 }
 
-void TexelBuffer::getARGBAt(
+void TexelBuffer::sampleLevel(
+	const Level &level,
 	unsigned int wrap_s, unsigned int wrap_t,
 	int s, int t,
 	uint8 &a, uint8 &r, uint8 &g, uint8 &b
 ) const {
 	unsigned int x, y;
-	x = wrap(wrap_s, s, _fracTextureUnit, _fracTextureMask) * _widthRatio;
-	y = wrap(wrap_t, t, _fracTextureUnit, _fracTextureMask) * _heightRatio;
+	x = wrap(wrap_s, s, _fracTextureUnit, _fracTextureMask) * level.widthRatio;
+	y = wrap(wrap_t, t, _fracTextureUnit, _fracTextureMask) * level.heightRatio;
 	getARGBAt(
-		(x >> ZB_POINT_ST_FRAC_BITS) + (y >> ZB_POINT_ST_FRAC_BITS) * _width,
+		level.offset + (x >> ZB_POINT_ST_FRAC_BITS) + (y >> ZB_POINT_ST_FRAC_BITS) * level.width,
 		x & ZB_POINT_ST_FRAC_MASK, y & ZB_POINT_ST_FRAC_MASK,
 		a, r, g, b
 	);
 }
 
+void TexelBuffer::getARGBAt(
+	unsigned int wrap_s, unsigned int wrap_t,
+	int s, int t,
+	uint8 &a, uint8 &r, uint8 &g, uint8 &b
+) const {
+	sampleLevel(_levels[0], wrap_s, wrap_t, s, t, a, r, g, b);
+}
+
+void TexelBuffer::getARGBAt(
+	unsigned int wrap_s, unsigned int wrap_t,
+	int s, int t, int lod,
+	uint8 &a, uint8 &r, uint8 &g, uint8 &b
+) const {
+	if (lod <= 0 || _levelCount == 1) {
+		sampleLevel(_levels[0], wrap_s, wrap_t, s, t, a, r, g, b);
+		return;
+	}
+
+	if (_mipmapMode == kMipmapNearest) {
+		unsigned int level = MIN<unsigned int>((lod + 128) >> 8, _levelCount - 1);
+		sampleLevel(_levels[level], wrap_s, wrap_t, s, t, a, r, g, b);
+		return;
+	}
+
+	unsigned int level = lod >> 8;
+	if (level >= _levelCount - 1) {
+		sampleLevel(_levels[_levelCount - 1], wrap_s, wrap_t, s, t, a, r, g, b);
+		return;
+	}
+
+	uint8 a1, r1, g1, b1;
+	int frac = lod & 0xFF;
+	sampleLevel(_levels[level], wrap_s, wrap_t, s, t, a, r, g, b);
+	sampleLevel(_levels[level + 1], wrap_s, wrap_t, s, t, a1, r1, g1, b1);
+	a += ((a1 - a) * frac) >> 8;
+	r += ((r1 - r) * frac) >> 8;
+	g += ((g1 - g) * frac) >> 8;
+	b += ((b1 - b) * frac) >> 8;
+}
+
+int TexelBuffer::getLevelOfDetail(float dsdx, float dtdx, float dsdy, float dtdy) const {
+	if (_levelCount == 1)
+		return 0;
+
+	// Footprint of the pixel in base level texels, along its longest axis
+	float scale = 1.0f / (1 << ZB_POINT_ST_FRAC_BITS);
+	float du = MAX(fabsf(dsdx), fabsf(dsdy)) * _widthRatio * scale;
+	float dv = MAX(fabsf(dtdx), fabsf(dtdy)) * _heightRatio * scale;
+	float rho = MAX(du, dv);
+	if (rho <= 1.0f)
+		return 0;
+
+	// log2(rho), linearly interpolated between powers of two
+	int level = 0;
+	while (rho >= 2.0f && level < (int)kMaxLevels) {
+		rho *= 0.5f;
+		level++;
+	}
+	return (level << 8) + (int)((rho - 1.0f) * 256);
+}
+
 // Nearest: store texture in original size.
-NearestTexelBuffer::NearestTexelBuffer(const PixelBuffer &buf, unsigned int width, unsigned int height, unsigned int textureSize) : TexelBuffer(width, height, textureSize) {
-	unsigned int pixel_count = _width * _height;
-	_buf = PixelBuffer(buf.getFormat(), pixel_count, DisposeAfterUse::NO);
-	_buf.copyBuffer(0, pixel_count, buf);
+NearestTexelBuffer::NearestTexelBuffer(const PixelBuffer &buf, unsigned int width, unsigned int height, unsigned int textureSize, MipmapMode mipmapMode) : TexelBuffer(width, height, textureSize, mipmapMode) {
+	PixelBuffer levels = createLevels(buf);
+	_buf = PixelBuffer(buf.getFormat(), _pixelCount, DisposeAfterUse::NO);
+	_buf.copyBuffer(0, _pixelCount, levels);
+	if (hasMipmaps())
+		levels.free();
 }
 
 NearestTexelBuffer::~NearestTexelBuffer() {
@@ -112,16 +226,25 @@ void NearestTexelBuffer::getARGBAt(
 #define P11_OFFSET 3
 #define PIXEL_PER_TEXEL_SHIFT 2
 
-BilinearTexelBuffer::BilinearTexelBuffer(const PixelBuffer &buf, unsigned int width, unsigned int height, unsigned int textureSize) : TexelBuffer(width, height, textureSize) {
-	unsigned int pixel00_offset = 0, pixel11_offset, pixel01_offset, pixel10_offset;
+BilinearTexelBuffer::BilinearTexelBuffer(const PixelBuffer &buf, unsigned int width, unsigned int height, unsigned int textureSize, MipmapMode mipmapMode) : TexelBuffer(width, height, textureSize, mipmapMode) {
+	PixelBuffer levels = createLevels(buf);
+	_texels = new uint32[_pixelCount << PIXEL_PER_TEXEL_SHIFT];
+	for (unsigned int l = 0; l < _levelCount; l++)
+		fillLevel(levels, _levels[l]);
+	if (hasMipmaps())
+		levels.free();
+}
+
+void BilinearTexelBuffer::fillLevel(const PixelBuffer &buf, const Level &level) {
+	unsigned int pixel00_offset = level.offset, pixel11_offset, pixel01_offset, pixel10_offset;
 	uint8 *texel8;
 	uint32 *texel32;
 
-	texel32 = _texels = new uint32[_width * _height << PIXEL_PER_TEXEL_SHIFT];
-	for (unsigned int y = 0; y < _height; y++) {
-		for (unsigned int x = 0; x < _width; x++) {
+	texel32 = _texels + (level.offset << PIXEL_PER_TEXEL_SHIFT);
+	for (unsigned int y = 0; y < level.height; y++) {
+		for (unsigned int x = 0; x < level.width; x++) {
 			texel8 = (uint8 *)texel32;
-			pixel11_offset = pixel00_offset + _width + 1;
+			pixel11_offset = pixel00_offset + level.width + 1;
 			buf.getARGBAt(
 				pixel00_offset,
 				*(texel8 + P00_OFFSET + A_OFFSET),
@@ -129,7 +252,7 @@ BilinearTexelBuffer::BilinearTexelBuffer(const PixelBuffer &buf, unsigned int wi
 				*(texel8 + P00_OFFSET + G_OFFSET),
 				*(texel8 + P00_OFFSET + B_OFFSET)
 			);
-			if ((x + 1) == _width) {
+			if ((x + 1) == level.width) {
 				pixel11_offset -= 1;
 				pixel01_offset = pixel00_offset;
 			} else
@@ -141,11 +264,11 @@ BilinearTexelBuffer::BilinearTexelBuffer(const PixelBuffer &buf, unsigned int wi
 				*(texel8 + P01_OFFSET + G_OFFSET),
 				*(texel8 + P01_OFFSET + B_OFFSET)
 			);
-			if ((y + 1) == _height) {
-				pixel11_offset -= _width;
+			if ((y + 1) == level.height) {
+				pixel11_offset -= level.width;
 				pixel10_offset = pixel00_offset;
 			} else
-				pixel10_offset = pixel00_offset + _width;
+				pixel10_offset = pixel00_offset + level.width;
 			buf.getARGBAt(
 				pixel10_offset,
 				*(texel8 + P10_OFFSET + A_OFFSET),
@@ -29,7 +29,13 @@ namespace Graphics {
 
 class TexelBuffer {
 public:
-	TexelBuffer(unsigned int width, unsigned int height, unsigned int textureSize);
+	enum MipmapMode {
+		kMipmapNone,    /** Only the base level exists */
+		kMipmapNearest, /** The closest level is sampled */
+		kMipmapLinear   /** The two closest levels are sampled and blended */
+	};
+
+	TexelBuffer(unsigned int width, unsigned int height, unsigned int textureSize, MipmapMode mipmapMode);
 	virtual ~TexelBuffer() {};
 
 	void getARGBAt(
@@ -38,19 +44,66 @@ public:
 		uint8 &a, uint8 &r, uint8 &g, uint8 &b
 	) const;
 
+	/**
+	 * Sample the texture at a level of detail, as returned by
+	 * getLevelOfDetail(). Level of details of 0 or less sample the base
+	 * level, like the overload above.
+	 */
+	void getARGBAt(
+		unsigned int wrap_s, unsigned int wrap_t,
+		int s, int t, int lod,
+		uint8 &a, uint8 &r, uint8 &g, uint8 &b
+	) const;
+
+	/**
+	 * Compute the level of detail for a pixel from the derivatives of its
+	 * texture coordinates, in the same fixed point unit as the coordinates.
+	 *
+	 * @return the mipmap level, in 1/256 of a level.
+	 */
+	int getLevelOfDetail(float dsdx, float dtdx, float dsdy, float dtdy) const;
+
+	bool hasMipmaps() const { return _levelCount > 1; }
+
 protected:
 	virtual void getARGBAt(
 		unsigned int pixel,
 		unsigned int ds, unsigned int dt,
 		uint8 &a, uint8 &r, uint8 &g, uint8 &b
 	) const = 0;
+
+	struct Level {
+		unsigned int width, height;
+		unsigned int offset; // index of the first pixel of the level
+		float widthRatio, heightRatio;
+	};
+
+	/**
+	 * Build the pixels of all levels, one after the other, by box filtering
+	 * the base level. The caller must free the returned buffer. Without
+	 * mipmaps, the base level is returned as is.
+	 */
+	PixelBuffer createLevels(const PixelBuffer &buf) const;
+
+	void sampleLevel(
+		const Level &level,
+		unsigned int wrap_s, unsigned int wrap_t,
+		int s, int t,
+		uint8 &a, uint8 &r, uint8 &g, uint8 &b
+	) const;
+
+	static const unsigned int kMaxLevels = 16;
+
 	unsigned int _width, _height, _fracTextureUnit, _fracTextureMask;
 	float _widthRatio, _heightRatio;
+	Level _levels[kMaxLevels];
+	unsigned int _levelCount, _pixelCount;
+	MipmapMode _mipmapMode;
 };
 
 class NearestTexelBuffer : public TexelBuffer {
 public:
-	NearestTexelBuffer(const PixelBuffer &buf, unsigned int width, unsigned int height, unsigned int textureSize);
+	NearestTexelBuffer(const PixelBuffer &buf, unsigned int width, unsigned int height, unsigned int textureSize, MipmapMode mipmapMode = kMipmapNone);
 	~NearestTexelBuffer();
 
 protected:
@@ -66,7 +119,7 @@ private:
 
 class BilinearTexelBuffer : public TexelBuffer {
 public:
-	BilinearTexelBuffer(const PixelBuffer &buf, unsigned int width, unsigned int height, unsigned int textureSize);
+	BilinearTexelBuffer(const PixelBuffer &buf, unsigned int width, unsigned int height, unsigned int textureSize, MipmapMode mipmapMode = kMipmapNone);
 	~BilinearTexelBuffer();
 
 protected:
@@ -77,6 +130,8 @@ protected:
 	) const override;
 
 private:
+	void fillLevel(const PixelBuffer &buf, const Level &level);
+
 	uint32 *_texels;
 };
 
@@ -196,11 +196,29 @@ void glopTexImage2D(GLContext *c, GLParam *p) {
 	}
 	if (pixels != NULL) {
 		unsigned int filter;
+		Graphics::TexelBuffer::MipmapMode mipmapMode;
 		Graphics::PixelBuffer src(formatType2PixelFormat(format, type), pixels);
 		if (width > c->_textureSize || height > c->_textureSize)
 			filter = c->texture_mag_filter;
 		else
 			filter = c->texture_min_filter;
+		// Only the base level is rendered, the rest of the mip chain is
+		// generated from it rather than taken from the other levels.
+		mipmapMode = Graphics::TexelBuffer::kMipmapNone;
+		if (level == 0) {
+			switch (c->texture_min_filter) {
+			case TGL_NEAREST_MIPMAP_NEAREST:
+			case TGL_LINEAR_MIPMAP_NEAREST:
+				mipmapMode = Graphics::TexelBuffer::kMipmapNearest;
+				break;
+			case TGL_NEAREST_MIPMAP_LINEAR:
+			case TGL_LINEAR_MIPMAP_LINEAR:
+				mipmapMode = Graphics::TexelBuffer::kMipmapLinear;
+				break;
+			default:
+				break;
+			}
+		}
 		switch (filter) {
 		case TGL_LINEAR_MIPMAP_NEAREST:
 		case TGL_LINEAR_MIPMAP_LINEAR:
@@ -208,14 +226,16 @@ void glopTexImage2D(GLContext *c, GLParam *p) {
 			im->pixmap = new Graphics::BilinearTexelBuffer(
 				src,
 				width, height,
-				c->_textureSize
+				c->_textureSize,
+				mipmapMode
 			);
 			break;
 		default:
 			im->pixmap = new Graphics::NearestTexelBuffer(
 				src,
 				width, height,
-				c->_textureSize
+				c->_textureSize,
+				mipmapMode
 			);
 			break;
 		}
@@ -91,6 +91,7 @@ FrameBuffer::FrameBuffer(int width, int height, const Graphics::PixelBuffer &fra
 
 	this->_zbuf = (unsigned int *)gl_malloc(size);
 	memset(this->_zbuf, 0, size);
+	this->_zbufAllocated = true;
 
 	this->frame_buffer_allocated = 0;
 	this->pbuf = frame_buffer;
@@ -104,6 +105,8 @@ FrameBuffer::FrameBuffer(int width, int height, const Graphics::PixelBuffer &fra
 	_alphaTestEnabled = false;
 	_depthTestEnabled = false;
 	_depthFunc = TGL_LESS;
+	_simdSpans = false;
+	enableSIMDSpans(true);
 }
 
 FrameBuffer::FrameBuffer(int width, int height, const Graphics::PixelFormat &format) : _depthWrite(true), _enableScissor(false) {
@@ -117,6 +120,7 @@ FrameBuffer::FrameBuffer(int width, int height, const Graphics::PixelFormat &for
 
 	this->_zbuf = (unsigned int *)gl_malloc(size);
 	memset(this->_zbuf, 0, size);
+	this->_zbufAllocated = true;
 
 	byte *pixelBuffer = (byte *)gl_malloc(this->ysize * this->linesize);
 	this->pbuf.set(this->cmode, pixelBuffer);
@@ -131,12 +135,28 @@ FrameBuffer::FrameBuffer(int width, int height, const Graphics::PixelFormat &for
 	_alphaTestEnabled = false;
 	_depthTestEnabled = false;
 	_depthFunc = TGL_LESS;
+	_simdSpans = false;
+	enableSIMDSpans(true);
 }
 
 FrameBuffer::~FrameBuffer() {
 	if (frame_buffer_allocated)
 		pbuf.free();
-	gl_free(_zbuf);
+	if (_zbufAllocated)
+		gl_free(_zbuf);
+}
+
+FrameBuffer *FrameBuffer::createSharedView() const {
+	FrameBuffer *view = new FrameBuffer(*this);
+	view->frame_buffer_allocated = 0;
+	view->_zbufAllocated = false;
+	return view;
+}
+
+void FrameBuffer::updateSharedView(FrameBuffer *view) const {
+	*view = *this;
+	view->frame_buffer_allocated = 0;
+	view->_zbufAllocated = false;
 }
 
 Buffer *FrameBuffer::genOffscreenBuffer() {
@@ -105,6 +105,21 @@ struct FrameBuffer {
 	FrameBuffer(int xsize, int ysize, const Graphics::PixelFormat &format);
 	~FrameBuffer();
 
+	/**
+	 * Create a frame buffer which draws into the same color and depth
+	 * buffers as this one, but has its own rendering state (scissor,
+	 * blending, texture...). The view does not own the buffers, so it
+	 * must be deleted before this frame buffer.
+	 */
+	FrameBuffer *createSharedView() const;
+
+	/**
+	 * Make a view returned by createSharedView() draw into the current
+	 * color and depth buffers of this frame buffer again, with its
+	 * current rendering state.
+	 */
+	void updateSharedView(FrameBuffer *view) const;
+
 	Buffer *genOffscreenBuffer();
 	void delOffscreenBuffer(Buffer *buffer);
 	void clear(int clear_z, int z, int clear_color, int r, int g, int b);
@@ -442,6 +457,16 @@ struct FrameBuffer {
 	template <bool kInterpRGB, bool kInterpZ, bool kInterpST, bool kInterpSTZ, int kDrawMode>
 	void fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint *p2);
 
+	/**
+	 * Enable or disable the vectorized span loops of the depth only, flat
+	 * and smooth triangle fillers. They are enabled by default whenever
+	 * the CPU and the pixel format allow them, and produce the same pixels
+	 * as the scalar loops.
+	 *
+	 * @return whether the vectorized loops are now in use.
+	 */
+	bool enableSIMDSpans(bool enable);
+
 	void fillTriangleTextureMappingPerspectiveSmooth(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint *p2);
 	void fillTriangleTextureMappingPerspectiveFlat(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint *p2);
 	void fillTriangleDepthOnly(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint *p2);
@@ -516,6 +541,8 @@ private:
 	void drawLine(const ZBufferPoint *p1, const ZBufferPoint *p2);
 
 	unsigned int *_zbuf;
+	bool _zbufAllocated;
+	bool _simdSpans;
 	bool _depthWrite;
 	Graphics::PixelBuffer pbuf;
 	bool _blendingEnabled;
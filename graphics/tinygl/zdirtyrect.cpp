@@ -29,14 +29,24 @@
 #include "graphics/tinygl/zdirtyrect.h"
 #include "graphics/tinygl/zgl.h"
 #include "graphics/tinygl/gl.h"
+#include "common/atomic.h"
 #include "common/debug.h"
 #include "common/math.h"
+#include "common/system.h"
+#include "common/threadpool.h"
+#include "graphics/dirtytilegrid.h"
 
 namespace TinyGL {
 
+// The threaded presentation bins draw calls by their dirty region, so
+// the regions are needed whenever it is enabled.
+static inline bool tglNeedsDirtyRegions(const GLContext *c) {
+	return c->_enableDirtyRectangles || c->_renderThreadCount > 1;
+}
+
 void tglIssueDrawCall(Graphics::DrawCall *drawCall) {
 	TinyGL::GLContext *c = TinyGL::gl_get_context();
-	if (c->_enableDirtyRectangles && drawCall->getDirtyRegion().isEmpty())
+	if (tglNeedsDirtyRegions(c) && drawCall->getDirtyRegion().isEmpty())
 		return;
 	c->_drawCallsQueue.push_back(drawCall);
 }
@@ -65,19 +75,10 @@ static void tglDrawRectangle(Common::Rect rect, int r, int g, int b) {
 }
 #endif
 
-struct DirtyRectangle {
-	Common::Rect rectangle;
-	int r, g, b;
-
-	DirtyRectangle() { }
-	DirtyRectangle(Common::Rect rect, int red, int green, int blue) {
-		this->rectangle = rect;
-		this->r = red;
-		this->g = green;
-		this->b = blue;
-	}
-};
-
+// Dirty regions are tracked with a grid of square tiles of this size, in
+// pixels. Marking a region and testing it are linear in the number of
+// tiles it covers, whatever the number of draw calls.
+static const int kDirtyTileSize = 16;
 
 void tglDisposeResources(TinyGL::GLContext *c) {
 	// Dispose textures and resources.
@@ -113,17 +114,221 @@ void tglDisposeDrawCallLists(TinyGL::GLContext *c) {
 	c->_drawCallsQueue.clear();
 }
 
-static inline void _appendDirtyRectangle(const Graphics::DrawCall &call, Common::List<DirtyRectangle> &rectangles, int r, int g, int b) {
-	Common::Rect dirty_region = call.getDirtyRegion();
-	if (rectangles.empty() || dirty_region != rectangles.back().rectangle)
-		rectangles.push_back(DirtyRectangle(dirty_region, r, g, b));
+// Height, in scanlines, of the bands the frame buffer is split into when
+// presenting on several threads. Each band is rasterized by one thread,
+// running the draw calls which touch it in their original order.
+static const int kRenderBandHeight = 32;
+
+struct RenderBand {
+	Common::Array<Common::Rect> clipRects;
+	Common::Array<const Graphics::DrawCall *> drawCalls;
+};
+
+struct RenderWorker {
+	RenderThreads *threads;
+	GLContext *context;
+	Common::Task *task;
+	Common::Array<GLVertex> vertices;
+};
+
+struct RenderThreads {
+	Common::Array<RenderBand> bands;
+	Common::Array<RenderWorker> workers;
+	Common::Atomic<uint32> nextBand;
+};
+
+static void tglRenderThread(RenderWorker &worker);
+
+// Workers are moved around as the array grows, so their task finds them by index.
+class RenderTask : public Common::Task {
+public:
+	RenderTask(RenderThreads *threads, uint index) : _threads(threads), _index(index) {}
+	~RenderTask() { wait(); }
+
+protected:
+	virtual void run() override { tglRenderThread(_threads->workers[_index]); }
+
+private:
+	RenderThreads *_threads;
+	uint _index;
+};
+
+static RenderThreads *tglGetRenderThreads(GLContext *c) {
+	if (!c->_renderThreads)
+		c->_renderThreads = new RenderThreads();
+
+	// Workers get their own context, so the rasterization state of each
+	// draw call can be applied without touching the main one. The contexts
+	// and their views of the frame buffer are kept for the next frames.
+	Common::Array<RenderWorker> &workers = c->_renderThreads->workers;
+	while (workers.size() > (uint)c->_renderThreadCount) {
+		delete workers.back().task;
+		delete workers.back().context->fb;
+		delete workers.back().context;
+		workers.pop_back();
+	}
+	while (workers.size() < (uint)c->_renderThreadCount) {
+		RenderWorker worker;
+		worker.threads = c->_renderThreads;
+		worker.context = new GLContext();
+		worker.context->fb = nullptr;
+		worker.task = new RenderTask(c->_renderThreads, workers.size());
+		workers.push_back(worker);
+	}
+
+	return c->_renderThreads;
+}
+
+void tglDisposeRenderThreads(GLContext *c) {
+	if (!c->_renderThreads)
+		return;
+
+	for (uint i = 0; i < c->_renderThreads->workers.size(); i++) {
+		delete c->_renderThreads->workers[i].task;
+		delete c->_renderThreads->workers[i].context->fb;
+		delete c->_renderThreads->workers[i].context;
+	}
+	delete c->_renderThreads;
+	c->_renderThreads = nullptr;
+}
+
+static void tglRenderBand(RenderWorker &worker, const RenderBand &band) {
+	for (uint i = 0; i < band.drawCalls.size(); i++) {
+		const Graphics::DrawCall *drawCall = band.drawCalls[i];
+		Common::Rect drawCallRegion = drawCall->getDirtyRegion();
+		for (uint j = 0; j < band.clipRects.size(); j++) {
+			if (!band.clipRects[j].intersects(drawCallRegion))
+				continue;
+
+			switch (drawCall->getType()) {
+			case Graphics::DrawCall::DrawCall_Rasterization:
+				((const Graphics::RasterizationDrawCall *)drawCall)->execute(worker.context, band.clipRects[j], worker.vertices);
+				break;
+			case Graphics::DrawCall::DrawCall_Clear:
+				((const Graphics::ClearBufferDrawCall *)drawCall)->execute(worker.context, band.clipRects[j]);
+				break;
+			default:
+				break;
+			}
+		}
+	}
+}
+
+static void tglRenderThread(RenderWorker &worker) {
+	RenderThreads *threads = worker.threads;
+
+	while (true) {
+		uint32 band = threads->nextBand.fetchAdd(1);
+		if (band >= threads->bands.size())
+			break;
+		tglRenderBand(worker, threads->bands[band]);
+	}
+}
+
+// Rasterize a run of draw calls without blits, spreading the bands over the workers.
+static void tglRenderSegment(GLContext *c, RenderThreads *threads, Common::List<Graphics::DrawCall *>::const_iterator begin, Common::List<Graphics::DrawCall *>::const_iterator end) {
+	typedef Common::List<Graphics::DrawCall *>::const_iterator DrawCallIterator;
+
+	const int lastBand = threads->bands.size() - 1;
+	for (DrawCallIterator it = begin; it != end; ++it) {
+		Common::Rect drawCallRegion = (*it)->getDirtyRegion();
+		int first = CLIP<int>(drawCallRegion.top / kRenderBandHeight, 0, lastBand);
+		int last = CLIP<int>((drawCallRegion.bottom - 1) / kRenderBandHeight, 0, lastBand);
+		for (int i = first; i <= last; i++) {
+			RenderBand &band = threads->bands[i];
+			for (uint j = 0; j < band.clipRects.size(); j++) {
+				if (band.clipRects[j].intersects(drawCallRegion)) {
+					band.drawCalls.push_back(*it);
+					break;
+				}
+			}
+		}
+	}
+
+	uint busyBands = 0;
+	for (uint i = 0; i < threads->bands.size(); i++) {
+		if (!threads->bands[i].drawCalls.empty())
+			busyBands++;
+	}
+
+	uint threadCount = MIN<uint>(threads->workers.size(), busyBands);
+	for (uint i = 0; i < threadCount; i++) {
+		GLContext *workerContext = threads->workers[i].context;
+		if (workerContext->fb)
+			c->fb->updateSharedView(workerContext->fb);
+		else
+			workerContext->fb = c->fb->createSharedView();
+		workerContext->render_mode = c->render_mode;
+		workerContext->current_cull_face = c->current_cull_face;
+		workerContext->vertex_n = c->vertex_n;
+	}
+
+	// The calling thread renders too, and picks up all the bands if the
+	// thread pool has no worker threads.
+	threads->nextBand.store(0);
+	for (uint i = 1; i < threadCount; i++)
+		Common::ThreadPool::instance().start(threads->workers[i].task);
+	if (threadCount > 0)
+		tglRenderThread(threads->workers[0]);
+	for (uint i = 1; i < threadCount; i++)
+		threads->workers[i].task->wait();
+
+	for (uint i = 0; i < threads->bands.size(); i++)
+		threads->bands[i].drawCalls.resize(0);
+}
+
+static inline bool tglUseRenderThreads(GLContext *c) {
+	return c->_renderThreadCount > 1 && c->render_mode != TGL_SELECT;
+}
+
+// Execute the frame's draw calls inside clipRects, rasterizing on several threads.
+// Blits read the global context, so they stay on this thread and split the frame
+// into segments which are rendered one after another.
+static void tglExecuteDrawCallsThreaded(GLContext *c, const Common::Array<Common::Rect> &clipRects, bool clipBlits) {
+	typedef Common::List<Graphics::DrawCall *>::const_iterator DrawCallIterator;
+
+	RenderThreads *threads = tglGetRenderThreads(c);
+	threads->bands.resize((c->fb->ysize + kRenderBandHeight - 1) / kRenderBandHeight);
+	for (uint i = 0; i < threads->bands.size(); i++) {
+		Common::Rect bandRect(0, i * kRenderBandHeight, c->fb->xsize, MIN<int>((i + 1) * kRenderBandHeight, c->fb->ysize));
+		RenderBand &band = threads->bands[i];
+		band.clipRects.resize(0);
+		for (uint j = 0; j < clipRects.size(); j++) {
+			Common::Rect clipRect = clipRects[j].findIntersectingRect(bandRect);
+			if (!clipRect.isEmpty())
+				band.clipRects.push_back(clipRect);
+		}
+	}
+
+	DrawCallIterator it = c->_drawCallsQueue.begin();
+	DrawCallIterator end = c->_drawCallsQueue.end();
+	while (it != end) {
+		if ((*it)->getType() == Graphics::DrawCall::DrawCall_Blitting) {
+			if (clipBlits) {
+				Common::Rect drawCallRegion = (*it)->getDirtyRegion();
+				for (uint i = 0; i < clipRects.size(); i++) {
+					if (clipRects[i].intersects(drawCallRegion))
+						(*it)->execute(clipRects[i], true);
+				}
+			} else {
+				(*it)->execute(true);
+			}
+			++it;
+			continue;
+		}
+
+		DrawCallIterator segmentEnd = it;
+		while (segmentEnd != end && (*segmentEnd)->getType() != Graphics::DrawCall::DrawCall_Blitting)
+			++segmentEnd;
+		tglRenderSegment(c, threads, it, segmentEnd);
+		it = segmentEnd;
+	}
 }
 
 static void tglPresentBufferDirtyRects(TinyGL::GLContext *c) {
 	typedef Common::List<Graphics::DrawCall *>::const_iterator DrawCallIterator;
-	typedef Common::List<TinyGL::DirtyRectangle>::iterator RectangleIterator;
 
-	Common::List<DirtyRectangle> rectangles;
+	Graphics::DirtyTileGrid dirtyTiles(c->fb->xsize, c->fb->ysize, kDirtyTileSize);
 
 	DrawCallIterator itFrame = c->_drawCallsQueue.begin();
 	DrawCallIterator endFrame = c->_drawCallsQueue.end();
@@ -137,93 +342,54 @@ static void tglPresentBufferDirtyRects(TinyGL::GLContext *c) {
 			const Graphics::DrawCall &previousCall = **itPrevFrame;
 
 			if (previousCall != currentCall) {
-				_appendDirtyRectangle(previousCall, rectangles, 255, 255, 255);
-				_appendDirtyRectangle(currentCall, rectangles, 255, 0, 0);
+				dirtyTiles.markRegion(previousCall.getDirtyRegion());
+				dirtyTiles.markRegion(currentCall.getDirtyRegion());
 			}
 	}
 
 	for ( ; itPrevFrame != endPrevFrame; ++itPrevFrame) {
-		_appendDirtyRectangle(**itPrevFrame, rectangles, 255, 255, 255);
+		dirtyTiles.markRegion((*itPrevFrame)->getDirtyRegion());
 	}
 
 	for ( ; itFrame != endFrame; ++itFrame) {
-		_appendDirtyRectangle(**itFrame, rectangles, 255, 0, 0);
-	}
-
-	// This loop increases outer rectangle coordinates to favor merging of adjacent rectangles.
-	for (RectangleIterator it = rectangles.begin(); it != rectangles.end(); ++it) {
-		(*it).rectangle.right++;
-		(*it).rectangle.bottom++;
-	}
-
-	// Merge coalesce dirty rects.
-	bool restartMerge;
-	do {
-		restartMerge = false;
-		for (RectangleIterator it1 = rectangles.begin(); it1 != rectangles.end(); ++it1) {
-			for (RectangleIterator it2 = rectangles.begin(); it2 != rectangles.end();) {
-				if (it1 != it2) {
-					if ((*it1).rectangle.intersects((*it2).rectangle)) {
-						(*it1).rectangle.extend((*it2).rectangle);
-						it2 = rectangles.erase(it2);
-						restartMerge = true;
-					} else {
-						++it2;
-					}
-				} else {
-					++it2;
-				}
-			}
-		}
-	} while(restartMerge);
-
-	for (RectangleIterator it1 = rectangles.begin(); it1 != rectangles.end(); ++it1) {
-		RectangleIterator it2 = it1;
-		it2++;
-		while (it2 != rectangles.end()) {
-			if ((*it1).rectangle.contains((*it2).rectangle)) {
-				it2 = rectangles.erase(it2);
-			} else {
-				++it2;
-			}
-		}
+		dirtyTiles.markRegion((*itFrame)->getDirtyRegion());
 	}
 
-	for (RectangleIterator it1 = rectangles.begin(); it1 != rectangles.end(); ++it1) {
-		(*it1).rectangle.clip(c->renderRect);
-	}
+	Common::Array<Common::Rect> rectangles;
+	dirtyTiles.extractRectangles(c->renderRect, rectangles);
 
-	if (!rectangles.empty()) {
-		// Execute draw calls.
+	if (!rectangles.empty() && tglUseRenderThreads(c)) {
+		tglExecuteDrawCallsThreaded(c, rectangles, true);
+	} else if (!rectangles.empty()) {
+		// Execute draw calls, skipping the ones which don't touch any dirty tile.
+		Common::Array<uint> touched;
 		for (DrawCallIterator it = c->_drawCallsQueue.begin(); it != c->_drawCallsQueue.end(); ++it) {
 			Common::Rect drawCallRegion = (*it)->getDirtyRegion();
-			for (RectangleIterator itRect = rectangles.begin(); itRect != rectangles.end(); ++itRect) {
-				Common::Rect dirtyRegion = (*itRect).rectangle;
+			dirtyTiles.findRectangles(drawCallRegion, rectangles, touched);
+			for (uint i = 0; i < touched.size(); i++) {
+				const Common::Rect &dirtyRegion = rectangles[touched[i]];
 				if (dirtyRegion.intersects(drawCallRegion)) {
 					(*it)->execute(dirtyRegion, true);
 				}
 			}
 		}
+	}
+
 #if TGL_DIRTY_RECT_SHOW
-		// Draw debug rectangles.
-		// Note: white rectangles are rectangle that contained other rectangles
-		// blue rectangles are rectangle merged from other rectangles
-		// red rectangles are original dirty rects
-
-		bool blendingEnabled = c->fb->isBlendingEnabled();
-		bool alphaTestEnabled = c->fb->isAlphaTestEnabled();
-		c->fb->enableBlending(false);
-		c->fb->enableAlphaTest(false);
-
-		for (RectangleIterator it = rectangles.begin(); it != rectangles.end(); ++it) {
-			tglDrawRectangle((*it).rectangle, (*it).r, (*it).g, (*it).b);
-		}
+	// Draw the redrawn rectangles.
+	bool blendingEnabled = c->fb->isBlendingEnabled();
+	bool alphaTestEnabled = c->fb->isAlphaTestEnabled();
+	c->fb->enableBlending(false);
+	c->fb->enableAlphaTest(false);
 
-		c->fb->enableBlending(blendingEnabled);
-		c->fb->enableAlphaTest(alphaTestEnabled);
-#endif
+	for (uint i = 0; i < rectangles.size(); i++) {
+		tglDrawRectangle(rectangles[i], 255, 0, 0);
 	}
 
+	c->fb->enableBlending(blendingEnabled);
+	c->fb->enableAlphaTest(alphaTestEnabled);
+#endif
+
 	// Dispose not necessary draw calls.
 	for (DrawCallIterator it = c->_previousFrameDrawCallsQueue.begin(); it != c->_previousFrameDrawCallsQueue.end(); ++it) {
 		delete *it;
@@ -242,9 +408,17 @@ static void tglPresentBufferDirtyRects(TinyGL::GLContext *c) {
 static void tglPresentBufferSimple(TinyGL::GLContext *c) {
 	typedef Common::List<Graphics::DrawCall *>::const_iterator DrawCallIterator;
 
-	for (DrawCallIterator it = c->_drawCallsQueue.begin(); it != c->_drawCallsQueue.end(); ++it) {
-		(*it)->execute(true);
-		delete *it;
+	if (tglUseRenderThreads(c)) {
+		Common::Array<Common::Rect> clipRects;
+		clipRects.push_back(Common::Rect(c->fb->xsize, c->fb->ysize));
+		tglExecuteDrawCallsThreaded(c, clipRects, false);
+		for (DrawCallIterator it = c->_drawCallsQueue.begin(); it != c->_drawCallsQueue.end(); ++it)
+			delete *it;
+	} else {
+		for (DrawCallIterator it = c->_drawCallsQueue.begin(); it != c->_drawCallsQueue.end(); ++it) {
+			(*it)->execute(true);
+			delete *it;
+		}
 	}
 
 	c->_drawCallsQueue.clear();
@@ -294,8 +468,8 @@ RasterizationDrawCall::RasterizationDrawCall() : DrawCall(DrawCall_Rasterization
 	_drawTriangleFront = c->draw_triangle_front;
 	_drawTriangleBack = c->draw_triangle_back;
 	memcpy(_vertex, c->vertex, sizeof(TinyGL::GLVertex) * _vertexCount);
-	_state = captureState();
-	if (c->_enableDirtyRectangles) {
+	_state = captureState(c);
+	if (TinyGL::tglNeedsDirtyRegions(c)) {
 		computeDirtyRegion();
 	}
 }
@@ -338,14 +512,37 @@ void RasterizationDrawCall::execute(bool restoreState) const {
 
 	RasterizationDrawCall::RasterizationState backupState;
 	if (restoreState) {
-		backupState = captureState();
+		backupState = captureState(c);
 	}
-	applyState(_state);
+	applyState(c, _state);
 
 	TinyGL::GLVertex *prevVertex = c->vertex;
 	int prevVertexCount = c->vertex_cnt;
 
-	c->vertex = _vertex;
+	drawPrimitives(c, _vertex);
+
+	c->vertex = prevVertex;
+	c->vertex_cnt = prevVertexCount;
+
+	if (restoreState) {
+		applyState(c, backupState);
+	}
+}
+
+void RasterizationDrawCall::execute(TinyGL::GLContext *c, const Common::Rect &clippingRectangle, Common::Array<TinyGL::GLVertex> &scratch) const {
+	// Rasterization writes to the vertices (edge flags, quad strips), so
+	// every execution gets a fresh copy.
+	scratch.resize(_vertexCount);
+	memcpy(scratch.begin(), _vertex, sizeof(TinyGL::GLVertex) * _vertexCount);
+
+	applyState(c, _state);
+	c->fb->setScissorRectangle(clippingRectangle);
+	drawPrimitives(c, scratch.begin());
+	c->fb->resetScissorRectangle();
+}
+
+void RasterizationDrawCall::drawPrimitives(TinyGL::GLContext *c, TinyGL::GLVertex *vertices) const {
+	c->vertex = vertices;
 	c->vertex_cnt = _vertexCount;
 	c->draw_triangle_front = (TinyGL::gl_draw_triangle_func)_drawTriangleFront;
 	c->draw_triangle_back = (TinyGL::gl_draw_triangle_func)_drawTriangleBack;
@@ -399,11 +596,16 @@ void RasterizationDrawCall::execute(bool restoreState) const {
 		break;
 	case TGL_QUADS:
 		for(int i = 0; i < cnt; i += 4) {
+			// Hide the diagonal, then restore the flags so that the call
+			// still compares equal to an identical one in the next frame.
+			int edgeFlag0 = c->vertex[i + 0].edge_flag;
+			int edgeFlag2 = c->vertex[i + 2].edge_flag;
 			c->vertex[i + 2].edge_flag = 0;
 			gl_draw_triangle(c, &c->vertex[i], &c->vertex[i + 1], &c->vertex[i + 2]);
-			c->vertex[i + 2].edge_flag = 1;
+			c->vertex[i + 2].edge_flag = edgeFlag2;
 			c->vertex[i + 0].edge_flag = 0;
 			gl_draw_triangle(c, &c->vertex[i], &c->vertex[i + 2], &c->vertex[i + 3]);
+			c->vertex[i + 0].edge_flag = edgeFlag0;
 		}
 		break;
 	case TGL_QUAD_STRIP:
@@ -424,18 +626,10 @@ void RasterizationDrawCall::execute(bool restoreState) const {
 	default:
 		error("glBegin: type %x not handled", c->begin_type);
 	}
-
-	c->vertex = prevVertex;
-	c->vertex_cnt = prevVertexCount;
-
-	if (restoreState) {
-		applyState(backupState);
-	}
 }
 
-RasterizationDrawCall::RasterizationState RasterizationDrawCall::captureState() const {
+RasterizationDrawCall::RasterizationState RasterizationDrawCall::captureState(TinyGL::GLContext *c) const {
 	RasterizationState state;
-	TinyGL::GLContext *c = TinyGL::gl_get_context();
 	state.alphaTest = c->fb->isAlphaTestEnabled();
 	c->fb->getBlendingFactors(state.sfactor, state.dfactor);
 	state.enableBlending = c->fb->isBlendingEnabled();
@@ -469,8 +663,7 @@ RasterizationDrawCall::RasterizationState RasterizationDrawCall::captureState()
 	return state;
 }
 
-void RasterizationDrawCall::applyState(const RasterizationDrawCall::RasterizationState &state) const {
-	TinyGL::GLContext *c = TinyGL::gl_get_context();
+void RasterizationDrawCall::applyState(TinyGL::GLContext *c, const RasterizationDrawCall::RasterizationState &state) const {
 	c->fb->setBlendingFactors(state.sfactor, state.dfactor);
 	c->fb->enableBlending(state.enableBlending);
 	c->fb->enableAlphaTest(state.alphaTest);
@@ -525,7 +718,7 @@ BlittingDrawCall::BlittingDrawCall(Graphics::BlitImage *image, const BlitTransfo
 	tglIncBlitImageRef(image);
 	_blitState = captureState();
 	_imageVersion = tglGetBlitImageVersion(image);
-	if (TinyGL::gl_get_context()->_enableDirtyRectangles) {
+	if (TinyGL::tglNeedsDirtyRegions(TinyGL::gl_get_context())) {
 		computeDirtyRegion();
 	}
 }
@@ -630,7 +823,7 @@ bool BlittingDrawCall::operator==(const BlittingDrawCall &other) const {
 ClearBufferDrawCall::ClearBufferDrawCall(bool clearZBuffer, int zValue, bool clearColorBuffer, int rValue, int gValue, int bValue)
 	: _clearZBuffer(clearZBuffer), _clearColorBuffer(clearColorBuffer), _zValue(zValue), _rValue(rValue), _gValue(gValue), _bValue(bValue), DrawCall(DrawCall_Clear) {
 	TinyGL::GLContext *c = TinyGL::gl_get_context();
-	if (c->_enableDirtyRectangles) {
+	if (TinyGL::tglNeedsDirtyRegions(c)) {
 		_dirtyRegion = c->renderRect;
 	}
 }
@@ -641,7 +834,10 @@ void ClearBufferDrawCall::execute(bool restoreState) const {
 }
 
 void ClearBufferDrawCall::execute(const Common::Rect &clippingRectangle, bool restoreState) const {
-	TinyGL::GLContext *c = TinyGL::gl_get_context();
+	execute(TinyGL::gl_get_context(), clippingRectangle);
+}
+
+void ClearBufferDrawCall::execute(TinyGL::GLContext *c, const Common::Rect &clippingRectangle) const {
 	Common::Rect clearRect = clippingRectangle.findIntersectingRect(getDirtyRegion());
 	c->fb->clearRegion(clearRect.left, clearRect.top, clearRect.width(), clearRect.height(), _clearZBuffer, _zValue, _clearColorBuffer, _rValue, _gValue, _bValue);
 }
@@ -77,6 +77,8 @@ public:
 	bool operator==(const ClearBufferDrawCall &other) const;
 	virtual void execute(bool restoreState) const;
 	virtual void execute(const Common::Rect &clippingRectangle, bool restoreState) const;
+	// Clear the part of the region inside clippingRectangle in the frame buffer of the given context.
+	void execute(TinyGL::GLContext *c, const Common::Rect &clippingRectangle) const;
 
 	void *operator new(size_t size) {
 		return ::Internal::allocateFrame(size);
@@ -96,6 +98,9 @@ public:
 	bool operator==(const RasterizationDrawCall &other) const;
 	virtual void execute(bool restoreState) const;
 	virtual void execute(const Common::Rect &clippingRectangle, bool restoreState) const;
+	// Rasterize with the given context, which may belong to a worker thread. The
+	// vertices are first copied to scratch, so the call itself is left untouched.
+	void execute(TinyGL::GLContext *c, const Common::Rect &clippingRectangle, Common::Array<TinyGL::GLVertex> &scratch) const;
 
 	void *operator new(size_t size) {
 		return ::Internal::allocateFrame(size);
@@ -140,8 +145,9 @@ private:
 
 	RasterizationState _state;
 
-	RasterizationState captureState() const;
-	void applyState(const RasterizationState &state) const;
+	RasterizationState captureState(TinyGL::GLContext *c) const;
+	void applyState(TinyGL::GLContext *c, const RasterizationState &state) const;
+	void drawPrimitives(TinyGL::GLContext *c, TinyGL::GLVertex *vertices) const;
 };
 
 // Encapsulate a blit call: it might execute either a color buffer or z buffer blit.
@@ -250,6 +250,7 @@ private:
 };
 
 struct GLContext;
+struct RenderThreads;
 
 typedef void (*gl_draw_triangle_func)(GLContext *c, GLVertex *p0, GLVertex *p1, GLVertex *p2);
 
@@ -388,6 +389,10 @@ struct GLContext {
 
 	bool _enableDirtyRectangles;
 
+	// Presentation on worker threads
+	int _renderThreadCount;
+	RenderThreads *_renderThreads;
+
 	// blit test
 	Common::List<Graphics::BlitImage *> _blitImages;
 
@@ -438,6 +443,7 @@ void tglIssueDrawCall(Graphics::DrawCall *drawCall);
 // zdirtyrect.cpp
 void tglDisposeResources(GLContext *c);
 void tglDisposeDrawCallLists(TinyGL::GLContext *c);
+void tglDisposeRenderThreads(GLContext *c);
 
 GLContext *gl_get_context();
 
@@ -31,6 +31,16 @@
 #include "graphics/tinygl/zbuffer.h"
 #include "graphics/tinygl/zgl.h"
 
+// SSE2 is part of the x86-64 baseline, so the vectorized span loops need no
+// runtime detection.
+#if defined(__GNUC__) && (defined(__x86_64__) || (defined(__i386__) && defined(__SSE2__)))
+#include <emmintrin.h>
+#define TINYGL_SIMD_SSE2
+#elif defined(_MSC_VER) && (defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#include <emmintrin.h>
+#define TINYGL_SIMD_SSE2
+#endif
+
 namespace TinyGL {
 
 static const int NB_INTERP = 8;
@@ -79,11 +89,11 @@ FORCEINLINE static void putPixelShadow(FrameBuffer *buffer, int buf, unsigned in
 template <bool kDepthWrite, bool kLightsMode, bool kSmoothMode, bool kEnableAlphaTest, bool kEnableScissor, bool kEnableBlending>
 FORCEINLINE static void putPixelTextureMappingPerspective(FrameBuffer *buffer, int buf,
 						const Graphics::TexelBuffer *texture, unsigned int wrap_s, unsigned int wrap_t, unsigned int *pz, int _a,
-						int x, int y, unsigned int &z, int &t, int &s, unsigned int &r, unsigned int &g, unsigned int &b, unsigned int &a,
+						int x, int y, unsigned int &z, int &t, int &s, int lod, unsigned int &r, unsigned int &g, unsigned int &b, unsigned int &a,
 						int &dzdx, int &dsdx, int &dtdx, int &drdx, int &dgdx, int &dbdx, unsigned int dadx) {
 	if ((!kEnableScissor || !buffer->scissorPixel(x + _a, y)) && buffer->compareDepth(z, pz[_a])) {
 		uint8 c_a, c_r, c_g, c_b;
-		texture->getARGBAt(wrap_s, wrap_t, s, t, c_a, c_r, c_g, c_b);
+		texture->getARGBAt(wrap_s, wrap_t, s, t, lod, c_a, c_r, c_g, c_b);
 		if (kLightsMode) {
 			unsigned int l_a = (a >> (ZB_POINT_ALPHA_BITS - 8));
 			unsigned int l_r = (r >> (ZB_POINT_RED_BITS - 8));
@@ -107,10 +117,227 @@ FORCEINLINE static void putPixelTextureMappingPerspective(FrameBuffer *buffer, i
 	}
 }
 
+#ifdef TINYGL_SIMD_SSE2
+
+/**
+ * Constants of the SSE2 span loops, set up once per triangle.
+ *
+ * The depth and alpha test functions are turned into masks selecting which
+ * of the "less", "equal" and "greater" comparison results pass, so a single
+ * loop handles all of them. Blending factors are handled the same way: each
+ * factor is the sum of the masked candidates.
+ */
+struct SpanStateSSE2 {
+	__m128i depthLess, depthEqual, depthGreater;
+	__m128i alphaLess, alphaEqual, alphaGreater, alphaRef;
+	__m128i clipLeft, clipRight;
+	__m128i aLoss, aShift, rShift, gShift, bShift;
+	__m128i dstAlphaFill;
+	__m128i srcOne, srcSrcAlpha, srcInvSrcAlpha, srcDstAlpha, srcInvDstAlpha;
+	__m128i dstOne, dstSrcAlpha, dstInvSrcAlpha, dstDstAlpha, dstInvDstAlpha;
+};
+
+static inline __m128i maskSSE2(bool set) {
+	return _mm_set1_epi32(set ? -1 : 0);
+}
+
+static void setupTestSSE2(bool enabled, int func, __m128i &less, __m128i &equal, __m128i &greater) {
+	if (!enabled)
+		func = TGL_ALWAYS;
+
+	less = maskSSE2(func == TGL_LESS || func == TGL_LEQUAL || func == TGL_NOTEQUAL || func == TGL_ALWAYS);
+	equal = maskSSE2(func == TGL_EQUAL || func == TGL_LEQUAL || func == TGL_GEQUAL || func == TGL_ALWAYS);
+	greater = maskSSE2(func == TGL_GREATER || func == TGL_GEQUAL || func == TGL_NOTEQUAL || func == TGL_ALWAYS);
+}
+
+static bool setupBlendFactorSSE2(int factor, __m128i &one, __m128i &srcAlpha, __m128i &invSrcAlpha, __m128i &dstAlpha, __m128i &invDstAlpha) {
+	switch (factor) {
+	case TGL_ZERO:
+	case TGL_ONE:
+	case TGL_SRC_ALPHA:
+	case TGL_ONE_MINUS_SRC_ALPHA:
+	case TGL_DST_ALPHA:
+	case TGL_ONE_MINUS_DST_ALPHA:
+		break;
+	default:
+		// The color factors depend on the other side of the equation
+		return false;
+	}
+
+	// Multiplying by 256 and shifting back leaves the channel unchanged
+	one = _mm_and_si128(maskSSE2(factor == TGL_ONE), _mm_set1_epi32(256));
+	srcAlpha = maskSSE2(factor == TGL_SRC_ALPHA);
+	invSrcAlpha = maskSSE2(factor == TGL_ONE_MINUS_SRC_ALPHA);
+	dstAlpha = maskSSE2(factor == TGL_DST_ALPHA);
+	invDstAlpha = maskSSE2(factor == TGL_ONE_MINUS_DST_ALPHA);
+	return true;
+}
+
+static bool setupSpanSSE2(const FrameBuffer *buffer, SpanStateSSE2 &state, bool blending) {
+	if (blending) {
+		int sourceFactor, destinationFactor;
+		buffer->getBlendingFactors(sourceFactor, destinationFactor);
+		if (!setupBlendFactorSSE2(sourceFactor, state.srcOne, state.srcSrcAlpha, state.srcInvSrcAlpha, state.srcDstAlpha, state.srcInvDstAlpha) ||
+				!setupBlendFactorSSE2(destinationFactor, state.dstOne, state.dstSrcAlpha, state.dstInvSrcAlpha, state.dstDstAlpha, state.dstInvDstAlpha))
+			return false;
+	}
+
+	setupTestSSE2(buffer->getDepthTestEnabled(), buffer->getDepthFunc(), state.depthLess, state.depthEqual, state.depthGreater);
+	setupTestSSE2(true, buffer->getAlphaTestFunc(), state.alphaLess, state.alphaEqual, state.alphaGreater);
+	state.alphaRef = _mm_set1_epi32(buffer->getAlphaTestRefVal());
+
+	state.clipLeft = _mm_set1_epi32(buffer->_clipRectangle.left - 1);
+	state.clipRight = _mm_set1_epi32(buffer->_clipRectangle.right);
+
+	const Graphics::PixelFormat &format = buffer->cmode;
+	state.aLoss = _mm_cvtsi32_si128(format.aLoss);
+	state.aShift = _mm_cvtsi32_si128(format.aShift);
+	state.rShift = _mm_cvtsi32_si128(format.rShift);
+	state.gShift = _mm_cvtsi32_si128(format.gShift);
+	state.bShift = _mm_cvtsi32_si128(format.bShift);
+	state.dstAlphaFill = _mm_set1_epi32(format.aBits() == 0 ? 0xFF : 0);
+	return true;
+}
+
+static inline __m128i selectSSE2(__m128i mask, __m128i a, __m128i b) {
+	return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+static inline __m128i compareSSE2(__m128i less, __m128i equal, __m128i greater, __m128i lessMask, __m128i equalMask, __m128i greaterMask) {
+	return _mm_or_si128(_mm_or_si128(_mm_and_si128(less, lessMask), _mm_and_si128(equal, equalMask)), _mm_and_si128(greater, greaterMask));
+}
+
+static inline __m128i blendFactorSSE2(__m128i aSrc, __m128i aDst, __m128i one, __m128i srcAlpha, __m128i invSrcAlpha, __m128i dstAlpha, __m128i invDstAlpha) {
+	const __m128i max = _mm_set1_epi32(255);
+	__m128i factor = _mm_or_si128(one, _mm_and_si128(srcAlpha, aSrc));
+	factor = _mm_or_si128(factor, _mm_and_si128(invSrcAlpha, _mm_sub_epi32(max, aSrc)));
+	factor = _mm_or_si128(factor, _mm_and_si128(dstAlpha, aDst));
+	return _mm_or_si128(factor, _mm_and_si128(invDstAlpha, _mm_sub_epi32(max, aDst)));
+}
+
+// Channels and factors are at most 256, so the products fit in the low
+// halves of the 32-bit lanes.
+static inline __m128i scaleChannelSSE2(__m128i channel, __m128i factor) {
+	return _mm_srli_epi32(_mm_mullo_epi16(channel, factor), 8);
+}
+
+static inline __m128i channelSSE2(__m128i value, __m128i shift) {
+	return _mm_and_si128(_mm_srl_epi32(value, shift), _mm_set1_epi32(0xFF));
+}
+
+/**
+ * SSE2 version of the depth only, flat and smooth span loops, drawing four
+ * pixels at a time. Only whole groups of four are drawn, the caller draws
+ * the remaining pixels with the scalar code.
+ *
+ * @return the number of pixels drawn. z, r, g, b and a are stepped past them.
+ */
+template <int kDrawLogic, bool kDepthWrite, bool kEnableAlphaTest, bool kEnableScissor, bool kEnableBlending>
+static int fillSpanSSE2(const SpanStateSSE2 &state, uint32 *pp, unsigned int *pz, int x, int count,
+						unsigned int &z, unsigned int &r, unsigned int &g, unsigned int &b, unsigned int &a,
+						int dzdx, int drdx, int dgdx, int dbdx, int dadx) {
+	const bool kInterpRGB = kDrawLogic == DRAW_SMOOTH;
+	const __m128i bias = _mm_set1_epi32((int)0x80000000);
+	const __m128i lanes = _mm_set_epi32(3, 2, 1, 0);
+
+	__m128i zv = _mm_set_epi32(z + 3 * dzdx, z + 2 * dzdx, z + dzdx, z);
+	__m128i rv = _mm_set_epi32(r + 3 * drdx, r + 2 * drdx, r + drdx, r);
+	__m128i gv = _mm_set_epi32(g + 3 * dgdx, g + 2 * dgdx, g + dgdx, g);
+	__m128i bv = _mm_set_epi32(b + 3 * dbdx, b + 2 * dbdx, b + dbdx, b);
+	__m128i av = _mm_set_epi32(a + 3 * dadx, a + 2 * dadx, a + dadx, a);
+	const __m128i zStep = _mm_set1_epi32(4 * dzdx);
+	const __m128i rStep = _mm_set1_epi32(4 * drdx);
+	const __m128i gStep = _mm_set1_epi32(4 * dgdx);
+	const __m128i bStep = _mm_set1_epi32(4 * dbdx);
+	const __m128i aStep = _mm_set1_epi32(4 * dadx);
+	const __m128i channelMask = _mm_set1_epi32(0xFF);
+
+	int done = 0;
+	for (; done + 4 <= count; done += 4) {
+		__m128i zDst = _mm_loadu_si128((const __m128i *)(pz + done));
+		__m128i zSrcBiased = _mm_xor_si128(zv, bias);
+		__m128i zDstBiased = _mm_xor_si128(zDst, bias);
+		__m128i mask = compareSSE2(_mm_cmpgt_epi32(zSrcBiased, zDstBiased), _mm_cmpeq_epi32(zv, zDst), _mm_cmpgt_epi32(zDstBiased, zSrcBiased),
+		                           state.depthLess, state.depthEqual, state.depthGreater);
+		if (kEnableScissor) {
+			__m128i xv = _mm_add_epi32(_mm_set1_epi32(x + done), lanes);
+			mask = _mm_and_si128(mask, _mm_and_si128(_mm_cmpgt_epi32(xv, state.clipLeft), _mm_cmplt_epi32(xv, state.clipRight)));
+		}
+
+		if (kDrawLogic == DRAW_DEPTH_ONLY) {
+			if (kDepthWrite)
+				_mm_storeu_si128((__m128i *)(pz + done), selectSSE2(mask, zv, zDst));
+		} else {
+			__m128i aSrc = _mm_and_si128(_mm_srli_epi32(av, ZB_POINT_ALPHA_BITS - 8), channelMask);
+			__m128i rSrc = _mm_and_si128(_mm_srli_epi32(rv, ZB_POINT_RED_BITS - 8), channelMask);
+			__m128i gSrc = _mm_and_si128(_mm_srli_epi32(gv, ZB_POINT_GREEN_BITS - 8), channelMask);
+			__m128i bSrc = _mm_and_si128(_mm_srli_epi32(bv, ZB_POINT_BLUE_BITS - 8), channelMask);
+			if (kEnableAlphaTest) {
+				mask = _mm_and_si128(mask, compareSSE2(_mm_cmplt_epi32(aSrc, state.alphaRef), _mm_cmpeq_epi32(aSrc, state.alphaRef), _mm_cmpgt_epi32(aSrc, state.alphaRef),
+				                                       state.alphaLess, state.alphaEqual, state.alphaGreater));
+			}
+
+			if (_mm_movemask_epi8(mask)) {
+				if (kDepthWrite)
+					_mm_storeu_si128((__m128i *)(pz + done), selectSSE2(mask, zv, zDst));
+
+				__m128i dst = _mm_loadu_si128((const __m128i *)(pp + done));
+				__m128i aOut = aSrc;
+				if (kEnableBlending) {
+					__m128i aDst = _mm_or_si128(channelSSE2(dst, state.aShift), state.dstAlphaFill);
+					__m128i srcFactor = blendFactorSSE2(aSrc, aDst, state.srcOne, state.srcSrcAlpha, state.srcInvSrcAlpha, state.srcDstAlpha, state.srcInvDstAlpha);
+					__m128i dstFactor = blendFactorSSE2(aSrc, aDst, state.dstOne, state.dstSrcAlpha, state.dstInvSrcAlpha, state.dstDstAlpha, state.dstInvDstAlpha);
+					rSrc = _mm_min_epi16(_mm_add_epi32(scaleChannelSSE2(rSrc, srcFactor), scaleChannelSSE2(channelSSE2(dst, state.rShift), dstFactor)), channelMask);
+					gSrc = _mm_min_epi16(_mm_add_epi32(scaleChannelSSE2(gSrc, srcFactor), scaleChannelSSE2(channelSSE2(dst, state.gShift), dstFactor)), channelMask);
+					bSrc = _mm_min_epi16(_mm_add_epi32(scaleChannelSSE2(bSrc, srcFactor), scaleChannelSSE2(channelSSE2(dst, state.bShift), dstFactor)), channelMask);
+					aOut = channelMask;
+				}
+
+				__m128i color = _mm_sll_epi32(_mm_srl_epi32(aOut, state.aLoss), state.aShift);
+				color = _mm_or_si128(color, _mm_sll_epi32(rSrc, state.rShift));
+				color = _mm_or_si128(color, _mm_sll_epi32(gSrc, state.gShift));
+				color = _mm_or_si128(color, _mm_sll_epi32(bSrc, state.bShift));
+				_mm_storeu_si128((__m128i *)(pp + done), selectSSE2(mask, color, dst));
+			}
+		}
+
+		zv = _mm_add_epi32(zv, zStep);
+		if (kInterpRGB) {
+			rv = _mm_add_epi32(rv, rStep);
+			gv = _mm_add_epi32(gv, gStep);
+			bv = _mm_add_epi32(bv, bStep);
+			av = _mm_add_epi32(av, aStep);
+		}
+	}
+
+	z += (unsigned int)done * dzdx;
+	if (kInterpRGB) {
+		r += (unsigned int)done * drdx;
+		g += (unsigned int)done * dgdx;
+		b += (unsigned int)done * dbdx;
+		a += (unsigned int)done * dadx;
+	}
+	return done;
+}
+
+#endif
+
+bool FrameBuffer::enableSIMDSpans(bool enable) {
+	_simdSpans = false;
+#ifdef TINYGL_SIMD_SSE2
+	// The loops pack and unpack whole bytes only
+	if (enable && cmode.bytesPerPixel == 4 && cmode.rLoss == 0 && cmode.gLoss == 0 && cmode.bLoss == 0 &&
+			(cmode.aLoss == 0 || cmode.aLoss == 8))
+		_simdSpans = true;
+#endif
+	return _simdSpans;
+}
+
 template <bool kInterpRGB, bool kInterpZ, bool kInterpST, bool kInterpSTZ, int kDrawLogic, bool kDepthWrite, bool kAlphaTestEnabled, bool kEnableScissor, bool kBlendingEnabled>
 void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint *p2) {
 	const Graphics::TexelBuffer *texture;
-	float fdzdx = 0, fndzdx = 0, ndszdx = 0, ndtzdx = 0;
+	float fdzdx = 0, fdzdy = 0, fndzdx = 0, ndszdx = 0, ndtzdx = 0;
+	bool mipmapped = false;
 
 	ZBufferPoint *tp, *pr1 = 0, *pr2 = 0, *l1 = 0, *l2 = 0;
 	float fdx1, fdx2, fdy1, fdy2, fz0, d1, d2;
@@ -262,12 +489,21 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 
 	if ((kInterpST || kInterpSTZ) && (kDrawLogic == DRAW_FLAT || kDrawLogic == DRAW_SMOOTH)) {
 		texture = current_texture;
+		mipmapped = texture->hasMipmaps();
 		fdzdx = (float)dzdx;
+		fdzdy = (float)dzdy;
 		fndzdx = NB_INTERP * fdzdx;
 		ndszdx = NB_INTERP * dszdx;
 		ndtzdx = NB_INTERP * dtzdx;
 	}
 
+#ifdef TINYGL_SIMD_SSE2
+	SpanStateSSE2 spanState;
+	const bool useSIMDSpans = kInterpZ && !(kInterpST || kInterpSTZ) &&
+		(kDrawLogic == DRAW_DEPTH_ONLY || kDrawLogic == DRAW_FLAT || kDrawLogic == DRAW_SMOOTH) &&
+		_simdSpans && setupSpanSSE2(this, spanState, kBlendingEnabled);
+#endif
+
 	if (fz0 > 0) {
 		l1 = p0;
 		l2 = p2;
@@ -360,8 +596,13 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 
 		// we draw all the scan line of the part
 		while (nb_lines > 0) {
+			// Nothing below the scissor rectangle can be drawn, and the
+			// scanlines above it only need their edges stepped. This keeps
+			// narrow horizontal scissor bands cheap for the tiled renderer.
+			if (kEnableScissor && y >= _clipRectangle.bottom)
+				return;
 			int x = x1;
-			{
+			if (!kEnableScissor || y >= _clipRectangle.top) {
 				if (kDrawLogic == DRAW_DEPTH_ONLY ||
 						(kDrawLogic == DRAW_FLAT && !(kInterpST || kInterpSTZ))) {
 					int pp;
@@ -381,6 +622,17 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 					if (kDrawLogic == DRAW_FLAT) {
 						a = a1;
 					}
+#ifdef TINYGL_SIMD_SSE2
+					if (useSIMDSpans) {
+						int done = fillSpanSSE2<kDrawLogic, kDepthWrite, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled>(spanState,
+						               (uint32 *)getPixelBuffer() + pp, pz, x, n + 1, z, r, g, b, a, dzdx, 0, 0, 0, 0);
+						pz += done;
+						pp += done;
+						buf += done;
+						n -= done;
+						x += done;
+					}
+#endif
 					while (n >= 3) {
 						if (kDrawLogic == DRAW_DEPTH_ONLY) {
 							putPixelDepth<kDepthWrite, kEnableScissor>(this, buf, pz, 0, x, y, z, dzdx);
@@ -392,7 +644,7 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 						if (kDrawLogic == DRAW_FLAT) {
 							putPixelFlat<kDepthWrite, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled>(this, pp, pz, 0, x, y, z, r, g, b, a, dzdx);
 							putPixelFlat<kDepthWrite, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled>(this, pp, pz, 1, x, y, z, r, g, b, a, dzdx);
-							putPixelFlat<kDepthWrite, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled>(this, pp, pz, 2, x, y, z, r, g, g, a, dzdx);
+							putPixelFlat<kDepthWrite, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled>(this, pp, pz, 2, x, y, z, r, g, b, a, dzdx);
 							putPixelFlat<kDepthWrite, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled>(this, pp, pz, 3, x, y, z, r, g, b, a, dzdx);
 						}
 						if (kInterpZ) {
@@ -485,6 +737,16 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 					g = g1;
 					b = b1;
 					a = a1;
+#ifdef TINYGL_SIMD_SSE2
+					if (useSIMDSpans) {
+						int done = fillSpanSSE2<kDrawLogic, kDepthWrite, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled>(spanState,
+						               (uint32 *)getPixelBuffer() + buf, pz, x, n + 1, z, r, g, b, a, dzdx, drdx, dgdx, dbdx, dadx);
+						pz += done;
+						buf += done;
+						n -= done;
+						x += done;
+					}
+#endif
 					while (n >= 3) {
 						putPixelSmooth<kDepthWrite, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled>(this, buf, pz, 0, x, y, z, r, g, b, a, dzdx, drdx, dgdx, dbdx, dadx);
 						putPixelSmooth<kDepthWrite, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled>(this, buf, pz, 1, x, y, z, r, g, b, a, dzdx, drdx, dgdx, dbdx, dadx);
@@ -509,6 +771,7 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 					int n;
 					float sz, tz, fz, zinv;
 					int dsdx, dtdx;
+					int lod = 0;
 
 					n = (x2 >> 16) - x1;
 					fz = (float)z1;
@@ -533,12 +796,14 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 							t = (int)tt;
 							dsdx = (int)((dszdx - ss * fdzdx) * zinv);
 							dtdx = (int)((dtzdx - tt * fdzdx) * zinv);
+							if (mipmapped)
+								lod = texture->getLevelOfDetail(dsdx, dtdx, (dszdy - ss * fdzdy) * zinv, (dtzdy - tt * fdzdy) * zinv);
 							fz += fndzdx;
 							zinv = (float)(1.0 / fz);
 						}
 						for (int _a = 0; _a < NB_INTERP; _a++) {
 							putPixelTextureMappingPerspective<kDepthWrite, kInterpRGB, kDrawLogic == DRAW_SMOOTH, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled>(this, buf, texture, wrapS, wrapT,
-							                           pz, _a, x, y, z, t, s, r, g, b, a, dzdx, dsdx, dtdx, drdx, dgdx, dbdx, dadx);
+							                           pz, _a, x, y, z, t, s, lod, r, g, b, a, dzdx, dsdx, dtdx, drdx, dgdx, dbdx, dadx);
 						}
 						pz += NB_INTERP;
 						buf += NB_INTERP;
@@ -556,11 +821,13 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 						t = (int)tt;
 						dsdx = (int)((dszdx - ss * fdzdx) * zinv);
 						dtdx = (int)((dtzdx - tt * fdzdx) * zinv);
+						if (mipmapped)
+							lod = texture->getLevelOfDetail(dsdx, dtdx, (dszdy - ss * fdzdy) * zinv, (dtzdy - tt * fdzdy) * zinv);
 					}
 
 					while (n >= 0) {
 						putPixelTextureMappingPerspective<kDepthWrite, kInterpRGB, kDrawLogic == DRAW_SMOOTH, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled>(this, buf, texture, wrapS, wrapT,
-						                           pz, 0, x, y, z, t, s, r, g, b, a, dzdx, dsdx, dtdx, drdx, dgdx, dbdx, dadx);
+						                           pz, 0, x, y, z, t, s, lod, r, g, b, a, dzdx, dsdx, dtdx, drdx, dgdx, dbdx, dadx);
 						pz += 1;
 						buf += 1;
 						n -= 1;
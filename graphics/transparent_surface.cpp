@@ -27,12 +27,38 @@
 #include "common/util.h"
 #include "common/rect.h"
 #include "common/math.h"
+#include "common/system.h"
 #include "common/textconsole.h"
 #include "graphics/conversion.h"
 #include "graphics/primitives.h"
 #include "graphics/transparent_surface.h"
 #include "graphics/transform_tools.h"
 
+// SSE2 is part of the x86-64 baseline, AVX2 is enabled per function and
+// only used when the CPU reports it. NEON is only used when it is part of
+// the build's baseline and USE_ARM_NEON_KERNELS is defined, as it has not
+// been built on ARM yet. The kernels assume the little endian byte order.
+#if defined(SCUMM_LITTLE_ENDIAN)
+#if defined(__GNUC__) && (defined(__x86_64__) || (defined(__i386__) && defined(__SSE2__)))
+#include <immintrin.h>
+#define BLEND_SIMD_SSE2
+#define BLEND_TARGET_SSE2
+#if defined(__clang__) || __GNUC__ >= 5
+#define BLEND_SIMD_AVX2
+#define BLEND_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#elif defined(_MSC_VER) && (defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#include <immintrin.h>
+#define BLEND_SIMD_SSE2
+#define BLEND_TARGET_SSE2
+#define BLEND_SIMD_AVX2
+#define BLEND_TARGET_AVX2
+#elif defined(USE_ARM_NEON_KERNELS) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+#include <arm_neon.h>
+#define BLEND_SIMD_NEON
+#endif
+#endif
+
 namespace Graphics {
 
 static const int kBModShift = 8;//img->format.bShift;
@@ -60,6 +86,494 @@ void doBlitAdditiveBlend(byte *ino, byte *outo, uint32 width, uint32 height, uin
 void doBlitSubtractiveBlend(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color);
 void doBlitMultiplyBlend(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color);
 
+/*
+ * Vector versions of the blend modes.
+ *
+ * They work on pixels widened to 16 bits per channel, and reproduce the
+ * arithmetic of the plain loops exactly, truncations included. Where those
+ * special case a channel modulated by 255 with a division by 256 instead of a
+ * multiplication by 255 and a division by 65536, the kernels multiply by 256
+ * and divide by 65536, which gives the same result. The kernels only process
+ * whole vectors of pixels and leave the last columns to the plain loops.
+ */
+
+enum BlendKernel {
+	kBlendAlpha,
+	kBlendAdditive,
+	kBlendSubtractive,
+	kBlendMultiply
+};
+
+static TransparentSurface::SIMDLevel s_simdLevel = TransparentSurface::kSIMDNone;
+static bool s_simdLevelChosen = false;
+
+/**
+ * Per channel factors of the color modulation, in the byte order of a pixel.
+ */
+struct BlendFactors {
+	uint16 color[4]; ///< The modulation color
+	uint16 scale[4]; ///< The modulation color with 255 replaced by 256
+	uint16 alpha;    ///< The modulation alpha
+};
+
+static void getBlendFactors(uint32 color, BlendFactors &factors) {
+	const bool colorMod = (color != 0xffffffff);
+
+	factors.color[kAIndex] = (color >> kAModShift) & 0xFF;
+	factors.color[kRIndex] = (color >> kRModShift) & 0xFF;
+	factors.color[kGIndex] = (color >> kGModShift) & 0xFF;
+	factors.color[kBIndex] = (color >> kBModShift) & 0xFF;
+
+	for (int i = 0; i < 4; i++) {
+		factors.scale[i] = (!colorMod || factors.color[i] == 255) ? 256 : factors.color[i];
+	}
+	factors.alpha = factors.color[kAIndex];
+}
+
+/**
+ * Whether a pixel with a zero alpha leaves the target unchanged, so that
+ * vectors of such pixels can be skipped.
+ */
+static inline bool skipsTransparent(int kernel, bool colorMod) {
+	return kernel == kBlendAlpha || kernel == kBlendAdditive || !colorMod;
+}
+
+#ifdef BLEND_SIMD_SSE2
+
+struct BlendVectorsSSE2 {
+	BLEND_TARGET_SSE2 BlendVectorsSSE2(const BlendFactors &factors) {
+		color = _mm_setr_epi16(factors.color[0], factors.color[1], factors.color[2], factors.color[3],
+		                       factors.color[0], factors.color[1], factors.color[2], factors.color[3]);
+		scale = _mm_setr_epi16(factors.scale[0], factors.scale[1], factors.scale[2], factors.scale[3],
+		                       factors.scale[0], factors.scale[1], factors.scale[2], factors.scale[3]);
+		alpha = _mm_set1_epi16(factors.alpha);
+		alphaLanes = _mm_setr_epi16(kAIndex == 0 ? -1 : 0, kAIndex == 1 ? -1 : 0, kAIndex == 2 ? -1 : 0, kAIndex == 3 ? -1 : 0,
+		                            kAIndex == 0 ? -1 : 0, kAIndex == 1 ? -1 : 0, kAIndex == 2 ? -1 : 0, kAIndex == 3 ? -1 : 0);
+	}
+
+	__m128i color, scale, alpha, alphaLanes;
+};
+
+BLEND_TARGET_SSE2 static inline __m128i selectSSE2(__m128i mask, __m128i a, __m128i b) {
+	return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+/**
+ * Blend two source pixels with two target pixels, 16 bits per channel.
+ */
+template<int kernel, bool colorMod>
+BLEND_TARGET_SSE2 static inline __m128i blendPixelsSSE2(__m128i src, __m128i dst, const BlendVectorsSSE2 &v) {
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i v255 = _mm_set1_epi16(255);
+
+	__m128i a = _mm_shufflelo_epi16(src, _MM_SHUFFLE(kAIndex, kAIndex, kAIndex, kAIndex));
+	a = _mm_shufflehi_epi16(a, _MM_SHUFFLE(kAIndex, kAIndex, kAIndex, kAIndex));
+	if (colorMod && kernel != kBlendSubtractive) {
+		a = _mm_srli_epi16(_mm_mullo_epi16(a, v.alpha), 8);
+	}
+
+	__m128i result;
+	switch (kernel) {
+	case kBlendAlpha:
+		if (colorMod) {
+			result = _mm_srli_epi16(_mm_mullo_epi16(dst, _mm_sub_epi16(v255, a)), 8);
+			result = _mm_add_epi16(result, _mm_mulhi_epu16(_mm_mullo_epi16(src, a), v.color));
+		} else {
+			result = _mm_add_epi16(_mm_mullo_epi16(src, a), _mm_mullo_epi16(dst, _mm_sub_epi16(v255, a)));
+			result = _mm_srli_epi16(result, 8);
+		}
+		result = selectSSE2(v.alphaLanes, v255, result);
+		return selectSSE2(_mm_cmpeq_epi16(a, zero), dst, result);
+
+	case kBlendAdditive:
+		// The saturation happens when packing
+		result = _mm_mulhi_epu16(_mm_mullo_epi16(src, a), v.scale);
+		return _mm_add_epi16(dst, _mm_andnot_si128(v.alphaLanes, result));
+
+	case kBlendSubtractive:
+		result = _mm_mulhi_epu16(_mm_mullo_epi16(src, dst), _mm_mullo_epi16(a, v.scale));
+		result = _mm_sub_epi16(dst, _mm_srli_epi16(result, 8));
+		return selectSSE2(v.alphaLanes, colorMod ? v255 : dst, result);
+
+	default:
+		result = _mm_mulhi_epu16(_mm_mullo_epi16(src, a), v.scale);
+		result = _mm_srli_epi16(_mm_mullo_epi16(dst, result), 8);
+		result = selectSSE2(v.alphaLanes, dst, result);
+		if (!colorMod) {
+			result = selectSSE2(_mm_cmpeq_epi16(a, zero), dst, result);
+		}
+		return result;
+	}
+}
+
+template<int kernel, bool colorMod>
+BLEND_TARGET_SSE2 static uint32 blendSSE2(const byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, const BlendFactors &factors) {
+	const uint32 columns = width & ~3;
+	const BlendVectorsSSE2 v(factors);
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i alphaBytes = _mm_set1_epi32(0xFF << (kAIndex * 8));
+
+	for (uint32 i = 0; i < height; i++) {
+		const byte *in = ino;
+		byte *out = outo;
+
+		for (uint32 j = 0; j < columns; j += 4) {
+			__m128i src;
+			if (inStep > 0) {
+				src = _mm_loadu_si128((const __m128i *)in);
+			} else {
+				// Flipped horizontally, load the pixels to the left and reverse them
+				src = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)(in - 12)), _MM_SHUFFLE(0, 1, 2, 3));
+			}
+			in += inStep * 4;
+
+			if (skipsTransparent(kernel, colorMod) && _mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(src, alphaBytes), zero)) == 0xFFFF) {
+				out += 16;
+				continue;
+			}
+
+			const __m128i dst = _mm_loadu_si128((const __m128i *)out);
+			const __m128i lo = blendPixelsSSE2<kernel, colorMod>(_mm_unpacklo_epi8(src, zero), _mm_unpacklo_epi8(dst, zero), v);
+			const __m128i hi = blendPixelsSSE2<kernel, colorMod>(_mm_unpackhi_epi8(src, zero), _mm_unpackhi_epi8(dst, zero), v);
+			_mm_storeu_si128((__m128i *)out, _mm_packus_epi16(lo, hi));
+			out += 16;
+		}
+
+		outo += pitch;
+		ino += inoStep;
+	}
+
+	return columns;
+}
+
+#endif
+
+#ifdef BLEND_SIMD_AVX2
+
+/**
+ * AVX2 version of BlendVectorsSSE2.
+ */
+struct BlendVectorsAVX2 {
+	BLEND_TARGET_AVX2 BlendVectorsAVX2(const BlendFactors &factors) {
+		color = _mm256_setr_epi16(factors.color[0], factors.color[1], factors.color[2], factors.color[3],
+		                          factors.color[0], factors.color[1], factors.color[2], factors.color[3],
+		                          factors.color[0], factors.color[1], factors.color[2], factors.color[3],
+		                          factors.color[0], factors.color[1], factors.color[2], factors.color[3]);
+		scale = _mm256_setr_epi16(factors.scale[0], factors.scale[1], factors.scale[2], factors.scale[3],
+		                          factors.scale[0], factors.scale[1], factors.scale[2], factors.scale[3],
+		                          factors.scale[0], factors.scale[1], factors.scale[2], factors.scale[3],
+		                          factors.scale[0], factors.scale[1], factors.scale[2], factors.scale[3]);
+		alpha = _mm256_set1_epi16(factors.alpha);
+		alphaLanes = _mm256_set1_epi64x((int64)0xFFFF << (kAIndex * 16));
+	}
+
+	__m256i color, scale, alpha, alphaLanes;
+};
+
+BLEND_TARGET_AVX2 static inline __m256i selectAVX2(__m256i mask, __m256i a, __m256i b) {
+	return _mm256_or_si256(_mm256_and_si256(mask, a), _mm256_andnot_si256(mask, b));
+}
+
+/**
+ * AVX2 version of blendPixelsSSE2, four pixels at a time.
+ */
+template<int kernel, bool colorMod>
+BLEND_TARGET_AVX2 static inline __m256i blendPixelsAVX2(__m256i src, __m256i dst, const BlendVectorsAVX2 &v) {
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i v255 = _mm256_set1_epi16(255);
+
+	__m256i a = _mm256_shufflelo_epi16(src, _MM_SHUFFLE(kAIndex, kAIndex, kAIndex, kAIndex));
+	a = _mm256_shufflehi_epi16(a, _MM_SHUFFLE(kAIndex, kAIndex, kAIndex, kAIndex));
+	if (colorMod && kernel != kBlendSubtractive) {
+		a = _mm256_srli_epi16(_mm256_mullo_epi16(a, v.alpha), 8);
+	}
+
+	__m256i result;
+	switch (kernel) {
+	case kBlendAlpha:
+		if (colorMod) {
+			result = _mm256_srli_epi16(_mm256_mullo_epi16(dst, _mm256_sub_epi16(v255, a)), 8);
+			result = _mm256_add_epi16(result, _mm256_mulhi_epu16(_mm256_mullo_epi16(src, a), v.color));
+		} else {
+			result = _mm256_add_epi16(_mm256_mullo_epi16(src, a), _mm256_mullo_epi16(dst, _mm256_sub_epi16(v255, a)));
+			result = _mm256_srli_epi16(result, 8);
+		}
+		result = selectAVX2(v.alphaLanes, v255, result);
+		return selectAVX2(_mm256_cmpeq_epi16(a, zero), dst, result);
+
+	case kBlendAdditive:
+		result = _mm256_mulhi_epu16(_mm256_mullo_epi16(src, a), v.scale);
+		return _mm256_add_epi16(dst, _mm256_andnot_si256(v.alphaLanes, result));
+
+	case kBlendSubtractive:
+		result = _mm256_mulhi_epu16(_mm256_mullo_epi16(src, dst), _mm256_mullo_epi16(a, v.scale));
+		result = _mm256_sub_epi16(dst, _mm256_srli_epi16(result, 8));
+		return selectAVX2(v.alphaLanes, colorMod ? v255 : dst, result);
+
+	default:
+		result = _mm256_mulhi_epu16(_mm256_mullo_epi16(src, a), v.scale);
+		result = _mm256_srli_epi16(_mm256_mullo_epi16(dst, result), 8);
+		result = selectAVX2(v.alphaLanes, dst, result);
+		if (!colorMod) {
+			result = selectAVX2(_mm256_cmpeq_epi16(a, zero), dst, result);
+		}
+		return result;
+	}
+}
+
+template<int kernel, bool colorMod>
+BLEND_TARGET_AVX2 static uint32 blendAVX2(const byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, const BlendFactors &factors) {
+	const uint32 columns = width & ~7;
+	const BlendVectorsAVX2 v(factors);
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i alphaBytes = _mm256_set1_epi32(0xFF << (kAIndex * 8));
+	const __m256i reverse = _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0);
+
+	for (uint32 i = 0; i < height; i++) {
+		const byte *in = ino;
+		byte *out = outo;
+
+		for (uint32 j = 0; j < columns; j += 8) {
+			__m256i src;
+			if (inStep > 0) {
+				src = _mm256_loadu_si256((const __m256i *)in);
+			} else {
+				src = _mm256_permutevar8x32_epi32(_mm256_loadu_si256((const __m256i *)(in - 28)), reverse);
+			}
+			in += inStep * 8;
+
+			if (skipsTransparent(kernel, colorMod) && _mm256_movemask_epi8(_mm256_cmpeq_epi32(_mm256_and_si256(src, alphaBytes), zero)) == -1) {
+				out += 32;
+				continue;
+			}
+
+			// Unpacking and packing both work within 128 bit lanes, so the
+			// pixels end up where they came from
+			const __m256i dst = _mm256_loadu_si256((const __m256i *)out);
+			const __m256i lo = blendPixelsAVX2<kernel, colorMod>(_mm256_unpacklo_epi8(src, zero), _mm256_unpacklo_epi8(dst, zero), v);
+			const __m256i hi = blendPixelsAVX2<kernel, colorMod>(_mm256_unpackhi_epi8(src, zero), _mm256_unpackhi_epi8(dst, zero), v);
+			_mm256_storeu_si256((__m256i *)out, _mm256_packus_epi16(lo, hi));
+			out += 32;
+		}
+
+		outo += pitch;
+		ino += inoStep;
+	}
+
+	return columns;
+}
+
+#endif
+
+#ifdef BLEND_SIMD_NEON
+
+struct BlendVectorsNEON {
+	BlendVectorsNEON(const BlendFactors &factors) {
+		const uint16 colors[8] = {
+			factors.color[0], factors.color[1], factors.color[2], factors.color[3],
+			factors.color[0], factors.color[1], factors.color[2], factors.color[3]
+		};
+		const uint16 scales[8] = {
+			factors.scale[0], factors.scale[1], factors.scale[2], factors.scale[3],
+			factors.scale[0], factors.scale[1], factors.scale[2], factors.scale[3]
+		};
+		color = vld1q_u16(colors);
+		scale = vld1q_u16(scales);
+		alpha = vdupq_n_u16(factors.alpha);
+		alphaLanes = vreinterpretq_u16_u64(vdupq_n_u64((uint64)0xFFFF << (kAIndex * 16)));
+	}
+
+	uint16x8_t color, scale, alpha, alphaLanes;
+};
+
+static inline uint16x8_t mulhiNEON(uint16x8_t a, uint16x8_t b) {
+	return vcombine_u16(vshrn_n_u32(vmull_u16(vget_low_u16(a), vget_low_u16(b)), 16),
+	                    vshrn_n_u32(vmull_u16(vget_high_u16(a), vget_high_u16(b)), 16));
+}
+
+/**
+ * NEON version of blendPixelsSSE2.
+ */
+template<int kernel, bool colorMod>
+static inline uint16x8_t blendPixelsNEON(uint16x8_t src, uint16x8_t dst, const BlendVectorsNEON &v) {
+	const uint16x8_t zero = vdupq_n_u16(0);
+	const uint16x8_t v255 = vdupq_n_u16(255);
+
+	// Spread the alpha of each pixel over its 64 bits
+	uint64x2_t alpha64 = vandq_u64(vshlq_u64(vreinterpretq_u64_u16(src), vdupq_n_s64(-16 * kAIndex)), vdupq_n_u64(0xFFFF));
+	alpha64 = vorrq_u64(alpha64, vshlq_n_u64(alpha64, 16));
+	alpha64 = vorrq_u64(alpha64, vshlq_n_u64(alpha64, 32));
+	uint16x8_t a = vreinterpretq_u16_u64(alpha64);
+	if (colorMod && kernel != kBlendSubtractive) {
+		a = vshrq_n_u16(vmulq_u16(a, v.alpha), 8);
+	}
+
+	uint16x8_t result;
+	switch (kernel) {
+	case kBlendAlpha:
+		if (colorMod) {
+			result = vshrq_n_u16(vmulq_u16(dst, vsubq_u16(v255, a)), 8);
+			result = vaddq_u16(result, mulhiNEON(vmulq_u16(src, a), v.color));
+		} else {
+			result = vshrq_n_u16(vmlaq_u16(vmulq_u16(src, a), dst, vsubq_u16(v255, a)), 8);
+		}
+		result = vbslq_u16(v.alphaLanes, v255, result);
+		return vbslq_u16(vceqq_u16(a, zero), dst, result);
+
+	case kBlendAdditive:
+		result = mulhiNEON(vmulq_u16(src, a), v.scale);
+		return vaddq_u16(dst, vbicq_u16(result, v.alphaLanes));
+
+	case kBlendSubtractive:
+		result = mulhiNEON(vmulq_u16(src, dst), vmulq_u16(a, v.scale));
+		result = vsubq_u16(dst, vshrq_n_u16(result, 8));
+		return vbslq_u16(v.alphaLanes, colorMod ? v255 : dst, result);
+
+	default:
+		result = mulhiNEON(vmulq_u16(src, a), v.scale);
+		result = vshrq_n_u16(vmulq_u16(dst, result), 8);
+		result = vbslq_u16(v.alphaLanes, dst, result);
+		if (!colorMod) {
+			result = vbslq_u16(vceqq_u16(a, zero), dst, result);
+		}
+		return result;
+	}
+}
+
+template<int kernel, bool colorMod>
+static uint32 blendNEON(const byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, const BlendFactors &factors) {
+	const uint32 columns = width & ~3;
+	const BlendVectorsNEON v(factors);
+	const uint32x4_t alphaBytes = vdupq_n_u32(0xFF << (kAIndex * 8));
+
+	for (uint32 i = 0; i < height; i++) {
+		const byte *in = ino;
+		byte *out = outo;
+
+		for (uint32 j = 0; j < columns; j += 4) {
+			uint8x16_t src;
+			if (inStep > 0) {
+				src = vld1q_u8(in);
+			} else {
+				const uint32x4_t reversed = vrev64q_u32(vreinterpretq_u32_u8(vld1q_u8(in - 12)));
+				src = vreinterpretq_u8_u32(vcombine_u32(vget_high_u32(reversed), vget_low_u32(reversed)));
+			}
+			in += inStep * 4;
+
+			if (skipsTransparent(kernel, colorMod)) {
+				const uint32x4_t alpha = vandq_u32(vreinterpretq_u32_u8(src), alphaBytes);
+				const uint32x2_t any = vorr_u32(vget_low_u32(alpha), vget_high_u32(alpha));
+				if ((vget_lane_u32(any, 0) | vget_lane_u32(any, 1)) == 0) {
+					out += 16;
+					continue;
+				}
+			}
+
+			const uint8x16_t dst = vld1q_u8(out);
+			const uint16x8_t lo = blendPixelsNEON<kernel, colorMod>(vmovl_u8(vget_low_u8(src)), vmovl_u8(vget_low_u8(dst)), v);
+			const uint16x8_t hi = blendPixelsNEON<kernel, colorMod>(vmovl_u8(vget_high_u8(src)), vmovl_u8(vget_high_u8(dst)), v);
+			vst1q_u8(out, vcombine_u8(vqmovn_u16(lo), vqmovn_u16(hi)));
+			out += 16;
+		}
+
+		outo += pitch;
+		ino += inoStep;
+	}
+
+	return columns;
+}
+
+#endif
+
+/**
+ * Blend as many columns as the vector kernels of the selected instruction
+ * set can handle.
+ *
+ * @return the number of columns blended
+ */
+template<int kernel>
+static uint32 doBlitBlendSIMD(const byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color) {
+	const TransparentSurface::SIMDLevel level = TransparentSurface::getSIMDLevel();
+	if (level == TransparentSurface::kSIMDNone) {
+		return 0;
+	}
+
+	const bool colorMod = (color != 0xffffffff);
+	BlendFactors factors;
+	getBlendFactors(color, factors);
+
+	switch (level) {
+#ifdef BLEND_SIMD_SSE2
+	case TransparentSurface::kSIMDSSE2:
+		if (colorMod)
+			return blendSSE2<kernel, true>(ino, outo, width, height, pitch, inStep, inoStep, factors);
+		return blendSSE2<kernel, false>(ino, outo, width, height, pitch, inStep, inoStep, factors);
+#endif
+#ifdef BLEND_SIMD_AVX2
+	case TransparentSurface::kSIMDAVX2:
+		if (colorMod)
+			return blendAVX2<kernel, true>(ino, outo, width, height, pitch, inStep, inoStep, factors);
+		return blendAVX2<kernel, false>(ino, outo, width, height, pitch, inStep, inoStep, factors);
+#endif
+#ifdef BLEND_SIMD_NEON
+	case TransparentSurface::kSIMDNEON:
+		if (colorMod)
+			return blendNEON<kernel, true>(ino, outo, width, height, pitch, inStep, inoStep, factors);
+		return blendNEON<kernel, false>(ino, outo, width, height, pitch, inStep, inoStep, factors);
+#endif
+	default:
+		return 0;
+	}
+}
+
+bool TransparentSurface::setSIMDLevel(SIMDLevel level) {
+	bool available;
+
+	switch (level) {
+	case kSIMDNone:
+		available = true;
+		break;
+#ifdef BLEND_SIMD_SSE2
+	case kSIMDSSE2:
+		// Part of the baseline of the build
+		available = true;
+		break;
+#endif
+#ifdef BLEND_SIMD_AVX2
+	case kSIMDAVX2:
+		available = g_system && g_system->hasFeature(OSystem::kFeatureCpuAVX2);
+		break;
+#endif
+#ifdef BLEND_SIMD_NEON
+	case kSIMDNEON:
+		available = true;
+		break;
+#endif
+	default:
+		available = false;
+		break;
+	}
+
+	if (available) {
+		s_simdLevel = level;
+		s_simdLevelChosen = true;
+	}
+
+	return available;
+}
+
+TransparentSurface::SIMDLevel TransparentSurface::getSIMDLevel() {
+	if (!s_simdLevelChosen && g_system) {
+		// Pick the fastest instruction set available, once the backend can
+		// tell which ones the CPU has
+		s_simdLevelChosen = true;
+		if (!setSIMDLevel(kSIMDAVX2) && !setSIMDLevel(kSIMDSSE2))
+			setSIMDLevel(kSIMDNEON);
+	}
+
+	return s_simdLevel;
+}
+
 TransparentSurface::TransparentSurface() : Surface(), _alphaMode(ALPHA_FULL) {}
 
 TransparentSurface::TransparentSurface(const Surface &surf, bool copyData) : Surface(), _alphaMode(ALPHA_FULL) {
@@ -88,7 +602,15 @@ void doBlitOpaqueFast(byte *ino, byte *outo, uint32 width, uint32 height, uint32
 	for (uint32 i = 0; i < height; i++) {
 		out = outo;
 		in = ino;
-		memcpy(out, in, width * 4);
+		if (inStep == 4) {
+			memcpy(out, in, width * 4);
+		} else {
+			// Flipped horizontally
+			for (uint32 j = 0; j < width; j++) {
+				WRITE_UINT32(out + j * 4, READ_UINT32(in));
+				in += inStep;
+			}
+		}
 		for (uint32 j = 0; j < width; j++) {
 			out[kAIndex] = 0xFF;
 			out += 4;
@@ -140,6 +662,12 @@ void doBlitAlphaBlend(byte *ino, byte *outo, uint32 width, uint32 height, uint32
 	byte *in;
 	byte *out;
 
+	// The vector kernels leave the last columns to the loops below
+	const uint32 columns = doBlitBlendSIMD<kBlendAlpha>(ino, outo, width, height, pitch, inStep, inoStep, color);
+	ino += (int32)columns * inStep;
+	outo += columns * 4;
+	width -= columns;
+
 	if (color == 0xffffffff) {
 
 		for (uint32 i = 0; i < height; i++) {
@@ -201,6 +729,12 @@ void doBlitAdditiveBlend(byte *ino, byte *outo, uint32 width, uint32 height, uin
 	byte *in;
 	byte *out;
 
+	// The vector kernels leave the last columns to the loops below
+	const uint32 columns = doBlitBlendSIMD<kBlendAdditive>(ino, outo, width, height, pitch, inStep, inoStep, color);
+	ino += (int32)columns * inStep;
+	outo += columns * 4;
+	width -= columns;
+
 	if (color == 0xffffffff) {
 
 		for (uint32 i = 0; i < height; i++) {
@@ -268,6 +802,12 @@ void doBlitSubtractiveBlend(byte *ino, byte *outo, uint32 width, uint32 height,
 	byte *in;
 	byte *out;
 
+	// The vector kernels leave the last columns to the loops below
+	const uint32 columns = doBlitBlendSIMD<kBlendSubtractive>(ino, outo, width, height, pitch, inStep, inoStep, color);
+	ino += (int32)columns * inStep;
+	outo += columns * 4;
+	width -= columns;
+
 	if (color == 0xffffffff) {
 
 		for (uint32 i = 0; i < height; i++) {
@@ -333,6 +873,12 @@ void doBlitMultiplyBlend(byte *ino, byte *outo, uint32 width, uint32 height, uin
 	byte *in;
 	byte *out;
 
+	// The vector kernels leave the last columns to the loops below
+	const uint32 columns = doBlitBlendSIMD<kBlendMultiply>(ino, outo, width, height, pitch, inStep, inoStep, color);
+	ino += (int32)columns * inStep;
+	outo += columns * 4;
+	width -= columns;
+
 	if (color == 0xffffffff) {
 		for (uint32 i = 0; i < height; i++) {
 			out = outo;
@@ -392,6 +938,97 @@ void doBlitMultiplyBlend(byte *ino, byte *outo, uint32 width, uint32 height, uin
 
 }
 
+/**
+ * Blits with the fastest of the functions above that gives the requested result
+ */
+static void doBlit(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color, TSpriteBlendMode blendMode, AlphaType alphaMode) {
+	if (color == 0xFFFFFFFF && blendMode == BLEND_NORMAL && alphaMode == ALPHA_OPAQUE) {
+		doBlitOpaqueFast(ino, outo, width, height, pitch, inStep, inoStep);
+	} else if (color == 0xFFFFFFFF && blendMode == BLEND_NORMAL && alphaMode == ALPHA_BINARY) {
+		doBlitBinaryFast(ino, outo, width, height, pitch, inStep, inoStep);
+	} else {
+		if (blendMode == BLEND_ADDITIVE) {
+			doBlitAdditiveBlend(ino, outo, width, height, pitch, inStep, inoStep, color);
+		} else if (blendMode == BLEND_SUBTRACTIVE) {
+			doBlitSubtractiveBlend(ino, outo, width, height, pitch, inStep, inoStep, color);
+		} else if (blendMode == BLEND_MULTIPLY) {
+			doBlitMultiplyBlend(ino, outo, width, height, pitch, inStep, inoStep, color);
+		} else {
+			assert(blendMode == BLEND_NORMAL);
+			doBlitAlphaBlend(ino, outo, width, height, pitch, inStep, inoStep, color);
+		}
+	}
+}
+
+/** Number of scaled pixels doBlitScaled() gathers before blending them */
+static const int kScaledChunkSize = 256;
+
+/**
+ * Blits src scaled to width x height at posX, posY, with the same result as
+ * scaling it with scaleBlit() first, but without storing the scaled image.
+ * The visible pixels of each row are gathered into a small buffer, stepping
+ * through the source with exact integer increments, and blended from there.
+ *
+ * @return the size of the visible part
+ */
+static Common::Rect doBlitScaled(const Graphics::Surface &src, Graphics::Surface &target, const Common::Rect &clippingArea,
+                                 int posX, int posY, int width, int height, int flipping, uint32 color,
+                                 TSpriteBlendMode blendMode, AlphaType alphaMode) {
+	const int left = MAX<int>(posX, clippingArea.left);
+	const int top = MAX<int>(posY, clippingArea.top);
+	const int right = MIN<int>(posX + width, clippingArea.right);
+	const int bottom = MIN<int>(posY + height, clippingArea.bottom);
+
+	Common::Rect retSize;
+	retSize.setWidth(MAX(right - left, 0));
+	retSize.setHeight(MAX(bottom - top, 0));
+	if (right <= left || bottom <= top)
+		return retSize;
+
+	// Source column x * src.w / width advances by stepX and stepRem / width
+	const int stepX = src.w / width;
+	const int stepRem = src.w % width;
+
+	uint32 buffer[kScaledChunkSize];
+	for (int y = top; y < bottom; y++) {
+		int scaledY = y - posY;
+		if (flipping & FLIP_V)
+			scaledY = height - 1 - scaledY;
+		const uint32 *in = (const uint32 *)src.getBasePtr(0, scaledY * src.h / height);
+		byte *outo = (byte *)target.getBasePtr(left, y);
+
+		for (int x = left; x < right; x += kScaledChunkSize) {
+			const int count = MIN(right - x, kScaledChunkSize);
+
+			// The buffer always holds scaled pixels left to right, flipped
+			// chunks are blended from its end
+			int scaledX = x - posX;
+			if (flipping & FLIP_H)
+				scaledX = width - scaledX - count;
+
+			int srcX = scaledX * src.w / width;
+			int rem = scaledX * src.w % width;
+			for (int i = 0; i < count; i++) {
+				buffer[i] = in[srcX];
+				srcX += stepX;
+				rem += stepRem;
+				if (rem >= width) {
+					rem -= width;
+					srcX++;
+				}
+			}
+
+			if (flipping & FLIP_H)
+				doBlit((byte *)(buffer + count - 1), outo, count, 1, target.pitch, -4, 0, color, blendMode, alphaMode);
+			else
+				doBlit((byte *)buffer, outo, count, 1, target.pitch, 4, 0, color, blendMode, alphaMode);
+			outo += count * 4;
+		}
+	}
+
+	return retSize;
+}
+
 Common::Rect TransparentSurface::blit(Graphics::Surface &target, int posX, int posY, int flipping, Common::Rect *pPartRect, uint color, int width, int height, TSpriteBlendMode blendMode) {
 
 	Common::Rect retSize;
@@ -452,17 +1089,13 @@ Common::Rect TransparentSurface::blit(Graphics::Surface &target, int posX, int p
 	height = height * 2 / 3;
 #endif
 
-	Graphics::Surface *img = nullptr;
-	Graphics::Surface *imgScaled = nullptr;
-	byte *savedPixels = nullptr;
 	if ((width != srcImage.w) || (height != srcImage.h)) {
-		// Scale the image
-		img = imgScaled = srcImage.scale(width, height);
-		savedPixels = (byte *)img->getPixels();
-	} else {
-		img = &srcImage;
+		// Scale the image while blitting it
+		return doBlitScaled(srcImage, target, Common::Rect(target.w, target.h), posX, posY, width, height, flipping, color, blendMode, _alphaMode);
 	}
 
+	Graphics::Surface *img = &srcImage;
+
 	// Handle off-screen clipping
 	if (posY < 0) {
 		img->h = MAX(0, (int)img->h - -posY);
@@ -509,34 +1142,13 @@ Common::Rect TransparentSurface::blit(Graphics::Surface &target, int posX, int p
 		byte *ino = (byte *)img->getBasePtr(xp, yp);
 		byte *outo = (byte *)target.getBasePtr(posX, posY);
 
-		if (color == 0xFFFFFFFF && blendMode == BLEND_NORMAL && _alphaMode == ALPHA_OPAQUE) {
-			doBlitOpaqueFast(ino, outo, img->w, img->h, target.pitch, inStep, inoStep);
-		} else if (color == 0xFFFFFFFF && blendMode == BLEND_NORMAL && _alphaMode == ALPHA_BINARY) {
-			doBlitBinaryFast(ino, outo, img->w, img->h, target.pitch, inStep, inoStep);
-		} else {
-			if (blendMode == BLEND_ADDITIVE) {
-				doBlitAdditiveBlend(ino, outo, img->w, img->h, target.pitch, inStep, inoStep, color);
-			} else if (blendMode == BLEND_SUBTRACTIVE) {
-				doBlitSubtractiveBlend(ino, outo, img->w, img->h, target.pitch, inStep, inoStep, color);
-			} else if (blendMode == BLEND_MULTIPLY) {
-				doBlitMultiplyBlend(ino, outo, img->w, img->h, target.pitch, inStep, inoStep, color);
-			} else {
-				assert(blendMode == BLEND_NORMAL);
-				doBlitAlphaBlend(ino, outo, img->w, img->h, target.pitch, inStep, inoStep, color);
-			}
-		}
+		doBlit(ino, outo, img->w, img->h, target.pitch, inStep, inoStep, color, blendMode, _alphaMode);
 
 	}
 
 	retSize.setWidth(img->w);
 	retSize.setHeight(img->h);
 
-	if (imgScaled) {
-		imgScaled->setPixels(savedPixels);
-		imgScaled->free();
-		delete imgScaled;
-	}
-
 	return retSize;
 }
 
@@ -599,17 +1211,13 @@ Common::Rect TransparentSurface::blitClip(Graphics::Surface &target, Common::Rec
 	height = height * 2 / 3;
 #endif
 
-	Graphics::Surface *img = nullptr;
-	Graphics::Surface *imgScaled = nullptr;
-	byte *savedPixels = nullptr;
 	if ((width != srcImage.w) || (height != srcImage.h)) {
-		// Scale the image
-		img = imgScaled = srcImage.scale(width, height);
-		savedPixels = (byte *)img->getPixels();
-	} else {
-		img = &srcImage;
+		// Scale the image while blitting it
+		return doBlitScaled(srcImage, target, clippingArea, posX, posY, width, height, flipping, color, blendMode, _alphaMode);
 	}
 
+	Graphics::Surface *img = &srcImage;
+
 	// Handle off-screen clipping
 	if (posY < clippingArea.top) {
 		img->h = MAX(0, (int)img->h - (clippingArea.top - posY));
@@ -656,34 +1264,13 @@ Common::Rect TransparentSurface::blitClip(Graphics::Surface &target, Common::Rec
 		byte *ino = (byte *)img->getBasePtr(xp, yp);
 		byte *outo = (byte *)target.getBasePtr(posX, posY);
 
-		if (color == 0xFFFFFFFF && blendMode == BLEND_NORMAL && _alphaMode == ALPHA_OPAQUE) {
-			doBlitOpaqueFast(ino, outo, img->w, img->h, target.pitch, inStep, inoStep);
-		} else if (color == 0xFFFFFFFF && blendMode == BLEND_NORMAL && _alphaMode == ALPHA_BINARY) {
-			doBlitBinaryFast(ino, outo, img->w, img->h, target.pitch, inStep, inoStep);
-		} else {
-			if (blendMode == BLEND_ADDITIVE) {
-				doBlitAdditiveBlend(ino, outo, img->w, img->h, target.pitch, inStep, inoStep, color);
-			} else if (blendMode == BLEND_SUBTRACTIVE) {
-				doBlitSubtractiveBlend(ino, outo, img->w, img->h, target.pitch, inStep, inoStep, color);
-			} else if (blendMode == BLEND_MULTIPLY) {
-				doBlitMultiplyBlend(ino, outo, img->w, img->h, target.pitch, inStep, inoStep, color);
-			} else {
-				assert(blendMode == BLEND_NORMAL);
-				doBlitAlphaBlend(ino, outo, img->w, img->h, target.pitch, inStep, inoStep, color);
-			}
-		}
+		doBlit(ino, outo, img->w, img->h, target.pitch, inStep, inoStep, color, blendMode, _alphaMode);
 
 	}
 
 	retSize.setWidth(img->w);
 	retSize.setHeight(img->h);
 
-	if (imgScaled) {
-		imgScaled->setPixels(savedPixels);
-		imgScaled->free();
-		delete imgScaled;
-	}
-
 	return retSize;
 }
 
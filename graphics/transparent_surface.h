@@ -132,6 +132,33 @@ struct TransparentSurface : public Graphics::Surface {
 						int width = -1, int height = -1,
 						TSpriteBlendMode blend = BLEND_NORMAL);
 
+	/** The vector instruction sets the blend modes of blit() can make use of */
+	enum SIMDLevel {
+		kSIMDNone, /** Plain loops */
+		kSIMDSSE2, /** x86 SSE2, 4 pixels at a time */
+		kSIMDAVX2, /** x86 AVX2, 8 pixels at a time */
+		kSIMDNEON  /** ARM NEON, 4 pixels at a time */
+	};
+
+	/**
+	 * Select the instruction set used by the blend modes of blit() and
+	 * blitClip(), for all surfaces.
+	 *
+	 * By default, the best instruction set supported by both the build and
+	 * the CPU is used. This is meant for testing and benchmarking. The
+	 * results of all instruction sets are identical.
+	 *
+	 * @param level the instruction set to use
+	 * @return whether the instruction set is available
+	 */
+	static bool setSIMDLevel(SIMDLevel level);
+
+	/**
+	 * Get the instruction set used by the blend modes of blit() and
+	 * blitClip().
+	 */
+	static SIMDLevel getSIMDLevel();
+
 	void applyColorKey(uint8 r, uint8 g, uint8 b, bool overwriteAlpha = false);
 	void setAlpha(uint8 alpha, bool skipTransparent = false);
 
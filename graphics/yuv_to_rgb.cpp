@@ -83,9 +83,34 @@
 // BASIS, AND BROWN UNIVERSITY HAS NO OBLIGATION TO PROVIDE MAINTENANCE,
 // SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 
+#include "common/endian.h"
+#include "common/system.h"
 #include "graphics/surface.h"
 #include "graphics/yuv_to_rgb.h"
 
+// SSE2 is part of the x86-64 baseline, AVX2 is enabled per function and
+// only used when the CPU reports it. NEON is only used when it is part of
+// the build's baseline, and USE_ARM_NEON_KERNELS is defined, as the NEON
+// kernels have not been built or tested on ARM yet.
+#if defined(__GNUC__) && (defined(__x86_64__) || (defined(__i386__) && defined(__SSE2__)))
+#include <immintrin.h>
+#define YUV_SIMD_SSE2
+#define YUV_TARGET_SSE2
+#if defined(__clang__) || __GNUC__ >= 5
+#define YUV_SIMD_AVX2
+#define YUV_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#elif defined(_MSC_VER) && (defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#include <immintrin.h>
+#define YUV_SIMD_SSE2
+#define YUV_TARGET_SSE2
+#define YUV_SIMD_AVX2
+#define YUV_TARGET_AVX2
+#elif defined(USE_ARM_NEON_KERNELS) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+#include <arm_neon.h>
+#define YUV_SIMD_NEON
+#endif
+
 namespace Common {
 DECLARE_SINGLETON(Graphics::YUVToRGBManager);
 }
@@ -169,6 +194,11 @@ YUVToRGBLookup::YUVToRGBLookup(Graphics::PixelFormat format, YUVToRGBManager::Lu
 YUVToRGBManager::YUVToRGBManager() {
 	_lookup = 0;
 	_alphaMode = false;
+	_simdLevel = kSIMDNone;
+
+	// Pick the fastest instruction set available
+	if (!setSIMDLevel(kSIMDAVX2) && !setSIMDLevel(kSIMDSSE2))
+		setSIMDLevel(kSIMDNEON);
 
 	int16 *Cr_r_tab = &_colorTab[0 * 256];
 	int16 *Cr_g_tab = &_colorTab[1 * 256];
@@ -193,6 +223,40 @@ YUVToRGBManager::~YUVToRGBManager() {
 	delete _lookup;
 }
 
+bool YUVToRGBManager::setSIMDLevel(SIMDLevel level) {
+	bool available;
+
+	switch (level) {
+	case kSIMDNone:
+		available = true;
+		break;
+#ifdef YUV_SIMD_SSE2
+	case kSIMDSSE2:
+		// Part of the baseline of the build
+		available = true;
+		break;
+#endif
+#ifdef YUV_SIMD_AVX2
+	case kSIMDAVX2:
+		available = g_system && g_system->hasFeature(OSystem::kFeatureCpuAVX2);
+		break;
+#endif
+#ifdef YUV_SIMD_NEON
+	case kSIMDNEON:
+		available = true;
+		break;
+#endif
+	default:
+		available = false;
+		break;
+	}
+
+	if (available)
+		_simdLevel = level;
+
+	return available;
+}
+
 const YUVToRGBLookup *YUVToRGBManager::getLookup(Graphics::PixelFormat format, YUVToRGBManager::LuminanceScale scale, bool alphaMode) {
 	if (_lookup && _lookup->getFormat() == format && _lookup->getScale() == scale && _alphaMode == alphaMode)
 		return _lookup;
@@ -203,21 +267,457 @@ const YUVToRGBLookup *YUVToRGBManager::getLookup(Graphics::PixelFormat format, Y
 	return _lookup;
 }
 
+// The vector kernels below compute the same values as the lookup tables. The
+// chroma offsets of the tables are truncated products, which are reproduced
+// exactly from the absolute chroma value and these 16-bit multipliers:
+//   trunc(c * 0.419 / 0.299) == ((|c| * 2) * kMulCrR) >> 16, and so on,
+// for all c in [-128, 127]. The ITU luminance expansion is exact as well:
+//   (i * 255 / 219) == ((i * 2) * kMulITU) >> 16 for all i in [0, 219].
+enum {
+	kMulCrR = 45876,
+	kMulCrG = 46735,
+	kMulCbG = 22562,
+	kMulCbB = 58109,
+	kMulITU = 38155
+};
+
+struct YUVToRGBKernelParams {
+	YUVToRGBKernelParams(const PixelFormat &format, YUVToRGBManager::LuminanceScale scale) {
+		itu = scale == YUVToRGBManager::kScaleITU;
+		alpha = format.ARGBToColor(255, 0, 0, 0);
+		loss[0] = format.rLoss;
+		loss[1] = format.gLoss;
+		loss[2] = format.bLoss;
+
+		// Pixels are assembled as two 16-bit halves, which works as long as
+		// no channel straddles them. This is the case for all usual formats.
+		const int shifts[3] = { format.rShift, format.gShift, format.bShift };
+		vectorizable = true;
+
+		for (int i = 0; i < 3; i++) {
+			// Shifting 16-bit lanes by 16 or more clears them
+			lowShift[i] = shifts[i] < 16 ? shifts[i] : 16;
+			highShift[i] = shifts[i] >= 16 ? shifts[i] - 16 : 16;
+
+			if (shifts[i] < 16 && shifts[i] + 8 - loss[i] > 16)
+				vectorizable = false;
+		}
+	}
+
+	bool itu;
+	bool vectorizable;
+	uint32 alpha;
+	int loss[3];
+	int lowShift[3];
+	int highShift[3];
+};
+
+#ifdef YUV_SIMD_SSE2
+
+YUV_TARGET_SSE2 static inline __m128i chromaOffsetSSE2(__m128i absValue, __m128i sign, int mul) {
+	__m128i offset = _mm_mulhi_epu16(absValue, _mm_set1_epi16((int16)mul));
+	return _mm_sub_epi16(_mm_xor_si128(offset, sign), sign);
+}
+
+template<bool itu>
+YUV_TARGET_SSE2 static inline __m128i clampChannelSSE2(__m128i value) {
+	if (itu) {
+		value = _mm_min_epi16(_mm_max_epi16(value, _mm_set1_epi16(16)), _mm_set1_epi16(235));
+		value = _mm_sub_epi16(value, _mm_set1_epi16(16));
+		return _mm_mulhi_epu16(_mm_add_epi16(value, value), _mm_set1_epi16((int16)kMulITU));
+	}
+
+	return _mm_min_epi16(_mm_max_epi16(value, _mm_setzero_si128()), _mm_set1_epi16(255));
+}
+
+/**
+ * Turns luminance plus chroma offsets into pixels of the destination format.
+ * Pixels are assembled as two 16-bit halves, so everything stays in 16-bit
+ * lanes until the final interleave.
+ */
+struct PixelPackerSSE2 {
+	YUV_TARGET_SSE2 PixelPackerSSE2(const YUVToRGBKernelParams &params) {
+		rLoss = _mm_cvtsi32_si128(params.loss[0]);
+		gLoss = _mm_cvtsi32_si128(params.loss[1]);
+		bLoss = _mm_cvtsi32_si128(params.loss[2]);
+		rLow = _mm_cvtsi32_si128(params.lowShift[0]);
+		gLow = _mm_cvtsi32_si128(params.lowShift[1]);
+		bLow = _mm_cvtsi32_si128(params.lowShift[2]);
+		rHigh = _mm_cvtsi32_si128(params.highShift[0]);
+		gHigh = _mm_cvtsi32_si128(params.highShift[1]);
+		bHigh = _mm_cvtsi32_si128(params.highShift[2]);
+		alphaLow = _mm_set1_epi16((int16)(params.alpha & 0xFFFF));
+		alphaHigh = _mm_set1_epi16((int16)(params.alpha >> 16));
+	}
+
+	template<typename PixelInt, bool itu>
+	YUV_TARGET_SSE2 inline void store(byte *out, __m128i y, __m128i rOffset, __m128i gOffset, __m128i bOffset) const {
+		__m128i r = _mm_srl_epi16(clampChannelSSE2<itu>(_mm_add_epi16(y, rOffset)), rLoss);
+		__m128i g = _mm_srl_epi16(clampChannelSSE2<itu>(_mm_sub_epi16(y, gOffset)), gLoss);
+		__m128i b = _mm_srl_epi16(clampChannelSSE2<itu>(_mm_add_epi16(y, bOffset)), bLoss);
+
+		__m128i low = _mm_or_si128(_mm_or_si128(alphaLow, _mm_sll_epi16(r, rLow)),
+		                           _mm_or_si128(_mm_sll_epi16(g, gLow), _mm_sll_epi16(b, bLow)));
+
+		if (sizeof(PixelInt) == 2) {
+			_mm_storeu_si128((__m128i *)out, low);
+		} else {
+			__m128i high = _mm_or_si128(_mm_or_si128(alphaHigh, _mm_sll_epi16(r, rHigh)),
+			                            _mm_or_si128(_mm_sll_epi16(g, gHigh), _mm_sll_epi16(b, bHigh)));
+			_mm_storeu_si128((__m128i *)out, _mm_unpacklo_epi16(low, high));
+			_mm_storeu_si128((__m128i *)(out + 16), _mm_unpackhi_epi16(low, high));
+		}
+	}
+
+	__m128i rLoss, gLoss, bLoss;
+	__m128i rLow, gLow, bLow;
+	__m128i rHigh, gHigh, bHigh;
+	__m128i alphaLow, alphaHigh;
+};
+
+/**
+ * Convert one row of pixels (two rows for 420, which share the chroma row)
+ * 8 at a time, and return how many pixels per row were converted.
+ */
+template<typename PixelInt, bool is420, bool itu>
+YUV_TARGET_SSE2 static int convertRowsSSE2(byte *dst, int dstPitch, const byte *ySrc, int yPitch, const byte *uSrc, const byte *vSrc, int width, const YUVToRGBKernelParams &params) {
+	if (!params.vectorizable)
+		return 0;
+
+	const PixelPackerSSE2 packer(params);
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i bias = _mm_set1_epi16(128);
+
+	int x = 0;
+	for (; x + 8 <= width; x += 8) {
+		__m128i u, v;
+
+		if (is420) {
+			u = _mm_cvtsi32_si128(READ_UINT32(uSrc + x / 2));
+			v = _mm_cvtsi32_si128(READ_UINT32(vSrc + x / 2));
+			u = _mm_unpacklo_epi8(u, u);
+			v = _mm_unpacklo_epi8(v, v);
+		} else {
+			u = _mm_loadl_epi64((const __m128i *)(uSrc + x));
+			v = _mm_loadl_epi64((const __m128i *)(vSrc + x));
+		}
+
+		u = _mm_sub_epi16(_mm_unpacklo_epi8(u, zero), bias);
+		v = _mm_sub_epi16(_mm_unpacklo_epi8(v, zero), bias);
+
+		__m128i uSign = _mm_srai_epi16(u, 15);
+		__m128i vSign = _mm_srai_epi16(v, 15);
+		__m128i uAbs = _mm_sub_epi16(_mm_xor_si128(u, uSign), uSign);
+		__m128i vAbs = _mm_sub_epi16(_mm_xor_si128(v, vSign), vSign);
+
+		__m128i rOffset = chromaOffsetSSE2(_mm_add_epi16(vAbs, vAbs), vSign, kMulCrR);
+		__m128i gOffset = _mm_add_epi16(chromaOffsetSSE2(vAbs, vSign, kMulCrG), chromaOffsetSSE2(uAbs, uSign, kMulCbG));
+		__m128i bOffset = chromaOffsetSSE2(_mm_add_epi16(uAbs, uAbs), uSign, kMulCbB);
+
+		__m128i y = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(ySrc + x)), zero);
+		packer.store<PixelInt, itu>(dst + x * sizeof(PixelInt), y, rOffset, gOffset, bOffset);
+
+		if (is420) {
+			y = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(ySrc + yPitch + x)), zero);
+			packer.store<PixelInt, itu>(dst + dstPitch + x * sizeof(PixelInt), y, rOffset, gOffset, bOffset);
+		}
+	}
+
+	return x;
+}
+
+#endif
+
+#ifdef YUV_SIMD_AVX2
+
+YUV_TARGET_AVX2 static inline __m256i chromaOffsetAVX2(__m256i absValue, __m256i sign, int mul) {
+	__m256i offset = _mm256_mulhi_epu16(absValue, _mm256_set1_epi16((int16)mul));
+	return _mm256_sub_epi16(_mm256_xor_si256(offset, sign), sign);
+}
+
+template<bool itu>
+YUV_TARGET_AVX2 static inline __m256i clampChannelAVX2(__m256i value) {
+	if (itu) {
+		value = _mm256_min_epi16(_mm256_max_epi16(value, _mm256_set1_epi16(16)), _mm256_set1_epi16(235));
+		value = _mm256_sub_epi16(value, _mm256_set1_epi16(16));
+		return _mm256_mulhi_epu16(_mm256_add_epi16(value, value), _mm256_set1_epi16((int16)kMulITU));
+	}
+
+	return _mm256_min_epi16(_mm256_max_epi16(value, _mm256_setzero_si256()), _mm256_set1_epi16(255));
+}
+
+/**
+ * AVX2 version of PixelPackerSSE2.
+ */
+struct PixelPackerAVX2 {
+	YUV_TARGET_AVX2 PixelPackerAVX2(const YUVToRGBKernelParams &params) {
+		rLoss = _mm_cvtsi32_si128(params.loss[0]);
+		gLoss = _mm_cvtsi32_si128(params.loss[1]);
+		bLoss = _mm_cvtsi32_si128(params.loss[2]);
+		rLow = _mm_cvtsi32_si128(params.lowShift[0]);
+		gLow = _mm_cvtsi32_si128(params.lowShift[1]);
+		bLow = _mm_cvtsi32_si128(params.lowShift[2]);
+		rHigh = _mm_cvtsi32_si128(params.highShift[0]);
+		gHigh = _mm_cvtsi32_si128(params.highShift[1]);
+		bHigh = _mm_cvtsi32_si128(params.highShift[2]);
+		alphaLow = _mm256_set1_epi16((int16)(params.alpha & 0xFFFF));
+		alphaHigh = _mm256_set1_epi16((int16)(params.alpha >> 16));
+	}
+
+	template<typename PixelInt, bool itu>
+	YUV_TARGET_AVX2 inline void store(byte *out, __m256i y, __m256i rOffset, __m256i gOffset, __m256i bOffset) const {
+		__m256i r = _mm256_srl_epi16(clampChannelAVX2<itu>(_mm256_add_epi16(y, rOffset)), rLoss);
+		__m256i g = _mm256_srl_epi16(clampChannelAVX2<itu>(_mm256_sub_epi16(y, gOffset)), gLoss);
+		__m256i b = _mm256_srl_epi16(clampChannelAVX2<itu>(_mm256_add_epi16(y, bOffset)), bLoss);
+
+		__m256i low = _mm256_or_si256(_mm256_or_si256(alphaLow, _mm256_sll_epi16(r, rLow)),
+		                              _mm256_or_si256(_mm256_sll_epi16(g, gLow), _mm256_sll_epi16(b, bLow)));
+
+		if (sizeof(PixelInt) == 2) {
+			_mm256_storeu_si256((__m256i *)out, low);
+		} else {
+			__m256i high = _mm256_or_si256(_mm256_or_si256(alphaHigh, _mm256_sll_epi16(r, rHigh)),
+			                               _mm256_or_si256(_mm256_sll_epi16(g, gHigh), _mm256_sll_epi16(b, bHigh)));
+
+			// The unpacks work within 128-bit lanes, so put the lanes back in order
+			__m256i first = _mm256_unpacklo_epi16(low, high);
+			__m256i second = _mm256_unpackhi_epi16(low, high);
+			_mm256_storeu_si256((__m256i *)out, _mm256_permute2x128_si256(first, second, 0x20));
+			_mm256_storeu_si256((__m256i *)(out + 32), _mm256_permute2x128_si256(first, second, 0x31));
+		}
+	}
+
+	__m128i rLoss, gLoss, bLoss;
+	__m128i rLow, gLow, bLow;
+	__m128i rHigh, gHigh, bHigh;
+	__m256i alphaLow, alphaHigh;
+};
+
+/**
+ * AVX2 version of convertRowsSSE2(), converting 16 pixels at a time.
+ */
+template<typename PixelInt, bool is420, bool itu>
+YUV_TARGET_AVX2 static int convertRowsAVX2(byte *dst, int dstPitch, const byte *ySrc, int yPitch, const byte *uSrc, const byte *vSrc, int width, const YUVToRGBKernelParams &params) {
+	if (!params.vectorizable)
+		return 0;
+
+	const PixelPackerAVX2 packer(params);
+	const __m256i bias = _mm256_set1_epi16(128);
+
+	int x = 0;
+	for (; x + 16 <= width; x += 16) {
+		__m128i u8, v8;
+
+		if (is420) {
+			u8 = _mm_loadl_epi64((const __m128i *)(uSrc + x / 2));
+			v8 = _mm_loadl_epi64((const __m128i *)(vSrc + x / 2));
+			u8 = _mm_unpacklo_epi8(u8, u8);
+			v8 = _mm_unpacklo_epi8(v8, v8);
+		} else {
+			u8 = _mm_loadu_si128((const __m128i *)(uSrc + x));
+			v8 = _mm_loadu_si128((const __m128i *)(vSrc + x));
+		}
+
+		__m256i u = _mm256_sub_epi16(_mm256_cvtepu8_epi16(u8), bias);
+		__m256i v = _mm256_sub_epi16(_mm256_cvtepu8_epi16(v8), bias);
+
+		__m256i uSign = _mm256_srai_epi16(u, 15);
+		__m256i vSign = _mm256_srai_epi16(v, 15);
+		__m256i uAbs = _mm256_abs_epi16(u);
+		__m256i vAbs = _mm256_abs_epi16(v);
+
+		__m256i rOffset = chromaOffsetAVX2(_mm256_add_epi16(vAbs, vAbs), vSign, kMulCrR);
+		__m256i gOffset = _mm256_add_epi16(chromaOffsetAVX2(vAbs, vSign, kMulCrG), chromaOffsetAVX2(uAbs, uSign, kMulCbG));
+		__m256i bOffset = chromaOffsetAVX2(_mm256_add_epi16(uAbs, uAbs), uSign, kMulCbB);
+
+		__m256i y = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(ySrc + x)));
+		packer.store<PixelInt, itu>(dst + x * sizeof(PixelInt), y, rOffset, gOffset, bOffset);
+
+		if (is420) {
+			y = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(ySrc + yPitch + x)));
+			packer.store<PixelInt, itu>(dst + dstPitch + x * sizeof(PixelInt), y, rOffset, gOffset, bOffset);
+		}
+	}
+
+	return x;
+}
+
+#endif
+
+#ifdef YUV_SIMD_NEON
+
+static inline int16x8_t mulHighNEON(uint16x8_t value, uint16 mul) {
+	uint32x4_t lo = vmull_n_u16(vget_low_u16(value), mul);
+	uint32x4_t hi = vmull_n_u16(vget_high_u16(value), mul);
+	return vreinterpretq_s16_u16(vcombine_u16(vshrn_n_u32(lo, 16), vshrn_n_u32(hi, 16)));
+}
+
+static inline int16x8_t chromaOffsetNEON(uint16x8_t absValue, int16x8_t sign, uint16 mul) {
+	int16x8_t offset = mulHighNEON(absValue, mul);
+	return vsubq_s16(veorq_s16(offset, sign), sign);
+}
+
+template<bool itu>
+static inline uint16x8_t clampChannelNEON(int16x8_t value) {
+	if (itu) {
+		value = vminq_s16(vmaxq_s16(value, vdupq_n_s16(16)), vdupq_n_s16(235));
+		value = vshlq_n_s16(vsubq_s16(value, vdupq_n_s16(16)), 1);
+		return vreinterpretq_u16_s16(mulHighNEON(vreinterpretq_u16_s16(value), kMulITU));
+	}
+
+	return vreinterpretq_u16_s16(vminq_s16(vmaxq_s16(value, vdupq_n_s16(0)), vdupq_n_s16(255)));
+}
+
+/**
+ * NEON version of PixelPackerSSE2.
+ */
+struct PixelPackerNEON {
+	// Negative counts shift to the right
+	PixelPackerNEON(const YUVToRGBKernelParams &params) {
+		rLoss = vdupq_n_s16(-params.loss[0]);
+		gLoss = vdupq_n_s16(-params.loss[1]);
+		bLoss = vdupq_n_s16(-params.loss[2]);
+		rLow = vdupq_n_s16(params.lowShift[0]);
+		gLow = vdupq_n_s16(params.lowShift[1]);
+		bLow = vdupq_n_s16(params.lowShift[2]);
+		rHigh = vdupq_n_s16(params.highShift[0]);
+		gHigh = vdupq_n_s16(params.highShift[1]);
+		bHigh = vdupq_n_s16(params.highShift[2]);
+		alphaLow = vdupq_n_u16((uint16)(params.alpha & 0xFFFF));
+		alphaHigh = vdupq_n_u16((uint16)(params.alpha >> 16));
+	}
+
+	template<typename PixelInt, bool itu>
+	inline void store(byte *out, int16x8_t y, int16x8_t rOffset, int16x8_t gOffset, int16x8_t bOffset) const {
+		uint16x8_t r = vshlq_u16(clampChannelNEON<itu>(vaddq_s16(y, rOffset)), rLoss);
+		uint16x8_t g = vshlq_u16(clampChannelNEON<itu>(vsubq_s16(y, gOffset)), gLoss);
+		uint16x8_t b = vshlq_u16(clampChannelNEON<itu>(vaddq_s16(y, bOffset)), bLoss);
+
+		uint16x8_t low = vorrq_u16(vorrq_u16(alphaLow, vshlq_u16(r, rLow)),
+		                           vorrq_u16(vshlq_u16(g, gLow), vshlq_u16(b, bLow)));
+
+		if (sizeof(PixelInt) == 2) {
+			vst1q_u16((uint16 *)out, low);
+		} else {
+			uint16x8_t high = vorrq_u16(vorrq_u16(alphaHigh, vshlq_u16(r, rHigh)),
+			                            vorrq_u16(vshlq_u16(g, gHigh), vshlq_u16(b, bHigh)));
+			uint16x8x2_t pixels = vzipq_u16(low, high);
+			vst1q_u16((uint16 *)out, pixels.val[0]);
+			vst1q_u16((uint16 *)(out + 16), pixels.val[1]);
+		}
+	}
+
+	int16x8_t rLoss, gLoss, bLoss;
+	int16x8_t rLow, gLow, bLow;
+	int16x8_t rHigh, gHigh, bHigh;
+	uint16x8_t alphaLow, alphaHigh;
+};
+
+/**
+ * NEON version of convertRowsSSE2(), converting 8 pixels at a time.
+ */
+template<typename PixelInt, bool is420, bool itu>
+static int convertRowsNEON(byte *dst, int dstPitch, const byte *ySrc, int yPitch, const byte *uSrc, const byte *vSrc, int width, const YUVToRGBKernelParams &params) {
+	if (!params.vectorizable)
+		return 0;
+
+	const PixelPackerNEON packer(params);
+	const int16x8_t bias = vdupq_n_s16(128);
+
+	int x = 0;
+	for (; x + 8 <= width; x += 8) {
+		uint8x8_t u8, v8;
+
+		if (is420) {
+			u8 = vreinterpret_u8_u32(vdup_n_u32(READ_UINT32(uSrc + x / 2)));
+			v8 = vreinterpret_u8_u32(vdup_n_u32(READ_UINT32(vSrc + x / 2)));
+			u8 = vzip_u8(u8, u8).val[0];
+			v8 = vzip_u8(v8, v8).val[0];
+		} else {
+			u8 = vld1_u8(uSrc + x);
+			v8 = vld1_u8(vSrc + x);
+		}
+
+		int16x8_t u = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(u8)), bias);
+		int16x8_t v = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(v8)), bias);
+
+		int16x8_t uSign = vshrq_n_s16(u, 15);
+		int16x8_t vSign = vshrq_n_s16(v, 15);
+		uint16x8_t uAbs = vreinterpretq_u16_s16(vabsq_s16(u));
+		uint16x8_t vAbs = vreinterpretq_u16_s16(vabsq_s16(v));
+
+		int16x8_t rOffset = chromaOffsetNEON(vshlq_n_u16(vAbs, 1), vSign, kMulCrR);
+		int16x8_t gOffset = vaddq_s16(chromaOffsetNEON(vAbs, vSign, kMulCrG), chromaOffsetNEON(uAbs, uSign, kMulCbG));
+		int16x8_t bOffset = chromaOffsetNEON(vshlq_n_u16(uAbs, 1), uSign, kMulCbB);
+
+		int16x8_t y = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(ySrc + x)));
+		packer.store<PixelInt, itu>(dst + x * sizeof(PixelInt), y, rOffset, gOffset, bOffset);
+
+		if (is420) {
+			y = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(ySrc + yPitch + x)));
+			packer.store<PixelInt, itu>(dst + dstPitch + x * sizeof(PixelInt), y, rOffset, gOffset, bOffset);
+		}
+	}
+
+	return x;
+}
+
+#endif
+
+/**
+ * Convert as much of a row (a pair of rows for 420) as the selected
+ * instruction set allows, and return how many pixels per row were
+ * converted. The rest is left to the lookup tables.
+ */
+template<typename PixelInt, bool is420>
+static int convertRowsSIMD(YUVToRGBManager::SIMDLevel level, byte *dst, int dstPitch, const byte *ySrc, int yPitch, const byte *uSrc, const byte *vSrc, int width, const YUVToRGBKernelParams &params) {
+	switch (level) {
+#ifdef YUV_SIMD_SSE2
+	case YUVToRGBManager::kSIMDSSE2:
+		if (params.itu)
+			return convertRowsSSE2<PixelInt, is420, true>(dst, dstPitch, ySrc, yPitch, uSrc, vSrc, width, params);
+		return convertRowsSSE2<PixelInt, is420, false>(dst, dstPitch, ySrc, yPitch, uSrc, vSrc, width, params);
+#endif
+#ifdef YUV_SIMD_AVX2
+	case YUVToRGBManager::kSIMDAVX2:
+		if (params.itu)
+			return convertRowsAVX2<PixelInt, is420, true>(dst, dstPitch, ySrc, yPitch, uSrc, vSrc, width, params);
+		return convertRowsAVX2<PixelInt, is420, false>(dst, dstPitch, ySrc, yPitch, uSrc, vSrc, width, params);
+#endif
+#ifdef YUV_SIMD_NEON
+	case YUVToRGBManager::kSIMDNEON:
+		if (params.itu)
+			return convertRowsNEON<PixelInt, is420, true>(dst, dstPitch, ySrc, yPitch, uSrc, vSrc, width, params);
+		return convertRowsNEON<PixelInt, is420, false>(dst, dstPitch, ySrc, yPitch, uSrc, vSrc, width, params);
+#endif
+	default:
+		return 0;
+	}
+}
+
 #define PUT_PIXEL(s, d) \
 	L = &rgbToPix[(s)]; \
 	*((PixelInt *)(d)) = (L[cr_r] | L[crb_g] | L[cb_b])
 
 template<typename PixelInt>
-void convertYUV444ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, int16 *colorTab, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+void convertYUV444ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, int16 *colorTab, YUVToRGBManager::SIMDLevel simdLevel, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
 	// Keep the tables in pointers here to avoid a dereference on each pixel
 	const int16 *Cr_r_tab = colorTab;
 	const int16 *Cr_g_tab = Cr_r_tab + 256;
 	const int16 *Cb_g_tab = Cr_g_tab + 256;
 	const int16 *Cb_b_tab = Cb_g_tab + 256;
 	const uint32 *rgbToPix = lookup->getRGBToPix();
+	const YUVToRGBKernelParams params(lookup->getFormat(), lookup->getScale());
 
 	for (int h = 0; h < yHeight; h++) {
-		for (int w = 0; w < yWidth; w++) {
+		int start = convertRowsSIMD<PixelInt, false>(simdLevel, dstPtr, dstPitch, ySrc, yPitch, uSrc, vSrc, yWidth, params);
+
+		dstPtr += start * sizeof(PixelInt);
+		ySrc += start;
+		uSrc += start;
+		vSrc += start;
+
+		for (int w = start; w < yWidth; w++) {
 			const uint32 *L;
 
 			int16 cr_r  = Cr_r_tab[*vSrc];
@@ -248,13 +748,13 @@ void YUVToRGBManager::convert444(Graphics::Surface *dst, YUVToRGBManager::Lumina
 
 	// Use a templated function to avoid an if check on every pixel
 	if (dst->format.bytesPerPixel == 2)
-		convertYUV444ToRGB<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		convertYUV444ToRGB<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, _simdLevel, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
 	else
-		convertYUV444ToRGB<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		convertYUV444ToRGB<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, _simdLevel, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
 }
 
 template<typename PixelInt>
-void convertYUV420ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, int16 *colorTab, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+void convertYUV420ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, int16 *colorTab, YUVToRGBManager::SIMDLevel simdLevel, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
 	int halfHeight = yHeight >> 1;
 	int halfWidth = yWidth >> 1;
 
@@ -264,9 +764,19 @@ void convertYUV420ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup
 	const int16 *Cb_g_tab = Cr_g_tab + 256;
 	const int16 *Cb_b_tab = Cb_g_tab + 256;
 	const uint32 *rgbToPix = lookup->getRGBToPix();
+	const YUVToRGBKernelParams params(lookup->getFormat(), lookup->getScale());
 
 	for (int h = 0; h < halfHeight; h++) {
-		for (int w = 0; w < halfWidth; w++) {
+		// The kernels convert an even number of pixels, so the rest is
+		// made of whole 2x2 blocks
+		int start = convertRowsSIMD<PixelInt, true>(simdLevel, dstPtr, dstPitch, ySrc, yPitch, uSrc, vSrc, yWidth, params) >> 1;
+
+		dstPtr += start * 2 * sizeof(PixelInt);
+		ySrc += start * 2;
+		uSrc += start;
+		vSrc += start;
+
+		for (int w = start; w < halfWidth; w++) {
 			const uint32 *L;
 
 			int16 cr_r  = Cr_r_tab[*vSrc];
@@ -304,9 +814,9 @@ void YUVToRGBManager::convert420(Graphics::Surface *dst, YUVToRGBManager::Lumina
 
 	// Use a templated function to avoid an if check on every pixel
 	if (dst->format.bytesPerPixel == 2)
-		convertYUV420ToRGB<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		convertYUV420ToRGB<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, _simdLevel, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
 	else
-		convertYUV420ToRGB<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		convertYUV420ToRGB<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, _simdLevel, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
 }
 
 #define PUT_PIXELA(s, a, d) \
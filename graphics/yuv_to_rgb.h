@@ -54,6 +54,31 @@ public:
 		kScaleITU   /** Luminance values range from [16, 235], the range from ITU-R BT.601 */
 	};
 
+	/** The vector instruction sets the conversion can make use of */
+	enum SIMDLevel {
+		kSIMDNone, /** Plain table lookups */
+		kSIMDSSE2, /** x86 SSE2, 8 pixels at a time */
+		kSIMDAVX2, /** x86 AVX2, 16 pixels at a time */
+		kSIMDNEON  /** ARM NEON, 8 pixels at a time */
+	};
+
+	/**
+	 * Select the instruction set used by convert444() and convert420().
+	 *
+	 * By default, the best instruction set supported by both the build and
+	 * the CPU is used. This is meant for testing and benchmarking. The
+	 * results of all instruction sets are identical.
+	 *
+	 * @param level the instruction set to use
+	 * @return whether the instruction set is available
+	 */
+	bool setSIMDLevel(SIMDLevel level);
+
+	/**
+	 * Get the instruction set used by convert444() and convert420().
+	 */
+	SIMDLevel getSIMDLevel() const { return _simdLevel; }
+
 	/**
 	 * Convert a YUV444 image to an RGB surface
 	 *
@@ -131,6 +156,7 @@ private:
 	YUVToRGBLookup *_lookup;
 	int16 _colorTab[4 * 256]; // 2048 bytes
 	bool _alphaMode;
+	SIMDLevel _simdLevel;
 };
  /** @} */
 } // End of namespace Graphics
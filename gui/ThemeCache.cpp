@@ -0,0 +1,557 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "gui/ThemeCache.h"
+#include "gui/ThemeEval.h"
+
+#include "common/algorithm.h"
+#include "common/archive.h"
+#include "common/md5.h"
+
+#include "graphics/VectorRenderer.h"
+
+namespace GUI {
+
+/**
+ * The drawing functions a DrawStep may call, which are saved as their
+ * index in this table.
+ */
+static const Graphics::DrawingFunctionCallback kDrawingCalls[] = {
+	&Graphics::VectorRenderer::drawCallback_CIRCLE,
+	&Graphics::VectorRenderer::drawCallback_SQUARE,
+	&Graphics::VectorRenderer::drawCallback_ROUNDSQ,
+	&Graphics::VectorRenderer::drawCallback_BEVELSQ,
+	&Graphics::VectorRenderer::drawCallback_LINE,
+	&Graphics::VectorRenderer::drawCallback_TRIANGLE,
+	&Graphics::VectorRenderer::drawCallback_FILLSURFACE,
+	&Graphics::VectorRenderer::drawCallback_TAB,
+	&Graphics::VectorRenderer::drawCallback_VOID,
+	&Graphics::VectorRenderer::drawCallback_BITMAP,
+	&Graphics::VectorRenderer::drawCallback_CROSS
+};
+
+static void writeColor(Common::WriteStream &stream, const Graphics::DrawStep::Color &color) {
+	stream.writeByte(color.r);
+	stream.writeByte(color.g);
+	stream.writeByte(color.b);
+	stream.writeByte(color.set);
+}
+
+static void readColor(Common::ReadStream &stream, Graphics::DrawStep::Color &color) {
+	color.r = stream.readByte();
+	color.g = stream.readByte();
+	color.b = stream.readByte();
+	color.set = stream.readByte() != 0;
+}
+
+static void writeRect(Common::WriteStream &stream, const Common::Rect &rect) {
+	stream.writeSint16LE(rect.top);
+	stream.writeSint16LE(rect.left);
+	stream.writeSint16LE(rect.bottom);
+	stream.writeSint16LE(rect.right);
+}
+
+static void readRect(Common::ReadStream &stream, Common::Rect &rect) {
+	rect.top = stream.readSint16LE();
+	rect.left = stream.readSint16LE();
+	rect.bottom = stream.readSint16LE();
+	rect.right = stream.readSint16LE();
+}
+
+ThemeCache::ThemeCache(const Common::String &key) : _key(key), _commands(DisposeAfterUse::YES) {
+}
+
+bool ThemeCache::replay(Common::SeekableReadStream *stream, ThemeEngine *theme) {
+	if (stream->readUint32BE() != MKTAG('T', 'H', 'M', 'C') || stream->readUint32LE() != kVersion)
+		return false;
+	if (stream->readString() != _key)
+		return false;
+
+	ThemeEval *eval = theme->getEvaluator();
+
+	// The number of layouts open in the evaluator, the dialog included.
+	// The layout commands are only replayed where the parser could have
+	// made them, so that a damaged cache cannot pop or use an empty stack.
+	int depth = 0;
+
+	for (;;) {
+		// Calls are only made once all their arguments were read
+		const byte command = stream->readByte();
+		if (stream->eos() || stream->err())
+			return false;
+
+		switch (command) {
+		case kCommandEnd:
+			return depth == 0;
+
+		case kCommandDrawData: {
+			const Common::String data = stream->readString();
+			const bool cached = stream->readByte() != 0;
+			if (stream->eos() || !theme->addDrawData(data, cached))
+				return false;
+			break;
+		}
+
+		case kCommandDrawStep:
+			if (!replayDrawStep(*stream, theme))
+				return false;
+			break;
+
+		case kCommandTextData: {
+			const Common::String drawDataId = stream->readString();
+			const TextData textId = (TextData)stream->readSint32LE();
+			const TextColor colorId = (TextColor)stream->readSint32LE();
+			const Graphics::TextAlign alignH = (Graphics::TextAlign)stream->readSint32LE();
+			const ThemeEngine::TextAlignVertical alignV = (ThemeEngine::TextAlignVertical)stream->readSint32LE();
+			if (stream->eos() || textId < kTextDataDefault || textId >= kTextDataMAX || colorId < kTextColorNormal || colorId >= kTextColorMAX)
+				return false;
+			if (alignH < Graphics::kTextAlignInvalid || alignH > Graphics::kTextAlignRight || alignV < ThemeEngine::kTextAlignVInvalid || alignV > ThemeEngine::kTextAlignVTop)
+				return false;
+			if (!theme->addTextData(drawDataId, textId, colorId, alignH, alignV))
+				return false;
+			break;
+		}
+
+		case kCommandFont:
+		case kCommandFontNames: {
+			const TextData textId = (TextData)stream->readSint32LE();
+			const Common::String language = stream->readString();
+			const Common::String file = stream->readString();
+			const Common::String scalableFile = stream->readString();
+			const int pointsize = stream->readSint32LE();
+			if (stream->eos() || textId < kTextDataDefault || textId >= kTextDataMAX)
+				return false;
+
+			if (command == kCommandFontNames)
+				theme->storeFontNames(textId, language, file, scalableFile, pointsize);
+			else if (!theme->addFont(textId, language, file, scalableFile, pointsize))
+				return false;
+			break;
+		}
+
+		case kCommandTextColor: {
+			const TextColor colorId = (TextColor)stream->readSint32LE();
+			const int r = stream->readSint32LE();
+			const int g = stream->readSint32LE();
+			const int b = stream->readSint32LE();
+			if (stream->eos() || colorId < kTextColorNormal || !theme->addTextColor(colorId, r, g, b))
+				return false;
+			break;
+		}
+
+		case kCommandBitmap:
+			if (!replayBitmap(*stream, theme))
+				return false;
+			break;
+
+		case kCommandCursor: {
+			const Common::String filename = stream->readString();
+			const int hotspotX = stream->readSint32LE();
+			const int hotspotY = stream->readSint32LE();
+			if (stream->eos() || !theme->createCursor(filename, hotspotX, hotspotY))
+				return false;
+			break;
+		}
+
+		case kCommandVar: {
+			const Common::String name = stream->readString();
+			const int val = stream->readSint32LE();
+			if (stream->eos())
+				return false;
+			eval->setVar(name, val);
+			break;
+		}
+
+		case kCommandDialog: {
+			const Common::String name = stream->readString();
+			const Common::String overlays = stream->readString();
+			const int16 maxWidth = stream->readSint16LE();
+			const int16 maxHeight = stream->readSint16LE();
+			const int inset = stream->readSint32LE();
+			if (stream->eos() || depth != 0)
+				return false;
+			eval->addDialog(name, overlays, maxWidth, maxHeight, inset);
+			depth = 1;
+			break;
+		}
+
+		case kCommandLayout: {
+			const ThemeLayout::LayoutType type = (ThemeLayout::LayoutType)stream->readByte();
+			const int spacing = stream->readSint32LE();
+			const ThemeLayout::ItemAlign itemAlign = (ThemeLayout::ItemAlign)stream->readByte();
+			if (stream->eos() || depth == 0)
+				return false;
+			if ((type != ThemeLayout::kLayoutVertical && type != ThemeLayout::kLayoutHorizontal) || itemAlign > ThemeLayout::kItemAlignStretch)
+				return false;
+			eval->addLayout(type, spacing, itemAlign);
+			depth++;
+			break;
+		}
+
+		case kCommandWidget: {
+			const Common::String name = stream->readString();
+			const Common::String type = stream->readString();
+			const int w = stream->readSint32LE();
+			const int h = stream->readSint32LE();
+			const Graphics::TextAlign align = (Graphics::TextAlign)stream->readSint32LE();
+			const bool useRTL = stream->readByte() != 0;
+			if (stream->eos() || depth == 0 || align < Graphics::kTextAlignInvalid || align > Graphics::kTextAlignRight)
+				return false;
+			eval->addWidget(name, type, w, h, align, useRTL);
+			break;
+		}
+
+		case kCommandImportedLayout: {
+			const Common::String name = stream->readString();
+			if (stream->eos() || depth == 0 || !eval->hasDialog(name))
+				return false;
+			eval->addImportedLayout(name);
+			break;
+		}
+
+		case kCommandSpace: {
+			const int size = stream->readSint32LE();
+			if (stream->eos() || depth == 0)
+				return false;
+			eval->addSpace(size);
+			break;
+		}
+
+		case kCommandPadding: {
+			const int16 l = stream->readSint16LE();
+			const int16 r = stream->readSint16LE();
+			const int16 t = stream->readSint16LE();
+			const int16 b = stream->readSint16LE();
+			if (stream->eos() || depth == 0)
+				return false;
+			eval->addPadding(l, r, t, b);
+			break;
+		}
+
+		case kCommandCloseLayout:
+			// The dialog is closed by kCommandCloseDialog
+			if (depth < 2)
+				return false;
+			eval->closeLayout();
+			depth--;
+			break;
+
+		case kCommandCloseDialog:
+			if (depth != 1)
+				return false;
+			eval->closeDialog();
+			depth = 0;
+			break;
+
+		default:
+			return false;
+		}
+	}
+}
+
+bool ThemeCache::replayDrawStep(Common::SeekableReadStream &stream, ThemeEngine *theme) {
+	const Common::String drawDataId = stream.readString();
+	const byte drawingCall = stream.readByte();
+	const Common::String bitmap = stream.readString();
+
+	Graphics::DrawStep step;
+	readColor(stream, step.fgColor);
+	readColor(stream, step.bgColor);
+	readColor(stream, step.gradColor1);
+	readColor(stream, step.gradColor2);
+	readColor(stream, step.bevelColor);
+	step.autoWidth = stream.readByte() != 0;
+	step.autoHeight = stream.readByte() != 0;
+	step.x = stream.readSint16LE();
+	step.y = stream.readSint16LE();
+	step.w = stream.readSint16LE();
+	step.h = stream.readSint16LE();
+	readRect(stream, step.padding);
+	readRect(stream, step.clip);
+	step.xAlign = (Graphics::DrawStep::VectorAlignment)stream.readByte();
+	step.yAlign = (Graphics::DrawStep::VectorAlignment)stream.readByte();
+	step.shadow = stream.readByte();
+	step.stroke = stream.readByte();
+	step.factor = stream.readByte();
+	step.radius = stream.readByte();
+	step.bevel = stream.readByte();
+	step.fillMode = stream.readByte();
+	step.shadowFillMode = stream.readByte();
+	step.extraData = stream.readUint32LE();
+	step.scale = stream.readUint32LE();
+	step.autoscale = (ThemeEngine::AutoScaleMode)stream.readByte();
+
+	if (stream.eos() || drawingCall >= ARRAYSIZE(kDrawingCalls))
+		return false;
+
+	const DrawData id = theme->parseDrawDataId(drawDataId);
+	if (id == kDDNone || !theme->_widgets[id])
+		return false;
+
+	step.drawingCall = kDrawingCalls[drawingCall];
+	if (!bitmap.empty()) {
+		step.blitSrc = theme->getImageSurface(bitmap);
+		if (!step.blitSrc)
+			return false;
+	}
+
+	theme->addDrawStep(drawDataId, step);
+	return true;
+}
+
+bool ThemeCache::replayBitmap(Common::SeekableReadStream &stream, ThemeEngine *theme) {
+	const Common::String filename = stream.readString();
+
+	Graphics::PixelFormat format;
+	format.bytesPerPixel = stream.readByte();
+	format.rLoss = stream.readByte();
+	format.gLoss = stream.readByte();
+	format.bLoss = stream.readByte();
+	format.aLoss = stream.readByte();
+	format.rShift = stream.readByte();
+	format.gShift = stream.readByte();
+	format.bShift = stream.readByte();
+	format.aShift = stream.readByte();
+	const uint16 w = stream.readUint16LE();
+	const uint16 h = stream.readUint16LE();
+
+	const uint32 lineSize = w * format.bytesPerPixel;
+	if (stream.eos() || format.bytesPerPixel == 0 || format.bytesPerPixel > 4 || stream.size() - stream.pos() < (int64)lineSize * h)
+		return false;
+
+	Graphics::ManagedSurface *surface = new Graphics::ManagedSurface(w, h, format);
+	for (uint y = 0; y < h; ++y)
+		stream.read(surface->getBasePtr(0, y), lineSize);
+
+	// Replace the bitmap of the same name, like ThemeEngine::addBitmap() does
+	Graphics::ManagedSurface *&entry = theme->_bitmaps[filename];
+	if (entry) {
+		entry->free();
+		delete entry;
+	}
+	entry = surface;
+
+	return true;
+}
+
+bool ThemeCache::save(Common::WriteStream *stream) {
+	stream->writeUint32BE(MKTAG('T', 'H', 'M', 'C'));
+	stream->writeUint32LE(kVersion);
+	stream->writeString(_key);
+	stream->writeByte(0);
+	stream->write(_commands.getData(), _commands.size());
+	stream->writeByte(kCommandEnd);
+
+	return stream->flush() && !stream->err();
+}
+
+Common::String ThemeCache::computeArchiveHash(const Common::Archive &archive) {
+	Common::ArchiveMemberList members;
+	archive.listMembers(members);
+
+	Common::StringArray names;
+	for (Common::ArchiveMemberList::const_iterator i = members.begin(); i != members.end(); ++i)
+		names.push_back((*i)->getName());
+	Common::sort(names.begin(), names.end());
+
+	// Hash the hashes of all the files, along with their names
+	Common::String hashes;
+	for (uint i = 0; i < names.size(); ++i) {
+		Common::SeekableReadStream *stream = archive.createReadStreamForMember(names[i]);
+		if (!stream)
+			continue;
+		hashes += names[i] + ' ' + Common::computeStreamMD5AsString(*stream) + '\n';
+		delete stream;
+	}
+
+	Common::MemoryReadStream hashesStream((const byte *)hashes.c_str(), hashes.size());
+	return Common::computeStreamMD5AsString(hashesStream);
+}
+
+void ThemeCache::writeString(const Common::String &str) {
+	_commands.writeString(str);
+	_commands.writeByte(0);
+}
+
+void ThemeCache::addDrawData(const Common::String &data, bool cached) {
+	_commands.writeByte(kCommandDrawData);
+	writeString(data);
+	_commands.writeByte(cached);
+}
+
+void ThemeCache::addDrawStep(const Common::String &drawDataId, const Graphics::DrawStep &step, const Common::String &bitmap) {
+	byte drawingCall = 0;
+	while (drawingCall < ARRAYSIZE(kDrawingCalls) && kDrawingCalls[drawingCall] != step.drawingCall)
+		drawingCall++;
+
+	_commands.writeByte(kCommandDrawStep);
+	writeString(drawDataId);
+	_commands.writeByte(drawingCall);
+	writeString(bitmap);
+	writeColor(_commands, step.fgColor);
+	writeColor(_commands, step.bgColor);
+	writeColor(_commands, step.gradColor1);
+	writeColor(_commands, step.gradColor2);
+	writeColor(_commands, step.bevelColor);
+	_commands.writeByte(step.autoWidth);
+	_commands.writeByte(step.autoHeight);
+	_commands.writeSint16LE(step.x);
+	_commands.writeSint16LE(step.y);
+	_commands.writeSint16LE(step.w);
+	_commands.writeSint16LE(step.h);
+	writeRect(_commands, step.padding);
+	writeRect(_commands, step.clip);
+	_commands.writeByte(step.xAlign);
+	_commands.writeByte(step.yAlign);
+	_commands.writeByte(step.shadow);
+	_commands.writeByte(step.stroke);
+	_commands.writeByte(step.factor);
+	_commands.writeByte(step.radius);
+	_commands.writeByte(step.bevel);
+	_commands.writeByte(step.fillMode);
+	_commands.writeByte(step.shadowFillMode);
+	_commands.writeUint32LE(step.extraData);
+	_commands.writeUint32LE(step.scale);
+	_commands.writeByte(step.autoscale);
+}
+
+void ThemeCache::addTextData(const Common::String &drawDataId, TextData textId, TextColor colorId, Graphics::TextAlign alignH, ThemeEngine::TextAlignVertical alignV) {
+	_commands.writeByte(kCommandTextData);
+	writeString(drawDataId);
+	_commands.writeSint32LE(textId);
+	_commands.writeSint32LE(colorId);
+	_commands.writeSint32LE(alignH);
+	_commands.writeSint32LE(alignV);
+}
+
+void ThemeCache::addFont(TextData textId, const Common::String &language, const Common::String &file, const Common::String &scalableFile, int pointsize) {
+	_commands.writeByte(kCommandFont);
+	_commands.writeSint32LE(textId);
+	writeString(language);
+	writeString(file);
+	writeString(scalableFile);
+	_commands.writeSint32LE(pointsize);
+}
+
+void ThemeCache::storeFontNames(TextData textId, const Common::String &language, const Common::String &file, const Common::String &scalableFile, int pointsize) {
+	_commands.writeByte(kCommandFontNames);
+	_commands.writeSint32LE(textId);
+	writeString(language);
+	writeString(file);
+	writeString(scalableFile);
+	_commands.writeSint32LE(pointsize);
+}
+
+void ThemeCache::addTextColor(TextColor colorId, int r, int g, int b) {
+	_commands.writeByte(kCommandTextColor);
+	_commands.writeSint32LE(colorId);
+	_commands.writeSint32LE(r);
+	_commands.writeSint32LE(g);
+	_commands.writeSint32LE(b);
+}
+
+void ThemeCache::addBitmap(const Common::String &filename, const Graphics::ManagedSurface *surface) {
+	const Graphics::PixelFormat &format = surface->format;
+
+	_commands.writeByte(kCommandBitmap);
+	writeString(filename);
+	_commands.writeByte(format.bytesPerPixel);
+	_commands.writeByte(format.rLoss);
+	_commands.writeByte(format.gLoss);
+	_commands.writeByte(format.bLoss);
+	_commands.writeByte(format.aLoss);
+	_commands.writeByte(format.rShift);
+	_commands.writeByte(format.gShift);
+	_commands.writeByte(format.bShift);
+	_commands.writeByte(format.aShift);
+	_commands.writeUint16LE(surface->w);
+	_commands.writeUint16LE(surface->h);
+	for (int y = 0; y < surface->h; ++y)
+		_commands.write(surface->getBasePtr(0, y), surface->w * format.bytesPerPixel);
+}
+
+void ThemeCache::createCursor(const Common::String &filename, int hotspotX, int hotspotY) {
+	_commands.writeByte(kCommandCursor);
+	writeString(filename);
+	_commands.writeSint32LE(hotspotX);
+	_commands.writeSint32LE(hotspotY);
+}
+
+void ThemeCache::setVar(const Common::String &name, int val) {
+	_commands.writeByte(kCommandVar);
+	writeString(name);
+	_commands.writeSint32LE(val);
+}
+
+void ThemeCache::addDialog(const Common::String &name, const Common::String &overlays, int16 maxWidth, int16 maxHeight, int inset) {
+	_commands.writeByte(kCommandDialog);
+	writeString(name);
+	writeString(overlays);
+	_commands.writeSint16LE(maxWidth);
+	_commands.writeSint16LE(maxHeight);
+	_commands.writeSint32LE(inset);
+}
+
+void ThemeCache::addLayout(ThemeLayout::LayoutType type, int spacing, ThemeLayout::ItemAlign itemAlign) {
+	_commands.writeByte(kCommandLayout);
+	_commands.writeByte(type);
+	_commands.writeSint32LE(spacing);
+	_commands.writeByte(itemAlign);
+}
+
+void ThemeCache::addWidget(const Common::String &name, const Common::String &type, int w, int h, Graphics::TextAlign align, bool useRTL) {
+	_commands.writeByte(kCommandWidget);
+	writeString(name);
+	writeString(type);
+	_commands.writeSint32LE(w);
+	_commands.writeSint32LE(h);
+	_commands.writeSint32LE(align);
+	_commands.writeByte(useRTL);
+}
+
+void ThemeCache::addImportedLayout(const Common::String &name) {
+	_commands.writeByte(kCommandImportedLayout);
+	writeString(name);
+}
+
+void ThemeCache::addSpace(int size) {
+	_commands.writeByte(kCommandSpace);
+	_commands.writeSint32LE(size);
+}
+
+void ThemeCache::addPadding(int16 l, int16 r, int16 t, int16 b) {
+	_commands.writeByte(kCommandPadding);
+	_commands.writeSint16LE(l);
+	_commands.writeSint16LE(r);
+	_commands.writeSint16LE(t);
+	_commands.writeSint16LE(b);
+}
+
+void ThemeCache::closeLayout() {
+	_commands.writeByte(kCommandCloseLayout);
+}
+
+void ThemeCache::closeDialog() {
+	_commands.writeByte(kCommandCloseDialog);
+}
+
+} // End of namespace GUI
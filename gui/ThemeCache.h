@@ -0,0 +1,141 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef GUI_THEME_CACHE_H
+#define GUI_THEME_CACHE_H
+
+#include "common/scummsys.h"
+#include "common/memstream.h"
+#include "common/noncopyable.h"
+#include "common/str.h"
+
+#include "gui/ThemeEngine.h"
+#include "gui/ThemeLayout.h"
+
+namespace Common {
+class Archive;
+}
+
+namespace GUI {
+
+/**
+ * A binary cache of a parsed theme.
+ *
+ * While a theme is parsed, the calls the ThemeParser makes to the
+ * ThemeEngine and the ThemeEval are recorded, along with the bitmaps they
+ * decoded. Replaying them loads the theme again without parsing any XML or
+ * decoding any image. Fonts are loaded again by the replayed calls, since
+ * they have a cache of their own.
+ *
+ * The recorded calls depend on the theme files, on the resolution and on
+ * the overlay format, so a cache is only replayed for the same key.
+ */
+class ThemeCache : Common::NonCopyable {
+public:
+	/**
+	 * @param key Identifies the theme contents and everything else the
+	 *            parsed theme depends on.
+	 */
+	explicit ThemeCache(const Common::String &key);
+
+	/**
+	 * Replay a cache saved with the same key into @p theme.
+	 *
+	 * @return false if the cache was saved for another key or is damaged, in
+	 *         which case the calls replayed so far are left in place.
+	 */
+	bool replay(Common::SeekableReadStream *stream, ThemeEngine *theme);
+
+	/**
+	 * Save the recorded calls.
+	 */
+	bool save(Common::WriteStream *stream);
+
+	/**
+	 * Compute a hash of all the files of a theme.
+	 */
+	static Common::String computeArchiveHash(const Common::Archive &archive);
+
+	/**
+	 * @name Recording
+	 * Each of these records a successful call to the ThemeEngine or ThemeEval
+	 * method of the same name.
+	 * @{
+	 */
+	void addDrawData(const Common::String &data, bool cached);
+	void addDrawStep(const Common::String &drawDataId, const Graphics::DrawStep &step, const Common::String &bitmap);
+	void addTextData(const Common::String &drawDataId, TextData textId, TextColor colorId, Graphics::TextAlign alignH, ThemeEngine::TextAlignVertical alignV);
+	void addFont(TextData textId, const Common::String &language, const Common::String &file, const Common::String &scalableFile, int pointsize);
+	void storeFontNames(TextData textId, const Common::String &language, const Common::String &file, const Common::String &scalableFile, int pointsize);
+	void addTextColor(TextColor colorId, int r, int g, int b);
+	void addBitmap(const Common::String &filename, const Graphics::ManagedSurface *surface);
+	void createCursor(const Common::String &filename, int hotspotX, int hotspotY);
+
+	void setVar(const Common::String &name, int val);
+	void addDialog(const Common::String &name, const Common::String &overlays, int16 maxWidth, int16 maxHeight, int inset);
+	void addLayout(ThemeLayout::LayoutType type, int spacing, ThemeLayout::ItemAlign itemAlign);
+	void addWidget(const Common::String &name, const Common::String &type, int w, int h, Graphics::TextAlign align, bool useRTL);
+	void addImportedLayout(const Common::String &name);
+	void addSpace(int size);
+	void addPadding(int16 l, int16 r, int16 t, int16 b);
+	void closeLayout();
+	void closeDialog();
+	/** @} */
+
+private:
+	enum {
+		kVersion = 1
+	};
+
+	enum Command {
+		kCommandEnd,
+		kCommandDrawData,
+		kCommandDrawStep,
+		kCommandTextData,
+		kCommandFont,
+		kCommandFontNames,
+		kCommandTextColor,
+		kCommandBitmap,
+		kCommandCursor,
+		kCommandVar,
+		kCommandDialog,
+		kCommandLayout,
+		kCommandWidget,
+		kCommandImportedLayout,
+		kCommandSpace,
+		kCommandPadding,
+		kCommandCloseLayout,
+		kCommandCloseDialog
+	};
+
+	void writeString(const Common::String &str);
+
+	bool replayDrawStep(Common::SeekableReadStream &stream, ThemeEngine *theme);
+	bool replayBitmap(Common::SeekableReadStream &stream, ThemeEngine *theme);
+
+	Common::String _key;
+	Common::MemoryWriteStreamDynamic _commands;
+};
+
+} // End of namespace GUI
+
+#endif
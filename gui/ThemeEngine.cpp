@@ -24,6 +24,9 @@
 #include "common/config-manager.h"
 #include "common/file.h"
 #include "common/fs.h"
+#include "common/md5.h"
+#include "common/memstream.h"
+#include "common/savefile.h"
 #include "common/unzip.h"
 #include "common/tokenizer.h"
 #include "common/translation.h"
@@ -42,6 +45,7 @@
 #include "image/png.h"
 
 #include "gui/widget.h"
+#include "gui/ThemeCache.h"
 #include "gui/ThemeEngine.h"
 #include "gui/ThemeEval.h"
 #include "gui/ThemeParser.h"
@@ -189,7 +193,7 @@ static const DrawDataInfo kDrawDataDefaults[] = {
 ThemeEngine::ThemeEngine(Common::String id, GraphicsMode mode) :
 	_system(nullptr), _vectorRenderer(nullptr),
 	_layerToDraw(kDrawLayerBackground), _bytesPerPixel(0),  _graphicsMode(kGfxDisabled),
-	_font(nullptr), _initOk(false), _themeOk(false), _enabled(false), _themeFiles(),
+	_themeCache(nullptr), _font(nullptr), _initOk(false), _themeOk(false), _enabled(false), _themeFiles(),
 	_cursor(nullptr), _scaleFactor(1.0f) {
 
 	_baseWidth = 640;	// Default sane values
@@ -503,6 +507,18 @@ void ThemeEngine::addDrawStep(const Common::String &drawDataId, const Graphics::
 
 	assert(id != kDDNone && _widgets[id] != nullptr);
 	_widgets[id]->_steps.push_back(step);
+
+	if (_themeCache) {
+		// Bitmaps are cached by their name
+		Common::String bitmap;
+		for (ImagesMap::const_iterator i = _bitmaps.begin(); i != _bitmaps.end() && step.blitSrc; ++i) {
+			if (i->_value == step.blitSrc) {
+				bitmap = i->_key;
+				break;
+			}
+		}
+		_themeCache->addDrawStep(drawDataId, step, bitmap);
+	}
 }
 
 bool ThemeEngine::addTextData(const Common::String &drawDataId, TextData textId, TextColor colorId, Graphics::TextAlign alignH, TextAlignVertical alignV) {
@@ -516,6 +532,9 @@ bool ThemeEngine::addTextData(const Common::String &drawDataId, TextData textId,
 	_widgets[id]->_textAlignH = alignH;
 	_widgets[id]->_textAlignV = alignV;
 
+	if (_themeCache)
+		_themeCache->addTextData(drawDataId, textId, colorId, alignH, alignV);
+
 	return true;
 }
 
@@ -523,6 +542,10 @@ bool ThemeEngine::addFont(TextData textId, const Common::String &language, const
 	if (textId == -1)
 		return false;
 
+	// Fonts are not cached with the theme, only the call loading them
+	if (_themeCache)
+		_themeCache->addFont(textId, language, file, scalableFile, pointsize);
+
 	if (!language.empty()) {
 #ifdef USE_TRANSLATION
 		Common::String cl = TransMan.getCurrentLanguage();
@@ -629,6 +652,9 @@ Common::Array<Common::Language> getLangIdentifiers(const Common::String &languag
 }
 
 void ThemeEngine::storeFontNames(TextData textId, const Common::String &language, const Common::String &file, const Common::String &scalableFile, const int pointsize) {
+	if (_themeCache)
+		_themeCache->storeFontNames(textId, language, file, scalableFile, pointsize);
+
 	if (language.empty())
 		return;
 
@@ -667,6 +693,9 @@ bool ThemeEngine::addTextColor(TextColor colorId, int r, int g, int b) {
 	_textColors[colorId]->g = g;
 	_textColors[colorId]->b = b;
 
+	if (_themeCache)
+		_themeCache->addTextColor(colorId, r, g, b);
+
 	return true;
 }
 
@@ -702,6 +731,9 @@ bool ThemeEngine::addBitmap(const Common::String &filename, const Common::String
 			return false;
 		}
 
+		if (_themeCache)
+			_themeCache->addBitmap(filename, _bitmaps[filename]);
+
 		return true;
 	}
 
@@ -762,6 +794,9 @@ bool ThemeEngine::addBitmap(const Common::String &filename, const Common::String
 	// Store the surface into our hashmap (attention, may store NULL entries!)
 	_bitmaps[filename] = surf;
 
+	if (_themeCache && surf)
+		_themeCache->addBitmap(filename, surf);
+
 	return surf != nullptr;
 }
 
@@ -778,6 +813,9 @@ bool ThemeEngine::addDrawData(const Common::String &data, bool cached) {
 	_widgets[id]->_layer = kDrawDataDefaults[id].layer;
 	_widgets[id]->_textDataId = kTextDataNone;
 
+	if (_themeCache)
+		_themeCache->addDrawData(data, cached);
+
 	return true;
 }
 
@@ -797,6 +835,20 @@ void ThemeEngine::loadTheme(const Common::String &themeId) {
 		_themeOk = loadThemeXML(themeId);
 	}
 
+	// Save the theme for the next time, unless it was loaded from the cache
+	if (_themeCache) {
+		_themeEval->setRecorder(nullptr);
+
+		if (_themeOk) {
+			Common::ScopedPtr<Common::OutSaveFile> cacheOut(_system->getSavefileManager()->openForSaving("themecache-" + _themeId, false));
+			if (cacheOut && _themeCache->save(cacheOut.get()))
+				cacheOut->finalize();
+		}
+
+		delete _themeCache;
+		_themeCache = nullptr;
+	}
+
 	if (!_themeOk) {
 		warning("Failed to load theme '%s'", themeId.c_str());
 		return;
@@ -812,9 +864,6 @@ void ThemeEngine::loadTheme(const Common::String &themeId) {
 }
 
 void ThemeEngine::unloadTheme() {
-	if (!_themeOk)
-		return;
-
 	for (int i = 0; i < kDrawDataMAX; ++i) {
 		delete _widgets[i];
 		_widgets[i] = nullptr;
@@ -837,6 +886,28 @@ void ThemeEngine::unloadTheme() {
 	_themeOk = false;
 }
 
+bool ThemeEngine::loadThemeCache(const Common::String &themeHash) {
+	// The parsed theme depends on the resolution and on the overlay format
+	// too. Only the last one is kept, so that the cache does not grow with
+	// each window size.
+	const Common::String key = Common::String::format("%s %dx%d %g %s", themeHash.c_str(),
+		_baseWidth, _baseHeight, _scaleFactor, _overlayFormat.toString().c_str());
+	ThemeCache *cache = new ThemeCache(key);
+
+	Common::ScopedPtr<Common::InSaveFile> cacheIn(_system->getSavefileManager()->openForLoading("themecache-" + _themeId));
+	if (cacheIn && cache->replay(cacheIn.get(), this)) {
+		delete cache;
+		return true;
+	}
+
+	// Drop what an outdated or damaged cache replayed, and record the theme
+	// while it is parsed
+	unloadTheme();
+	_themeCache = cache;
+	_themeEval->setRecorder(cache);
+	return false;
+}
+
 void ThemeEngine::unloadExtraFont() {
 	delete _texts[kTextDataExtraLang];
 	_texts[kTextDataExtraLang] = nullptr;
@@ -871,6 +942,16 @@ bool ThemeEngine::loadDefaultXML() {
 	_themeId = "builtin";
 	_themeFile.clear();
 
+	if (ConfMan.getBool("gui_theme_cache")) {
+		Common::MemoryReadStream xmlStream(tmpXML, xmllen);
+		if (loadThemeCache(Common::computeStreamMD5AsString(xmlStream))) {
+			_parser->close();
+			free(tmpXML);
+
+			return true;
+		}
+	}
+
 	bool result = _parser->parse();
 	_parser->close();
 
@@ -912,6 +993,9 @@ bool ThemeEngine::loadThemeXML(const Common::String &themeId) {
 		return false;
 	}
 
+	if (ConfMan.getBool("gui_theme_cache") && loadThemeCache(ThemeCache::computeArchiveHash(*_themeArchive)))
+		return true;
+
 	//
 	// Loop over all STX files, load and parse them
 	//
@@ -1532,6 +1616,9 @@ bool ThemeEngine::createCursor(const Common::String &filename, int hotspotX, int
 	if (!cursor)
 		return false;
 
+	if (_themeCache)
+		_themeCache->createCursor(filename, hotspotX, hotspotY);
+
 	// Set up the cursor parameters
 	_cursorHotspotX = hotspotX;
 	_cursorHotspotY = hotspotY;
@@ -53,6 +53,7 @@ struct TextDrawData;
 struct TextColorData;
 class Dialog;
 class GuiObject;
+class ThemeCache;
 class ThemeEval;
 class ThemeParser;
 
@@ -204,6 +205,7 @@ protected:
 
 	friend class GUI::Dialog;
 	friend class GUI::GuiObject;
+	friend class GUI::ThemeCache;
 
 public:
 	/// Vertical alignment of the text.
@@ -661,6 +663,16 @@ protected:
 	 */
 	bool loadDefaultXML();
 
+	/**
+	 * Loads the theme from the theme cache, if it is enabled and was saved
+	 * for the same theme files and resolution. Otherwise, starts recording
+	 * the theme as it is parsed, so that loadTheme() can save it.
+	 *
+	 * @param themeHash Hash of the theme files.
+	 * @returns true if the theme was loaded from the cache.
+	 */
+	bool loadThemeCache(const Common::String &themeHash);
+
 	/**
 	 * Unloads the currently loaded theme so another one can
 	 * be loaded.
@@ -735,6 +747,9 @@ protected:
 	/** Theme getEvaluator (changed from GUI::Eval to add functionality) */
 	GUI::ThemeEval *_themeEval;
 
+	/** Records the parsed theme for the theme cache, while a theme is parsed */
+	GUI::ThemeCache *_themeCache;
+
 	/** Main screen surface. This is blitted straight into the overlay. */
 	Graphics::ManagedSurface _screen;
 
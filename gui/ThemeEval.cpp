@@ -21,6 +21,7 @@
  */
 
 #include "gui/ThemeEval.h"
+#include "gui/ThemeCache.h"
 
 #include "graphics/scaler.h"
 
@@ -50,6 +51,13 @@ void ThemeEval::reset() {
 	_layouts.clear();
 }
 
+void ThemeEval::setVar(const Common::String &name, int val) {
+	_vars[name] = val;
+
+	if (_recorder)
+		_recorder->setVar(name, val);
+}
+
 bool ThemeEval::getWidgetData(const Common::String &widget, int16 &x, int16 &y, int16 &w, int16 &h) {
 	bool useRTL;
 
@@ -113,6 +121,9 @@ ThemeEval &ThemeEval::addWidget(const Common::String &name, const Common::String
 
 	_curLayout.top()->addChild(widget);
 
+	if (_recorder)
+		_recorder->addWidget(name, type, w, h, align, useRTL);
+
 	return *this;
 }
 
@@ -136,12 +147,18 @@ ThemeEval &ThemeEval::addDialog(const Common::String &name, const Common::String
 	_curLayout.push(layout);
 	_curDialog = name;
 
+	if (_recorder)
+		_recorder->addDialog(name, overlays, width, height, inset);
+
 	return *this;
 }
 
 ThemeEval &ThemeEval::addLayout(ThemeLayout::LayoutType type, int spacing, ThemeLayout::ItemAlign itemAlign) {
 	ThemeLayout *layout = nullptr;
 
+	if (_recorder)
+		_recorder->addLayout(type, spacing, itemAlign);
+
 	if (spacing == -1)
 		spacing = getVar("Globals.Layout.Spacing");
 
@@ -166,6 +183,28 @@ ThemeEval &ThemeEval::addSpace(int size) {
 	ThemeLayout *space = new ThemeLayoutSpacing(_curLayout.top(), size);
 	_curLayout.top()->addChild(space);
 
+	if (_recorder)
+		_recorder->addSpace(size);
+
+	return *this;
+}
+
+ThemeEval &ThemeEval::closeLayout() {
+	_curLayout.pop();
+
+	if (_recorder)
+		_recorder->closeLayout();
+
+	return *this;
+}
+
+ThemeEval &ThemeEval::closeDialog() {
+	_curLayout.pop();
+	_curDialog.clear();
+
+	if (_recorder)
+		_recorder->closeDialog();
+
 	return *this;
 }
 
@@ -174,6 +213,9 @@ ThemeEval &ThemeEval::addSpace(int size) {
 ThemeEval &ThemeEval::addPadding(int16 l, int16 r, int16 t, int16 b) {
 	_curLayout.top()->setPadding(SCALEVALUE(l), SCALEVALUE(r), SCALEVALUE(t), SCALEVALUE(b));
 
+	if (_recorder)
+		_recorder->addPadding(l, r, t, b);
+
 	return *this;
 }
 
@@ -202,6 +244,9 @@ ThemeEval &ThemeEval::addImportedLayout(const Common::String &name) {
 
 	_curLayout.top()->importLayout(importedLayout);
 
+	if (_recorder)
+		_recorder->addImportedLayout(name);
+
 	return *this;
 }
 
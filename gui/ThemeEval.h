@@ -35,13 +35,15 @@
 
 namespace GUI {
 
+class ThemeCache;
+
 class ThemeEval {
 
 	typedef Common::HashMap<Common::String, int> VariablesMap;
 	typedef Common::HashMap<Common::String, ThemeLayout *> LayoutsMap;
 
 public:
-	ThemeEval() : _scaleFactor(1.0f) {
+	ThemeEval() : _scaleFactor(1.0f), _recorder(nullptr) {
 		buildBuiltinVars();
 	}
 
@@ -72,7 +74,10 @@ public:
 
 	void setScaleFactor(float s) { _scaleFactor = s; }
 
-	void setVar(const Common::String &name, int val) { _vars[name] = val; }
+	/** Record the layouts into @p recorder while a theme is parsed, or stop recording if it is null */
+	void setRecorder(ThemeCache *recorder) { _recorder = recorder; }
+
+	void setVar(const Common::String &name, int val);
 
 	bool hasVar(const Common::String &name) { return _vars.contains(name) || _builtin.contains(name); }
 
@@ -84,8 +89,8 @@ public:
 
 	ThemeEval &addPadding(int16 l, int16 r, int16 t, int16 b);
 
-	ThemeEval &closeLayout() { _curLayout.pop(); return *this; }
-	ThemeEval &closeDialog() { _curLayout.pop(); _curDialog.clear(); return *this; }
+	ThemeEval &closeLayout();
+	ThemeEval &closeDialog();
 
 	bool hasDialog(const Common::String &name);
 
@@ -112,6 +117,8 @@ private:
 	Common::String _curDialog;
 
 	float _scaleFactor;
+
+	ThemeCache *_recorder;
 };
 
 } // End of namespace GUI
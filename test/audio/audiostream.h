@@ -205,4 +205,73 @@ public:
 	void test_sub_looping_audio_stream_stereo_22050_end_fixed_iter() {
 		testSubLoopingAudioStreamFixedIter(22050, true, 2, 2);
 	}
+
+private:
+	void testQueuingAudioStream(Audio::QueuingAudioStream *queue) {
+		const int sampleRate = 11025;
+		const int numStreams = 40;
+
+		int16 *buffer = new int16[sampleRate];
+
+		TS_ASSERT_EQUALS(queue->numQueuedStreams(), (uint32)0);
+		TS_ASSERT_EQUALS(queue->endOfData(), true);
+		TS_ASSERT_EQUALS(queue->endOfStream(), false);
+
+		// Queue more streams than the initial capacity of the lock-free variant
+		int16 *sines[numStreams];
+		for (int i = 0; i < numStreams; ++i)
+			queue->queueAudioStream(createSineStream<int16>(sampleRate, 1, &sines[i], false, false));
+
+		TS_ASSERT_EQUALS(queue->numQueuedStreams(), (uint32)numStreams);
+		TS_ASSERT_EQUALS(queue->getQueuedDuration().msecs(), numStreams * 1000);
+		TS_ASSERT_EQUALS(queue->endOfData(), false);
+
+		// Read half a stream, then the remainder straddling two streams
+		const int half = sampleRate / 2;
+		TS_ASSERT_EQUALS(queue->readBuffer(buffer, half), half);
+		TS_ASSERT_EQUALS(memcmp(buffer, sines[0], half * sizeof(int16)), 0);
+		TS_ASSERT_EQUALS(queue->readBuffer(buffer, sampleRate), sampleRate);
+		TS_ASSERT_EQUALS(memcmp(buffer, sines[0] + half, (sampleRate - half) * sizeof(int16)), 0);
+		TS_ASSERT_EQUALS(memcmp(buffer + sampleRate - half, sines[1], half * sizeof(int16)), 0);
+		TS_ASSERT_EQUALS(queue->numQueuedStreams(), (uint32)(numStreams - 1));
+		TS_ASSERT_EQUALS(queue->getQueuedDuration().totalNumberOfFrames(), (numStreams - 1) * sampleRate - half);
+
+		for (int i = 1; i < numStreams - 1; ++i)
+			TS_ASSERT_EQUALS(queue->readBuffer(buffer, sampleRate), sampleRate);
+		TS_ASSERT_EQUALS(queue->getUnderrunCount(), (uint32)0);
+
+		// Running dry before finish() is an underrun
+		TS_ASSERT_EQUALS(queue->readBuffer(buffer, sampleRate), sampleRate - half);
+		TS_ASSERT_EQUALS(memcmp(buffer, sines[numStreams - 1] + half, (sampleRate - half) * sizeof(int16)), 0);
+		TS_ASSERT_EQUALS(queue->getUnderrunCount(), (uint32)1);
+		TS_ASSERT_EQUALS(queue->numQueuedStreams(), (uint32)0);
+		TS_ASSERT_EQUALS(queue->getQueuedDuration().totalNumberOfFrames(), 0);
+		TS_ASSERT_EQUALS(queue->endOfData(), true);
+
+		// Queuing again clears the end of data condition
+		int16 *last;
+		queue->queueAudioStream(createSineStream<int16>(sampleRate, 1, &last, false, false));
+		TS_ASSERT_EQUALS(queue->endOfData(), false);
+		queue->finish();
+		TS_ASSERT_EQUALS(queue->endOfStream(), false);
+		TS_ASSERT_EQUALS(queue->readBuffer(buffer, sampleRate * 2), sampleRate);
+		TS_ASSERT_EQUALS(memcmp(buffer, last, sampleRate * sizeof(int16)), 0);
+		TS_ASSERT_EQUALS(queue->getUnderrunCount(), (uint32)1);
+		TS_ASSERT_EQUALS(queue->endOfStream(), true);
+
+		for (int i = 0; i < numStreams; ++i)
+			delete[] sines[i];
+		delete[] last;
+		delete[] buffer;
+		delete queue;
+	}
+
+public:
+	void test_queuing_audio_stream() {
+		testQueuingAudioStream(Audio::makeQueuingAudioStream(11025, false));
+	}
+
+	void test_lock_free_queuing_audio_stream() {
+		testQueuingAudioStream(Audio::makeLockFreeQueuingAudioStream(11025, false, 4));
+	}
 };
@@ -0,0 +1,215 @@
+#include <cxxtest/TestSuite.h>
+
+#include "backends/graphics/opengl/texture.h"
+
+#include "common/array.h"
+
+namespace {
+
+/**
+ * Just enough of OpenGL to upload to a single texture, so that its contents
+ * can be compared with the surface uploaded to it.
+ */
+namespace FakeGL {
+
+enum {
+	kWidth = 320,
+	kHeight = 200
+};
+
+uint32 texture[kWidth * kHeight];
+GLint rowLength;
+GLuint boundBuffer;
+Common::Array<byte> buffers[3];
+bool mapped;
+uint32 uploadedBytes;
+uint uploads;
+
+void GL_CALL_CONV pixelStorei(GLenum pname, GLint param) {
+	if (pname == GL_UNPACK_ROW_LENGTH)
+		rowLength = param;
+}
+
+void GL_CALL_CONV deleteTextures(GLsizei n, const GLuint *textures) {}
+
+void GL_CALL_CONV genTextures(GLsizei n, GLuint *textures) {
+	for (GLsizei i = 0; i < n; i++)
+		textures[i] = 1;
+}
+
+void GL_CALL_CONV bindTexture(GLenum target, GLuint name) {}
+void GL_CALL_CONV texParameteri(GLenum target, GLenum pname, GLint param) {}
+void GL_CALL_CONV texImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const GLvoid *pixels) {}
+
+void GL_CALL_CONV texSubImage2D(GLenum target, GLint level, GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, const GLvoid *pixels) {
+	// With a pixel buffer bound, the pointer is an offset into it
+	const byte *src = boundBuffer ? &buffers[boundBuffer][0] + (uintptr)pixels : (const byte *)pixels;
+	const uint pitch = (rowLength ? rowLength : width) * 4;
+
+	for (GLsizei row = 0; row < height; row++)
+		memcpy(&texture[(y + row) * kWidth + x], src + row * pitch, width * 4);
+
+	uploadedBytes += width * height * 4;
+	uploads++;
+}
+
+GLenum GL_CALL_CONV getError() { return GL_NO_ERROR; }
+
+void GL_CALL_CONV genBuffers(GLsizei n, GLuint *names) {
+	for (GLsizei i = 0; i < n; i++)
+		names[i] = i + 1;
+}
+
+void GL_CALL_CONV deleteBuffers(GLsizei n, const GLuint *names) {}
+
+void GL_CALL_CONV bindBuffer(GLenum target, GLuint name) {
+	boundBuffer = name;
+}
+
+void GL_CALL_CONV bufferData(GLenum target, GLsizeiptr size, const GLvoid *data, GLenum usage) {
+	buffers[boundBuffer].resize(size);
+}
+
+GLvoid *GL_CALL_CONV mapBuffer(GLenum target, GLenum access) {
+	mapped = true;
+	return &buffers[boundBuffer][0];
+}
+
+GLboolean GL_CALL_CONV unmapBuffer(GLenum target) {
+	mapped = false;
+	return GL_TRUE;
+}
+
+void install(bool unpackSubimage, bool pixelBuffers) {
+	OpenGL::g_context.reset();
+	OpenGL::g_context.NPOTSupported = true;
+	OpenGL::g_context.textureEdgeClampSupported = true;
+	OpenGL::g_context.unpackSubimageSupported = unpackSubimage;
+	OpenGL::g_context.pixelBufferObjectSupported = pixelBuffers;
+
+	OpenGL::g_context.glPixelStorei = pixelStorei;
+	OpenGL::g_context.glDeleteTextures = deleteTextures;
+	OpenGL::g_context.glGenTextures = genTextures;
+	OpenGL::g_context.glBindTexture = bindTexture;
+	OpenGL::g_context.glTexParameteri = texParameteri;
+	OpenGL::g_context.glTexImage2D = texImage2D;
+	OpenGL::g_context.glTexSubImage2D = texSubImage2D;
+	OpenGL::g_context.glGetError = getError;
+#if !USE_FORCED_GLES
+	OpenGL::g_context.glGenBuffers = genBuffers;
+	OpenGL::g_context.glDeleteBuffers = deleteBuffers;
+	OpenGL::g_context.glBindBuffer = bindBuffer;
+	OpenGL::g_context.glBufferData = bufferData;
+	OpenGL::g_context.glMapBuffer = mapBuffer;
+	OpenGL::g_context.glUnmapBuffer = unmapBuffer;
+#endif
+
+	memset(texture, 0, sizeof(texture));
+	rowLength = 0;
+	boundBuffer = 0;
+	mapped = false;
+	uploadedBytes = 0;
+	uploads = 0;
+}
+
+} // End of namespace FakeGL
+
+} // End of anonymous namespace
+
+class OpenGLTextureTestSuite : public CxxTest::TestSuite {
+public:
+	void test_upload_rows() {
+		// Without GL_UNPACK_ROW_LENGTH, whole rows are uploaded
+		FakeGL::install(false, false);
+		checkUploads();
+
+		OpenGL::Texture texture(GL_RGBA, GL_RGBA, GL_UNSIGNED_BYTE, format());
+		texture.allocate(FakeGL::kWidth, FakeGL::kHeight);
+		texture.updateGLTexture();
+		texture.resetUploadedBytes();
+
+		const uint32 pixels[10 * 4] = {};
+		texture.copyRectToTexture(20, 30, 10, 4, pixels, 10 * 4);
+		texture.copyRectToTexture(200, 32, 10, 4, pixels, 10 * 4);
+		texture.updateGLTexture();
+		TS_ASSERT_EQUALS(texture.getUploadedBytes(), 6u * FakeGL::kWidth * 4);
+	}
+
+	void test_upload_areas() {
+		// With GL_UNPACK_ROW_LENGTH, only the areas are uploaded
+		FakeGL::install(true, false);
+		checkUploads();
+
+		OpenGL::Texture texture(GL_RGBA, GL_RGBA, GL_UNSIGNED_BYTE, format());
+		texture.allocate(FakeGL::kWidth, FakeGL::kHeight);
+		texture.updateGLTexture();
+		texture.resetUploadedBytes();
+
+		const uint32 pixels[10 * 4] = {};
+		texture.copyRectToTexture(20, 30, 10, 4, pixels, 10 * 4);
+		texture.updateGLTexture();
+		TS_ASSERT_EQUALS(texture.getUploadedBytes(), 10u * 4 * 4);
+		TS_ASSERT_EQUALS(FakeGL::rowLength, 0);
+	}
+
+	void test_upload_through_pixel_buffer() {
+#if !USE_FORCED_GLES
+		// The areas are packed into a pixel buffer, and uploaded from there
+		FakeGL::install(true, true);
+		checkUploads();
+		TS_ASSERT_EQUALS(FakeGL::boundBuffer, 0u);
+		TS_ASSERT(!FakeGL::mapped);
+		TS_ASSERT(!FakeGL::buffers[1].empty() && !FakeGL::buffers[2].empty());
+#endif
+	}
+
+private:
+	static uint32 nextRandom(uint32 &seed) {
+		seed = seed * 1103515245 + 12345;
+		return seed >> 16;
+	}
+
+	static Graphics::PixelFormat format() {
+		return Graphics::PixelFormat(4, 8, 8, 8, 8, 0, 8, 16, 24);
+	}
+
+	/**
+	 * Upload frames of random areas, and check that the texture matches the
+	 * surface, and that the uploaded bytes are counted for each frame.
+	 */
+	void checkUploads() {
+		OpenGL::Texture texture(GL_RGBA, GL_RGBA, GL_UNSIGNED_BYTE, format());
+		texture.allocate(FakeGL::kWidth, FakeGL::kHeight);
+
+		uint32 seed = 1;
+		uint32 pixels[60 * 60];
+
+		for (int frame = 0; frame < 50; frame++) {
+			const uint count = frame ? nextRandom(seed) % 20 : 0;
+			for (uint i = 0; i < count; i++) {
+				const uint w = 1 + nextRandom(seed) % 60;
+				const uint h = 1 + nextRandom(seed) % 60;
+				const uint x = nextRandom(seed) % (FakeGL::kWidth - w);
+				const uint y = nextRandom(seed) % (FakeGL::kHeight - h);
+				for (uint p = 0; p < w * h; p++)
+					pixels[p] = nextRandom(seed) ^ (nextRandom(seed) << 16);
+				texture.copyRectToTexture(x, y, w, h, pixels, w * 4);
+			}
+
+			FakeGL::uploadedBytes = 0;
+			texture.resetUploadedBytes();
+			texture.updateGLTexture();
+			TS_ASSERT_EQUALS(texture.getUploadedBytes(), FakeGL::uploadedBytes);
+
+			const Graphics::Surface *surface = texture.getSurface();
+			for (int y = 0; y < FakeGL::kHeight; y++) {
+				if (memcmp(&FakeGL::texture[y * FakeGL::kWidth], surface->getBasePtr(0, y), FakeGL::kWidth * 4)) {
+					TS_FAIL(Common::String::format("Row %d of frame %d differs", y, frame).c_str());
+					return;
+				}
+			}
+		}
+
+		TS_ASSERT(FakeGL::uploads > 50u);
+	}
+};
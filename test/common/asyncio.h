@@ -0,0 +1,122 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/archive.h"
+#include "common/asyncio.h"
+#include "common/memstream.h"
+#include "common/ptr.h"
+#include "common/substream.h"
+#include "common/system.h"
+#include "../null_osystem.h"
+
+class AsyncIOTestSuite : public CxxTest::TestSuite {
+public:
+	void test_memory_stream_reads() {
+		if (!installSystem())
+			return;
+
+		byte data[1000];
+		for (uint i = 0; i < sizeof(data); i++)
+			data[i] = i * 13;
+
+		Common::MemoryReadStream stream(data, sizeof(data));
+		stream.seek(123);
+
+		Common::ScopedPtr<Common::AsyncReadRequest> request(stream.readAsync(400, 300));
+		TS_ASSERT(request);
+		TS_ASSERT_EQUALS(stream.pos(), 123);
+		TS_ASSERT_EQUALS(request->getDataSize(), 300u);
+		TS_ASSERT(!request->err());
+		TS_ASSERT(request->isDone());
+		TS_ASSERT_EQUALS(memcmp(request->getData(), data + 400, 300), 0);
+
+		// Past the end
+		request.reset(stream.readAsync(900, 300));
+		TS_ASSERT_EQUALS(request->getDataSize(), 100u);
+		TS_ASSERT(request->err());
+		TS_ASSERT_EQUALS(memcmp(request->getData(), data + 900, 100), 0);
+
+		// The data outlives the request once handed over
+		Common::SeekableReadStream *result = request->createReadStream();
+		TS_ASSERT(!request->getData());
+		request.reset();
+		TS_ASSERT_EQUALS(result->size(), 100);
+		TS_ASSERT_EQUALS(result->readByte(), data[900]);
+		delete result;
+	}
+
+	void test_substream_reads() {
+		if (!installSystem())
+			return;
+
+		byte data[1000];
+		for (uint i = 0; i < sizeof(data); i++)
+			data[i] = i * 17;
+
+		Common::MemoryReadStream stream(data, sizeof(data));
+		Common::SeekableSubReadStream subStream(&stream, 200, 500);
+
+		// Shortened to the end of the substream
+		Common::ScopedPtr<Common::AsyncReadRequest> request(subStream.readAsync(100, 1000));
+		TS_ASSERT(request);
+		TS_ASSERT_EQUALS(request->getDataSize(), 200u);
+		TS_ASSERT_EQUALS(memcmp(request->getData(), data + 300, 200), 0);
+	}
+
+	void test_archive_members() {
+		if (!installSystem())
+			return;
+
+		byte data[1000];
+		for (uint i = 0; i < sizeof(data); i++)
+			data[i] = i * 7;
+
+		MemoryArchive archive(data, sizeof(data));
+		Common::SearchSet searchSet;
+		searchSet.add("memory", &archive, 0, false);
+
+		Common::ScopedPtr<Common::AsyncReadRequest> request(searchSet.readMemberAsync("member.bin"));
+		TS_ASSERT(request);
+		TS_ASSERT_EQUALS(request->getDataSize(), sizeof(data));
+		TS_ASSERT_EQUALS(memcmp(request->getData(), data, sizeof(data)), 0);
+
+		TS_ASSERT(!searchSet.readMemberAsync("missing.bin"));
+	}
+
+private:
+	// Requests need mutexes
+	bool installSystem() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		if (!g_system)
+			Common::install_null_g_system();
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	class MemoryArchive : public Common::Archive {
+	public:
+		MemoryArchive(const byte *data, uint32 size) : _data(data), _size(size) {}
+
+		virtual bool hasFile(const Common::String &name) const {
+			return name.equalsIgnoreCase("member.bin");
+		}
+
+		virtual int listMembers(Common::ArchiveMemberList &list) const {
+			list.push_back(getMember("member.bin"));
+			return 1;
+		}
+
+		virtual const Common::ArchiveMemberPtr getMember(const Common::String &name) const {
+			return Common::ArchiveMemberPtr(new Common::GenericArchiveMember(name, this));
+		}
+
+		virtual Common::SeekableReadStream *createReadStreamForMember(const Common::String &name) const {
+			return hasFile(name) ? new Common::MemoryReadStream(_data, _size) : nullptr;
+		}
+
+	private:
+		const byte *_data;
+		uint32 _size;
+	};
+};
@@ -0,0 +1,315 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/flat-hashmap.h"
+#include "common/hash-str.h"
+
+class FlatHashMapTestSuite : public CxxTest::TestSuite
+{
+	public:
+	void test_empty_clear() {
+		Common::FlatHashMap<int, int> container;
+		TS_ASSERT(container.empty());
+		container[0] = 17;
+		container[1] = 33;
+		TS_ASSERT(!container.empty());
+		container.clear();
+		TS_ASSERT(container.empty());
+
+		Common::FlatHashMap<Common::String, Common::String, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> container2;
+		TS_ASSERT(container2.empty());
+		container2["foo"] = "bar";
+		container2["quux"] = "blub";
+		TS_ASSERT(!container2.empty());
+		container2.clear();
+		TS_ASSERT(container2.empty());
+	}
+
+	void test_contains() {
+		Common::FlatHashMap<int, int> container;
+		container[0] = 17;
+		container[1] = 33;
+		TS_ASSERT(container.contains(0));
+		TS_ASSERT(container.contains(1));
+		TS_ASSERT(!container.contains(17));
+		TS_ASSERT(!container.contains(-1));
+
+		Common::FlatHashMap<Common::String, Common::String, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> container2;
+		container2["foo"] = "bar";
+		container2["quux"] = "blub";
+		TS_ASSERT(container2.contains("foo"));
+		TS_ASSERT(container2.contains("quux"));
+		TS_ASSERT(!container2.contains("bar"));
+		TS_ASSERT(!container2.contains("asdf"));
+	}
+
+	void test_add_remove() {
+		Common::FlatHashMap<int, int> container;
+		container[0] = 17;
+		container[1] = 33;
+		container[2] = 45;
+		container[3] = 12;
+		container[4] = 96;
+		TS_ASSERT(container.contains(1));
+		container.erase(1);
+		TS_ASSERT(!container.contains(1));
+		container[1] = 42;
+		TS_ASSERT(container.contains(1));
+		container.erase(0);
+		TS_ASSERT(!container.empty());
+		container.erase(1);
+		TS_ASSERT(!container.empty());
+		container.erase(2);
+		TS_ASSERT(!container.empty());
+		container.erase(3);
+		TS_ASSERT(!container.empty());
+		container.erase(4);
+		TS_ASSERT(container.empty());
+		container[1] = 33;
+		TS_ASSERT(container.contains(1));
+		TS_ASSERT(!container.empty());
+		container.erase(1);
+		TS_ASSERT(container.empty());
+	}
+
+	void test_add_remove_iterator() {
+		Common::FlatHashMap<int, int> container;
+		container[0] = 17;
+		container[1] = 33;
+		container[2] = 45;
+		container[3] = 12;
+		container[4] = 96;
+		TS_ASSERT(container.contains(1));
+		container.erase(container.find(1));
+		TS_ASSERT(!container.contains(1));
+		container[1] = 42;
+		TS_ASSERT(container.contains(1));
+		container.erase(container.find(0));
+		TS_ASSERT(!container.empty());
+		container.erase(container.find(1));
+		TS_ASSERT(!container.empty());
+		container.erase(container.find(2));
+		TS_ASSERT(!container.empty());
+		container.erase(container.find(3));
+		TS_ASSERT(!container.empty());
+		container.erase(container.find(4));
+		TS_ASSERT(container.empty());
+		container[1] = 33;
+		TS_ASSERT(container.contains(1));
+		TS_ASSERT(!container.empty());
+		container.erase(container.find(1));
+		TS_ASSERT(container.empty());
+	}
+
+	void test_lookup() {
+		Common::FlatHashMap<int, int> container;
+		container[0] = 17;
+		container[1] = -1;
+		container[2] = 45;
+		container[3] = 12;
+		container[4] = 96;
+
+		TS_ASSERT_EQUALS(container[0], 17);
+		TS_ASSERT_EQUALS(container[1], -1);
+		TS_ASSERT_EQUALS(container[2], 45);
+		TS_ASSERT_EQUALS(container[3], 12);
+		TS_ASSERT_EQUALS(container[4], 96);
+	}
+
+	void test_lookup_with_default() {
+		Common::FlatHashMap<int, int> container;
+		container[0] = 17;
+		container[1] = -1;
+		container[2] = 45;
+		container[3] = 12;
+		container[4] = 96;
+
+		// We take a const ref now to ensure that the map
+		// is not modified by getValOrDefault.
+		const Common::FlatHashMap<int, int> &containerRef = container;
+
+		TS_ASSERT_EQUALS(containerRef.getValOrDefault(0), 17);
+		TS_ASSERT_EQUALS(containerRef.getValOrDefault(17), 0);
+		TS_ASSERT_EQUALS(containerRef.getValOrDefault(0, -10), 17);
+		TS_ASSERT_EQUALS(containerRef.getValOrDefault(17, -10), -10);
+	}
+
+	void test_iterator_begin_end() {
+		Common::FlatHashMap<int, int> container;
+
+		// The container is initially empty ...
+		TS_ASSERT_EQUALS(container.begin(), container.end());
+
+		// ... then non-empty ...
+		container[324] = 33;
+		TS_ASSERT_DIFFERS(container.begin(), container.end());
+
+		// ... and again empty.
+		container.clear();
+		TS_ASSERT_EQUALS(container.begin(), container.end());
+	}
+
+	void test_hash_map_copy() {
+		Common::FlatHashMap<int, int> map1, container2;
+		map1[323] = 32;
+		container2 = map1;
+		TS_ASSERT_EQUALS(container2[323], 32);
+	}
+
+	void test_collision() {
+		// NB: The usefulness of this example depends strongly on the
+		// specific hashmap implementation.
+		// It is constructed to insert multiple colliding elements.
+		Common::FlatHashMap<int, int> h;
+		h[5] = 1;
+		h[32+5] = 1;
+		h[64+5] = 1;
+		h[128+5] = 1;
+		TS_ASSERT(h.contains(5));
+		TS_ASSERT(h.contains(32+5));
+		TS_ASSERT(h.contains(64+5));
+		TS_ASSERT(h.contains(128+5));
+		h.erase(32+5);
+		TS_ASSERT(h.contains(5));
+		TS_ASSERT(h.contains(64+5));
+		TS_ASSERT(h.contains(128+5));
+		h.erase(5);
+		TS_ASSERT(h.contains(64+5));
+		TS_ASSERT(h.contains(128+5));
+		h[32+5] = 1;
+		TS_ASSERT(h.contains(32+5));
+		TS_ASSERT(h.contains(64+5));
+		TS_ASSERT(h.contains(128+5));
+		h[5] = 1;
+		TS_ASSERT(h.contains(5));
+		TS_ASSERT(h.contains(32+5));
+		TS_ASSERT(h.contains(64+5));
+		TS_ASSERT(h.contains(128+5));
+		h.erase(5);
+		TS_ASSERT(h.contains(32+5));
+		TS_ASSERT(h.contains(64+5));
+		TS_ASSERT(h.contains(128+5));
+		h.erase(64+5);
+		TS_ASSERT(h.contains(32+5));
+		TS_ASSERT(h.contains(128+5));
+		h.erase(128+5);
+		TS_ASSERT(h.contains(32+5));
+		h.erase(32+5);
+		TS_ASSERT(h.empty());
+	}
+
+	void test_iterator() {
+		Common::FlatHashMap<int, int> container;
+		container[0] = 17;
+		container[1] = 33;
+		container[2] = 45;
+		container[3] = 12;
+		container[4] = 96;
+		container.erase(1);
+		container[1] = 42;
+		container.erase(0);
+		container.erase(1);
+
+		int found = 0;
+		Common::FlatHashMap<int, int>::iterator i;
+		for (i = container.begin(); i != container.end(); ++i) {
+			int key = i->_key;
+			TS_ASSERT(key >= 0 && key <= 4);
+			TS_ASSERT(!(found & (1 << key)));
+			found |= 1 << key;
+		}
+		TS_ASSERT(found == 16+8+4);
+
+		found = 0;
+		Common::FlatHashMap<int, int>::const_iterator j;
+		for (j = container.begin(); j != container.end(); ++j) {
+			int key = j->_key;
+			TS_ASSERT(key >= 0 && key <= 4);
+			TS_ASSERT(!(found & (1 << key)));
+			found |= 1 << key;
+		}
+		TS_ASSERT(found == 16+8+4);
+}
+
+	void test_erase_while_iterating() {
+		Common::FlatHashMap<int, int> container;
+		for (int i = 0; i < 1000; i++)
+			container[i] = i * 3;
+
+		for (Common::FlatHashMap<int, int>::iterator i = container.begin(); i != container.end(); ++i) {
+			if (i->_key % 3)
+				container.erase(i);
+		}
+
+		TS_ASSERT_EQUALS(container.size(), 334u);
+		for (int i = 0; i < 1000; i++) {
+			TS_ASSERT_EQUALS(container.contains(i), i % 3 == 0);
+			if (i % 3 == 0)
+				TS_ASSERT_EQUALS(container[i], i * 3);
+		}
+	}
+
+	void test_matches_hash_map() {
+		// Random inserts and erases, with many erased entries to clean up,
+		// and keys which collide in their low bits
+		Common::FlatHashMap<uint32, uint32> flat;
+		Common::HashMap<uint32, uint32> reference;
+		uint32 seed = 1;
+		for (int i = 0; i < 200000; i++) {
+			seed = seed * 1103515245 + 12345;
+			const uint32 key = ((seed >> 8) % 3000) << ((i / 50000) * 4);
+			if ((seed >> 4) % 3 == 0) {
+				flat.erase(key);
+				reference.erase(key);
+			} else {
+				flat[key] = i;
+				reference[key] = i;
+			}
+		}
+
+		TS_ASSERT_EQUALS(flat.size(), reference.size());
+		for (Common::HashMap<uint32, uint32>::const_iterator i = reference.begin(); i != reference.end(); ++i)
+			TS_ASSERT_EQUALS(flat.getValOrDefault(i->_key, (uint32)-1), i->_value);
+
+		uint count = 0;
+		const Common::FlatHashMap<uint32, uint32> copy(flat);
+		for (Common::FlatHashMap<uint32, uint32>::const_iterator i = copy.begin(); i != copy.end(); ++i, count++)
+			TS_ASSERT(reference.contains(i->_key));
+		TS_ASSERT_EQUALS(count, reference.size());
+
+		flat.clear(true);
+		TS_ASSERT(flat.empty());
+		TS_ASSERT_EQUALS(flat.begin(), flat.end());
+		TS_ASSERT(!flat.contains(0));
+	}
+
+	void test_keys_differing_in_high_bits() {
+		// Keys whose hashes only differ in their high bits must not all
+		// start probing from the same groups
+		Common::FlatHashMap<uint32, uint32> h;
+		for (uint32 i = 0; i < 30000; i++)
+			h[i << 16] = i;
+
+		TS_ASSERT_EQUALS(h.size(), 30000u);
+		for (uint32 i = 0; i < 30000; i++) {
+			TS_ASSERT_EQUALS(h.getValOrDefault(i << 16, (uint32)-1), i);
+			TS_ASSERT(!h.contains((i << 16) | 0x8000));
+		}
+
+		for (uint32 i = 0; i < 30000; i += 2)
+			h.erase(i << 16);
+		TS_ASSERT_EQUALS(h.size(), 15000u);
+		TS_ASSERT(!h.contains(0));
+		TS_ASSERT(h.contains(1 << 16));
+	}
+
+	void test_values_outlive_rehashing() {
+		Common::FlatHashMap<Common::String, Common::String> container;
+		for (int i = 0; i < 500; i++)
+			container[Common::String::format("key%d", i)] = Common::String::format("value%d", i);
+
+		for (int i = 0; i < 500; i++)
+			TS_ASSERT_EQUALS(container[Common::String::format("key%d", i)], Common::String::format("value%d", i));
+	}
+
+	// TODO: Add test cases for iterators, find, ...
+};
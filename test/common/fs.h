@@ -0,0 +1,161 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/algorithm.h"
+#include "common/fs.h"
+#include "common/intern-str.h"
+#include "common/memstream.h"
+#include "common/str-array.h"
+#include "common/system.h"
+#include "../null_osystem.h"
+
+class FSTestSuite : public CxxTest::TestSuite {
+public:
+	void test_directory_listing_cache() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		if (!g_system)
+			Common::install_null_g_system();
+
+		// The directory the tests are built in
+		Common::FSNode node("test");
+		if (!node.isDirectory())
+			return;
+
+		Common::FSDirectory plain(node, 2);
+		const Common::StringArray expected = listMembers(plain);
+		TS_ASSERT(!expected.empty());
+
+		Common::MemoryWriteStreamDynamic saved(DisposeAfterUse::YES);
+		Common::FSDirectory first(node, 2);
+		TS_ASSERT(!first.loadListingCache(nullptr));
+		TS_ASSERT(first.listingCacheChanged());
+		TS_ASSERT(first.saveListingCache(&saved));
+		TS_ASSERT_EQUALS(listMembers(first), expected);
+
+		Common::MemoryReadStream savedData(saved.getData(), saved.size());
+		Common::FSDirectory second(node, 2);
+		TS_ASSERT(second.loadListingCache(&savedData));
+		TS_ASSERT_EQUALS(listMembers(second), expected);
+
+		// Listings of another directory, and truncated ones, are ignored
+		savedData.seek(0);
+		Common::FSDirectory other(node.getChild("engine-data"), 2);
+		TS_ASSERT(!other.loadListingCache(&savedData));
+
+		Common::MemoryReadStream truncated(saved.getData(), saved.size() - 1);
+		Common::FSDirectory third(node, 2);
+		TS_ASSERT(!third.loadListingCache(&truncated));
+		TS_ASSERT_EQUALS(listMembers(third), expected);
+
+		// A listing which does not match the modification time of the
+		// directory is not used
+		Common::MemoryWriteStreamDynamic stale(DisposeAfterUse::YES);
+		stale.writeUint32BE(MKTAG('F', 'S', 'D', 'C'));
+		stale.writeUint32LE(1);
+		stale.writeString(node.getPath());
+		stale.writeByte(0);
+		stale.writeSint32LE(2);
+		stale.writeUint32LE(1);
+		stale.writeString(node.getPath());
+		stale.writeByte(0);
+		stale.writeSint64LE(1);
+		stale.writeUint32LE(1);
+		stale.writeByte(0);
+		stale.writeString("stale.bin");
+		stale.writeByte(0);
+
+		Common::MemoryReadStream staleData(stale.getData(), stale.size());
+		Common::FSDirectory fourth(node, 2);
+		TS_ASSERT(fourth.loadListingCache(&staleData));
+		TS_ASSERT(!fourth.hasFile("stale.bin"));
+		TS_ASSERT(fourth.listingCacheChanged());
+		TS_ASSERT_EQUALS(listMembers(fourth), expected);
+#endif
+	}
+
+	void test_directory_without_interned_names() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		if (!g_system)
+			Common::install_null_g_system();
+
+		Common::FSNode node("test");
+		if (!node.isDirectory())
+			return;
+
+		// With the table of interned strings full, the names are kept as
+		// strings instead. The prefixes make sure they are new.
+		Common::FSDirectory plain("fs-test-plain", node, 2);
+		const Common::StringArray expected = listMembers(plain);
+
+		const uint32 maxSize = Common::InternedString::getMaxSize();
+		Common::InternedString::setMaxSize(Common::InternedString::getSize());
+		Common::FSDirectory full("fs-test-full", node, 2);
+		TS_ASSERT_EQUALS(listMembers(full), expected);
+		Common::InternedString::setMaxSize(maxSize);
+
+		Common::InternedString interned;
+		TS_ASSERT(!Common::InternedString::find("fs-test-full/runner.cpp", interned));
+
+		TS_ASSERT(full.hasFile("FS-TEST-FULL/Runner.CPP"));
+		TS_ASSERT(!full.hasFile("fs-test-full/missing.cpp"));
+
+		Common::ArchiveMemberList matches;
+		TS_ASSERT_EQUALS(full.listMatchingMembers(matches, "FS-TEST-FULL/RUNNER.*"), 1);
+
+		Common::FSDirectory *engineData = full.getSubDirectory("fs-test-full/Engine-Data");
+		TS_ASSERT(engineData);
+		if (engineData)
+			TS_ASSERT(engineData->hasFile("encoding.dat"));
+		delete engineData;
+#endif
+	}
+
+	void test_game_data_streams() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		if (!g_system)
+			Common::install_null_g_system();
+
+		// The test runner is large enough to be mapped into memory
+		Common::FSNode node("test");
+		Common::FSNode runner = node.getChild("runner");
+		if (!runner.exists())
+			return;
+
+		// Files which may be changed while they are read, like savegames,
+		// are never mapped
+		Common::SeekableReadStream *file = runner.createReadStream();
+		TS_ASSERT(file);
+		if (!file)
+			return;
+		TS_ASSERT(!file->mapRange(0, 16));
+
+		// Game data may be, and reads the same either way
+		Common::FSDirectory dir(node);
+		Common::SeekableReadStream *gameData = dir.createReadStreamForMember("RUNNER");
+		TS_ASSERT(gameData);
+		if (gameData) {
+			TS_ASSERT_EQUALS(gameData->size(), file->size());
+
+			byte expected[4096], actual[4096];
+			file->seek(file->size() / 2);
+			gameData->seek(file->pos());
+			TS_ASSERT_EQUALS(file->read(expected, sizeof(expected)), gameData->read(actual, sizeof(actual)));
+			TS_ASSERT_EQUALS(memcmp(expected, actual, sizeof(actual)), 0);
+			delete gameData;
+		}
+
+		delete file;
+#endif
+	}
+
+private:
+	Common::StringArray listMembers(const Common::FSDirectory &dir) {
+		Common::ArchiveMemberList members;
+		dir.listMembers(members);
+
+		Common::StringArray names;
+		for (Common::ArchiveMemberList::const_iterator it = members.begin(); it != members.end(); ++it)
+			names.push_back((*it)->getName());
+		Common::sort(names.begin(), names.end());
+		return names;
+	}
+};
@@ -0,0 +1,134 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/hash-str.h"
+#include "common/hashmap.h"
+#include "common/intern-str.h"
+
+class InternedStringTestSuite : public CxxTest::TestSuite {
+public:
+	void test_equality() {
+		Common::String name("intern-test-Equality");
+		Common::InternedString a(name);
+		Common::InternedString b("intern-test-Equality");
+		Common::InternedString c("intern-test-equality");
+
+		TS_ASSERT_EQUALS(strcmp(a.c_str(), "intern-test-Equality"), 0);
+		TS_ASSERT_EQUALS(a.size(), name.size());
+		TS_ASSERT_EQUALS(a.toString(), name);
+		TS_ASSERT_EQUALS(a.c_str(), b.c_str());
+		TS_ASSERT(a == b);
+		TS_ASSERT(a != c);
+		TS_ASSERT(a.equalsIgnoreCase(c));
+		TS_ASSERT(!a.equalsIgnoreCase(Common::InternedString("intern-test-equality2")));
+
+		// The lowercase version is the same as if it was interned directly
+		TS_ASSERT(a.toLowercase() == c);
+		TS_ASSERT(c.toLowercase() == c);
+	}
+
+	void test_empty() {
+		Common::InternedString empty;
+		TS_ASSERT(empty.empty());
+		TS_ASSERT_EQUALS(empty.size(), 0u);
+		TS_ASSERT_EQUALS(strcmp(empty.c_str(), ""), 0);
+		TS_ASSERT(empty == Common::InternedString(""));
+		TS_ASSERT(empty == empty.toLowercase());
+		TS_ASSERT(!Common::InternedString("intern-test-empty").empty());
+	}
+
+	void test_find() {
+		Common::InternedString result;
+		TS_ASSERT(!Common::InternedString::find("intern-test-Find", result));
+		TS_ASSERT(!Common::InternedString::findIgnoreCase("intern-test-Find", result));
+
+		// Finding does not add it
+		TS_ASSERT(!Common::InternedString::find("intern-test-Find", result));
+
+		Common::InternedString interned("intern-test-Find");
+		TS_ASSERT(Common::InternedString::find("intern-test-Find", result));
+		TS_ASSERT(result == interned);
+		TS_ASSERT(!Common::InternedString::find("intern-test-find2", result));
+
+		// Ignoring the case finds the lowercase version, interned along
+		// with the original
+		TS_ASSERT(Common::InternedString::findIgnoreCase("INTERN-TEST-FIND", result));
+		TS_ASSERT(result == interned.toLowercase());
+		TS_ASSERT_EQUALS(strcmp(result.c_str(), "intern-test-find"), 0);
+		TS_ASSERT(Common::InternedString::find("intern-test-find", result));
+		TS_ASSERT(!Common::InternedString::find("INTERN-TEST-FIND", result));
+
+		TS_ASSERT(Common::InternedString::find("", result));
+		TS_ASSERT(result.empty());
+	}
+
+	void test_hashes_match_strings() {
+		const char *names[] = { "", "a", "intern-test-Hash", "SCUMMVM.INI", "Mixed Case/And Path" };
+		for (uint i = 0; i < ARRAYSIZE(names); i++) {
+			Common::InternedString interned(names[i]);
+			TS_ASSERT_EQUALS(interned.hash(), Common::String(names[i]).hash());
+			TS_ASSERT_EQUALS(interned.hashIgnoreCase(), Common::hashit_lower(names[i]));
+			TS_ASSERT_EQUALS(interned.hashIgnoreCase(), interned.toLowercase().hash());
+		}
+	}
+
+	void test_many_strings() {
+		// Far more strings than buckets
+		Common::Array<Common::InternedString> interned;
+		for (uint i = 0; i < 20000; i++)
+			interned.push_back(Common::InternedString(Common::String::format("intern-test-Many-%u", i)));
+
+		for (uint i = 0; i < 20000; i++) {
+			Common::String name = Common::String::format("intern-test-Many-%u", i);
+			TS_ASSERT(Common::InternedString(name) == interned[i]);
+			TS_ASSERT_EQUALS(interned[i].toString(), name);
+
+			Common::InternedString lowercase;
+			TS_ASSERT(Common::InternedString::findIgnoreCase(name, lowercase));
+			TS_ASSERT(lowercase == interned[i].toLowercase());
+			TS_ASSERT(lowercase != interned[i]);
+		}
+	}
+
+	void test_max_size() {
+		const uint32 maxSize = Common::InternedString::getMaxSize();
+		Common::InternedString result;
+
+		// Nothing new is added to a full table, not even the lowercase version
+		Common::InternedString::setMaxSize(Common::InternedString::getSize());
+		TS_ASSERT(!Common::InternedString::intern("intern-test-Full", result));
+		TS_ASSERT(!Common::InternedString::find("intern-test-Full", result));
+		TS_ASSERT(!Common::InternedString::find("intern-test-full", result));
+
+		// Strings already there are still found, and the constructors do
+		// not give up
+		Common::InternedString known("intern-test-Known");
+		TS_ASSERT(Common::InternedString::intern("intern-test-Known", result));
+		TS_ASSERT(result == known);
+		TS_ASSERT(Common::InternedString::intern("", result));
+		TS_ASSERT(result.empty());
+
+		const uint32 size = Common::InternedString::getSize();
+		Common::InternedString::setMaxSize(size + 1000);
+		TS_ASSERT(Common::InternedString::intern("intern-test-Full", result));
+		TS_ASSERT_EQUALS(strcmp(result.c_str(), "intern-test-Full"), 0);
+		TS_ASSERT(result.toLowercase() != result);
+		TS_ASSERT(Common::InternedString::getSize() > size);
+
+		Common::InternedString::setMaxSize(maxSize);
+	}
+
+	void test_map_keys() {
+		Common::HashMap<Common::InternedString, int> caseSensitive;
+		Common::HashMap<Common::InternedString, int, Common::InternedString_IgnoreCase_Hash, Common::InternedString_IgnoreCase_EqualTo> ignoreCase;
+
+		caseSensitive[Common::InternedString("intern-test-Key")] = 1;
+		caseSensitive[Common::InternedString("intern-test-key")] = 2;
+		ignoreCase[Common::InternedString("intern-test-Key")] = 1;
+		ignoreCase[Common::InternedString("intern-test-key")] = 2;
+
+		TS_ASSERT_EQUALS(caseSensitive.size(), 2u);
+		TS_ASSERT_EQUALS(caseSensitive[Common::InternedString("intern-test-Key")], 1);
+		TS_ASSERT_EQUALS(ignoreCase.size(), 1u);
+		TS_ASSERT_EQUALS(ignoreCase[Common::InternedString("INTERN-TEST-KEY")], 2);
+	}
+};
@@ -0,0 +1,166 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/memorypool.h"
+#include "common/system.h"
+
+#include "../null_osystem.h"
+
+class MemoryPoolTestSuite : public CxxTest::TestSuite {
+public:
+	void test_thread_safe_pool() {
+		Common::ThreadSafeMemoryPool pool(20);
+		TS_ASSERT_EQUALS(pool.getChunkSize() % sizeof(void *), 0u);
+		TS_ASSERT(pool.getChunkSize() >= 20);
+
+		// Freed chunks are used again, the most recent first
+		void *a = pool.allocChunk();
+		void *b = pool.allocChunk();
+		TS_ASSERT(a != b);
+		pool.freeChunk(a);
+		pool.freeChunk(b);
+		TS_ASSERT_EQUALS(pool.allocChunk(), b);
+		TS_ASSERT_EQUALS(pool.allocChunk(), a);
+
+		// Chunks go from caches to the pool and back
+		{
+			Common::ThreadSafeMemoryPool::Cache cache(pool);
+			void *chunks[100];
+			for (int i = 0; i < 100; i++) {
+				chunks[i] = cache.allocChunk();
+				memset(chunks[i], i, pool.getChunkSize());
+			}
+			for (int i = 0; i < 100; i++) {
+				for (uint j = 0; j < pool.getChunkSize(); j++)
+					TS_ASSERT_EQUALS(((byte *)chunks[i])[j], i);
+			}
+			for (int i = 0; i < 50; i++)
+				cache.freeChunk(chunks[i]);
+			for (int i = 50; i < 100; i++)
+				pool.freeChunk(chunks[i]);
+		}
+
+		pool.freeChunk(a);
+		pool.freeChunk(b);
+		pool.freeUnusedPages();
+	}
+
+	void test_thread_safe_pool_stress() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		if (!g_system)
+			Common::install_null_g_system();
+#endif
+
+		// Threads allocate, free, and hand chunks to each other, half of them
+		// through caches. Chunks are filled with a tag, checked before they
+		// are freed, which catches chunks handed out twice.
+		Common::ThreadSafeMemoryPool pool(48);
+		Worker workers[kWorkers];
+		OSystem::ThreadRef threads[kWorkers];
+		for (uint i = 0; i < kWorkers; i++) {
+			workers[i]._pool = &pool;
+			workers[i]._mailboxes = _mailboxes;
+			workers[i]._index = i;
+			workers[i]._errors = 0;
+			threads[i] = g_system ? g_system->createThread(&Worker::run, &workers[i]) : nullptr;
+			if (!threads[i])
+				Worker::run(&workers[i]);
+		}
+
+		for (uint i = 0; i < kWorkers; i++) {
+			if (threads[i])
+				g_system->joinThread(threads[i]);
+			TS_ASSERT_EQUALS(workers[i]._errors, 0u);
+		}
+
+		for (uint i = 0; i < kMailboxes; i++) {
+			void *chunk = _mailboxes[i].exchange(nullptr);
+			if (chunk)
+				pool.freeChunk(chunk);
+		}
+		pool.freeUnusedPages();
+	}
+
+private:
+	enum {
+		kWorkers = 4,
+		kMailboxes = 16,
+		kLiveChunks = 64,
+		kIterations = 200000
+	};
+
+	Common::Atomic<void *> _mailboxes[kMailboxes];
+
+	struct Worker {
+		Common::ThreadSafeMemoryPool *_pool;
+		Common::Atomic<void *> *_mailboxes;
+		uint32 _index;
+		uint32 _errors;
+
+		static void run(void *param) {
+			Worker *worker = (Worker *)param;
+			Common::ThreadSafeMemoryPool::Cache *cache = (worker->_index & 1) ? new Common::ThreadSafeMemoryPool::Cache(*worker->_pool) : nullptr;
+
+			void *live[kLiveChunks];
+			uint32 tags[kLiveChunks];
+			uint32 count = 0;
+			uint32 seed = worker->_index + 1;
+			for (uint32 i = 0; i < kIterations; i++) {
+				seed = seed * 1103515245 + 12345;
+				const uint32 choice = (seed >> 16) % 8;
+
+				if (count < kLiveChunks && (choice < 4 || count == 0)) {
+					void *chunk = cache ? cache->allocChunk() : worker->_pool->allocChunk();
+					tags[count] = (worker->_index << 24) | (i & 0xFFFFFF);
+					worker->fill(chunk, tags[count]);
+					live[count++] = chunk;
+				} else if (choice < 7) {
+					const uint32 slot = (seed >> 8) % count;
+					void *chunk = live[slot];
+					worker->check(chunk, tags[slot]);
+					count--;
+					live[slot] = live[count];
+					tags[slot] = tags[count];
+					if (cache)
+						cache->freeChunk(chunk);
+					else
+						worker->_pool->freeChunk(chunk);
+				} else {
+					// Swap a chunk with one left by another thread
+					count--;
+					worker->check(live[count], tags[count]);
+					void *other = worker->_mailboxes[(seed >> 8) % kMailboxes].exchange(live[count]);
+					if (other) {
+						worker->check(other, *(uint32 *)other);
+						tags[count] = (worker->_index << 24) | (i & 0xFFFFFF);
+						worker->fill(other, tags[count]);
+						live[count++] = other;
+					}
+				}
+			}
+
+			while (count) {
+				count--;
+				worker->check(live[count], tags[count]);
+				worker->_pool->freeChunk(live[count]);
+			}
+
+			delete cache;
+		}
+
+		void fill(void *chunk, uint32 tag) {
+			uint32 *words = (uint32 *)chunk;
+			for (uint j = 0; j < _pool->getChunkSize() / 4; j++)
+				words[j] = tag;
+		}
+
+		void check(void *chunk, uint32 tag) {
+			const uint32 *words = (const uint32 *)chunk;
+			for (uint j = 0; j < _pool->getChunkSize() / 4; j++) {
+				if (words[j] != tag) {
+					_errors++;
+					return;
+				}
+			}
+		}
+	};
+};
@@ -104,4 +104,20 @@ class MemoryReadStreamTestSuite : public CxxTest::TestSuite {
 		ms.seek(0, SEEK_SET);
 		TS_ASSERT(!ms.eos());
 	}
+
+	void test_map_range() {
+		byte contents[] = { 1, 2, 3, 4, 5, 6, 7 };
+		Common::MemoryReadStream ms(contents, sizeof(contents));
+
+		ms.seek(3);
+		TS_ASSERT_EQUALS(ms.mapRange(0, 7), contents);
+		TS_ASSERT_EQUALS(ms.mapRange(5, 2), contents + 5);
+		TS_ASSERT_EQUALS(ms.mapRange(7, 0), contents + 7);
+		TS_ASSERT_EQUALS(ms.pos(), 3);
+
+		TS_ASSERT(!ms.mapRange(5, 3));
+		TS_ASSERT(!ms.mapRange(8, 0));
+		TS_ASSERT(!ms.mapRange(-1, 2));
+		TS_ASSERT(!ms.mapRange(1, 0xFFFFFFFF));
+	}
 };
@@ -70,4 +70,17 @@ class SeekableSubReadStreamTestSuite : public CxxTest::TestSuite {
 		b = ssrs.readByte();
 		TS_ASSERT_EQUALS(b, 1);
 	}
+
+	void test_map_range() {
+		byte contents[10] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+		Common::MemoryReadStream ms(contents, 10);
+		Common::SeekableSubReadStream ssrs(&ms, 2, 8);
+
+		TS_ASSERT_EQUALS(ssrs.mapRange(0, 6), contents + 2);
+		TS_ASSERT_EQUALS(ssrs.mapRange(4, 2), contents + 6);
+
+		// Within the parent stream, but not within the substream
+		TS_ASSERT(!ssrs.mapRange(4, 3));
+		TS_ASSERT(!ssrs.mapRange(-2, 2));
+	}
 };
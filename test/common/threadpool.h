@@ -0,0 +1,165 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/array.h"
+#include "common/system.h"
+#include "common/threadpool.h"
+
+#include "../null_osystem.h"
+
+class ThreadPoolTestSuite : public CxxTest::TestSuite {
+public:
+	void setUp() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		if (!g_system)
+			Common::install_null_g_system();
+#endif
+	}
+
+	void test_futures() {
+		if (!g_system)
+			return;
+
+		Common::ThreadPool pool(3);
+
+		Common::Future<int> answer([]() { return 6 * 7; });
+		TS_ASSERT(!answer.isDone());
+		pool.start(&answer);
+		TS_ASSERT_EQUALS(answer.get(), 42);
+		TS_ASSERT(answer.isDone());
+
+		// Tasks can be started again once they are done
+		pool.start(&answer);
+		TS_ASSERT_EQUALS(answer.get(), 42);
+
+		Common::Atomic<int> counter(0);
+		{
+			Common::Array<Common::Future<void> *> tasks;
+			for (int i = 0; i < 100; i++) {
+				tasks.push_back(new Common::Future<void>([&counter]() { counter.fetchAdd(1); }));
+				pool.start(tasks.back());
+			}
+			for (uint i = 0; i < tasks.size(); i++) {
+				tasks[i]->get();
+				TS_ASSERT(tasks[i]->isDone());
+				delete tasks[i];
+			}
+		}
+		TS_ASSERT_EQUALS(counter.load(), 100);
+
+		// Deleting a future waits for it
+		{
+			Common::Future<void> task([&counter]() { counter.fetchAdd(1); });
+			pool.start(&task);
+		}
+		TS_ASSERT_EQUALS(counter.load(), 101);
+	}
+
+	void test_no_threads() {
+		if (!g_system)
+			return;
+
+		// Tasks run right away
+		Common::ThreadPool pool(0);
+		TS_ASSERT_EQUALS(pool.getThreadCount(), 0u);
+
+		Common::Future<int> answer([]() { return 42; });
+		pool.start(&answer);
+		TS_ASSERT(answer.isDone());
+		TS_ASSERT_EQUALS(answer.get(), 42);
+
+		checkParallelFor(pool, 0, 1000);
+	}
+
+	void test_parallel_for() {
+		if (!g_system)
+			return;
+
+		Common::ThreadPool pool(3);
+		checkParallelFor(pool, 0, 0);
+		checkParallelFor(pool, 5, 6);
+		checkParallelFor(pool, -10, 3);
+		checkParallelFor(pool, 0, 100000);
+	}
+
+	void test_waiting_runs_queued_tasks() {
+		if (!g_system)
+			return;
+
+		// The worker thread is kept busy until the other tasks were waited
+		// for, which only works if they run on the waiting thread
+		Common::ThreadPool pool(1);
+		if (pool.getThreadCount() != 1)
+			return;
+
+		Common::Atomic<int> release(0);
+		Common::Future<void> blocker([&release]() {
+			while (!release.load()) {
+			}
+		});
+		pool.start(&blocker);
+
+		Common::Future<int> queued([]() { return 1; });
+		pool.start(&queued);
+		TS_ASSERT_EQUALS(queued.get(), 1);
+
+		Common::Array<int> counts(100, 0);
+		pool.parallelFor(0, 100, [&counts](int i) { counts[i]++; });
+		for (int i = 0; i < 100; i++)
+			TS_ASSERT_EQUALS(counts[i], 1);
+
+		release.store(1);
+		blocker.get();
+	}
+
+	void test_nested_tasks() {
+		if (!g_system)
+			return;
+
+		// Tasks which start and wait for other tasks, including parallel
+		// loops, on the same pool
+		Common::ThreadPool pool(3);
+		Common::Atomic<int> total(0);
+		pool.parallelFor(0, 16, [&pool, &total](int i) {
+			Common::Future<int> inner([&pool, i]() {
+				Common::Atomic<int> sum(0);
+				pool.parallelFor(0, 100, [&sum, i](int j) { sum.fetchAdd(i * j); });
+				return sum.load();
+			});
+			pool.start(&inner);
+			total.fetchAdd(inner.get());
+		});
+
+		// Each outer index i adds i * (0 + ... + 99)
+		TS_ASSERT_EQUALS(total.load(), 120 * 4950);
+	}
+
+	void test_stress() {
+		if (!g_system)
+			return;
+
+		// Many short tasks, started while the workers take them, some of
+		// them waited for right away and others only when they are deleted
+		Common::ThreadPool pool(4);
+		Common::Atomic<int> counter(0);
+		for (int round = 0; round < 200; round++) {
+			Common::Future<void> *tasks[32];
+			for (int i = 0; i < 32; i++) {
+				tasks[i] = new Common::Future<void>([&counter]() { counter.fetchAdd(1); });
+				pool.start(tasks[i]);
+				if (i % 5 == 0)
+					tasks[i]->wait();
+			}
+			for (int i = 31; i >= 0; i--)
+				delete tasks[i];
+		}
+		TS_ASSERT_EQUALS(counter.load(), 200 * 32);
+	}
+
+private:
+	void checkParallelFor(Common::ThreadPool &pool, int begin, int end) {
+		Common::Array<Common::Atomic<int> > counts(MAX(end - begin, 1));
+		pool.parallelFor(begin, end, [&counts, begin](int i) { counts[i - begin].fetchAdd(1); });
+		for (int i = begin; i < end; i++)
+			TS_ASSERT_EQUALS(counts[i - begin].load(), 1);
+	}
+};
@@ -0,0 +1,222 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/archive.h"
+#include "common/memstream.h"
+#include "common/unzip.h"
+#include "common/zlib.h"
+
+class ZipTestSuite : public CxxTest::TestSuite {
+public:
+	void test_stored_members() {
+		byte data[1000];
+		for (uint i = 0; i < sizeof(data); i++)
+			data[i] = i * 7;
+
+		Common::MemoryWriteStreamDynamic zip(DisposeAfterUse::NO);
+		const uint32 localHeader = zip.pos();
+		const uint32 crc = computeCrc(data, sizeof(data));
+		writeLocalHeader(zip, "stored.bin", 0, crc, sizeof(data), sizeof(data));
+		zip.write(data, sizeof(data));
+		writeDirectory(zip, "stored.bin", 0, crc, sizeof(data), sizeof(data), localHeader);
+
+		Common::Archive *archive = Common::makeZipArchive(new Common::MemoryReadStream(zip.getData(), zip.size(), DisposeAfterUse::YES));
+		TS_ASSERT(archive);
+		if (!archive)
+			return;
+
+		Common::SeekableReadStream *first = archive->createReadStreamForMember("stored.bin");
+		Common::SeekableReadStream *second = archive->createReadStreamForMember("STORED.BIN");
+		TS_ASSERT(first && second);
+		TS_ASSERT(!archive->createReadStreamForMember("missing.bin"));
+
+		// The streams and the archive do not get in each other's way, and the
+		// streams outlive the archive
+		byte buffer[1000];
+		TS_ASSERT_EQUALS(first->size(), (int64)sizeof(data));
+		TS_ASSERT_EQUALS(first->read(buffer, 300), 300u);
+		TS_ASSERT(archive->hasFile("stored.bin"));
+		second->seek(500);
+		TS_ASSERT_EQUALS(second->read(buffer + 500, 500), 500u);
+		delete archive;
+		TS_ASSERT_EQUALS(first->read(buffer + 300, 200), 200u);
+		TS_ASSERT_EQUALS(memcmp(buffer, data, sizeof(data)), 0);
+
+		TS_ASSERT_EQUALS(first->read(buffer, 1000), 500u);
+		TS_ASSERT(first->eos());
+		TS_ASSERT(!first->err());
+
+		delete first;
+		delete second;
+	}
+
+	void test_deflated_members() {
+#ifdef USE_ZLIB
+		// Compressible, with enough data for a few checkpoints
+		const uint32 size = 3 * 1024 * 1024 + 123;
+		byte *data = new byte[size];
+		uint32 seed = 1;
+		for (uint32 i = 0; i < size; i++) {
+			seed = seed * 1103515245 + 12345;
+			data[i] = "abcdefgh"[(seed >> 16) & 7];
+		}
+
+		// Raw deflate data is gzip data without its header and trailer
+		Common::MemoryWriteStreamDynamic *gzipData = new Common::MemoryWriteStreamDynamic(DisposeAfterUse::NO);
+		Common::WriteStream *gzip = Common::wrapCompressedWriteStream(gzipData);
+		gzip->write(data, size);
+		gzip->finalize();
+		byte *deflated = gzipData->getData() + 10;
+		const uint32 deflatedSize = gzipData->size() - 18;
+		delete gzip;
+
+		Common::MemoryWriteStreamDynamic zip(DisposeAfterUse::NO);
+		const uint32 localHeader = zip.pos();
+		const uint32 crc = computeCrc(data, size);
+		writeLocalHeader(zip, "deflated.bin", 8, crc, deflatedSize, size);
+		zip.write(deflated, deflatedSize);
+		writeDirectory(zip, "deflated.bin", 8, crc, deflatedSize, size, localHeader);
+		free(deflated - 10);
+
+		Common::Archive *archive = Common::makeZipArchive(new Common::MemoryReadStream(zip.getData(), zip.size(), DisposeAfterUse::YES));
+		TS_ASSERT(archive);
+		if (!archive) {
+			delete[] data;
+			return;
+		}
+
+		Common::SeekableReadStream *sequential = archive->createReadStreamForMember("deflated.bin");
+		Common::SeekableReadStream *random = archive->createReadStreamForMember("deflated.bin");
+		TS_ASSERT(sequential && random);
+		TS_ASSERT_EQUALS(random->size(), (int64)size);
+
+		// Seeks in all directions, near and far, some before any checkpoint
+		// was made
+		byte buffer[4096];
+		uint32 sequentialPos = 0;
+		seed = 2;
+		for (int i = 0; i < 200; i++) {
+			seed = seed * 1103515245 + 12345;
+			const uint32 pos = (i % 3) ? (seed >> 8) % (size - sizeof(buffer)) : (uint32)random->pos() / 2;
+			TS_ASSERT(random->seek(pos));
+			TS_ASSERT_EQUALS(random->pos(), (int64)pos);
+			TS_ASSERT_EQUALS(random->read(buffer, sizeof(buffer)), sizeof(buffer));
+			TS_ASSERT_EQUALS(memcmp(buffer, data + pos, sizeof(buffer)), 0);
+
+			const uint32 count = MIN<uint32>(sizeof(buffer), size - sequentialPos);
+			TS_ASSERT_EQUALS(sequential->read(buffer, count), count);
+			TS_ASSERT_EQUALS(memcmp(buffer, data + sequentialPos, count), 0);
+			sequentialPos += count;
+		}
+
+		delete archive;
+
+		TS_ASSERT(random->seek(-100, SEEK_END));
+		TS_ASSERT_EQUALS(random->read(buffer, sizeof(buffer)), 100u);
+		TS_ASSERT_EQUALS(memcmp(buffer, data + size - 100, 100), 0);
+		TS_ASSERT(random->eos());
+		TS_ASSERT(!random->err());
+
+		TS_ASSERT_EQUALS(sequential->read(buffer, sizeof(buffer)), MIN<uint32>(sizeof(buffer), size - sequentialPos));
+		while (!sequential->eos())
+			sequential->read(buffer, sizeof(buffer));
+		TS_ASSERT(!sequential->err());
+
+		delete sequential;
+		delete random;
+		delete[] data;
+#endif
+	}
+
+	void test_crc_mismatch() {
+#ifdef USE_ZLIB
+		byte data[100];
+		for (uint i = 0; i < sizeof(data); i++)
+			data[i] = i;
+
+		Common::MemoryWriteStreamDynamic zip(DisposeAfterUse::NO);
+		const uint32 localHeader = zip.pos();
+		const uint32 crc = computeCrc(data, sizeof(data)) ^ 1;
+		writeLocalHeader(zip, "damaged.bin", 0, crc, sizeof(data), sizeof(data));
+		zip.write(data, sizeof(data));
+		writeDirectory(zip, "damaged.bin", 0, crc, sizeof(data), sizeof(data), localHeader);
+
+		Common::Archive *archive = Common::makeZipArchive(new Common::MemoryReadStream(zip.getData(), zip.size(), DisposeAfterUse::YES));
+		TS_ASSERT(archive);
+		if (!archive)
+			return;
+
+		Common::SeekableReadStream *stream = archive->createReadStreamForMember("damaged.bin");
+		TS_ASSERT(stream);
+		if (stream) {
+			// The mismatch is only known once all of the member was read,
+			// rereading a part of it does not count twice
+			byte buffer[100];
+			TS_ASSERT_EQUALS(stream->read(buffer, 60), 60u);
+			stream->seek(20);
+			TS_ASSERT_EQUALS(stream->read(buffer, 50), 50u);
+			TS_ASSERT(!stream->err());
+			TS_ASSERT_EQUALS(stream->read(buffer, 30), 30u);
+			TS_ASSERT(stream->err());
+			delete stream;
+		}
+
+		delete archive;
+#endif
+	}
+
+private:
+	uint32 computeCrc(const byte *data, uint32 size) {
+		uint32 crc = 0xFFFFFFFF;
+		for (uint32 i = 0; i < size; i++) {
+			crc ^= data[i];
+			for (int bit = 0; bit < 8; bit++)
+				crc = (crc >> 1) ^ ((crc & 1) ? 0xEDB88320 : 0);
+		}
+		return ~crc;
+	}
+
+	void writeLocalHeader(Common::WriteStream &zip, const char *name, uint16 method, uint32 crc, uint32 compressedSize, uint32 size) {
+		zip.writeUint32LE(0x04034b50);
+		zip.writeUint16LE(20);     // version needed
+		zip.writeUint16LE(0);      // flags
+		zip.writeUint16LE(method);
+		zip.writeUint32LE(0);      // date and time
+		zip.writeUint32LE(crc);
+		zip.writeUint32LE(compressedSize);
+		zip.writeUint32LE(size);
+		zip.writeUint16LE(strlen(name));
+		zip.writeUint16LE(0);      // extra field length
+		zip.writeString(name);
+	}
+
+	void writeDirectory(Common::SeekableWriteStream &zip, const char *name, uint16 method, uint32 crc, uint32 compressedSize, uint32 size, uint32 localHeader) {
+		const uint32 directory = zip.pos();
+		zip.writeUint32LE(0x02014b50);
+		zip.writeUint16LE(20);     // version made by
+		zip.writeUint16LE(20);     // version needed
+		zip.writeUint16LE(0);      // flags
+		zip.writeUint16LE(method);
+		zip.writeUint32LE(0);      // date and time
+		zip.writeUint32LE(crc);
+		zip.writeUint32LE(compressedSize);
+		zip.writeUint32LE(size);
+		zip.writeUint16LE(strlen(name));
+		zip.writeUint16LE(0);      // extra field length
+		zip.writeUint16LE(0);      // comment length
+		zip.writeUint16LE(0);      // disk
+		zip.writeUint16LE(0);      // internal attributes
+		zip.writeUint32LE(0);      // external attributes
+		zip.writeUint32LE(localHeader);
+		zip.writeString(name);
+
+		const uint32 directorySize = zip.pos() - directory;
+		zip.writeUint32LE(0x06054b50);
+		zip.writeUint16LE(0);      // disk
+		zip.writeUint16LE(0);      // disk of the directory
+		zip.writeUint16LE(1);      // entries on this disk
+		zip.writeUint16LE(1);      // entries
+		zip.writeUint32LE(directorySize);
+		zip.writeUint32LE(directory);
+		zip.writeUint16LE(0);      // comment length
+	}
+};
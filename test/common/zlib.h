@@ -0,0 +1,62 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/memstream.h"
+#include "common/zlib.h"
+
+class ZlibTestSuite : public CxxTest::TestSuite {
+public:
+	void test_gzip_seeks() {
+#ifdef USE_ZLIB
+		// Compressible, with enough data for a few checkpoints
+		const uint32 size = 5 * 1024 * 1024 + 77;
+		byte *data = new byte[size];
+		uint32 seed = 3;
+		for (uint32 i = 0; i < size; i++) {
+			seed = seed * 1103515245 + 12345;
+			data[i] = "0123456789abcdef"[(seed >> 16) & 15];
+		}
+
+		Common::MemoryWriteStreamDynamic *gzipData = new Common::MemoryWriteStreamDynamic(DisposeAfterUse::NO);
+		Common::WriteStream *gzip = Common::wrapCompressedWriteStream(gzipData);
+		gzip->write(data, size);
+		gzip->finalize();
+		Common::SeekableReadStream *compressed = new Common::MemoryReadStream(gzipData->getData(), gzipData->size(), DisposeAfterUse::YES);
+		delete gzip;
+
+		Common::SeekableReadStream *stream = Common::wrapCompressedReadStream(compressed);
+		TS_ASSERT(stream);
+		if (!stream) {
+			delete[] data;
+			return;
+		}
+		TS_ASSERT_EQUALS(stream->size(), (int64)size);
+
+		// Read it whole first, then seek around in what was read and in
+		// what was not, and read it whole again
+		byte *buffer = new byte[size];
+		TS_ASSERT_EQUALS(stream->read(buffer, size / 2), size / 2);
+		TS_ASSERT_EQUALS(memcmp(buffer, data, size / 2), 0);
+
+		seed = 4;
+		for (int i = 0; i < 100; i++) {
+			seed = seed * 1103515245 + 12345;
+			const uint32 pos = (seed >> 8) % (size - 1000);
+			TS_ASSERT(stream->seek(pos));
+			TS_ASSERT_EQUALS(stream->pos(), (int64)pos);
+			TS_ASSERT_EQUALS(stream->read(buffer, 1000), 1000u);
+			TS_ASSERT_EQUALS(memcmp(buffer, data + pos, 1000), 0);
+		}
+
+		TS_ASSERT(stream->seek(0));
+		TS_ASSERT_EQUALS(stream->read(buffer, size), size);
+		TS_ASSERT_EQUALS(memcmp(buffer, data, size), 0);
+		TS_ASSERT_EQUALS(stream->read(buffer, 1), 0u);
+		TS_ASSERT(stream->eos());
+		TS_ASSERT(!stream->err());
+
+		delete stream;
+		delete[] buffer;
+		delete[] data;
+#endif
+	}
+};
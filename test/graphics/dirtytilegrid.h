@@ -0,0 +1,84 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/dirtytilegrid.h"
+
+class DirtyTileGridTestSuite : public CxxTest::TestSuite {
+public:
+	void test_merge_regions() {
+		Graphics::DirtyTileGrid grid(100, 60, 8);
+		Common::Array<Common::Rect> rects;
+
+		grid.extractRectangles(Common::Rect(100, 60), rects);
+		TS_ASSERT(grid.isClean());
+		TS_ASSERT_EQUALS(rects.size(), 0u);
+
+		// Many small regions in the same tiles become one rectangle,
+		// aligned on the tiles
+		for (int i = 0; i < 500; i++)
+			grid.markRegion(Common::Rect(10 + i % 5, 3, 12 + i % 5, 20));
+		TS_ASSERT(!grid.isClean());
+		grid.extractRectangles(Common::Rect(100, 60), rects);
+		TS_ASSERT_EQUALS(rects.size(), 1u);
+		TS_ASSERT_EQUALS(rects[0], Common::Rect(8, 0, 16, 24));
+
+		// Separate regions stay separate and are clipped
+		rects.clear();
+		grid.clear();
+		grid.markRegion(Common::Rect(0, 0, 4, 4));
+		grid.markRegion(Common::Rect(90, 50, 120, 80));
+		grid.extractRectangles(Common::Rect(100, 60), rects);
+		TS_ASSERT_EQUALS(rects.size(), 2u);
+		TS_ASSERT_EQUALS(rects[0], Common::Rect(0, 0, 8, 8));
+		TS_ASSERT_EQUALS(rects[1], Common::Rect(88, 48, 100, 60));
+
+		Common::Array<uint> indices;
+		grid.findRectangles(Common::Rect(95, 55, 96, 56), rects, indices);
+		TS_ASSERT_EQUALS(indices.size(), 1u);
+		TS_ASSERT_EQUALS(indices[0], 1u);
+		grid.findRectangles(Common::Rect(40, 20, 50, 30), rects, indices);
+		TS_ASSERT_EQUALS(indices.size(), 0u);
+
+		// Resizing clears the grid
+		grid.resize(50, 50);
+		TS_ASSERT(grid.isClean());
+		TS_ASSERT_EQUALS(grid.getWidth(), 50);
+	}
+
+	void test_regions_outside_the_grid() {
+		Graphics::DirtyTileGrid grid(100, 60, 8);
+		Common::Array<Common::Rect> rects;
+
+		// Regions entirely off the grid, including at negative
+		// coordinates, do not mark the edge tiles
+		grid.markRegion(Common::Rect(-20, -20, -4, -4));
+		grid.markRegion(Common::Rect(-20, 10, -1, 30));
+		grid.markRegion(Common::Rect(100, 10, 140, 30));
+		grid.markRegion(Common::Rect(10, 60, 30, 90));
+		TS_ASSERT(grid.isClean());
+
+		// Regions straddling an edge only mark the tiles they overlap
+		grid.markRegion(Common::Rect(-5, -5, 3, 3));
+		grid.extractRectangles(Common::Rect(100, 60), rects);
+		TS_ASSERT_EQUALS(rects.size(), 1u);
+		TS_ASSERT_EQUALS(rects[0], Common::Rect(0, 0, 8, 8));
+
+		Common::Array<uint> indices;
+		grid.findRectangles(Common::Rect(-10, -10, -2, -2), rects, indices);
+		TS_ASSERT_EQUALS(indices.size(), 0u);
+		grid.findRectangles(Common::Rect(-10, -10, 1, 1), rects, indices);
+		TS_ASSERT_EQUALS(indices.size(), 1u);
+	}
+
+	void test_rows_extend_rectangles() {
+		Graphics::DirtyTileGrid grid(64, 64, 16);
+		Common::Array<Common::Rect> rects;
+
+		// An L shape: the column continues below the bar, which is wider
+		grid.markRegion(Common::Rect(0, 0, 16, 48));
+		grid.markRegion(Common::Rect(0, 48, 64, 64));
+		grid.extractRectangles(Common::Rect(64, 64), rects);
+		TS_ASSERT_EQUALS(rects.size(), 2u);
+		TS_ASSERT_EQUALS(rects[0], Common::Rect(0, 0, 16, 48));
+		TS_ASSERT_EQUALS(rects[1], Common::Rect(0, 48, 64, 64));
+	}
+};
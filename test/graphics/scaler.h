@@ -0,0 +1,130 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/scummsys.h"
+
+#ifdef USE_SCALERS
+#include "graphics/scaler/sai.h"
+#include "graphics/scaler/tv.h"
+#endif
+
+#ifdef USE_HQ_SCALERS
+#include "graphics/scaler/hq.h"
+#endif
+
+class ScalerTestSuite : public CxxTest::TestSuite {
+public:
+	void test_bands_match_single_pass() {
+#ifdef USE_SCALERS
+		SAIPlugin sai;
+		checkBands(sai, 2);
+
+		TVPlugin tv;
+		checkBands(tv, 2);
+#endif
+
+#ifdef USE_HQ_SCALERS
+		HQPlugin hq;
+		checkBands(hq, 2);
+		checkBands(hq, 3);
+#endif
+	}
+
+	void test_hq_simd_matches_scalar() {
+#ifdef USE_HQ_SCALERS
+		const Graphics::PixelFormat formats[] = {
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 16, 8, 0, 24),
+			Graphics::PixelFormat(4, 8, 8, 8, 0, 16, 8, 0, 0)
+		};
+
+		HQPlugin hq;
+		for (uint f = 0; f < ARRAYSIZE(formats); f++) {
+			for (uint factor = 2; factor <= 3; factor++) {
+				hq.initialize(formats[f]);
+				hq.setFactor(factor);
+				hq.setThreadCount(1);
+
+				// Neighbours differing by a little more or less than the
+				// thresholds, sometimes only in the alpha channel. The odd
+				// width leaves pixels for the scalar tail.
+				const int width = 141, height = 23;
+				const int srcPitch = (width + 2) * 4;
+				const int dstPitch = width * factor * 4;
+				uint32 *src = new uint32[(width + 2) * (height + 2)];
+				uint32 seed = f * 4 + factor;
+				src[0] = seed;
+				for (int i = 1; i < (width + 2) * (height + 2); i++) {
+					seed = seed * 1103515245 + 12345;
+					const uint32 prev = src[i - 1];
+					switch ((seed >> 16) & 3) {
+					case 0:
+						src[i] = seed;
+						break;
+					case 1:
+						src[i] = prev ^ (((seed >> 20) & 0x1F) << ((seed >> 25) & 3) * 8);
+						break;
+					default:
+						src[i] = prev;
+						break;
+					}
+				}
+				const uint8 *srcPtr = (const uint8 *)(src + width + 3);
+
+				uint8 *expected = new uint8[dstPitch * height * factor];
+				uint8 *actual = new uint8[dstPitch * height * factor];
+
+				hq.enableSIMD(false);
+				hq.scale(srcPtr, srcPitch, expected, dstPitch, width, height, 0, 0);
+				if (hq.enableSIMD(true)) {
+					hq.scale(srcPtr, srcPitch, actual, dstPitch, width, height, 0, 0);
+					TS_ASSERT_EQUALS(memcmp(expected, actual, dstPitch * height * factor), 0);
+				}
+
+				delete[] expected;
+				delete[] actual;
+				delete[] src;
+				hq.deinitialize();
+			}
+		}
+#endif
+	}
+
+private:
+	void checkBands(ScalerPluginObject &scaler, uint factor) {
+		// Large enough to be split, with an odd height so the last band
+		// is shorter
+		const int width = 150, height = 123;
+		const int padding = 4;
+		const int srcPitch = (width + padding * 2) * 2;
+		const int dstPitch = width * factor * 2;
+
+		const Graphics::PixelFormat format(2, 5, 6, 5, 0, 11, 5, 0, 0);
+		scaler.initialize(format);
+		scaler.setFactor(factor);
+
+		// Random pixels with runs of equal ones, so that the scalers take
+		// their edge detection paths too
+		uint16 *src = new uint16[(width + padding * 2) * (height + padding * 2)];
+		uint32 seed = 1;
+		src[0] = 0;
+		for (int i = 1; i < (width + padding * 2) * (height + padding * 2); i++) {
+			seed = seed * 1103515245 + 12345;
+			src[i] = ((seed >> 16) & 3) ? src[i - 1] : (uint16)(seed >> 8);
+		}
+		const uint8 *srcPtr = (const uint8 *)(src + padding * (width + padding * 2) + padding);
+
+		uint8 *expected = new uint8[dstPitch * height * factor];
+		uint8 *actual = new uint8[dstPitch * height * factor];
+
+		scaler.setThreadCount(1);
+		scaler.scale(srcPtr, srcPitch, expected, dstPitch, width, height, 0, 0);
+		scaler.setThreadCount(4);
+		scaler.scale(srcPtr, srcPitch, actual, dstPitch, width, height, 0, 0);
+
+		TS_ASSERT_EQUALS(memcmp(expected, actual, dstPitch * height * factor), 0);
+
+		delete[] expected;
+		delete[] actual;
+		delete[] src;
+		scaler.deinitialize();
+	}
+};
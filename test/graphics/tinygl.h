@@ -0,0 +1,215 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/scummsys.h"
+
+#ifdef USE_TINYGL
+#include "graphics/tinygl/texelbuffer.h"
+#include "graphics/tinygl/zbuffer.h"
+#endif
+
+class TinyGLTestSuite : public CxxTest::TestSuite {
+public:
+	void test_simd_spans_match_scalar() {
+#ifdef USE_TINYGL
+		const Graphics::PixelFormat formats[] = {
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0),
+			Graphics::PixelFormat(4, 8, 8, 8, 0, 16, 8, 0, 0)
+		};
+
+		// Depth test disabled, then each function
+		const int depthFuncs[] = {
+			-1, TGL_NEVER, TGL_LESS, TGL_EQUAL, TGL_LEQUAL, TGL_GREATER, TGL_NOTEQUAL, TGL_GEQUAL, TGL_ALWAYS
+		};
+		const int alphaFuncs[] = {
+			-1, TGL_GEQUAL, TGL_LESS, TGL_NOTEQUAL
+		};
+		// The last pair is not vectorized and checks the fallback
+		const int blendFactors[][2] = {
+			{ -1, -1 },
+			{ TGL_SRC_ALPHA, TGL_ONE_MINUS_SRC_ALPHA },
+			{ TGL_ONE, TGL_ONE },
+			{ TGL_DST_ALPHA, TGL_ZERO },
+			{ TGL_ONE_MINUS_DST_ALPHA, TGL_SRC_ALPHA },
+			{ TGL_ZERO, TGL_ONE_MINUS_DST_ALPHA },
+			{ TGL_DST_COLOR, TGL_ZERO }
+		};
+
+		for (uint f = 0; f < ARRAYSIZE(formats); f++) {
+			TinyGL::FrameBuffer scalar(kWidth, kHeight, formats[f]);
+			TinyGL::FrameBuffer simd(kWidth, kHeight, formats[f]);
+			scalar.enableSIMDSpans(false);
+			if (!simd.enableSIMDSpans(true))
+				return;
+
+			for (int mode = 0; mode < 3; mode++) {
+				for (uint d = 0; d < ARRAYSIZE(depthFuncs); d++) {
+					for (int depthWrite = 0; depthWrite < 2; depthWrite++) {
+						for (uint a = 0; a < ARRAYSIZE(alphaFuncs); a++) {
+							for (uint b = 0; b < ARRAYSIZE(blendFactors); b++) {
+								for (int scissor = 0; scissor < 2; scissor++) {
+									uint32 seed = (((mode * 16 + d) * 2 + depthWrite) * 8 + a) * 8 + b;
+									setState(scalar, depthFuncs[d], depthWrite, alphaFuncs[a], blendFactors[b], scissor);
+									setState(simd, depthFuncs[d], depthWrite, alphaFuncs[a], blendFactors[b], scissor);
+									drawTriangles(scalar, mode, seed);
+									drawTriangles(simd, mode, seed);
+									compareBuffers(scalar, simd);
+								}
+							}
+						}
+					}
+				}
+			}
+		}
+
+		// Formats with less than 8 bits per channel always use the scalar loops
+		TinyGL::FrameBuffer rgb565(kWidth, kHeight, Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0));
+		TS_ASSERT(!rgb565.enableSIMDSpans(true));
+#endif
+	}
+
+	void test_mipmaps() {
+#ifdef USE_TINYGL
+		// 8x8 checkerboard of single black and white pixels, which all
+		// mipmap levels average to gray
+		const Graphics::PixelFormat format(4, 8, 8, 8, 8, 24, 16, 8, 0);
+		uint32 pixels[8 * 8];
+		for (int i = 0; i < 8 * 8; i++)
+			pixels[i] = ((i / 8 + i) & 1) ? format.ARGBToColor(255, 255, 255, 255) : format.ARGBToColor(255, 0, 0, 0);
+		Graphics::PixelBuffer src(format, (byte *)pixels);
+
+		Graphics::NearestTexelBuffer none(src, 8, 8, 8);
+		Graphics::NearestTexelBuffer nearest(src, 8, 8, 8, Graphics::TexelBuffer::kMipmapNearest);
+		Graphics::NearestTexelBuffer linear(src, 8, 8, 8, Graphics::TexelBuffer::kMipmapLinear);
+		Graphics::BilinearTexelBuffer bilinear(src, 8, 8, 8, Graphics::TexelBuffer::kMipmapLinear);
+		TS_ASSERT(!none.hasMipmaps());
+		TS_ASSERT(nearest.hasMipmaps());
+
+		// One texel per pixel samples the base level, four texels per
+		// pixel the third one
+		const float texel = 1 << ZB_POINT_ST_FRAC_BITS;
+		TS_ASSERT_EQUALS(linear.getLevelOfDetail(texel, 0, 0, texel), 0);
+		TS_ASSERT_EQUALS(linear.getLevelOfDetail(4 * texel, 0, 0, texel), 2 << 8);
+		TS_ASSERT_EQUALS(linear.getLevelOfDetail(0, -3 * texel, 0, 0), (1 << 8) + 128);
+		TS_ASSERT_EQUALS(none.getLevelOfDetail(4 * texel, 0, 0, texel), 0);
+
+		// The first texel of the base level is black
+		TS_ASSERT_EQUALS(sampleRed(none, 3 << 8), 0);
+		TS_ASSERT_EQUALS(sampleRed(nearest, 100), 0);
+		TS_ASSERT_EQUALS(sampleRed(nearest, 200), 128);
+		TS_ASSERT_EQUALS(sampleRed(nearest, 3 << 8), 128);
+		TS_ASSERT_EQUALS(sampleRed(linear, 0), 0);
+		TS_ASSERT_EQUALS(sampleRed(linear, 128), 64);
+		TS_ASSERT_EQUALS(sampleRed(linear, 10 << 8), 128);
+		TS_ASSERT_EQUALS(sampleRed(bilinear, 1 << 8), 128);
+#endif
+	}
+
+	void test_shared_view() {
+#ifdef USE_TINYGL
+		TinyGL::FrameBuffer buffer(kWidth, kHeight, Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0));
+		buffer.enableBlending(true);
+
+		// The view draws into the same buffers with a state of its own
+		TinyGL::FrameBuffer *view = buffer.createSharedView();
+		TS_ASSERT_EQUALS(view->getPixelBuffer(), buffer.getPixelBuffer());
+		TS_ASSERT_EQUALS(view->getZBuffer(), buffer.getZBuffer());
+		TS_ASSERT(view->isBlendingEnabled());
+		view->enableBlending(false);
+		TS_ASSERT(buffer.isBlendingEnabled());
+
+		// Updating it follows the state of the frame buffer again, and
+		// deleting it leaves the buffers alone
+		buffer.enableAlphaTest(true);
+		buffer.updateSharedView(view);
+		TS_ASSERT(view->isBlendingEnabled());
+		TS_ASSERT(view->isAlphaTestEnabled());
+		TS_ASSERT_EQUALS(view->getPixelBuffer(), buffer.getPixelBuffer());
+		delete view;
+
+		buffer.clear(1, 0, 1, 10, 20, 30);
+		TS_ASSERT_EQUALS(buffer.getZBuffer()[0], 0u);
+#endif
+	}
+
+#ifdef USE_TINYGL
+private:
+	uint8 sampleRed(const Graphics::TexelBuffer &texture, int lod) {
+		uint8 a, r, g, b;
+		texture.getARGBAt(TGL_REPEAT, TGL_REPEAT, 0, 0, lod, a, r, g, b);
+		return r;
+	}
+
+	static const int kWidth = 61;
+	static const int kHeight = 37;
+
+	uint32 nextRandom(uint32 &seed) {
+		seed = seed * 1103515245 + 12345;
+		return seed >> 8;
+	}
+
+	void setState(TinyGL::FrameBuffer &buffer, int depthFunc, bool depthWrite, int alphaFunc, const int *blendFactors, bool scissor) {
+		buffer.enableDepthTest(depthFunc >= 0);
+		if (depthFunc >= 0)
+			buffer.setDepthFunc(depthFunc);
+		buffer.enableDepthWrite(depthWrite);
+		buffer.enableAlphaTest(alphaFunc >= 0);
+		if (alphaFunc >= 0)
+			buffer.setAlphaTestFunc(alphaFunc, 128);
+		buffer.enableBlending(blendFactors[0] >= 0);
+		if (blendFactors[0] >= 0)
+			buffer.setBlendingFactors(blendFactors[0], blendFactors[1]);
+		if (scissor)
+			buffer.setScissorRectangle(Common::Rect(7, 5, 50, 30));
+		else
+			buffer.resetScissorRectangle();
+	}
+
+	void drawTriangles(TinyGL::FrameBuffer &buffer, int mode, uint32 seed) {
+		// Random colors and depths, including pixels without alpha
+		uint32 *pixels = (uint32 *)buffer.getPixelBuffer();
+		unsigned int *depths = buffer.getZBuffer();
+		for (int i = 0; i < kWidth * kHeight; i++) {
+			pixels[i] = nextRandom(seed) ^ (nextRandom(seed) << 8);
+			depths[i] = nextRandom(seed) << 6;
+		}
+
+		for (int i = 0; i < 6; i++) {
+			TinyGL::ZBufferPoint points[3];
+			for (int p = 0; p < 3; p++) {
+				points[p].x = nextRandom(seed) % kWidth;
+				points[p].y = nextRandom(seed) % kHeight;
+				points[p].z = nextRandom(seed) << 6;
+				points[p].r = nextRandom(seed) % (ZB_POINT_RED_MAX + 1);
+				points[p].g = nextRandom(seed) % (ZB_POINT_GREEN_MAX + 1);
+				points[p].b = nextRandom(seed) % (ZB_POINT_BLUE_MAX + 1);
+				points[p].a = nextRandom(seed) % (ZB_POINT_ALPHA_MAX + 1);
+			}
+
+			switch (mode) {
+			case 0:
+				buffer.fillTriangleDepthOnly(&points[0], &points[1], &points[2]);
+				break;
+			case 1:
+				buffer.fillTriangleFlat(&points[0], &points[1], &points[2]);
+				break;
+			default:
+				buffer.fillTriangleSmooth(&points[0], &points[1], &points[2]);
+				break;
+			}
+		}
+	}
+
+	void compareBuffers(TinyGL::FrameBuffer &expected, TinyGL::FrameBuffer &actual) {
+		const uint32 *expectedPixels = (const uint32 *)expected.getPixelBuffer();
+		const uint32 *actualPixels = (const uint32 *)actual.getPixelBuffer();
+		const unsigned int *expectedDepths = expected.getZBuffer();
+		const unsigned int *actualDepths = actual.getZBuffer();
+		for (int i = 0; i < kWidth * kHeight; i++) {
+			TS_ASSERT_EQUALS(expectedPixels[i], actualPixels[i]);
+			TS_ASSERT_EQUALS(expectedDepths[i], actualDepths[i]);
+			if (expectedPixels[i] != actualPixels[i] || expectedDepths[i] != actualDepths[i])
+				return;
+		}
+	}
+#endif
+};
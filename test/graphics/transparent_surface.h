@@ -0,0 +1,137 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/transparent_surface.h"
+
+class TransparentSurfaceTestSuite : public CxxTest::TestSuite {
+public:
+	void test_simd_blends_match_plain_loops() {
+		const Graphics::TSpriteBlendMode blendModes[] = {
+			Graphics::BLEND_NORMAL,
+			Graphics::BLEND_ADDITIVE,
+			Graphics::BLEND_SUBTRACTIVE,
+			Graphics::BLEND_MULTIPLY
+		};
+
+		// No modulation, then with channels at 255 and 0 which some modes
+		// special case
+		const uint colors[] = {
+			TS_ARGB(255, 255, 255, 255),
+			TS_ARGB(255, 128, 255, 3),
+			TS_ARGB(77, 255, 0, 200),
+			TS_ARGB(255, 255, 255, 254)
+		};
+
+		const Graphics::TransparentSurface::SIMDLevel levels[] = {
+			Graphics::TransparentSurface::kSIMDSSE2,
+			Graphics::TransparentSurface::kSIMDAVX2,
+			Graphics::TransparentSurface::kSIMDNEON
+		};
+
+		Graphics::TransparentSurface::SIMDLevel defaultLevel = Graphics::TransparentSurface::getSIMDLevel();
+
+		// Not a multiple of any vector width, to cover the remaining columns
+		Graphics::TransparentSurface sprite;
+		sprite.create(37, 9, Graphics::TransparentSurface::getSupportedPixelFormat());
+		fillRandom(sprite, 1);
+
+		Graphics::Surface background;
+		background.create(45, 13, Graphics::TransparentSurface::getSupportedPixelFormat());
+		fillRandom(background, 2);
+
+		Graphics::Surface expected, actual;
+		for (uint b = 0; b < ARRAYSIZE(blendModes); b++) {
+			for (uint c = 0; c < ARRAYSIZE(colors); c++) {
+				for (int flipping = 0; flipping <= Graphics::FLIP_HV; flipping++) {
+					Graphics::TransparentSurface::setSIMDLevel(Graphics::TransparentSurface::kSIMDNone);
+					expected.copyFrom(background);
+					sprite.blit(expected, 3, 2, flipping, nullptr, colors[c], -1, -1, blendModes[b]);
+
+					for (uint l = 0; l < ARRAYSIZE(levels); l++) {
+						if (!Graphics::TransparentSurface::setSIMDLevel(levels[l]))
+							continue;
+
+						actual.copyFrom(background);
+						sprite.blit(actual, 3, 2, flipping, nullptr, colors[c], -1, -1, blendModes[b]);
+						TS_ASSERT_EQUALS(memcmp(expected.getPixels(), actual.getPixels(), background.h * background.pitch), 0);
+					}
+				}
+			}
+		}
+
+		Graphics::TransparentSurface::setSIMDLevel(defaultLevel);
+
+		expected.free();
+		actual.free();
+		background.free();
+		sprite.free();
+	}
+
+	void test_scaled_blits_match_scaled_copies() {
+		// Wider than the chunks blended at a time, shrunk and enlarged
+		const int sizes[][2] = { { 300, 17 }, { 20, 5 }, { 37, 30 }, { 1, 1 } };
+		const int positions[][2] = { { 3, 2 }, { -11, -4 }, { 290, 30 } };
+		const Common::Rect clippingArea(5, 3, 310, 35);
+
+		Graphics::TransparentSurface sprite;
+		sprite.create(37, 9, Graphics::TransparentSurface::getSupportedPixelFormat());
+		fillRandom(sprite, 3);
+
+		Graphics::Surface background;
+		background.create(320, 40, Graphics::TransparentSurface::getSupportedPixelFormat());
+		fillRandom(background, 4);
+
+		Graphics::Surface expected, actual;
+		for (uint s = 0; s < ARRAYSIZE(sizes); s++) {
+			Graphics::TransparentSurface *scaled = sprite.scale(sizes[s][0], sizes[s][1]);
+
+			for (uint p = 0; p < ARRAYSIZE(positions); p++) {
+				for (int flipping = 0; flipping <= Graphics::FLIP_HV; flipping++) {
+					for (int alphaMode = Graphics::ALPHA_OPAQUE; alphaMode <= Graphics::ALPHA_FULL; alphaMode++) {
+						sprite.setAlphaMode((Graphics::AlphaType)alphaMode);
+						scaled->setAlphaMode((Graphics::AlphaType)alphaMode);
+
+						expected.copyFrom(background);
+						actual.copyFrom(background);
+						Common::Rect expectedSize = scaled->blit(expected, positions[p][0], positions[p][1], flipping);
+						Common::Rect actualSize = sprite.blit(actual, positions[p][0], positions[p][1], flipping, nullptr,
+						                                      TS_ARGB(255, 255, 255, 255), sizes[s][0], sizes[s][1]);
+						TS_ASSERT_EQUALS(expectedSize, actualSize);
+						TS_ASSERT_EQUALS(memcmp(expected.getPixels(), actual.getPixels(), background.h * background.pitch), 0);
+
+						expected.copyFrom(background);
+						actual.copyFrom(background);
+						expectedSize = scaled->blitClip(expected, clippingArea, positions[p][0], positions[p][1], flipping,
+						                                nullptr, TS_ARGB(128, 255, 0, 255), -1, -1, Graphics::BLEND_ADDITIVE);
+						actualSize = sprite.blitClip(actual, clippingArea, positions[p][0], positions[p][1], flipping, nullptr,
+						                             TS_ARGB(128, 255, 0, 255), sizes[s][0], sizes[s][1], Graphics::BLEND_ADDITIVE);
+						TS_ASSERT_EQUALS(expectedSize, actualSize);
+						TS_ASSERT_EQUALS(memcmp(expected.getPixels(), actual.getPixels(), background.h * background.pitch), 0);
+					}
+				}
+			}
+
+			scaled->free();
+			delete scaled;
+		}
+
+		expected.free();
+		actual.free();
+		background.free();
+		sprite.free();
+	}
+
+private:
+	void fillRandom(Graphics::Surface &surface, uint32 seed) {
+		uint32 *pixels = (uint32 *)surface.getPixels();
+		for (int i = 0; i < surface.w * surface.h; i++) {
+			seed = seed * 1103515245 + 12345;
+			pixels[i] = seed ^ (seed >> 11);
+
+			// Whole vectors of transparent and opaque pixels as well
+			if ((i / 8) % 5 == 1)
+				pixels[i] &= ~surface.format.ARGBToColor(255, 0, 0, 0);
+			else if ((i / 8) % 5 == 2)
+				pixels[i] |= surface.format.ARGBToColor(255, 0, 0, 0);
+		}
+	}
+};
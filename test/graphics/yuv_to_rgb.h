@@ -0,0 +1,99 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/surface.h"
+#include "graphics/yuv_to_rgb.h"
+
+class YUVToRGBTestSuite : public CxxTest::TestSuite {
+public:
+	void test_simd_matches_lookup() {
+		const Graphics::PixelFormat formats[] = {
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0),
+			Graphics::PixelFormat(4, 8, 8, 8, 0, 16, 8, 0, 0),
+			Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0),
+			Graphics::PixelFormat(2, 5, 5, 5, 1, 10, 5, 0, 15)
+		};
+
+		// Not a multiple of any vector width, to cover the remainders too
+		const int width = 46, height = 6;
+
+		byte ySrc[width * height], uSrc[width * height], vSrc[width * height];
+		uint32 seed = 1;
+		for (int i = 0; i < width * height; i++) {
+			seed = seed * 1103515245 + 12345;
+			ySrc[i] = seed >> 24;
+			uSrc[i] = seed >> 16;
+			vSrc[i] = seed >> 8;
+		}
+
+		// Include the extreme values of the chroma tables
+		uSrc[0] = vSrc[0] = 0;
+		uSrc[1] = vSrc[1] = 255;
+		ySrc[0] = 0;
+		ySrc[1] = 255;
+
+		const Graphics::YUVToRGBManager::SIMDLevel levels[] = {
+			Graphics::YUVToRGBManager::kSIMDSSE2,
+			Graphics::YUVToRGBManager::kSIMDAVX2,
+			Graphics::YUVToRGBManager::kSIMDNEON
+		};
+
+		Graphics::YUVToRGBManager::SIMDLevel defaultLevel = YUVToRGBMan.getSIMDLevel();
+
+		for (uint f = 0; f < ARRAYSIZE(formats); f++) {
+			for (int scale = 0; scale < 2; scale++) {
+				Graphics::YUVToRGBManager::LuminanceScale lumScale = scale ? Graphics::YUVToRGBManager::kScaleITU : Graphics::YUVToRGBManager::kScaleFull;
+
+				Graphics::Surface expected444, expected420;
+				expected444.create(width, height, formats[f]);
+				expected420.create(width, height, formats[f]);
+
+				YUVToRGBMan.setSIMDLevel(Graphics::YUVToRGBManager::kSIMDNone);
+				YUVToRGBMan.convert444(&expected444, lumScale, ySrc, uSrc, vSrc, width, height, width, width);
+				YUVToRGBMan.convert420(&expected420, lumScale, ySrc, uSrc, vSrc, width, height, width, width);
+
+				for (uint l = 0; l < ARRAYSIZE(levels); l++) {
+					if (!YUVToRGBMan.setSIMDLevel(levels[l]))
+						continue;
+
+					Graphics::Surface actual;
+					actual.create(width, height, formats[f]);
+
+					YUVToRGBMan.convert444(&actual, lumScale, ySrc, uSrc, vSrc, width, height, width, width);
+					compareSurfaces(expected444, actual);
+
+					YUVToRGBMan.convert420(&actual, lumScale, ySrc, uSrc, vSrc, width, height, width, width);
+					compareSurfaces(expected420, actual);
+
+					actual.free();
+				}
+
+				expected444.free();
+				expected420.free();
+			}
+		}
+
+		YUVToRGBMan.setSIMDLevel(defaultLevel);
+	}
+
+private:
+	void compareSurfaces(const Graphics::Surface &expected, const Graphics::Surface &actual) {
+		const Graphics::PixelFormat &format = expected.format;
+
+		for (int y = 0; y < expected.h; y++) {
+			for (int x = 0; x < expected.w; x++) {
+				uint32 p1 = expected.getPixel(x, y);
+				uint32 p2 = actual.getPixel(x, y);
+
+				// Allow an error of one least significant bit per channel
+				TS_ASSERT_EQUALS(channel(p1, format.aShift, format.aLoss), channel(p2, format.aShift, format.aLoss));
+				TS_ASSERT_LESS_THAN_EQUALS(ABS(channel(p1, format.rShift, format.rLoss) - channel(p2, format.rShift, format.rLoss)), 1);
+				TS_ASSERT_LESS_THAN_EQUALS(ABS(channel(p1, format.gShift, format.gLoss) - channel(p2, format.gShift, format.gLoss)), 1);
+				TS_ASSERT_LESS_THAN_EQUALS(ABS(channel(p1, format.bShift, format.bLoss) - channel(p2, format.bShift, format.bLoss)), 1);
+			}
+		}
+	}
+
+	static int channel(uint32 pixel, int shift, int loss) {
+		return (pixel >> shift) & (0xFF >> loss);
+	}
+};
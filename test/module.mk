@@ -5,7 +5,7 @@
 #
 ######################################################################
 
-TESTS        := $(srcdir)/test/common/*.h $(srcdir)/test/audio/*.h $(srcdir)/test/math/*.h $(srcdir)/test/image/*.h
+TESTS        := $(srcdir)/test/common/*.h $(srcdir)/test/audio/*.h $(srcdir)/test/math/*.h $(srcdir)/test/image/*.h $(srcdir)/test/graphics/*.h $(srcdir)/test/video/*.h
 TEST_LIBS    :=
 
 ifdef POSIX
@@ -13,9 +13,11 @@ TEST_LIBS += test/null_osystem.o \
 	backends/fs/posix/posix-fs-factory.o \
 	backends/fs/posix/posix-fs.o \
 	backends/fs/posix/posix-iostream.o \
+	backends/fs/posix/posix-mappedstream.o \
 	backends/fs/abstract-fs.o \
 	backends/fs/stdiostream.o \
-	backends/modular-backend.o
+	backends/modular-backend.o \
+	backends/mutex/pthread/pthread-mutex.o
 endif
 
 ifdef WIN32
@@ -28,7 +30,20 @@ TEST_LIBS += test/null_osystem.o \
 	backends/platform/sdl/win32/win32_wrapper.o
 endif
 
-TEST_LIBS +=	audio/libaudio.a math/libmath.a common/libcommon.a image/libimage.a graphics/libgraphics.a
+ifdef USE_OPENGL
+TESTS += $(srcdir)/test/backends/opengl/*.h
+TEST_LIBS += backends/graphics/opengl/context.o \
+	backends/graphics/opengl/debug.o \
+	backends/graphics/opengl/framebuffer.o \
+	backends/graphics/opengl/shader.o \
+	backends/graphics/opengl/texture.o \
+	backends/graphics/opengl/pipelines/clut8.o \
+	backends/graphics/opengl/pipelines/fixed.o \
+	backends/graphics/opengl/pipelines/pipeline.o \
+	backends/graphics/opengl/pipelines/shader.o
+endif
+
+TEST_LIBS +=	video/libvideo.a audio/libaudio.a math/libmath.a common/libcommon.a image/libimage.a graphics/libgraphics.a
 
 ifeq ($(ENABLE_WINTERMUTE), STATIC_PLUGIN)
 	TESTS += $(srcdir)/test/engines/wintermute/*.h
@@ -46,6 +61,10 @@ TEST_CFLAGS  := $(CFLAGS) -I$(srcdir)/test/cxxtest
 TEST_LDFLAGS := $(LDFLAGS) $(LIBS)
 TEST_CXXFLAGS := $(filter-out -Wglobal-constructors,$(CXXFLAGS))
 
+ifdef POSIX
+TEST_LDFLAGS += -lpthread
+endif
+
 ifdef WIN32
 TEST_LDFLAGS := $(filter-out -mwindows,$(TEST_LDFLAGS))
 endif
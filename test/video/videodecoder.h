@@ -0,0 +1,259 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/atomic.h"
+#include "common/system.h"
+#include "common/threadpool.h"
+#include "graphics/surface.h"
+#include "video/video_decoder.h"
+
+#include "../null_osystem.h"
+
+namespace {
+
+/**
+ * Makes a pool with worker threads the default one, so frames are decoded
+ * ahead even on single CPU systems.
+ */
+class ScopedDefaultPool : public Common::ThreadPool {
+public:
+	ScopedDefaultPool() : Common::ThreadPool(2), _previous(_singleton) { _singleton = this; }
+	~ScopedDefaultPool() { _singleton = _previous; }
+
+private:
+	Common::ThreadPool *_previous;
+};
+
+class CountingDecoder : public Video::VideoDecoder {
+public:
+	/**
+	 * A video track whose frames are filled with their frame number.
+	 *
+	 * Like Bink, it may decode its frames when the decoder reads the next
+	 * packet rather than in decodeNextFrame().
+	 */
+	class CountingVideoTrack : public FixedRateVideoTrack {
+	public:
+		CountingVideoTrack(int frameCount, bool direct, bool inPacket) : _frameCount(frameCount), _direct(direct), _inPacket(inPacket), _curFrame(-1), _output(0), _spin(0), _decoding(0), _decoded(0), _decodedInto(0) {
+			_surface.create(16, 8, Graphics::PixelFormat::createFormatCLUT8());
+		}
+
+		~CountingVideoTrack() {
+			_surface.free();
+		}
+
+		uint16 getWidth() const override { return _surface.w; }
+		uint16 getHeight() const override { return _surface.h; }
+		Graphics::PixelFormat getPixelFormat() const override { return _surface.format; }
+		int getCurFrame() const override { return _curFrame; }
+		int getFrameCount() const override { return _frameCount; }
+		bool isSeekable() const override { return true; }
+
+		bool seek(const Audio::Timestamp &time) override {
+			_curFrame = getFrameAtTime(time) - 1;
+			return true;
+		}
+
+		bool canDecodeInto(const Graphics::Surface &dst) const override {
+			return _direct && dst.format == _surface.format && dst.w >= _surface.w && dst.h >= _surface.h;
+		}
+
+		void setOutputSurface(Graphics::Surface *dst) override { _output = dst; }
+
+		const Graphics::Surface *decodeNextFrame() override {
+			if (!_inPacket)
+				decodePacket();
+
+			return _output ? _output : &_surface;
+		}
+
+		void decodePacket() {
+			_decoding.store(1);
+
+			// Give the main thread a chance to catch the worker decoding
+			for (volatile uint i = 0; i < _spin; i++)
+				;
+
+			_curFrame++;
+
+			Graphics::Surface *dst = _output ? _output : &_surface;
+			for (int y = 0; y < _surface.h; y++)
+				memset(dst->getBasePtr(0, y), _curFrame, _surface.w);
+
+			_decoded.fetchAdd(1);
+			if (_output)
+				_decodedInto.fetchAdd(1);
+			_decoding.store(0);
+		}
+
+		bool decodesInPacket() const { return _inPacket; }
+
+		/** Number of busy loop iterations for each frame */
+		void setSpin(uint spin) { _spin = spin; }
+
+		bool isDecoding() { return _decoding.load() != 0; }
+		int getDecodedCount() { return _decoded.load(); }
+		int getDecodedIntoCount() { return _decodedInto.load(); }
+
+	protected:
+		Common::Rational getFrameRate() const override { return 10; }
+
+	private:
+		Graphics::Surface _surface;
+		int _frameCount;
+		bool _direct;
+		bool _inPacket;
+		int _curFrame;
+		Graphics::Surface *_output;
+		uint _spin;
+		Common::Atomic<uint32> _decoding;
+		Common::Atomic<int> _decoded;
+		Common::Atomic<int> _decodedInto;
+	};
+
+	CountingDecoder(int frameCount, bool direct, bool inPacket = false) : _frameCount(frameCount), _direct(direct), _inPacket(inPacket), _track(0) {}
+	~CountingDecoder() { close(); }
+
+	bool loadStream(Common::SeekableReadStream *stream) override {
+		close();
+		_track = new CountingVideoTrack(_frameCount, _direct, _inPacket);
+		addTrack(_track);
+		return true;
+	}
+
+	CountingVideoTrack *getCountingTrack() { return _track; }
+
+protected:
+	void readNextPacket() override {
+		if (_track && _track->decodesInPacket() && !_track->endOfTrack())
+			_track->decodePacket();
+	}
+
+private:
+	int _frameCount;
+	bool _direct;
+	bool _inPacket;
+	CountingVideoTrack *_track;
+};
+
+} // End of anonymous namespace
+
+class VideoDecoderTestSuite : public CxxTest::TestSuite {
+public:
+	void setUp() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		if (!g_system)
+			Common::install_null_g_system();
+#endif
+	}
+
+	void test_decode_ahead_order() {
+		if (!g_system)
+			return;
+
+		ScopedDefaultPool pool;
+
+		// Tracks decoding in readNextPacket() need their output surface set
+		// before it
+		for (int mode = 0; mode < 4; mode++) {
+			const bool direct = (mode & 1) != 0;
+			CountingDecoder decoder(20, direct, (mode & 2) != 0);
+			decoder.setDecodeAhead(3);
+			TS_ASSERT(decoder.loadStream(0));
+			decoder.start();
+
+			for (int i = 0; i < 20; i++) {
+				TS_ASSERT(!decoder.endOfVideo());
+
+				const Graphics::Surface *frame = decoder.decodeNextFrame();
+				TS_ASSERT(frame);
+				if (!frame)
+					break;
+
+				// The decoder describes the frame returned, not the one being decoded
+				TS_ASSERT_EQUALS(decoder.getCurFrame(), i);
+				TS_ASSERT_EQUALS(*(const byte *)frame->getBasePtr(0, 0), i);
+				TS_ASSERT_EQUALS(*(const byte *)frame->getBasePtr(15, 7), i);
+			}
+
+			TS_ASSERT(decoder.endOfVideo());
+
+			// Tracks which can do so decode straight into the queued surfaces
+			TS_ASSERT_EQUALS(decoder.getCountingTrack()->getDecodedIntoCount(), direct ? 20 : 0);
+			decoder.close();
+		}
+	}
+
+	void test_decode_ahead_seek() {
+		if (!g_system)
+			return;
+
+		ScopedDefaultPool pool;
+
+		CountingDecoder decoder(50, true);
+		decoder.setDecodeAhead(4);
+		TS_ASSERT(decoder.loadStream(0));
+		decoder.start();
+
+		for (int i = 0; i < 3; i++)
+			decoder.decodeNextFrame();
+
+		// The frames decoded ahead are thrown away
+		TS_ASSERT(decoder.seekToFrame(30));
+		const Graphics::Surface *frame = decoder.decodeNextFrame();
+		TS_ASSERT(frame);
+		TS_ASSERT_EQUALS(decoder.getCurFrame(), 30);
+		if (frame)
+			TS_ASSERT_EQUALS(*(const byte *)frame->getPixels(), 30);
+
+		TS_ASSERT(decoder.rewind());
+		frame = decoder.decodeNextFrame();
+		TS_ASSERT(frame);
+		TS_ASSERT_EQUALS(decoder.getCurFrame(), 0);
+		if (frame)
+			TS_ASSERT_EQUALS(*(const byte *)frame->getPixels(), 0);
+
+		// Disabling it carries on from the frame returned last
+		decoder.decodeNextFrame();
+		decoder.setDecodeAhead(0);
+		for (int i = 2; i < 6; i++) {
+			frame = decoder.decodeNextFrame();
+			TS_ASSERT_EQUALS(decoder.getCurFrame(), i);
+			if (frame)
+				TS_ASSERT_EQUALS(*(const byte *)frame->getPixels(), i);
+		}
+	}
+
+	void test_decode_ahead_stop() {
+		if (!g_system)
+			return;
+
+		ScopedDefaultPool pool;
+
+		CountingDecoder decoder(1000, false);
+		decoder.setDecodeAhead(500);
+		TS_ASSERT(decoder.loadStream(0));
+		CountingDecoder::CountingVideoTrack *track = decoder.getCountingTrack();
+		track->setSpin(100000);
+		decoder.start();
+		decoder.decodeNextFrame();
+
+		for (int i = 0; i < 1000 && !track->isDecoding(); i++)
+			g_system->delayMillis(1);
+		TS_ASSERT(track->isDecoding());
+
+		// Stopping waits for the frame being decoded, and nothing is
+		// decoded afterwards
+		decoder.stop();
+		TS_ASSERT(!track->isDecoding());
+		const int decoded = track->getDecodedCount();
+		g_system->delayMillis(20);
+		TS_ASSERT_EQUALS(track->getDecodedCount(), decoded);
+
+		// Closing while decoding does not leave the worker behind either
+		decoder.start();
+		decoder.decodeNextFrame();
+		for (int i = 0; i < 1000 && !track->isDecoding(); i++)
+			g_system->delayMillis(1);
+		decoder.close();
+	}
+};
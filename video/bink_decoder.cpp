@@ -39,6 +39,7 @@
 #include "common/rdft.h"
 #include "common/dct.h"
 #include "common/system.h"
+#include "common/threadpool.h"
 
 #include "graphics/yuv_to_rgb.h"
 #include "graphics/surface.h"
@@ -46,6 +47,10 @@
 #include "video/binkdata.h"
 #include "video/bink_decoder.h"
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 static const uint32 kBIKfID = MKTAG('B', 'I', 'K', 'f');
 static const uint32 kBIKgID = MKTAG('B', 'I', 'K', 'g');
 static const uint32 kBIKhID = MKTAG('B', 'I', 'K', 'h');
@@ -245,6 +250,7 @@ BinkDecoder::AudioInfo::~AudioInfo() {
 BinkDecoder::BinkVideoTrack::BinkVideoTrack(uint32 width, uint32 height, const Graphics::PixelFormat &format, uint32 frameCount, const Common::Rational &frameRate, bool swapPlanes, bool hasAlpha, uint32 id) :
 		_frameCount(frameCount), _frameRate(frameRate), _swapPlanes(swapPlanes), _hasAlpha(hasAlpha), _id(id) {
 	_curFrame = -1;
+	_outputSurface = 0;
 
 	for (int i = 0; i < 16; i++)
 		_huffman[i] = 0;
@@ -302,6 +308,19 @@ BinkDecoder::BinkVideoTrack::BinkVideoTrack(uint32 width, uint32 height, const G
 	_oldPlanes[2] = new byte[_uvBlockWidth * 8 * _uvBlockHeight * 8]; // V, 1/4 resolution
 	_oldPlanes[3] = new byte[_yBlockWidth  * 8 * _yBlockHeight  * 8]; // A
 
+	// Reserve room for deferring every block, so that parsing never reallocates
+	for (int i = 0; i < 4; i++) {
+		const bool isChroma = (i == 1) || (i == 2);
+		const uint32 blocks = isChroma ? (_uvBlockWidth * _uvBlockHeight) : (_yBlockWidth * _yBlockHeight);
+
+		_deferredBlocks[i].pitch = (isChroma ? _uvBlockWidth : _yBlockWidth) * 8;
+		if (i == 3 && !_hasAlpha)
+			continue;
+
+		_deferredBlocks[i].blocks.reserve(blocks);
+		_deferredBlocks[i].coeffs.reserve(blocks * 64);
+	}
+
 	// Initialize the video with solid green
 	memset(_curPlanes[0],   0, _yBlockWidth  * 8 * _yBlockHeight  * 8);
 	memset(_curPlanes[1],   0, _uvBlockWidth * 8 * _uvBlockHeight * 8);
@@ -473,35 +492,58 @@ bool BinkDecoder::BinkVideoTrack::rewind() {
 void BinkDecoder::BinkVideoTrack::decodePacket(VideoFrame &frame) {
 	assert(frame.bits);
 
+	PlaneBlocks *planes[2];
+	uint planeCount = 0;
+
 	if (_hasAlpha) {
 		if (_id == kBIKiID)
 			frame.bits->skip(32);
 
 		decodePlane(frame, 3, false);
+		planes[planeCount++] = &_deferredBlocks[3];
 	}
 
 	if (_id == kBIKiID)
 		frame.bits->skip(32);
 
+	// The bitstream has to be parsed serially, but once the luma plane
+	// is parsed it can be reconstructed on a worker thread while the
+	// chroma planes are parsed and reconstructed here.
+	Common::Future<void> reconstruct([&planes, &planeCount]() {
+		for (uint i = 0; i < planeCount; i++)
+			reconstructPlane(*planes[i]);
+	});
+
 	for (int i = 0; i < 3; i++) {
 		int planeIdx = ((i == 0) || !_swapPlanes) ? i : (i ^ 3);
 
 		decodePlane(frame, planeIdx, i != 0);
 
+		if (i == 0) {
+			planes[planeCount++] = &_deferredBlocks[planeIdx];
+			Common::ThreadPool::instance().start(&reconstruct);
+		} else {
+			reconstructPlane(_deferredBlocks[planeIdx]);
+		}
+
 		if (frame.bits->pos() >= frame.bits->size())
 			break;
 	}
 
+	reconstruct.wait();
+
 	// Convert the YUV data we have to our format
 	// The width used here is the surface-width, and not the video-width
 	// to allow for odd-sized videos.
+	Graphics::Surface *dst = _outputSurface ? _outputSurface : &_surface;
+
 	if (_hasAlpha) {
 		assert(_curPlanes[0] && _curPlanes[1] && _curPlanes[2] && _curPlanes[3]);
-		YUVToRGBMan.convert420Alpha(&_surface, Graphics::YUVToRGBManager::kScaleITU, _curPlanes[0], _curPlanes[1], _curPlanes[2], _curPlanes[3],
+		YUVToRGBMan.convert420Alpha(dst, Graphics::YUVToRGBManager::kScaleITU, _curPlanes[0], _curPlanes[1], _curPlanes[2], _curPlanes[3],
 				_surfaceWidth, _surfaceHeight, _yBlockWidth * 8, _uvBlockWidth * 8);
 	} else {
 		assert(_curPlanes[0] && _curPlanes[1] && _curPlanes[2]);
-		YUVToRGBMan.convert420(&_surface, Graphics::YUVToRGBManager::kScaleITU, _curPlanes[0], _curPlanes[1], _curPlanes[2],
+		YUVToRGBMan.convert420(dst, Graphics::YUVToRGBManager::kScaleITU, _curPlanes[0], _curPlanes[1], _curPlanes[2],
 				_surfaceWidth, _surfaceHeight, _yBlockWidth * 8, _uvBlockWidth * 8);
 	}
 
@@ -512,6 +554,15 @@ void BinkDecoder::BinkVideoTrack::decodePacket(VideoFrame &frame) {
 	_curFrame++;
 }
 
+bool BinkDecoder::BinkVideoTrack::canDecodeInto(const Graphics::Surface &dst) const {
+	// Odd-sized videos are converted with an extra row or column, which
+	// must not end up in the caller's surface
+	if (_surfaceWidth != _surface.w || _surfaceHeight != _surface.h)
+		return false;
+
+	return dst.format == _surface.format && dst.w >= _surface.w && dst.h >= _surface.h;
+}
+
 void BinkDecoder::BinkVideoTrack::decodePlane(VideoFrame &video, int planeIdx, bool isChroma) {
 	uint32 blockWidth  = isChroma ? _uvBlockWidth  : _yBlockWidth;
 	uint32 blockHeight = isChroma ? _uvBlockHeight : _yBlockHeight;
@@ -527,6 +578,10 @@ void BinkDecoder::BinkVideoTrack::decodePlane(VideoFrame &video, int planeIdx, b
 	ctx.prevStart = _oldPlanes[planeIdx];
 	ctx.prevEnd   = _oldPlanes[planeIdx] + width * height;
 	ctx.pitch     = width;
+	ctx.deferred  = &_deferredBlocks[planeIdx];
+
+	ctx.deferred->blocks.resize(0);
+	ctx.deferred->coeffs.resize(0);
 
 	for (int i = 0; i < 64; i++) {
 		ctx.coordMap[i] = (i & 7) + (i >> 3) * ctx.pitch;
@@ -612,6 +667,55 @@ void BinkDecoder::BinkVideoTrack::decodePlane(VideoFrame &video, int planeIdx, b
 
 }
 
+void BinkDecoder::BinkVideoTrack::reconstructPlane(const PlaneBlocks &plane) {
+	const uint32 pitch = plane.pitch;
+
+	for (uint i = 0; i < plane.blocks.size(); i++) {
+		const DeferredBlock &block = plane.blocks[i];
+
+		switch (block.type) {
+		case kBlockSkip:
+		case kBlockMotion:
+			copyBlock(block.dest, block.prev, pitch);
+			break;
+		case kBlockResidue:
+			copyBlock(block.dest, block.prev, pitch);
+			addResidue(block.dest, pitch, &plane.coeffs[block.coeffs]);
+			break;
+		case kBlockIntra:
+			IDCTPut(block.dest, pitch, &plane.coeffs[block.coeffs]);
+			break;
+		case kBlockInter:
+			copyBlock(block.dest, block.prev, pitch);
+			IDCTAdd(block.dest, pitch, &plane.coeffs[block.coeffs]);
+			break;
+		case kBlockScaled:
+			IDCTPutScaled(block.dest, pitch, &plane.coeffs[block.coeffs]);
+			break;
+		default:
+			break;
+		}
+	}
+}
+
+int32 *BinkDecoder::BinkVideoTrack::deferBlock(DecodeContext &ctx, BlockType type, const byte *prev) {
+	PlaneBlocks &plane = *ctx.deferred;
+
+	DeferredBlock block;
+	block.type   = type;
+	block.dest   = ctx.dest;
+	block.prev   = prev;
+	block.coeffs = plane.coeffs.size();
+	plane.blocks.push_back(block);
+
+	if ((type == kBlockSkip) || (type == kBlockMotion))
+		return nullptr;
+
+	// Newly added coefficients are zero-initialized
+	plane.coeffs.resize(block.coeffs + 64);
+	return &plane.coeffs[block.coeffs];
+}
+
 void BinkDecoder::BinkVideoTrack::readBundle(VideoFrame &video, Source source) {
 	if (source == kSourceColors) {
 		for (int i = 0; i < 16; i++)
@@ -770,11 +874,7 @@ uint32 BinkDecoder::BinkVideoTrack::readBundleCount(VideoFrame &video, Bundle &b
 }
 
 void BinkDecoder::BinkVideoTrack::blockSkip(DecodeContext &ctx) {
-	byte *dest = ctx.dest;
-	byte *prev = ctx.prev;
-
-	for (int j = 0; j < 8; j++, dest += ctx.pitch, prev += ctx.pitch)
-		memcpy(dest, prev, 8);
+	deferBlock(ctx, kBlockSkip, ctx.prev);
 }
 
 void BinkDecoder::BinkVideoTrack::blockScaledSkip(DecodeContext &ctx) {
@@ -822,24 +922,11 @@ void BinkDecoder::BinkVideoTrack::blockScaledRun(DecodeContext &ctx) {
 }
 
 void BinkDecoder::BinkVideoTrack::blockScaledIntra(DecodeContext &ctx) {
-	int32 block[64];
-	memset(block, 0, 64 * sizeof(int32));
+	int32 *block = deferBlock(ctx, kBlockScaled, nullptr);
 
 	block[0] = getBundleValue(kSourceIntraDC);
 
 	readDCTCoeffs(*ctx.video, block, true);
-
-	IDCT(block);
-
-	int32 *src   = block;
-	byte  *dest1 = ctx.dest;
-	byte  *dest2 = ctx.dest + ctx.pitch;
-	for (int j = 0; j < 8; j++, dest1 += (ctx.pitch << 1) - 16, dest2 += (ctx.pitch << 1) - 16, src += 8) {
-
-		for (int i = 0; i < 8; i++, dest1 += 2, dest2 += 2)
-			dest1[0] = dest1[1] = dest2[0] = dest2[1] = src[i];
-
-	}
 }
 
 void BinkDecoder::BinkVideoTrack::blockScaledFill(DecodeContext &ctx) {
@@ -909,17 +996,19 @@ void BinkDecoder::BinkVideoTrack::blockScaled(DecodeContext &ctx) {
 	ctx.prev   += 8;
 }
 
-void BinkDecoder::BinkVideoTrack::blockMotion(DecodeContext &ctx) {
+const byte *BinkDecoder::BinkVideoTrack::readMotion(DecodeContext &ctx) {
 	int8 xOff = getBundleValue(kSourceXOff);
 	int8 yOff = getBundleValue(kSourceYOff);
 
-	byte *dest = ctx.dest;
-	byte *prev = ctx.prev + yOff * ((int32) ctx.pitch) + xOff;
+	const byte *prev = ctx.prev + yOff * ((int32) ctx.pitch) + xOff;
 	if ((prev < ctx.prevStart) || (prev > ctx.prevEnd))
 		error("Copy out of bounds (%d | %d)", ctx.blockX * 8 + xOff, ctx.blockY * 8 + yOff);
 
-	for (int j = 0; j < 8; j++, dest += ctx.pitch, prev += ctx.pitch)
-		memcpy(dest, prev, 8);
+	return prev;
+}
+
+void BinkDecoder::BinkVideoTrack::blockMotion(DecodeContext &ctx) {
+	deferBlock(ctx, kBlockMotion, readMotion(ctx));
 }
 
 void BinkDecoder::BinkVideoTrack::blockRun(DecodeContext &ctx) {
@@ -950,7 +1039,7 @@ void BinkDecoder::BinkVideoTrack::blockRun(DecodeContext &ctx) {
 }
 
 void BinkDecoder::BinkVideoTrack::blockResidue(DecodeContext &ctx) {
-	blockMotion(ctx);
+	const byte *prev = readMotion(ctx);
 
 	byte v = ctx.video->bits->getBits(7);
 
@@ -959,22 +1048,17 @@ void BinkDecoder::BinkVideoTrack::blockResidue(DecodeContext &ctx) {
 
 	readResidue(*ctx.video, block, v);
 
-	byte  *dst = ctx.dest;
-	int16 *src = block;
-	for (int i = 0; i < 8; i++, dst += ctx.pitch, src += 8)
-		for (int j = 0; j < 8; j++)
-			dst[j] += src[j];
+	int32 *residue = deferBlock(ctx, kBlockResidue, prev);
+	for (int i = 0; i < 64; i++)
+		residue[i] = block[i];
 }
 
 void BinkDecoder::BinkVideoTrack::blockIntra(DecodeContext &ctx) {
-	int32 block[64];
-	memset(block, 0, 64 * sizeof(int32));
+	int32 *block = deferBlock(ctx, kBlockIntra, nullptr);
 
 	block[0] = getBundleValue(kSourceIntraDC);
 
 	readDCTCoeffs(*ctx.video, block, true);
-
-	IDCTPut(ctx, block);
 }
 
 void BinkDecoder::BinkVideoTrack::blockFill(DecodeContext &ctx) {
@@ -986,16 +1070,13 @@ void BinkDecoder::BinkVideoTrack::blockFill(DecodeContext &ctx) {
 }
 
 void BinkDecoder::BinkVideoTrack::blockInter(DecodeContext &ctx) {
-	blockMotion(ctx);
+	const byte *prev = readMotion(ctx);
 
-	int32 block[64];
-	memset(block, 0, 64 * sizeof(int32));
+	int32 *block = deferBlock(ctx, kBlockInter, prev);
 
 	block[0] = getBundleValue(kSourceInterDC);
 
 	readDCTCoeffs(*ctx.video, block, false);
-
-	IDCTAdd(ctx, block);
 }
 
 void BinkDecoder::BinkVideoTrack::blockPattern(DecodeContext &ctx) {
@@ -1474,37 +1555,213 @@ static inline void IDCTCol(int32 *dest, const int32 *src) {
 	}
 }
 
-void BinkDecoder::BinkVideoTrack::IDCT(int32 *block) {
-	int i;
+#ifdef __SSE2__
+
+// SSE2 versions of the kernels below. They produce exactly the same results
+// as the C versions, working on four columns (or rows) at once.
+
+static inline __m128i mulConstSSE2(__m128i a, int32 c) {
+	// No 32-bit multiply in SSE2; combine two 32x32->64 multiplies
+	const __m128i b = _mm_set1_epi32(c);
+	const __m128i even = _mm_mul_epu32(a, b);
+	const __m128i odd  = _mm_mul_epu32(_mm_srli_epi64(a, 32), b);
+	return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+static inline void transposeSSE2(__m128i &a, __m128i &b, __m128i &c, __m128i &d) {
+	const __m128i t0 = _mm_unpacklo_epi32(a, b);
+	const __m128i t1 = _mm_unpacklo_epi32(c, d);
+	const __m128i t2 = _mm_unpackhi_epi32(a, b);
+	const __m128i t3 = _mm_unpackhi_epi32(c, d);
+	a = _mm_unpacklo_epi64(t0, t1);
+	b = _mm_unpackhi_epi64(t0, t1);
+	c = _mm_unpacklo_epi64(t2, t3);
+	d = _mm_unpackhi_epi64(t2, t3);
+}
+
+static inline void IDCTTransformSSE2(__m128i *d, const __m128i *s) {
+	const __m128i a0 = _mm_add_epi32(s[0], s[4]);
+	const __m128i a1 = _mm_sub_epi32(s[0], s[4]);
+	const __m128i a2 = _mm_add_epi32(s[2], s[6]);
+	const __m128i a3 = _mm_srai_epi32(mulConstSSE2(_mm_sub_epi32(s[2], s[6]), A1), 11);
+	const __m128i a4 = _mm_add_epi32(s[5], s[3]);
+	const __m128i a5 = _mm_sub_epi32(s[5], s[3]);
+	const __m128i a6 = _mm_add_epi32(s[1], s[7]);
+	const __m128i a7 = _mm_sub_epi32(s[1], s[7]);
+	const __m128i b0 = _mm_add_epi32(a4, a6);
+	const __m128i b1 = _mm_srai_epi32(mulConstSSE2(_mm_add_epi32(a5, a7), A3), 11);
+	const __m128i b2 = _mm_add_epi32(_mm_sub_epi32(_mm_srai_epi32(mulConstSSE2(a5, A4), 11), b0), b1);
+	const __m128i b3 = _mm_sub_epi32(_mm_srai_epi32(mulConstSSE2(_mm_sub_epi32(a6, a4), A1), 11), b2);
+	const __m128i b4 = _mm_sub_epi32(_mm_add_epi32(_mm_srai_epi32(mulConstSSE2(a7, A2), 11), b3), b1);
+
+	const __m128i a02 = _mm_add_epi32(a0, a2);
+	const __m128i a0m2 = _mm_sub_epi32(a0, a2);
+	const __m128i a132 = _mm_sub_epi32(_mm_add_epi32(a1, a3), a2);
+	const __m128i a1m32 = _mm_add_epi32(_mm_sub_epi32(a1, a3), a2);
+
+	d[0] = _mm_add_epi32(a02, b0);
+	d[1] = _mm_add_epi32(a132, b2);
+	d[2] = _mm_add_epi32(a1m32, b3);
+	d[3] = _mm_sub_epi32(a0m2, b4);
+	d[4] = _mm_add_epi32(a0m2, b4);
+	d[5] = _mm_sub_epi32(a1m32, b3);
+	d[6] = _mm_sub_epi32(a132, b2);
+	d[7] = _mm_sub_epi32(a02, b0);
+}
+
+/** Full IDCT; rows[2 * i] and rows[2 * i + 1] receive the left and right half of row i. */
+static inline void IDCTSSE2(__m128i *rows, const int32 *block) {
+	__m128i src[8], cols[2][8];
+
+	for (int h = 0; h < 2; h++) {
+		for (int k = 0; k < 8; k++)
+			src[k] = _mm_loadu_si128((const __m128i *)(block + 8 * k + 4 * h));
+
+		IDCTTransformSSE2(cols[h], src);
+	}
+
+	const __m128i round = _mm_set1_epi32(0x7F);
+
+	for (int g = 0; g < 8; g += 4) {
+		__m128i dst[8];
+
+		for (int k = 0; k < 4; k++) {
+			src[k]     = cols[0][g + k];
+			src[k + 4] = cols[1][g + k];
+		}
+		transposeSSE2(src[0], src[1], src[2], src[3]);
+		transposeSSE2(src[4], src[5], src[6], src[7]);
+
+		IDCTTransformSSE2(dst, src);
+
+		for (int k = 0; k < 8; k++)
+			dst[k] = _mm_srai_epi32(_mm_add_epi32(dst[k], round), 8);
+
+		transposeSSE2(dst[0], dst[1], dst[2], dst[3]);
+		transposeSSE2(dst[4], dst[5], dst[6], dst[7]);
+
+		for (int k = 0; k < 4; k++) {
+			rows[2 * (g + k)    ] = dst[k];
+			rows[2 * (g + k) + 1] = dst[k + 4];
+		}
+	}
+}
+
+/** Truncate eight 32-bit values to bytes, like storing them to a byte would. */
+static inline __m128i packBytesSSE2(__m128i lo, __m128i hi) {
+	const __m128i mask = _mm_set1_epi32(0xFF);
+	const __m128i words = _mm_packs_epi32(_mm_and_si128(lo, mask), _mm_and_si128(hi, mask));
+	return _mm_packus_epi16(words, words);
+}
+
+/** Add eight 32-bit values to the bytes at dest, wrapping around. */
+static inline void addRowSSE2(byte *dest, __m128i lo, __m128i hi) {
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i pixels = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)dest), zero);
+
+	lo = _mm_add_epi32(lo, _mm_unpacklo_epi16(pixels, zero));
+	hi = _mm_add_epi32(hi, _mm_unpackhi_epi16(pixels, zero));
+	_mm_storel_epi64((__m128i *)dest, packBytesSSE2(lo, hi));
+}
+
+void BinkDecoder::BinkVideoTrack::IDCTPut(byte *dest, uint32 pitch, const int32 *block) {
+	__m128i rows[16];
+	IDCTSSE2(rows, block);
+
+	for (int i = 0; i < 8; i++, dest += pitch)
+		_mm_storel_epi64((__m128i *)dest, packBytesSSE2(rows[2 * i], rows[2 * i + 1]));
+}
+
+void BinkDecoder::BinkVideoTrack::IDCTPutScaled(byte *dest, uint32 pitch, const int32 *block) {
+	__m128i rows[16];
+	IDCTSSE2(rows, block);
+
+	for (int i = 0; i < 8; i++, dest += pitch << 1) {
+		const __m128i pixels = packBytesSSE2(rows[2 * i], rows[2 * i + 1]);
+		const __m128i doubled = _mm_unpacklo_epi8(pixels, pixels);
+		_mm_storeu_si128((__m128i *)dest, doubled);
+		_mm_storeu_si128((__m128i *)(dest + pitch), doubled);
+	}
+}
+
+void BinkDecoder::BinkVideoTrack::IDCTAdd(byte *dest, uint32 pitch, const int32 *block) {
+	__m128i rows[16];
+	IDCTSSE2(rows, block);
+
+	for (int i = 0; i < 8; i++, dest += pitch)
+		addRowSSE2(dest, rows[2 * i], rows[2 * i + 1]);
+}
+
+void BinkDecoder::BinkVideoTrack::addResidue(byte *dest, uint32 pitch, const int32 *block) {
+	for (int i = 0; i < 8; i++, dest += pitch, block += 8)
+		addRowSSE2(dest, _mm_loadu_si128((const __m128i *)block), _mm_loadu_si128((const __m128i *)(block + 4)));
+}
+
+void BinkDecoder::BinkVideoTrack::copyBlock(byte *dest, const byte *src, uint32 pitch) {
+	for (int i = 0; i < 8; i++, dest += pitch, src += pitch)
+		_mm_storel_epi64((__m128i *)dest, _mm_loadl_epi64((const __m128i *)src));
+}
+
+#else
+
+static void IDCT(int32 *dest, const int32 *block) {
 	int32 temp[64];
 
-	for (i = 0; i < 8; i++)
+	for (int i = 0; i < 8; i++)
 		IDCTCol(&temp[i], &block[i]);
-	for (i = 0; i < 8; i++) {
-		IDCT_ROW( (&block[8*i]), (&temp[8*i]) );
+	for (int i = 0; i < 8; i++) {
+		IDCT_ROW( (&dest[8*i]), (&temp[8*i]) );
 	}
 }
 
-void BinkDecoder::BinkVideoTrack::IDCTAdd(DecodeContext &ctx, int32 *block) {
-	int i, j;
+void BinkDecoder::BinkVideoTrack::IDCTPut(byte *dest, uint32 pitch, const int32 *block) {
+	int32 temp[64];
 
-	IDCT(block);
-	byte *dest = ctx.dest;
-	for (i = 0; i < 8; i++, dest += ctx.pitch, block += 8)
-		for (j = 0; j < 8; j++)
-			 dest[j] += block[j];
+	for (int i = 0; i < 8; i++)
+		IDCTCol(&temp[i], &block[i]);
+	for (int i = 0; i < 8; i++) {
+		IDCT_ROW( (&dest[i*pitch]), (&temp[8*i]) );
+	}
 }
 
-void BinkDecoder::BinkVideoTrack::IDCTPut(DecodeContext &ctx, int32 *block) {
-	int i;
+void BinkDecoder::BinkVideoTrack::IDCTPutScaled(byte *dest, uint32 pitch, const int32 *block) {
 	int32 temp[64];
-	for (i = 0; i < 8; i++)
-		IDCTCol(&temp[i], &block[i]);
-	for (i = 0; i < 8; i++) {
-		IDCT_ROW( (&ctx.dest[i*ctx.pitch]), (&temp[8*i]) );
+	IDCT(temp, block);
+
+	const int32 *src = temp;
+	byte *dest1 = dest;
+	byte *dest2 = dest + pitch;
+	for (int j = 0; j < 8; j++, dest1 += (pitch << 1) - 16, dest2 += (pitch << 1) - 16, src += 8) {
+
+		for (int i = 0; i < 8; i++, dest1 += 2, dest2 += 2)
+			dest1[0] = dest1[1] = dest2[0] = dest2[1] = src[i];
+
 	}
 }
 
+void BinkDecoder::BinkVideoTrack::IDCTAdd(byte *dest, uint32 pitch, const int32 *block) {
+	int32 temp[64];
+	IDCT(temp, block);
+
+	const int32 *src = temp;
+	for (int i = 0; i < 8; i++, dest += pitch, src += 8)
+		for (int j = 0; j < 8; j++)
+			dest[j] += src[j];
+}
+
+void BinkDecoder::BinkVideoTrack::addResidue(byte *dest, uint32 pitch, const int32 *block) {
+	for (int i = 0; i < 8; i++, dest += pitch, block += 8)
+		for (int j = 0; j < 8; j++)
+			dest[j] += block[j];
+}
+
+void BinkDecoder::BinkVideoTrack::copyBlock(byte *dest, const byte *src, uint32 pitch) {
+	for (int i = 0; i < 8; i++, dest += pitch, src += pitch)
+		memcpy(dest, src, 8);
+}
+
+#endif // __SSE2__
+
 BinkDecoder::BinkAudioTrack::BinkAudioTrack(BinkDecoder::AudioInfo &audio, Audio::Mixer::SoundType soundType) :
 		AudioTrack(soundType),
 		_audioInfo(&audio) {
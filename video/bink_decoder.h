@@ -154,7 +154,9 @@ private:
 		Graphics::PixelFormat getPixelFormat() const override { return _surface.format; }
 		int getCurFrame() const override { return _curFrame; }
 		int getFrameCount() const override { return _frameCount; }
-		const Graphics::Surface *decodeNextFrame() override { return &_surface; }
+		const Graphics::Surface *decodeNextFrame() override { return _outputSurface ? _outputSurface : &_surface; }
+		bool canDecodeInto(const Graphics::Surface &dst) const override;
+		void setOutputSurface(Graphics::Surface *dst) override { _outputSurface = dst; }
 		bool isSeekable() const  override{ return true; }
 		bool seek(const Audio::Timestamp &time) override { return true; }
 		bool rewind() override;
@@ -166,6 +168,8 @@ private:
 		Common::Rational getFrameRate() const override { return _frameRate; }
 
 	private:
+		struct PlaneBlocks;
+
 		/** A decoder state. */
 		struct DecodeContext {
 			VideoFrame *video;
@@ -183,6 +187,8 @@ private:
 
 			uint32 pitch;
 
+			PlaneBlocks *deferred;
+
 			int coordMap[64];
 			int coordScaledMap1[64];
 			int coordScaledMap2[64];
@@ -239,12 +245,35 @@ private:
 			byte *curPtr; ///< Pointer to the data that wasn't yet read.
 		};
 
+		/**
+		 * A block whose reconstruction (motion compensation, IDCT) was
+		 * deferred while parsing the bitstream.
+		 *
+		 * Blocks only ever write to their own area of the current plane
+		 * and only read from the previous frame, so deferred blocks can
+		 * be reconstructed in any order and on any thread.
+		 */
+		struct DeferredBlock {
+			BlockType type;   ///< kBlockSkip, kBlockMotion, kBlockResidue, kBlockIntra, kBlockInter or kBlockScaled (16x16 intra).
+			byte *dest;       ///< Top-left corner of the block in the current plane.
+			const byte *prev; ///< Motion-compensated source block in the previous plane.
+			uint32 coeffs;    ///< Index of the 64 DCT coefficients or residues in PlaneBlocks::coeffs.
+		};
+
+		/** All deferred blocks of a plane. */
+		struct PlaneBlocks {
+			Common::Array<DeferredBlock> blocks;
+			Common::Array<int32> coeffs;
+			uint32 pitch;
+		};
+
 		int _curFrame;
 		int _frameCount;
 
 		Graphics::Surface _surface;
 		int _surfaceWidth; ///< The actual surface width
 		int _surfaceHeight; ///< The actual surface height
+		Graphics::Surface *_outputSurface; ///< Caller-supplied surface to convert into instead of _surface
 
 		uint32 _id; ///< The BIK FourCC.
 
@@ -270,6 +299,8 @@ private:
 		byte *_curPlanes[4]; ///< The 4 color planes, YUVA, current frame.
 		byte *_oldPlanes[4]; ///< The 4 color planes, YUVA, last frame.
 
+		PlaneBlocks _deferredBlocks[4]; ///< Blocks left to reconstruct, YUVA.
+
 		/** Initialize the bundles. */
 		void initBundles();
 		/** Deinitialize the bundles. */
@@ -278,9 +309,15 @@ private:
 		/** Initialize the Huffman decoders. */
 		void initHuffman();
 
-		/** Decode a plane. */
+		/** Parse a plane, deferring the expensive blocks to reconstructPlane(). */
 		void decodePlane(VideoFrame &video, int planeIdx, bool isChroma);
 
+		/** Reconstruct all blocks of a plane that were deferred by decodePlane(). */
+		static void reconstructPlane(const PlaneBlocks &plane);
+
+		/** Queue a block for reconstruction and return its zeroed coefficients, if it has any. */
+		int32 *deferBlock(DecodeContext &ctx, BlockType type, const byte *prev);
+
 		/** Read/Initialize a bundle for decoding a plane. */
 		void readBundle(VideoFrame &video, Source source);
 
@@ -315,6 +352,9 @@ private:
 		void blockPattern      (DecodeContext &ctx);
 		void blockRaw          (DecodeContext &ctx);
 
+		/** Read a motion vector and return the source block it points to. */
+		const byte *readMotion(DecodeContext &ctx);
+
 		// Read the bundles
 		void readRuns        (VideoFrame &video, Bundle &bundle);
 		void readMotionValues(VideoFrame &video, Bundle &bundle);
@@ -325,10 +365,12 @@ private:
 		void readDCTCoeffs   (VideoFrame &video, int32 *block, bool isIntra);
 		void readResidue     (VideoFrame &video, int16 *block, int masksCount);
 
-		// Bink video IDCT
-		void IDCT(int32 *block);
-		void IDCTPut(DecodeContext &ctx, int32 *block);
-		void IDCTAdd(DecodeContext &ctx, int32 *block);
+		// Bink video IDCT and block kernels, see bink_decoder.cpp
+		static void IDCTPut(byte *dest, uint32 pitch, const int32 *block);
+		static void IDCTPutScaled(byte *dest, uint32 pitch, const int32 *block);
+		static void IDCTAdd(byte *dest, uint32 pitch, const int32 *block);
+		static void addResidue(byte *dest, uint32 pitch, const int32 *block);
+		static void copyBlock(byte *dest, const byte *src, uint32 pitch);
 	};
 
 	class BinkAudioTrack : public AudioTrack {
@@ -74,6 +74,9 @@ public:
 protected:
 	Common::QuickTimeParser::SampleDesc *readSampleDesc(Common::QuickTimeParser::Track *track, uint32 format, uint32 descSize);
 
+	// Audio is buffered from decodeNextFrame(), sharing the stream with the video tracks
+	bool supportsDecodeAhead() const { return false; }
+
 private:
 	void init();
 
@@ -27,12 +27,26 @@
 
 #include "common/rational.h"
 #include "common/file.h"
+#include "common/rect.h"
 #include "common/system.h"
+#include "common/threadpool.h"
 
+#include "graphics/conversion.h"
 #include "graphics/palette.h"
+#include "graphics/surface.h"
 
 namespace Video {
 
+struct VideoDecoder::AheadFrame {
+	Graphics::Surface surface;
+	bool hasSurface;
+	bool dirtyPalette;
+	byte palette[256 * 3];
+	int curFrame;
+	uint32 nextFrameStartTime;
+	bool endOfTrack;
+};
+
 VideoDecoder::VideoDecoder() {
 	_startTime = 0;
 	_dirtyPalette = false;
@@ -49,6 +63,16 @@ VideoDecoder::VideoDecoder() {
 	_nextVideoTrack = 0;
 	_mainAudioTrack = 0;
 	_canSetDither = true;
+	_decodeAheadFrames = 0;
+	_aheadFrames = 0;
+	_aheadFrameCount = 0;
+	_aheadTask = nullptr;
+	_aheadRead = 0;
+	_aheadNoThreads = false;
+	_aheadTrack = 0;
+	_aheadCurFrame = -1;
+	_aheadNextFrameStartTime = 0;
+	_aheadEndOfTrack = false;
 
 	// Find the best format for output
 	_defaultHighColorFormat = g_system->getScreenFormat();
@@ -57,7 +81,16 @@ VideoDecoder::VideoDecoder() {
 		_defaultHighColorFormat = Graphics::PixelFormat(4, 8, 8, 8, 8, 8, 16, 24, 0);
 }
 
+VideoDecoder::~VideoDecoder() {
+	stopDecodeAhead();
+	delete _aheadTask;
+	freeDecodeAheadFrames();
+}
+
 void VideoDecoder::close() {
+	flushDecodeAhead();
+	freeDecodeAheadFrames();
+
 	if (isPlaying())
 		stop();
 
@@ -98,6 +131,9 @@ bool VideoDecoder::needsUpdate() const {
 }
 
 void VideoDecoder::pauseVideo(bool pause) {
+	// The tracks are about to be paused or resumed
+	stopDecodeAhead();
+
 	if (pause) {
 		_pauseLevel++;
 
@@ -188,12 +224,40 @@ const Graphics::Surface *VideoDecoder::decodeNextFrame() {
 	_needsUpdate = false;
 	_canSetDither = false;
 
-	readNextPacket();
+	if (_aheadTrack) {
+		// If the worker fell behind, wait for the frame it is decoding
+		if (_aheadWritten.load() == _aheadRead)
+			stopDecodeAhead();
 
-	// If we have no next video track at this point, there shouldn't be
-	// any frame available for us to display.
-	if (!_nextVideoTrack)
-		return 0;
+		// Once the queue ran dry with the worker stopped, the track is
+		// back in sync with what was returned and can be used directly.
+		if (_aheadWritten.load() == _aheadRead)
+			_aheadTrack = 0;
+	}
+
+	if (!_aheadTrack) {
+		// The worker is about to reuse the track's surface, so the frame
+		// is returned through the queue as well. Some tracks decode in
+		// readNextPacket(), so the slot is set up before it.
+		const bool ahead = _nextVideoTrack && prepareDecodeAhead();
+		const bool direct = ahead && beginAheadFrame();
+
+		readNextPacket();
+
+		// If we have no next video track at this point, there shouldn't be
+		// any frame available for us to display.
+		if (!_nextVideoTrack)
+			return 0;
+
+		if (ahead)
+			queueAheadFrame(direct);
+	}
+
+	if (_aheadTrack) {
+		const Graphics::Surface *frame = presentAheadFrame();
+		startDecodeAhead();
+		return frame;
+	}
 
 	const Graphics::Surface *frame = _nextVideoTrack->decodeNextFrame();
 
@@ -208,14 +272,64 @@ const Graphics::Surface *VideoDecoder::decodeNextFrame() {
 	return frame;
 }
 
+bool VideoDecoder::decodeNextFrameInto(Graphics::Surface &dst) {
+	// Frames decoded ahead come out of their own surfaces anyway
+	VideoTrack *directTrack = 0;
+	bool decodingAhead = _aheadTrack || (_decodeAheadFrames != 0 && !_aheadNoThreads && supportsDecodeAhead());
+
+	if (!decodingAhead && _nextVideoTrack && _nextVideoTrack->canDecodeInto(dst))
+		directTrack = _nextVideoTrack;
+
+	if (directTrack)
+		directTrack->setOutputSurface(&dst);
+
+	const Graphics::Surface *frame = decodeNextFrame();
+
+	if (directTrack)
+		directTrack->setOutputSurface(0);
+
+	if (!frame)
+		return false;
+
+	// Nothing left to do if the track wrote the frame in place
+	if (frame->getPixels() == dst.getPixels())
+		return true;
+
+	const Common::Rect area(MIN(frame->w, dst.w), MIN(frame->h, dst.h));
+
+	if (frame->format == dst.format) {
+		dst.copyRectToSurface(*frame, 0, 0, area);
+		return true;
+	}
+
+	if (frame->format.bytesPerPixel == 1) {
+		if (!_palette)
+			return false;
+
+		Graphics::Surface *converted = frame->getSubArea(area).convertTo(dst.format, _palette);
+		dst.copyRectToSurface(*converted, 0, 0, area);
+		converted->free();
+		delete converted;
+		return true;
+	}
+
+	return Graphics::crossBlit((byte *)dst.getPixels(), (const byte *)frame->getPixels(), dst.pitch, frame->pitch,
+	                           area.width(), area.height(), dst.format, frame->format);
+}
+
 bool VideoDecoder::setReverse(bool reverse) {
 	// Can only reverse video-only videos
 	if (reverse && hasAudio())
 		return false;
 
+	stopDecodeAhead();
+
 	// Attempt to make sure all the tracks are in the requested direction
 	for (TrackList::iterator it = _tracks.begin(); it != _tracks.end(); it++) {
 		if ((*it)->getTrackType() == Track::kTrackTypeVideo && ((VideoTrack *)*it)->isReversed() != reverse) {
+			// Frames decoded ahead are in the wrong direction now
+			flushDecodeAhead();
+
 			if (!((VideoTrack *)*it)->setReverse(reverse))
 				return false;
 
@@ -237,7 +351,7 @@ int VideoDecoder::getCurFrame() const {
 
 	for (TrackList::const_iterator it = _tracks.begin(); it != _tracks.end(); it++)
 		if ((*it)->getTrackType() == Track::kTrackTypeVideo)
-			frame += ((VideoTrack *)*it)->getCurFrame() + 1;
+			frame += getTrackCurFrame((const VideoTrack *)*it) + 1;
 
 	return frame;
 }
@@ -278,7 +392,7 @@ uint32 VideoDecoder::getTimeToNextFrame() const {
 		return 0;
 
 	uint32 currentTime = getTime();
-	uint32 nextFrameStartTime = _nextVideoTrack->getNextFrameStartTime();
+	uint32 nextFrameStartTime = getTrackNextFrameStartTime(_nextVideoTrack);
 
 	if (_nextVideoTrack->isReversed()) {
 		// For reversed videos, we need to handle the time difference the opposite way.
@@ -299,8 +413,8 @@ bool VideoDecoder::endOfVideo() const {
 	for (TrackList::const_iterator it = _tracks.begin(); it != _tracks.end(); it++) {
 		const Track *track = *it;
 
-		bool videoEndTimeReached = _endTimeSet && track->getTrackType() == Track::kTrackTypeVideo && ((const VideoTrack *)track)->getNextFrameStartTime() >= (uint)_endTime.msecs();
-		bool endReached = track->endOfTrack() || (isPlaying() && videoEndTimeReached);
+		bool videoEndTimeReached = _endTimeSet && track->getTrackType() == Track::kTrackTypeVideo && getTrackNextFrameStartTime((const VideoTrack *)track) >= (uint)_endTime.msecs();
+		bool endReached = getTrackEndOfTrack(track) || (isPlaying() && videoEndTimeReached);
 		if (!endReached)
 			return false;
 	}
@@ -323,6 +437,8 @@ bool VideoDecoder::rewind() {
 	if (!isRewindable())
 		return false;
 
+	flushDecodeAhead();
+
 	// Stop all tracks so they can be rewound
 	if (isPlaying())
 		stopAudio();
@@ -357,6 +473,8 @@ bool VideoDecoder::seek(const Audio::Timestamp &time) {
 	if (!isSeekable())
 		return false;
 
+	flushDecodeAhead();
+
 	// Stop all tracks so they can be seeked
 	if (isPlaying())
 		stopAudio();
@@ -423,6 +541,9 @@ void VideoDecoder::stop() {
 	if (!isPlaying())
 		return;
 
+	// The tracks are about to be resumed
+	stopDecodeAhead();
+
 	// Stop audio here so we don't have it affect getTime()
 	stopAudio();
 
@@ -526,6 +647,195 @@ bool VideoDecoder::setDitheringPalette(const byte *palette) {
 	return result;
 }
 
+void VideoDecoder::setDecodeAhead(uint frames) {
+	stopDecodeAhead();
+	_decodeAheadFrames = frames;
+}
+
+bool VideoDecoder::prepareDecodeAhead() {
+	if (_decodeAheadFrames == 0 || _aheadNoThreads || !supportsDecodeAhead())
+		return false;
+
+	// Only forward playback of a single video track is supported
+	VideoTrack *track = 0;
+
+	for (TrackList::iterator it = _tracks.begin(); it != _tracks.end(); it++) {
+		if ((*it)->getTrackType() == Track::kTrackTypeVideo) {
+			if (track)
+				return false;
+
+			track = (VideoTrack *)*it;
+		}
+	}
+
+	if (track != _nextVideoTrack || track->isReversed())
+		return false;
+
+	// The queue is empty, so this is a good time to apply a new depth
+	if (_aheadFrameCount != _decodeAheadFrames + 1) {
+		freeDecodeAheadFrames();
+		_aheadFrameCount = _decodeAheadFrames + 1;
+		_aheadFrames = new AheadFrame[_aheadFrameCount];
+	}
+
+	_aheadRead = 0;
+	_aheadWritten.store(0);
+	_aheadReleased.store(0);
+	_aheadTrack = track;
+	return true;
+}
+
+void VideoDecoder::startDecodeAhead() {
+	if (!_aheadTrack || _decodeAheadFrames == 0)
+		return;
+
+	if (_aheadTask && !_aheadTask->isDone())
+		return;
+
+	// The worker is idle, so the track may be queried here
+	if (_aheadWritten.loadRelaxed() - _aheadReleased.load() >= _aheadFrameCount || _aheadTrack->endOfTrack())
+		return;
+
+	if (!_aheadTask) {
+		// Without worker threads, the task would decode the frames right
+		// away, so fall back to decoding on demand once the queue runs dry
+		if (Common::ThreadPool::instance().getThreadCount() == 0) {
+			_aheadNoThreads = true;
+			return;
+		}
+
+		_aheadTask = new Common::Future<void>([this]() { decodeAhead(); });
+	}
+
+	_aheadStop.store(0);
+	Common::ThreadPool::instance().start(_aheadTask);
+}
+
+void VideoDecoder::stopDecodeAhead() {
+	if (!_aheadTask)
+		return;
+
+	_aheadStop.store(1);
+	_aheadTask->wait();
+}
+
+void VideoDecoder::flushDecodeAhead() {
+	stopDecodeAhead();
+
+	_aheadRead = _aheadWritten.loadRelaxed();
+	_aheadReleased.store(_aheadRead);
+	_aheadTrack = 0;
+}
+
+void VideoDecoder::freeDecodeAheadFrames() {
+	if (!_aheadFrames)
+		return;
+
+	for (uint i = 0; i < _aheadFrameCount; i++)
+		_aheadFrames[i].surface.free();
+
+	delete[] _aheadFrames;
+	_aheadFrames = 0;
+	_aheadFrameCount = 0;
+}
+
+bool VideoDecoder::beginAheadFrame() {
+	AheadFrame &slot = _aheadFrames[_aheadWritten.loadRelaxed() % _aheadFrameCount];
+
+	// Tracks able to do so decode straight into the slot, as they would
+	// into the caller's surface in decodeNextFrameInto()
+	const uint16 width = _aheadTrack->getWidth();
+	const uint16 height = _aheadTrack->getHeight();
+	const Graphics::PixelFormat format = _aheadTrack->getPixelFormat();
+
+	if (!slot.surface.getPixels() && width && height)
+		slot.surface.create(width, height, format);
+
+	// Otherwise the slot keeps the size of the frames copied into it
+	bool direct = slot.surface.getPixels() && slot.surface.w == width && slot.surface.h == height && slot.surface.format == format &&
+	              _aheadTrack->canDecodeInto(slot.surface);
+
+	if (direct)
+		_aheadTrack->setOutputSurface(&slot.surface);
+
+	return direct;
+}
+
+void VideoDecoder::queueAheadFrame(bool direct) {
+	uint32 written = _aheadWritten.loadRelaxed();
+	AheadFrame &slot = _aheadFrames[written % _aheadFrameCount];
+
+	const Graphics::Surface *frame = _aheadTrack->decodeNextFrame();
+
+	if (direct)
+		_aheadTrack->setOutputSurface(0);
+
+	slot.hasSurface = frame != 0;
+
+	if (frame && frame->getPixels() != slot.surface.getPixels()) {
+		if (slot.surface.w != frame->w || slot.surface.h != frame->h || slot.surface.format != frame->format) {
+			slot.surface.free();
+			slot.surface.create(frame->w, frame->h, frame->format);
+		}
+
+		slot.surface.copyRectToSurface(*frame, 0, 0, Common::Rect(frame->w, frame->h));
+	}
+
+	slot.dirtyPalette = _aheadTrack->hasDirtyPalette();
+	if (slot.dirtyPalette)
+		memcpy(slot.palette, _aheadTrack->getPalette(), sizeof(slot.palette));
+
+	slot.curFrame = _aheadTrack->getCurFrame();
+	slot.endOfTrack = _aheadTrack->endOfTrack();
+	slot.nextFrameStartTime = _aheadTrack->getNextFrameStartTime();
+
+	_aheadWritten.store(written + 1);
+}
+
+const Graphics::Surface *VideoDecoder::presentAheadFrame() {
+	AheadFrame &slot = _aheadFrames[_aheadRead % _aheadFrameCount];
+	_aheadRead++;
+
+	// The frame returned previously is no longer in use
+	_aheadReleased.store(_aheadRead - 1);
+
+	_aheadCurFrame = slot.curFrame;
+	_aheadNextFrameStartTime = slot.nextFrameStartTime;
+	_aheadEndOfTrack = slot.endOfTrack;
+
+	if (slot.dirtyPalette) {
+		memcpy(_aheadPalette, slot.palette, sizeof(_aheadPalette));
+		_palette = _aheadPalette;
+		_dirtyPalette = true;
+	}
+
+	findNextVideoTrack();
+	return slot.hasSurface ? &slot.surface : 0;
+}
+
+void VideoDecoder::decodeAhead() {
+	while (!_aheadStop.load()) {
+		if (_aheadWritten.loadRelaxed() - _aheadReleased.load() >= _aheadFrameCount || _aheadTrack->endOfTrack())
+			break;
+
+		const bool direct = beginAheadFrame();
+		readNextPacket();
+		queueAheadFrame(direct);
+	}
+}
+
+int VideoDecoder::getTrackCurFrame(const VideoTrack *track) const {
+	return track == _aheadTrack ? _aheadCurFrame : track->getCurFrame();
+}
+
+uint32 VideoDecoder::getTrackNextFrameStartTime(const VideoTrack *track) const {
+	return track == _aheadTrack ? _aheadNextFrameStartTime : track->getNextFrameStartTime();
+}
+
+bool VideoDecoder::getTrackEndOfTrack(const Track *track) const {
+	return track == _aheadTrack ? _aheadEndOfTrack : track->endOfTrack();
+}
+
 VideoDecoder::Track::Track() {
 	_paused = false;
 }
@@ -718,6 +1028,8 @@ bool VideoDecoder::StreamFileAudioTrack::loadFromFile(const Common::String &base
 }
 
 void VideoDecoder::addTrack(Track *track, bool isExternal) {
+	flushDecodeAhead();
+
 	_tracks.push_back(track);
 
 	if (isExternal)
@@ -871,6 +1183,11 @@ bool VideoDecoder::endOfVideoTracks() const {
 }
 
 VideoDecoder::VideoTrack *VideoDecoder::findNextVideoTrack() {
+	if (_aheadTrack) {
+		_nextVideoTrack = _aheadEndOfTrack ? 0 : _aheadTrack;
+		return _nextVideoTrack;
+	}
+
 	_nextVideoTrack = 0;
 	uint32 bestTime = 0xFFFFFFFF;
 
@@ -924,8 +1241,8 @@ bool VideoDecoder::hasFramesLeft() const {
 
 		const VideoTrack *track = (const VideoTrack *)*it;
 
-		bool videoEndTimeReached = _endTimeSet && track->getNextFrameStartTime() >= (uint)_endTime.msecs();
-		bool endReached = track->endOfTrack() || (isPlaying() && videoEndTimeReached);
+		bool videoEndTimeReached = _endTimeSet && getTrackNextFrameStartTime(track) >= (uint)_endTime.msecs();
+		bool endReached = getTrackEndOfTrack(track) || (isPlaying() && videoEndTimeReached);
 		if (!endReached)
 			return true;
 	}
@@ -942,6 +1259,8 @@ bool VideoDecoder::hasAudio() const {
 }
 
 void VideoDecoder::eraseTrack(Track *track) {
+	flushDecodeAhead();
+
 	for (uint idx = 0; idx < _externalTracks.size(); ++idx) {
 		if (_externalTracks[idx] == track)
 			_externalTracks.remove_at(idx);
@@ -26,8 +26,10 @@
 #include "audio/mixer.h"
 #include "audio/timestamp.h"	// TODO: Move this to common/ ?
 #include "common/array.h"
+#include "common/atomic.h"
 #include "common/rational.h"
 #include "common/str.h"
+#include "common/system.h"
 #include "graphics/pixelformat.h"
 
 namespace Audio {
@@ -38,6 +40,7 @@ class SeekableAudioStream;
 
 namespace Common {
 class SeekableReadStream;
+class Task;
 }
 
 namespace Graphics {
@@ -52,7 +55,7 @@ namespace Video {
 class VideoDecoder {
 public:
 	VideoDecoder();
-	virtual ~VideoDecoder() {}
+	virtual ~VideoDecoder();
 
 	/////////////////////////////////////////
 	// Opening/Closing a Video
@@ -355,6 +358,26 @@ public:
 	 */
 	virtual const Graphics::Surface *decodeNextFrame();
 
+	/**
+	 * Decode the next frame straight into a surface owned by the caller.
+	 *
+	 * This is meant for callers that would otherwise copy the frames
+	 * unchanged to another surface, e.g. a locked screen surface. Video
+	 * tracks supporting it write the frame directly into @p dst, which saves
+	 * both the track's own surface and the copy. For all other tracks, and
+	 * while frames are decoded ahead, the frame returned by decodeNextFrame()
+	 * is copied into @p dst, converting it to the format of @p dst if needed.
+	 *
+	 * The frame is placed in the top-left corner of @p dst and clipped to its
+	 * size. Use Graphics::Surface::getSubArea() to place it elsewhere.
+	 *
+	 * @param dst The surface to write the frame to
+	 * @return true if a frame was written to @p dst, false otherwise
+	 * @note As with decodeNextFrame(), there may be no new frame, in which
+	 *       case the last frame should be kept on screen
+	 */
+	bool decodeNextFrameInto(Graphics::Surface &dst);
+
 	/**
 	 * Set the default high color format for videos that convert from YUV.
 	 *
@@ -396,6 +419,39 @@ public:
 	 */
 	bool setDitheringPalette(const byte *palette);
 
+	/**
+	 * Decode frames ahead of time on a worker thread.
+	 *
+	 * When enabled, up to the given number of frames are decoded in the
+	 * background into a pool of recycled surfaces, and decodeNextFrame()
+	 * hands them out in order. Tracks which can write their frames into a
+	 * caller's surface decode straight into the pooled ones, the others have
+	 * their frames copied there. needsUpdate(), getTimeToNextFrame(),
+	 * getCurFrame() and endOfVideo() keep describing the frame that was
+	 * last returned, not the one being decoded.
+	 *
+	 * This only has an effect on forward playback of videos with a single
+	 * video track, and when Common::ThreadPool has worker threads. Otherwise
+	 * frames are decoded on demand as usual. Pass 0 to disable it.
+	 *
+	 * While frames are decoded ahead, the tracks are accessed from the
+	 * worker thread. Functions of this class stop the worker where needed,
+	 * but decoder specific functions accessing the tracks must not be
+	 * called until decode-ahead has been disabled again.
+	 *
+	 * A change of the number of frames takes effect once the frames already
+	 * queued have been consumed, or after seek() or rewind().
+	 *
+	 * @param frames The maximum number of frames to decode in advance
+	 */
+	void setDecodeAhead(uint frames);
+
+	/**
+	 * Get the maximum number of frames decoded in advance.
+	 * @see setDecodeAhead()
+	 */
+	uint getDecodeAhead() const { return _decodeAheadFrames; }
+
 	/////////////////////////////////////////
 	// Audio Control
 	/////////////////////////////////////////
@@ -603,6 +659,20 @@ protected:
 		 */
 		virtual const Graphics::Surface *decodeNextFrame() = 0;
 
+		/**
+		 * Check whether the track can write its frames straight into the
+		 * given surface.
+		 * @see setOutputSurface()
+		 */
+		virtual bool canDecodeInto(const Graphics::Surface &dst) const { return false; }
+
+		/**
+		 * Write the frames into the given surface instead of the track's own
+		 * one, until 0 is passed. In the meantime decodeNextFrame() returns
+		 * @p dst. This is only called with surfaces canDecodeInto() accepted.
+		 */
+		virtual void setOutputSurface(Graphics::Surface *dst) {}
+
 		/**
 		 * Get the palette currently in use by this track
 		 */
@@ -853,6 +923,17 @@ protected:
 	 */
 	virtual bool useAudioSync() const { return true; }
 
+	/**
+	 * Whether or not frames may be decoded ahead on a worker thread.
+	 *
+	 * A subclass that accesses its tracks or their data source during
+	 * playback outside of readNextPacket() and the tracks' decodeNextFrame()
+	 * must override this to disable the feature.
+	 *
+	 * @see setDecodeAhead()
+	 */
+	virtual bool supportsDecodeAhead() const { return true; }
+
 	/**
 	 * Get the given track based on its index.
 	 *
@@ -959,6 +1040,43 @@ private:
 	// Default PixelFormat settings
 	Graphics::PixelFormat _defaultHighColorFormat;
 
+	// Frame-ahead decoding. The queue is a ring of _aheadFrameCount slots,
+	// filled by a thread pool task and consumed by decodeNextFrame(). The slot
+	// returned last is only released on the following decodeNextFrame().
+	struct AheadFrame;
+
+	uint _decodeAheadFrames;
+	AheadFrame *_aheadFrames;
+	uint _aheadFrameCount;
+	Common::Task *_aheadTask;
+	Common::Atomic<uint32> _aheadWritten;
+	Common::Atomic<uint32> _aheadReleased;
+	Common::Atomic<uint32> _aheadStop;
+	uint32 _aheadRead;
+	bool _aheadNoThreads;
+
+	// The track being decoded ahead, and its state as of the frame last
+	// returned. Zero while the track is in sync with what was returned.
+	VideoTrack *_aheadTrack;
+	int _aheadCurFrame;
+	uint32 _aheadNextFrameStartTime;
+	bool _aheadEndOfTrack;
+	byte _aheadPalette[256 * 3];
+
+	bool prepareDecodeAhead();
+	void startDecodeAhead();
+	void stopDecodeAhead();
+	void flushDecodeAhead();
+	void freeDecodeAheadFrames();
+	bool beginAheadFrame();
+	void queueAheadFrame(bool direct);
+	const Graphics::Surface *presentAheadFrame();
+	void decodeAhead();
+
+	int getTrackCurFrame(const VideoTrack *track) const;
+	uint32 getTrackNextFrameStartTime(const VideoTrack *track) const;
+	bool getTrackEndOfTrack(const Track *track) const;
+
 protected:
 	// Internal helper functions
 	void stopAudio();